@@ -0,0 +1,67 @@
+using System;
+using System.Buffers.Binary;
+
+namespace VRGameConverter.Audio
+{
+    /// <summary>
+    /// Format of one render stream, parsed from the WAVEFORMATEX(TENSIBLE) returned by IAudioClient::GetMixFormat
+    /// </summary>
+    public struct AudioMixFormat
+    {
+        public int SampleRate;
+        public int Channels;
+        public bool IsFloat32;   // Only interleaved 32-bit float streams are spatialized
+
+        public const int WaveFormatExSize = 18;
+
+        private const ushort WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+        private const ushort WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+        private const int ExtensibleExtraSize = 22;
+        private const int SubFormatOffset = 24;
+
+        private static readonly Guid KSDATAFORMAT_SUBTYPE_IEEE_FLOAT = new Guid("00000003-0000-0010-8000-00aa00389b71");
+
+        /// <summary>
+        /// Profile defaults, for streams created before the audio hooks went in
+        /// </summary>
+        public static AudioMixFormat FromSettings(AudioSettings settings)
+        {
+            return new AudioMixFormat { SampleRate = settings.SampleRate, Channels = settings.Channels, IsFloat32 = true };
+        }
+
+        /// <summary>
+        /// Total size of the structure starting with <paramref name="waveFormatHeader"/>: the header plus cbSize extra bytes
+        /// </summary>
+        public static int SizeOf(ReadOnlySpan<byte> waveFormatHeader)
+        {
+            return WaveFormatExSize + BinaryPrimitives.ReadUInt16LittleEndian(waveFormatHeader.Slice(16));
+        }
+
+        public static AudioMixFormat Parse(ReadOnlySpan<byte> waveFormat)
+        {
+            ushort tag = BinaryPrimitives.ReadUInt16LittleEndian(waveFormat);
+            ushort channels = BinaryPrimitives.ReadUInt16LittleEndian(waveFormat.Slice(2));
+            uint sampleRate = BinaryPrimitives.ReadUInt32LittleEndian(waveFormat.Slice(4));
+            ushort bitsPerSample = BinaryPrimitives.ReadUInt16LittleEndian(waveFormat.Slice(14));
+            ushort extraSize = BinaryPrimitives.ReadUInt16LittleEndian(waveFormat.Slice(16));
+
+            bool isFloat = tag == WAVE_FORMAT_IEEE_FLOAT;
+            if (tag == WAVE_FORMAT_EXTENSIBLE && extraSize >= ExtensibleExtraSize)
+            {
+                isFloat = new Guid(waveFormat.Slice(SubFormatOffset, 16)) == KSDATAFORMAT_SUBTYPE_IEEE_FLOAT;
+            }
+
+            return new AudioMixFormat
+            {
+                SampleRate = (int)sampleRate,
+                Channels = channels,
+                IsFloat32 = isFloat && bitsPerSample == 32
+            };
+        }
+
+        public override string ToString()
+        {
+            return $"{SampleRate} Hz, {Channels} ch, {(IsFloat32 ? "float32" : "not float32")}";
+        }
+    }
+}
@@ -0,0 +1,18 @@
+namespace VRGameConverter.Audio
+{
+    /// <summary>
+    /// Settings for re-spatializing game audio around the player's head
+    /// </summary>
+    public class AudioSettings
+    {
+        public bool SpatializationEnabled { get; set; } = true;
+
+        // Shared-mode mix format of the game's render endpoint (float32 interleaved)
+        public int SampleRate { get; set; } = 48000;
+        public int Channels { get; set; } = 2;
+
+        // Where the game's left/right channels are placed as virtual speakers
+        public float SpeakerAngleDegrees { get; set; } = 30.0f;
+        public int BlockSize { get; set; } = HrtfSpatializer.DefaultBlockSize;
+    }
+}
@@ -0,0 +1,113 @@
+using System;
+using System.Runtime.CompilerServices;
+
+namespace VRGameConverter.Audio
+{
+    /// <summary>
+    /// Iterative radix-2 complex FFT on split real/imaginary arrays with precomputed twiddles.
+    /// Allocation-free after construction.
+    /// </summary>
+    public sealed class Fft
+    {
+        public int Size { get; }
+
+        private readonly int[] bitReverse;
+        private readonly float[] cosTable;
+        private readonly float[] sinTable;
+
+        public Fft(int size)
+        {
+            if (size < 2 || (size & (size - 1)) != 0)
+            {
+                throw new ArgumentException("FFT size must be a power of two", nameof(size));
+            }
+
+            Size = size;
+            bitReverse = new int[size];
+            cosTable = new float[size / 2];
+            sinTable = new float[size / 2];
+
+            int bits = 0;
+            while ((1 << bits) < size) bits++;
+
+            for (int i = 0; i < size; i++)
+            {
+                int reversed = 0;
+                for (int b = 0; b < bits; b++)
+                {
+                    if ((i & (1 << b)) != 0) reversed |= 1 << (bits - 1 - b);
+                }
+                bitReverse[i] = reversed;
+            }
+
+            for (int i = 0; i < size / 2; i++)
+            {
+                double angle = -2.0 * Math.PI * i / size;
+                cosTable[i] = (float)Math.Cos(angle);
+                sinTable[i] = (float)Math.Sin(angle);
+            }
+        }
+
+        public void Forward(float[] re, float[] im)
+        {
+            Transform(re, im, false);
+        }
+
+        /// <summary>
+        /// Inverse transform, scaled by 1/N
+        /// </summary>
+        public void Inverse(float[] re, float[] im)
+        {
+            Transform(re, im, true);
+
+            float scale = 1.0f / Size;
+            for (int i = 0; i < Size; i++)
+            {
+                re[i] *= scale;
+                im[i] *= scale;
+            }
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        private void Transform(float[] re, float[] im, bool inverse)
+        {
+            for (int i = 0; i < Size; i++)
+            {
+                int j = bitReverse[i];
+                if (j > i)
+                {
+                    float tr = re[i]; re[i] = re[j]; re[j] = tr;
+                    float ti = im[i]; im[i] = im[j]; im[j] = ti;
+                }
+            }
+
+            float sign = inverse ? -1.0f : 1.0f;
+
+            for (int length = 2; length <= Size; length <<= 1)
+            {
+                int half = length >> 1;
+                int step = Size / length;
+
+                for (int start = 0; start < Size; start += length)
+                {
+                    for (int k = 0; k < half; k++)
+                    {
+                        float wr = cosTable[k * step];
+                        float wi = sign * sinTable[k * step];
+
+                        int a = start + k;
+                        int b = a + half;
+
+                        float xr = re[b] * wr - im[b] * wi;
+                        float xi = re[b] * wi + im[b] * wr;
+
+                        re[b] = re[a] - xr;
+                        im[b] = im[a] - xi;
+                        re[a] += xr;
+                        im[a] += xi;
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,136 @@
+using System;
+using System.Collections.Generic;
+
+namespace VRGameConverter.Audio
+{
+    /// <summary>
+    /// Head-related impulse responses for the horizontal plane, indexed by azimuth
+    /// (0 = straight ahead, positive = to the right)
+    /// </summary>
+    public class HrtfSet
+    {
+        public int SampleRate { get; }
+        public int Length { get; }
+        public IReadOnlyList<HrtfMeasurement> Measurements => measurements;
+
+        private readonly List<HrtfMeasurement> measurements = new List<HrtfMeasurement>();
+
+        public HrtfSet(int sampleRate, int length)
+        {
+            SampleRate = sampleRate;
+            Length = length;
+        }
+
+        public void Add(float azimuthDegrees, float[] left, float[] right)
+        {
+            if (left.Length > Length || right.Length > Length)
+            {
+                throw new ArgumentException($"Impulse responses must be at most {Length} samples");
+            }
+
+            measurements.Add(new HrtfMeasurement
+            {
+                AzimuthDegrees = NormalizeAzimuth(azimuthDegrees),
+                Left = left,
+                Right = right
+            });
+        }
+
+        /// <summary>
+        /// Index of the measurement closest to the given azimuth
+        /// </summary>
+        public int FindNearest(float azimuthDegrees)
+        {
+            float target = NormalizeAzimuth(azimuthDegrees);
+            int best = 0;
+            float bestDistance = float.MaxValue;
+
+            for (int i = 0; i < measurements.Count; i++)
+            {
+                float distance = Math.Abs(NormalizeAzimuth(measurements[i].AzimuthDegrees - target));
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    best = i;
+                }
+            }
+
+            return best;
+        }
+
+        public static float NormalizeAzimuth(float degrees)
+        {
+            degrees %= 360.0f;
+            if (degrees > 180.0f) degrees -= 360.0f;
+            if (degrees <= -180.0f) degrees += 360.0f;
+            return degrees;
+        }
+
+        /// <summary>
+        /// Spherical-head approximation used when no measured set is installed:
+        /// Woodworth interaural time difference plus a head-shadow low-pass on the far ear
+        /// </summary>
+        public static HrtfSet CreateSphericalHeadModel(int sampleRate, float stepDegrees = 10.0f, int length = 256)
+        {
+            const float headRadius = 0.0875f;
+            const float speedOfSound = 343.0f;
+
+            var set = new HrtfSet(sampleRate, length);
+
+            for (float azimuth = -180.0f + stepDegrees; azimuth <= 180.0f; azimuth += stepDegrees)
+            {
+                float theta = azimuth * MathF.PI / 180.0f;
+
+                // Angle from each ear's axis: 0 when the source is directly beside that ear
+                float rightIncidence = MathF.Acos(Math.Clamp(MathF.Sin(theta), -1.0f, 1.0f));
+                float leftIncidence = MathF.PI - rightIncidence;
+
+                set.Add(azimuth,
+                    CreateEarResponse(sampleRate, length, leftIncidence, headRadius, speedOfSound),
+                    CreateEarResponse(sampleRate, length, rightIncidence, headRadius, speedOfSound));
+            }
+
+            return set;
+        }
+
+        private static float[] CreateEarResponse(int sampleRate, int length, float incidence, float headRadius, float speedOfSound)
+        {
+            var response = new float[length];
+
+            // Path relative to the head centre: a straight line for the lit ear,
+            // an arc around the head once the ear is in shadow (incidence past 90 degrees)
+            float shadow = Math.Max(0.0f, incidence - MathF.PI / 2);
+            float path = shadow > 0.0f ? headRadius * shadow : -headRadius * MathF.Cos(incidence);
+            float delaySamples = 4.0f + (headRadius + path) / speedOfSound * sampleRate;
+
+            // Fractional delay via linear interpolation between two taps
+            int tap = (int)delaySamples;
+            float fraction = delaySamples - tap;
+            float gain = 0.4f + 0.6f * (1.0f + MathF.Cos(incidence)) * 0.5f;
+
+            if (tap + 1 < length)
+            {
+                response[tap] = gain * (1.0f - fraction);
+                response[tap + 1] = gain * fraction;
+            }
+
+            // Head shadow: stronger low-pass the deeper the ear is in shadow
+            float pole = 0.65f * shadow / (MathF.PI / 2);
+            float state = 0.0f;
+            for (int i = 0; i < length; i++)
+            {
+                state = (1.0f - pole) * response[i] + pole * state;
+                response[i] = state;
+            }
+
+            return response;
+        }
+    }
+
+    public class HrtfMeasurement
+    {
+        public float AzimuthDegrees { get; set; }
+        public float[] Left { get; set; }
+        public float[] Right { get; set; }
+    }
+}
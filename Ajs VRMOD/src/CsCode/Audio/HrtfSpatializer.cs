@@ -0,0 +1,198 @@
+using System;
+using System.Diagnostics;
+using System.Numerics;
+using System.Runtime.CompilerServices;
+
+namespace VRGameConverter.Audio
+{
+    /// <summary>
+    /// Re-spatializes the game's flat stereo mix: the left/right channels become virtual speakers fixed in the
+    /// room, and each is rendered to both ears through the HRIR for its angle relative to the current head yaw.
+    /// Streaming, in-place and allocation-free; adds one block of latency.
+    /// </summary>
+    public sealed class HrtfSpatializer
+    {
+        public const int DefaultBlockSize = 256;
+
+        public int BlockSize { get; }
+        public int SampleRate { get; }
+
+        // Per-block processing cost, to check the real-time budget
+        public double LastBlockMicroseconds { get; private set; }
+        public double MaxBlockMicroseconds { get; private set; }
+
+        private readonly HrtfSet hrtfSet;
+        private readonly float speakerAngle;
+        private readonly PartitionedFilter[] leftEarFilters;
+        private readonly PartitionedFilter[] rightEarFilters;
+        private readonly PartitionedConvolver leftInput;
+        private readonly PartitionedConvolver rightInput;
+
+        // Streaming buffers: input collects a block while output plays the previous one
+        private readonly float[] inputLeft;
+        private readonly float[] inputRight;
+        private readonly float[] outputLeft;
+        private readonly float[] outputRight;
+        private int fill = 0;
+
+        // Scratch for spectra and crossfades
+        private readonly float[] accRe;
+        private readonly float[] accIm;
+        private readonly float[] fadeScratch;
+
+        private int currentLeftSpeaker = -1;
+        private int currentRightSpeaker = -1;
+        private float headYawDegrees = 0;
+
+        public HrtfSpatializer(HrtfSet hrtfSet, float speakerAngleDegrees = 30.0f, int blockSize = DefaultBlockSize)
+        {
+            this.hrtfSet = hrtfSet;
+            speakerAngle = speakerAngleDegrees;
+            BlockSize = blockSize;
+            SampleRate = hrtfSet.SampleRate;
+
+            var fft = new Fft(blockSize * 2);
+
+            // Pre-transform every HRIR once so switching direction costs nothing
+            int count = hrtfSet.Measurements.Count;
+            leftEarFilters = new PartitionedFilter[count];
+            rightEarFilters = new PartitionedFilter[count];
+            for (int i = 0; i < count; i++)
+            {
+                leftEarFilters[i] = new PartitionedFilter(hrtfSet.Measurements[i].Left, blockSize, fft);
+                rightEarFilters[i] = new PartitionedFilter(hrtfSet.Measurements[i].Right, blockSize, fft);
+            }
+
+            int partitions = (hrtfSet.Length + blockSize - 1) / blockSize;
+            leftInput = new PartitionedConvolver(blockSize, partitions, fft);
+            rightInput = new PartitionedConvolver(blockSize, partitions, fft);
+
+            inputLeft = new float[blockSize];
+            inputRight = new float[blockSize];
+            outputLeft = new float[blockSize];
+            outputRight = new float[blockSize];
+            accRe = new float[fft.Size];
+            accIm = new float[fft.Size];
+            fadeScratch = new float[blockSize];
+        }
+
+        /// <summary>
+        /// Update the listener orientation. Called from the VR update loop, read by the audio thread.
+        /// </summary>
+        public void SetHeadRotation(Quaternion rotation)
+        {
+            // Yaw of the head's forward vector, positive when turning right
+            Vector3 forward = Vector3.Transform(-Vector3.UnitZ, rotation);
+            headYawDegrees = MathF.Atan2(forward.X, -forward.Z) * 180.0f / MathF.PI;
+        }
+
+        /// <summary>
+        /// Process interleaved float samples in place. Channels beyond the first two are passed through.
+        /// </summary>
+        public void ProcessInterleaved(Span<float> samples, int channels)
+        {
+            if (channels < 2) return;
+
+            for (int frame = 0; frame + channels <= samples.Length; frame += channels)
+            {
+                inputLeft[fill] = samples[frame];
+                inputRight[fill] = samples[frame + 1];
+
+                samples[frame] = outputLeft[fill];
+                samples[frame + 1] = outputRight[fill];
+
+                if (++fill == BlockSize)
+                {
+                    ProcessBlock();
+                    fill = 0;
+                }
+            }
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        private void ProcessBlock()
+        {
+            long start = Stopwatch.GetTimestamp();
+
+            leftInput.PushBlock(inputLeft, 0);
+            rightInput.PushBlock(inputRight, 0);
+
+            // Speakers stay fixed in the room, so turning the head moves them the other way
+            float yaw = headYawDegrees;
+            int leftSpeaker = hrtfSet.FindNearest(-speakerAngle - yaw);
+            int rightSpeaker = hrtfSet.FindNearest(speakerAngle - yaw);
+
+            if (currentLeftSpeaker < 0)
+            {
+                currentLeftSpeaker = leftSpeaker;
+                currentRightSpeaker = rightSpeaker;
+            }
+
+            RenderEar(leftEarFilters, currentLeftSpeaker, currentRightSpeaker, outputLeft);
+            RenderEar(rightEarFilters, currentLeftSpeaker, currentRightSpeaker, outputRight);
+
+            if (leftSpeaker != currentLeftSpeaker || rightSpeaker != currentRightSpeaker)
+            {
+                // Direction changed: render with the new HRIRs too and crossfade over this block to avoid clicks
+                RenderEar(leftEarFilters, leftSpeaker, rightSpeaker, fadeScratch);
+                Crossfade(outputLeft, fadeScratch);
+                RenderEar(rightEarFilters, leftSpeaker, rightSpeaker, fadeScratch);
+                Crossfade(outputRight, fadeScratch);
+
+                currentLeftSpeaker = leftSpeaker;
+                currentRightSpeaker = rightSpeaker;
+            }
+
+            LastBlockMicroseconds = (Stopwatch.GetTimestamp() - start) * 1e6 / Stopwatch.Frequency;
+            MaxBlockMicroseconds = Math.Max(MaxBlockMicroseconds, LastBlockMicroseconds);
+        }
+
+        private void RenderEar(PartitionedFilter[] earFilters, int leftSpeaker, int rightSpeaker, float[] output)
+        {
+            // Both speakers summed in the frequency domain: one inverse FFT per ear
+            Array.Clear(accRe, 0, accRe.Length);
+            Array.Clear(accIm, 0, accIm.Length);
+            leftInput.Accumulate(earFilters[leftSpeaker], accRe, accIm);
+            rightInput.Accumulate(earFilters[rightSpeaker], accRe, accIm);
+            leftInput.Finish(accRe, accIm, output, 0);
+        }
+
+        private void Crossfade(float[] from, float[] to)
+        {
+            float step = 1.0f / BlockSize;
+            for (int i = 0; i < BlockSize; i++)
+            {
+                float t = i * step;
+                from[i] = from[i] * (1.0f - t) + to[i] * t;
+            }
+        }
+
+        /// <summary>
+        /// Offline path: spatialize a WAV file with a scripted head yaw (degrees as a function of time in seconds)
+        /// </summary>
+        public static void ProcessFile(string inputPath, string outputPath, Func<double, float> headYawAt, HrtfSet hrtfSet = null)
+        {
+            var wav = WavFile.Read(inputPath);
+            var spatializer = new HrtfSpatializer(hrtfSet ?? HrtfSet.CreateSphericalHeadModel(wav.SampleRate));
+
+            if (spatializer.SampleRate != wav.SampleRate)
+            {
+                throw new ArgumentException($"HRTF set is {spatializer.SampleRate} Hz but input is {wav.SampleRate} Hz");
+            }
+
+            int blockSamples = spatializer.BlockSize * wav.Channels;
+            for (int offset = 0; offset < wav.Samples.Length; offset += blockSamples)
+            {
+                double time = (double)offset / wav.Channels / wav.SampleRate;
+                float yaw = headYawAt(time) * MathF.PI / 180.0f;
+                spatializer.SetHeadRotation(Quaternion.CreateFromAxisAngle(Vector3.UnitY, -yaw));
+
+                int count = Math.Min(blockSamples, wav.Samples.Length - offset);
+                spatializer.ProcessInterleaved(new Span<float>(wav.Samples, offset, count), wav.Channels);
+            }
+
+            WavFile.Write(outputPath, wav);
+            Console.WriteLine($"Spatialized {inputPath}: max {spatializer.MaxBlockMicroseconds:F0} us per {spatializer.BlockSize}-sample block");
+        }
+    }
+}
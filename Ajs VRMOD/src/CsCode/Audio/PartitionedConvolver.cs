@@ -0,0 +1,140 @@
+using System;
+using System.Numerics;
+using System.Runtime.CompilerServices;
+
+namespace VRGameConverter.Audio
+{
+    /// <summary>
+    /// Impulse response split into block-sized partitions, each pre-transformed for overlap-save
+    /// </summary>
+    public sealed class PartitionedFilter
+    {
+        public int Partitions { get; }
+        internal readonly float[][] Re;
+        internal readonly float[][] Im;
+
+        public PartitionedFilter(float[] impulse, int blockSize, Fft fft)
+        {
+            if (fft.Size != blockSize * 2)
+            {
+                throw new ArgumentException("FFT size must be twice the block size", nameof(fft));
+            }
+
+            Partitions = Math.Max(1, (impulse.Length + blockSize - 1) / blockSize);
+            Re = new float[Partitions][];
+            Im = new float[Partitions][];
+
+            for (int p = 0; p < Partitions; p++)
+            {
+                // Each partition is zero-padded to the FFT size
+                Re[p] = new float[fft.Size];
+                Im[p] = new float[fft.Size];
+
+                int offset = p * blockSize;
+                int count = Math.Min(blockSize, impulse.Length - offset);
+                if (count > 0) Array.Copy(impulse, offset, Re[p], 0, count);
+
+                fft.Forward(Re[p], Im[p]);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Uniformly partitioned overlap-save convolution for one input channel.
+    /// Keeps a frequency-domain delay line of recent input spectra, so any number of filters
+    /// (e.g. one per ear, or old/new filters while crossfading) can be applied to the same input cheaply.
+    /// </summary>
+    public sealed class PartitionedConvolver
+    {
+        public int BlockSize { get; }
+
+        private readonly Fft fft;
+        private readonly float[] history;     // Previous block followed by current block
+        private readonly float[][] delayRe;   // Input spectra, newest at delayHead
+        private readonly float[][] delayIm;
+        private int delayHead = 0;
+
+        public PartitionedConvolver(int blockSize, int partitions, Fft fft)
+        {
+            if (fft.Size != blockSize * 2)
+            {
+                throw new ArgumentException("FFT size must be twice the block size", nameof(fft));
+            }
+
+            BlockSize = blockSize;
+            this.fft = fft;
+            history = new float[blockSize * 2];
+
+            delayRe = new float[partitions][];
+            delayIm = new float[partitions][];
+            for (int p = 0; p < partitions; p++)
+            {
+                delayRe[p] = new float[fft.Size];
+                delayIm[p] = new float[fft.Size];
+            }
+        }
+
+        /// <summary>
+        /// Add one block of input and transform it into the delay line
+        /// </summary>
+        public void PushBlock(float[] input, int offset)
+        {
+            Array.Copy(history, BlockSize, history, 0, BlockSize);
+            Array.Copy(input, offset, history, BlockSize, BlockSize);
+
+            delayHead = (delayHead + delayRe.Length - 1) % delayRe.Length;
+
+            float[] re = delayRe[delayHead];
+            float[] im = delayIm[delayHead];
+            Array.Copy(history, re, history.Length);
+            Array.Clear(im, 0, im.Length);
+            fft.Forward(re, im);
+        }
+
+        /// <summary>
+        /// Accumulate sum over partitions of X[k - p] * H[p] into the output spectrum
+        /// </summary>
+        public void Accumulate(PartitionedFilter filter, float[] accRe, float[] accIm)
+        {
+            int partitions = Math.Min(filter.Partitions, delayRe.Length);
+            for (int p = 0; p < partitions; p++)
+            {
+                int slot = (delayHead + p) % delayRe.Length;
+                ComplexMultiplyAccumulate(delayRe[slot], delayIm[slot], filter.Re[p], filter.Im[p], accRe, accIm);
+            }
+        }
+
+        /// <summary>
+        /// Inverse-transform an accumulated spectrum and copy the valid (non-aliased) half to the output
+        /// </summary>
+        public void Finish(float[] accRe, float[] accIm, float[] output, int offset)
+        {
+            fft.Inverse(accRe, accIm);
+            Array.Copy(accRe, BlockSize, output, offset, BlockSize);
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        private static void ComplexMultiplyAccumulate(float[] ar, float[] ai, float[] br, float[] bi, float[] cr, float[] ci)
+        {
+            int width = Vector<float>.Count;
+            int i = 0;
+
+            for (; i <= ar.Length - width; i += width)
+            {
+                var xr = new Vector<float>(ar, i);
+                var xi = new Vector<float>(ai, i);
+                var yr = new Vector<float>(br, i);
+                var yi = new Vector<float>(bi, i);
+
+                (new Vector<float>(cr, i) + xr * yr - xi * yi).CopyTo(cr, i);
+                (new Vector<float>(ci, i) + xr * yi + xi * yr).CopyTo(ci, i);
+            }
+
+            for (; i < ar.Length; i++)
+            {
+                cr[i] += ar[i] * br[i] - ai[i] * bi[i];
+                ci[i] += ar[i] * bi[i] + ai[i] * br[i];
+            }
+        }
+    }
+}
@@ -0,0 +1,121 @@
+using System;
+using System.IO;
+using System.Text;
+
+namespace VRGameConverter.Audio
+{
+    /// <summary>
+    /// Minimal RIFF/WAVE reader and writer for offline audio processing (16-bit PCM or 32-bit float)
+    /// </summary>
+    public class WavFile
+    {
+        public int SampleRate { get; set; }
+        public int Channels { get; set; }
+        public float[] Samples { get; set; }  // Interleaved, normalized to [-1, 1]
+
+        private const ushort FormatPcm = 1;
+        private const ushort FormatFloat = 3;
+        private const ushort FormatExtensible = 0xFFFE;
+
+        public static WavFile Read(string path)
+        {
+            using (var reader = new BinaryReader(File.OpenRead(path)))
+            {
+                if (Encoding.ASCII.GetString(reader.ReadBytes(4)) != "RIFF")
+                    throw new InvalidDataException($"{path} is not a RIFF file");
+                reader.ReadInt32();
+                if (Encoding.ASCII.GetString(reader.ReadBytes(4)) != "WAVE")
+                    throw new InvalidDataException($"{path} is not a WAVE file");
+
+                ushort format = 0;
+                int channels = 0, sampleRate = 0, bitsPerSample = 0;
+
+                while (reader.BaseStream.Position < reader.BaseStream.Length)
+                {
+                    string chunkId = Encoding.ASCII.GetString(reader.ReadBytes(4));
+                    int chunkSize = reader.ReadInt32();
+                    long next = reader.BaseStream.Position + chunkSize + (chunkSize & 1);
+
+                    if (chunkId == "fmt ")
+                    {
+                        format = reader.ReadUInt16();
+                        channels = reader.ReadUInt16();
+                        sampleRate = reader.ReadInt32();
+                        reader.ReadInt32();  // byte rate
+                        reader.ReadUInt16(); // block align
+                        bitsPerSample = reader.ReadUInt16();
+
+                        if (format == FormatExtensible && chunkSize >= 40)
+                        {
+                            reader.ReadBytes(8);
+                            format = reader.ReadUInt16();  // First two bytes of the sub-format GUID
+                        }
+                    }
+                    else if (chunkId == "data")
+                    {
+                        if (channels == 0)
+                            throw new InvalidDataException($"{path} has no fmt chunk before data");
+
+                        return new WavFile
+                        {
+                            SampleRate = sampleRate,
+                            Channels = channels,
+                            Samples = ReadSamples(reader, chunkSize, format, bitsPerSample)
+                        };
+                    }
+
+                    reader.BaseStream.Position = next;
+                }
+
+                throw new InvalidDataException($"{path} has no data chunk");
+            }
+        }
+
+        private static float[] ReadSamples(BinaryReader reader, int byteCount, ushort format, int bitsPerSample)
+        {
+            if (format == FormatFloat && bitsPerSample == 32)
+            {
+                var samples = new float[byteCount / 4];
+                for (int i = 0; i < samples.Length; i++) samples[i] = reader.ReadSingle();
+                return samples;
+            }
+
+            if (format == FormatPcm && bitsPerSample == 16)
+            {
+                var samples = new float[byteCount / 2];
+                for (int i = 0; i < samples.Length; i++) samples[i] = reader.ReadInt16() / 32768.0f;
+                return samples;
+            }
+
+            throw new NotSupportedException($"Unsupported WAV format {format} with {bitsPerSample} bits per sample");
+        }
+
+        /// <summary>
+        /// Write as 32-bit float so processed output is never clipped
+        /// </summary>
+        public static void Write(string path, WavFile wav)
+        {
+            using (var writer = new BinaryWriter(File.Create(path)))
+            {
+                int dataSize = wav.Samples.Length * 4;
+
+                writer.Write(Encoding.ASCII.GetBytes("RIFF"));
+                writer.Write(36 + dataSize);
+                writer.Write(Encoding.ASCII.GetBytes("WAVE"));
+
+                writer.Write(Encoding.ASCII.GetBytes("fmt "));
+                writer.Write(16);
+                writer.Write(FormatFloat);
+                writer.Write((ushort)wav.Channels);
+                writer.Write(wav.SampleRate);
+                writer.Write(wav.SampleRate * wav.Channels * 4);
+                writer.Write((ushort)(wav.Channels * 4));
+                writer.Write((ushort)32);
+
+                writer.Write(Encoding.ASCII.GetBytes("data"));
+                writer.Write(dataSize);
+                foreach (float sample in wav.Samples) writer.Write(sample);
+            }
+        }
+    }
+}
@@ -0,0 +1,283 @@
+using System;
+using System.Diagnostics;
+using System.Threading;
+using VRGameConverter.Rendering;
+
+namespace VRGameConverter.Diagnostics
+{
+    /// <summary>
+    /// What limited a frame: the part of the frame interval that took the longest
+    /// </summary>
+    public enum FrameBottleneck
+    {
+        None,        // Frame made the refresh interval
+        GameCpu,     // Game simulation and draw submission
+        Hooks,       // Our own work inside the game's hooks
+        Gpu,         // Blocked in Present waiting for the GPU
+        Compositor   // Waiting on the VR runtime's frame pacing
+    }
+
+    /// <summary>
+    /// Rolling summary over the last analysis window
+    /// </summary>
+    public struct FrameSummary
+    {
+        public int Frames;
+        public double MeanFrameMilliseconds;
+        public double P95FrameMilliseconds;
+        public double MeanGameCpuMilliseconds;
+        public double MeanHookMilliseconds;
+        public double MeanGpuMilliseconds;
+        public double MeanVsyncMilliseconds;
+        public double MeanCompositorMilliseconds;
+        public int MissedFrames;
+        public FrameBottleneck Bottleneck;  // Most common bottleneck among missed frames
+
+        public override string ToString()
+        {
+            return $"{Frames} frames, mean {MeanFrameMilliseconds:F2} ms (p95 {P95FrameMilliseconds:F2}), {MissedFrames} missed, " +
+                $"cpu {MeanGameCpuMilliseconds:F2} / hooks {MeanHookMilliseconds:F2} / gpu {MeanGpuMilliseconds:F2} / vsync {MeanVsyncMilliseconds:F2} / compositor {MeanCompositorMilliseconds:F2} ms, " +
+                $"bound by {Bottleneck}";
+        }
+    }
+
+    /// <summary>
+    /// Splits every frame interval (present to present) into game CPU, our hooks, GPU wait, vsync wait and
+    /// compositor wait, classifies which one made the frame miss the refresh interval, and summarizes over a
+    /// rolling window. Fed from the present hook and from timers around our own hook bodies.
+    /// </summary>
+    public sealed class FrameAnalyzer
+    {
+        public static FrameAnalyzer Shared { get; } = new FrameAnalyzer();
+
+        public const int WindowFrames = 120;
+
+        // Time accumulated since the last present, added from any thread
+        private long hookTicks = 0;
+        private long compositorTicks = 0;
+
+        private long lastPresentEnd = 0;
+        private double refreshMilliseconds = 1000.0 / 90.0;
+
+        // Current window, touched only by the present thread
+        private readonly double[] frameTimes = new double[WindowFrames];
+        private readonly int[] bottleneckCounts = new int[Enum.GetValues(typeof(FrameBottleneck)).Length];
+        private int windowCount = 0;
+        private double sumCpu, sumHooks, sumGpu, sumVsync, sumCompositor;
+        private int missed = 0;
+
+        // Last finished window, handed to the update thread
+        private readonly object summaryLock = new object();
+        private FrameSummary summary;
+        private bool summaryReady = false;
+
+        public FrameBottleneck LastBottleneck { get; private set; }
+
+        public void SetRefreshRate(float refreshRate)
+        {
+            refreshMilliseconds = 1000.0 / refreshRate;
+        }
+
+        /// <summary>
+        /// Add the time since a Stopwatch timestamp taken at the start of a hook body
+        /// </summary>
+        public void AddHookTime(long startTimestamp)
+        {
+            Interlocked.Add(ref hookTicks, Stopwatch.GetTimestamp() - startTimestamp);
+        }
+
+        /// <summary>
+        /// Time the VR runtime held the game's thread for frame pacing (e.g. WaitGetPoses / xrWaitFrame)
+        /// </summary>
+        public void AddCompositorWait(long ticks)
+        {
+            Interlocked.Add(ref compositorTicks, ticks);
+        }
+
+        /// <summary>
+        /// Called from the present hook once the game's Present has returned. presentStart is when the real
+        /// Present was called, i.e. when the game and our hooks finished submitting the frame.
+        /// </summary>
+        public void EndFrame(long presentStart, long presentEnd)
+        {
+            if (lastPresentEnd == 0)
+            {
+                lastPresentEnd = presentEnd;
+                Interlocked.Exchange(ref hookTicks, 0);
+                Interlocked.Exchange(ref compositorTicks, 0);
+                return;
+            }
+
+            double frequency = Stopwatch.Frequency / 1000.0;
+            double frame = (presentEnd - lastPresentEnd) / frequency;
+            double submit = (presentStart - lastPresentEnd) / frequency;
+            double blocked = (presentEnd - presentStart) / frequency;
+            double hooks = Interlocked.Exchange(ref hookTicks, 0) / frequency;
+            double compositor = Interlocked.Exchange(ref compositorTicks, 0) / frequency;
+            lastPresentEnd = presentEnd;
+
+            // Present returns on a refresh boundary. Blocking up to the first boundary after submission is
+            // waiting for vsync, whatever made the submission late; only blocking past it is the GPU's.
+            double vsyncBoundary = Math.Max(1, Math.Ceiling(submit / refreshMilliseconds)) * refreshMilliseconds;
+            double vsync = Math.Min(blocked, Math.Max(0, vsyncBoundary - submit));
+            double gpu = blocked - vsync;
+            double cpu = Math.Max(0, submit - hooks - compositor);
+
+            var bottleneck = Classify(frame, cpu, hooks, gpu, compositor);
+            LastBottleneck = bottleneck;
+
+            frameTimes[windowCount++] = frame;
+            sumCpu += cpu;
+            sumHooks += hooks;
+            sumGpu += gpu;
+            sumVsync += vsync;
+            sumCompositor += compositor;
+            bottleneckCounts[(int)bottleneck]++;
+            if (bottleneck != FrameBottleneck.None) missed++;
+
+            if (windowCount == WindowFrames)
+            {
+                CloseWindow();
+            }
+        }
+
+        private FrameBottleneck Classify(double frame, double cpu, double hooks, double gpu, double compositor)
+        {
+            if (frame <= refreshMilliseconds * 1.05) return FrameBottleneck.None;
+
+            var bottleneck = FrameBottleneck.GameCpu;
+            double largest = cpu;
+            if (hooks > largest) { largest = hooks; bottleneck = FrameBottleneck.Hooks; }
+            if (gpu > largest) { largest = gpu; bottleneck = FrameBottleneck.Gpu; }
+            if (compositor > largest) { bottleneck = FrameBottleneck.Compositor; }
+            return bottleneck;
+        }
+
+        private void CloseWindow()
+        {
+            var sorted = (double[])frameTimes.Clone();
+            Array.Sort(sorted);
+
+            double sum = 0;
+            foreach (double t in sorted) sum += t;
+
+            var dominant = FrameBottleneck.None;
+            for (int i = 1; i < bottleneckCounts.Length; i++)
+            {
+                if (bottleneckCounts[i] > 0 && (dominant == FrameBottleneck.None || bottleneckCounts[i] > bottleneckCounts[(int)dominant]))
+                {
+                    dominant = (FrameBottleneck)i;
+                }
+            }
+
+            var finished = new FrameSummary
+            {
+                Frames = windowCount,
+                MeanFrameMilliseconds = sum / windowCount,
+                P95FrameMilliseconds = sorted[(int)((windowCount - 1) * 0.95)],
+                MeanGameCpuMilliseconds = sumCpu / windowCount,
+                MeanHookMilliseconds = sumHooks / windowCount,
+                MeanGpuMilliseconds = sumGpu / windowCount,
+                MeanVsyncMilliseconds = sumVsync / windowCount,
+                MeanCompositorMilliseconds = sumCompositor / windowCount,
+                MissedFrames = missed,
+                Bottleneck = dominant
+            };
+
+            lock (summaryLock)
+            {
+                summary = finished;
+                summaryReady = true;
+            }
+
+            windowCount = 0;
+            sumCpu = sumHooks = sumGpu = sumVsync = sumCompositor = 0;
+            missed = 0;
+            Array.Clear(bottleneckCounts, 0, bottleneckCounts.Length);
+        }
+
+        /// <summary>
+        /// The most recent window summary, once per window
+        /// </summary>
+        public bool TryTakeSummary(out FrameSummary result)
+        {
+            lock (summaryLock)
+            {
+                result = summary;
+                bool ready = summaryReady;
+                summaryReady = false;
+                return ready;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Adjusts stereo mode and dynamic resolution from frame summaries.
+    /// GPU-bound windows lower the resolution first; CPU-bound ones switch to alternate-eye rendering, which
+    /// halves the game's per-frame work. With steady headroom both are walked back.
+    /// </summary>
+    public sealed class AdaptiveQualityController
+    {
+        private const float ResolutionStep = 0.05f;
+
+        // Windows to wait after a stereo switch before judging it, so the change shows up in the numbers
+        private const int StereoCooldownWindows = 3;
+        private int cooldown = 0;
+
+        /// <summary>
+        /// Returns true when the settings were changed and need re-applying
+        /// </summary>
+        public bool Adapt(FrameSummary summary, RenderSettings settings)
+        {
+            if (!settings.AdaptiveQualityEnabled) return false;
+            if (cooldown > 0) { cooldown--; return false; }
+
+            double budget = 1000.0 / settings.HeadsetRefreshRate;
+            bool missing = summary.MissedFrames > summary.Frames / 10;
+
+            if (missing)
+            {
+                switch (summary.Bottleneck)
+                {
+                    case FrameBottleneck.Gpu:
+                        if (settings.DynamicResolutionScale > settings.MinDynamicResolutionScale)
+                        {
+                            settings.DynamicResolutionScale = Math.Max(settings.MinDynamicResolutionScale, settings.DynamicResolutionScale - ResolutionStep);
+                            return true;
+                        }
+                        return SwitchStereo(settings, StereoMode.AlternateEye);
+
+                    case FrameBottleneck.GameCpu:
+                        return SwitchStereo(settings, StereoMode.AlternateEye);
+                }
+
+                // Our hooks or the compositor: nothing render-side would help
+                return false;
+            }
+
+            // Headroom: restore resolution first, then dual-pass once a frame would still fit at twice the work
+            if (summary.P95FrameMilliseconds < budget * 0.8 && settings.DynamicResolutionScale < 1.0f)
+            {
+                settings.DynamicResolutionScale = Math.Min(1.0f, settings.DynamicResolutionScale + ResolutionStep);
+                return true;
+            }
+
+            if (settings.StereoMode == StereoMode.AlternateEye && settings.DynamicResolutionScale >= 1.0f &&
+                summary.P95FrameMilliseconds < budget * 0.45)
+            {
+                return SwitchStereo(settings, StereoMode.DualPass);
+            }
+
+            return false;
+        }
+
+        private bool SwitchStereo(RenderSettings settings, StereoMode mode)
+        {
+            if (settings.StereoMode == mode) return false;
+
+            settings.StereoMode = mode;
+            cooldown = StereoCooldownWindows;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,134 @@
+using System;
+using System.Runtime.InteropServices;
+using System.Threading;
+
+namespace VRGameConverter.Events
+{
+    // Producer and consumer indices on their own cache lines. Outside EventQueue<T> because a struct nested in a
+    // generic type is generic itself, and those can't have explicit layout.
+    [StructLayout(LayoutKind.Explicit, Size = 192)]
+    internal struct EventQueueIndices
+    {
+        [FieldOffset(64)] public long Head;    // Next to read; consumer only
+        [FieldOffset(128)] public long Tail;   // Next to write; producer only
+    }
+
+    /// <summary>
+    /// One consumer's queue of one event type. Single producer (the thread that publishes the type, normally the
+    /// game thread in a hook) and single consumer (the subsystem that subscribed). A full queue drops the newest
+    /// event rather than block the game.
+    /// </summary>
+    public sealed class EventQueue<T> where T : struct
+    {
+        private readonly T[] events;
+        private readonly long mask;
+        private EventQueueIndices indices;
+
+        public long Dropped { get; private set; }
+
+        public EventQueue(int capacity)
+        {
+            if (capacity <= 0 || (capacity & (capacity - 1)) != 0)
+            {
+                throw new ArgumentException("Queue capacity must be a power of two", nameof(capacity));
+            }
+
+            events = new T[capacity];
+            mask = capacity - 1;
+        }
+
+        internal void Enqueue(in T item)
+        {
+            long tail = indices.Tail;
+            if (tail - Volatile.Read(ref indices.Head) >= events.Length)
+            {
+                Dropped++;
+                return;
+            }
+
+            events[tail & mask] = item;
+            Volatile.Write(ref indices.Tail, tail + 1);
+        }
+
+        /// <summary>
+        /// Consumer side: next event in publish order, or false when there is none
+        /// </summary>
+        public bool TryDequeue(out T item)
+        {
+            long head = indices.Head;
+            if (head == Volatile.Read(ref indices.Tail))
+            {
+                item = default;
+                return false;
+            }
+
+            item = events[head & mask];
+            Volatile.Write(ref indices.Head, head + 1);
+            return true;
+        }
+    }
+
+    /// <summary>
+    /// Lets subsystems react to each other's hooks without calling into each other. Each event type is a plain
+    /// struct; every subscriber gets its own queue, so publishing is a copy per subscriber with no locks and no
+    /// allocation, and each subsystem drains its queues whenever it next updates.
+    /// Subscribe during setup and unsubscribe on teardown; publish from one thread per event type.
+    /// </summary>
+    public static class EventBus
+    {
+        public const int DefaultQueueCapacity = 64;
+
+        private static class Channel<T> where T : struct
+        {
+            // Replaced wholesale on subscribe, so publishers never see a half-updated list
+            public static EventQueue<T>[] Subscribers = Array.Empty<EventQueue<T>>();
+            public static readonly object SubscribeLock = new object();
+        }
+
+        public static EventQueue<T> Subscribe<T>(int capacity = DefaultQueueCapacity) where T : struct
+        {
+            var queue = new EventQueue<T>(capacity);
+
+            // Setup only, never on the publish path
+            lock (Channel<T>.SubscribeLock)
+            {
+                var current = Channel<T>.Subscribers;
+                var updated = new EventQueue<T>[current.Length + 1];
+                Array.Copy(current, updated, current.Length);
+                updated[current.Length] = queue;
+                Volatile.Write(ref Channel<T>.Subscribers, updated);
+            }
+
+            return queue;
+        }
+
+        /// <summary>
+        /// Stop delivering to a queue from Subscribe. A publish already under way may still add to it.
+        /// </summary>
+        public static void Unsubscribe<T>(EventQueue<T> queue) where T : struct
+        {
+            if (queue == null) return;
+
+            lock (Channel<T>.SubscribeLock)
+            {
+                var current = Channel<T>.Subscribers;
+                int index = Array.IndexOf(current, queue);
+                if (index < 0) return;
+
+                var updated = new EventQueue<T>[current.Length - 1];
+                Array.Copy(current, 0, updated, 0, index);
+                Array.Copy(current, index + 1, updated, index, current.Length - index - 1);
+                Volatile.Write(ref Channel<T>.Subscribers, updated);
+            }
+        }
+
+        public static void Publish<T>(in T item) where T : struct
+        {
+            var subscribers = Volatile.Read(ref Channel<T>.Subscribers);
+            for (int i = 0; i < subscribers.Length; i++)
+            {
+                subscribers[i].Enqueue(item);
+            }
+        }
+    }
+}
@@ -0,0 +1,40 @@
+using System;
+using System.Numerics;
+
+namespace VRGameConverter.Events
+{
+    /// <summary>
+    /// The player's character got into a vehicle
+    /// </summary>
+    public struct VehicleEnteredEvent
+    {
+        public long Timestamp;
+        public IntPtr Character;
+        public IntPtr Vehicle;
+        public int Seat;
+        public int VehicleType;     // VehicleType value
+        public bool HasAnchor;
+        public Vector3 SeatOffset;  // Eye point relative to the vehicle root, when HasAnchor
+        public Quaternion SeatRotation;
+    }
+
+    /// <summary>
+    /// The player's character left its vehicle
+    /// </summary>
+    public struct VehicleExitedEvent
+    {
+        public long Timestamp;
+        public IntPtr Character;
+        public IntPtr Vehicle;
+    }
+
+    /// <summary>
+    /// The game or the player switched between first and third person
+    /// </summary>
+    public struct CameraModeChangedEvent
+    {
+        public long Timestamp;
+        public bool FirstPerson;
+        public int GameMode;        // Game-specific mode value, -1 when toggled from our side
+    }
+}
@@ -0,0 +1,92 @@
+using System;
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+
+namespace VRGameConverter.Hooking
+{
+    /// <summary>
+    /// Measures what a hook costs on every call: relay jump, managed transition and the trampoline back
+    /// </summary>
+    public static class HookBenchmark
+    {
+        [UnmanagedFunctionPointer(CallingConvention.Winapi)]
+        private delegate long ProbeFunction(long value);
+
+        // mov rax, rcx; add rax, 1; ret; int3 padding
+        private static readonly byte[] ProbeCode =
+        {
+            0x48, 0x89, 0xC8, 0x48, 0x83, 0xC0, 0x01, 0xC3,
+            0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC
+        };
+
+        /// <summary>
+        /// Hook a generated probe function with a pass-through hook and report the added cost per call
+        /// </summary>
+        public static double MeasureCallOverheadNanoseconds(HookEngine engine, int iterations = 100000)
+        {
+            IntPtr probe = VirtualAlloc(IntPtr.Zero, (UIntPtr)4096, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+            if (probe == IntPtr.Zero)
+            {
+                throw new OutOfMemoryException("Unable to allocate hook benchmark probe");
+            }
+
+            try
+            {
+                // Leave zeroed bytes in front so the engine's padding probe stays inside the page
+                IntPtr entry = probe + 16;
+                Marshal.Copy(ProbeCode, 0, entry, ProbeCode.Length);
+                var direct = Marshal.GetDelegateForFunctionPointer<ProbeFunction>(entry);
+
+                double baseline = TimeCalls(direct, iterations);
+
+                ProbeFunction original = null;
+                ProbeFunction passThrough = value => original(value);
+                engine.InstallHook(entry, passThrough, HookInstallMode.HotPatch, trampoline => original = trampoline);
+
+                double hooked = TimeCalls(direct, iterations);
+                engine.UninstallHook(entry);
+
+                GC.KeepAlive(passThrough);
+                return Math.Max(0, hooked - baseline);
+            }
+            finally
+            {
+                VirtualFree(probe, UIntPtr.Zero, MEM_RELEASE);
+            }
+        }
+
+        /// <summary>
+        /// Log install timings and per-call overhead for the current session
+        /// </summary>
+        public static void Report(HookEngine engine)
+        {
+            Console.WriteLine($"Hook engine: {engine.GetStatistics()}");
+            Console.WriteLine($"Hook engine: {MeasureCallOverheadNanoseconds(engine):F1} ns added per hooked call");
+        }
+
+        private static double TimeCalls(ProbeFunction function, int iterations)
+        {
+            // Warm the call path before timing
+            long sink = 0;
+            for (int i = 0; i < 1000; i++) sink += function(i);
+
+            long start = Stopwatch.GetTimestamp();
+            for (int i = 0; i < iterations; i++) sink += function(i);
+            long elapsed = Stopwatch.GetTimestamp() - start;
+
+            GC.KeepAlive(sink);
+            return elapsed * 1e9 / Stopwatch.Frequency / iterations;
+        }
+
+        private const uint MEM_COMMIT = 0x1000;
+        private const uint MEM_RESERVE = 0x2000;
+        private const uint MEM_RELEASE = 0x8000;
+        private const uint PAGE_EXECUTE_READWRITE = 0x40;
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern IntPtr VirtualAlloc(IntPtr lpAddress, UIntPtr dwSize, uint flAllocationType, uint flProtect);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool VirtualFree(IntPtr lpAddress, UIntPtr dwSize, uint dwFreeType);
+    }
+}
@@ -0,0 +1,701 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using System.Threading;
+
+namespace VRGameConverter.Hooking
+{
+    /// <summary>
+    /// How a hook is written into the target prologue
+    /// </summary>
+    public enum HookInstallMode
+    {
+        SuspendAllThreads,  // Freeze every other thread while the prologue is rewritten
+        HotPatch            // Atomic aligned write when no thread can be mid-instruction inside the patched bytes
+    }
+
+    /// <summary>
+    /// Install/uninstall counters reported by the hook engine
+    /// </summary>
+    public struct HookStatistics
+    {
+        public int InstalledHooks;
+        public long InstallCount;
+        public long UninstallCount;
+        public double AverageInstallMicroseconds;
+        public double MaxInstallMicroseconds;
+        public long ThreadsRedirected;
+        public long SuspendFallbacks;
+
+        public override string ToString()
+        {
+            return $"{InstalledHooks} active, {InstallCount} installs (avg {AverageInstallMicroseconds:F1} us, max {MaxInstallMicroseconds:F1} us), " +
+                   $"{UninstallCount} uninstalls, {ThreadsRedirected} threads redirected, {SuspendFallbacks} suspend fallbacks";
+        }
+    }
+
+    /// <summary>
+    /// Inline hook engine shared by all subsystems.
+    /// Hot-patch installs never stop the game when the jump only replaces whole instructions that no thread
+    /// can be halfway through: either the compiler's hot-patch padding or a first instruction of at least 5 bytes.
+    /// Any other prologue is rewritten with every other thread suspended.
+    /// </summary>
+    public class HookEngine
+    {
+        public static HookEngine Shared { get; } = new HookEngine();
+
+        public HookInstallMode DefaultMode { get; set; } = HookInstallMode.HotPatch;
+
+        private const int JumpRel32Size = 5;
+        private const int AbsoluteJumpSize = 14;
+        private const int HotPatchPaddingSize = 5;
+        private const int CodePageSize = 0x10000;
+        private const long MaxRel32Distance = 0x7FFF0000;
+
+        private readonly Dictionary<IntPtr, HookRecord> hooks = new Dictionary<IntPtr, HookRecord>();
+        private readonly List<CodePage> codePages = new List<CodePage>();
+        private readonly object installLock = new object();
+
+        // Benchmark counters, updated under installLock
+        private long installCount;
+        private long uninstallCount;
+        private long totalInstallTicks;
+        private long maxInstallTicks;
+        private long threadsRedirected;
+        private long suspendFallbacks;
+
+        private class HookRecord
+        {
+            public IntPtr Target;
+            public Delegate HookDelegate;     // Keeps the marshalled thunk alive
+            public IntPtr Relay;
+            public IntPtr Trampoline;
+            public IntPtr PatchAddress;
+            public byte[] OriginalBytes;
+            public byte[] PatchBytes;         // What the install wrote, checked before restoring
+            public RelocatedPrologue Prologue;
+            public HookInstallMode Mode;
+        }
+
+        private class CodePage
+        {
+            public IntPtr Base;
+            public int Used;
+        }
+
+        /// <summary>
+        /// Install a hook using the default mode. Returns the trampoline that calls the original function.
+        /// </summary>
+        public IntPtr InstallHook(IntPtr targetFunction, Delegate hookFunction)
+        {
+            return InstallHook(targetFunction, hookFunction, DefaultMode);
+        }
+
+        public IntPtr InstallHook(IntPtr targetFunction, Delegate hookFunction, HookInstallMode mode)
+        {
+            return Install(targetFunction, hookFunction, mode, null);
+        }
+
+        /// <summary>
+        /// Install a hook whose body calls the original function. setOriginal receives the original before the
+        /// patch goes in: a game thread can enter the hook the moment it is written, so the delegate the hook
+        /// calls through has to be in place first.
+        /// </summary>
+        public IntPtr InstallHook<T>(IntPtr targetFunction, T hookFunction, Action<T> setOriginal) where T : Delegate
+        {
+            return InstallHook(targetFunction, hookFunction, DefaultMode, setOriginal);
+        }
+
+        public IntPtr InstallHook<T>(IntPtr targetFunction, T hookFunction, HookInstallMode mode, Action<T> setOriginal) where T : Delegate
+        {
+            return Install(targetFunction, hookFunction, mode,
+                trampoline => setOriginal(Marshal.GetDelegateForFunctionPointer<T>(trampoline)));
+        }
+
+        private IntPtr Install(IntPtr targetFunction, Delegate hookFunction, HookInstallMode mode, Action<IntPtr> beforePatch)
+        {
+            if (targetFunction == IntPtr.Zero)
+            {
+                Console.WriteLine($"Skipping hook {hookFunction.Method.Name}: target was not resolved");
+                return IntPtr.Zero;
+            }
+
+            lock (installLock)
+            {
+                if (hooks.TryGetValue(targetFunction, out var existing))
+                {
+                    beforePatch?.Invoke(existing.Trampoline);
+                    return existing.Trampoline;
+                }
+
+                Console.WriteLine($"Installing hook at {targetFunction} with function {hookFunction.Method.Name} ({mode})");
+                long started = Stopwatch.GetTimestamp();
+
+                var record = new HookRecord
+                {
+                    Target = targetFunction,
+                    HookDelegate = hookFunction,
+                    Mode = mode
+                };
+
+                IntPtr hookPointer = Marshal.GetFunctionPointerForDelegate(hookFunction);
+
+                // Use the compiler's hot-patch padding when present: the 2-byte entry jump never
+                // splits an instruction, so no thread can be caught mid-patch
+                bool usePadding = mode == HookInstallMode.HotPatch && HasHotPatchPadding(targetFunction);
+                int minimumStolen = usePadding ? 2 : JumpRel32Size;
+
+                byte[] prologue = ReadBytes(targetFunction, 32);
+
+                record.Relay = AllocateCode(targetFunction, AbsoluteJumpSize);
+                WriteAbsoluteJump(record.Relay, hookPointer);
+
+                record.Trampoline = AllocateCode(targetFunction, TrampolineBuilder.MaxSize(prologue, minimumStolen));
+                record.Prologue = TrampolineBuilder.Build(prologue, minimumStolen, targetFunction.ToInt64(), record.Trampoline.ToInt64());
+                WriteBytes(record.Trampoline, record.Prologue.Code, record.Prologue.Code.Length);
+
+                // The patch below publishes the hook; its interlocked or suspended write orders this store before it
+                beforePatch?.Invoke(record.Trampoline);
+
+                if (usePadding)
+                {
+                    InstallViaPadding(record);
+                }
+                else if (mode == HookInstallMode.HotPatch && CanPatchWithoutSuspension(targetFunction, prologue))
+                {
+                    InstallViaCompareExchange(record);
+                }
+                else
+                {
+                    if (mode == HookInstallMode.HotPatch)
+                    {
+                        Console.WriteLine($"Hook at {targetFunction} splits an instruction or an 8-byte boundary, falling back to thread suspension");
+                        record.Mode = HookInstallMode.SuspendAllThreads;
+                        suspendFallbacks++;
+                    }
+                    InstallWithSuspendedThreads(record);
+                }
+
+                hooks[targetFunction] = record;
+
+                long elapsed = Stopwatch.GetTimestamp() - started;
+                installCount++;
+                totalInstallTicks += elapsed;
+                maxInstallTicks = Math.Max(maxInstallTicks, elapsed);
+
+                return record.Trampoline;
+            }
+        }
+
+        /// <summary>
+        /// Restore the original prologue. The trampoline is intentionally leaked since a thread may still be inside it.
+        /// </summary>
+        public void UninstallHook(IntPtr targetFunction)
+        {
+            lock (installLock)
+            {
+                if (!hooks.TryGetValue(targetFunction, out var record)) return;
+
+                if (record.Mode == HookInstallMode.HotPatch)
+                {
+                    // Padding bytes are dead code, so only the entry needs to be restored atomically
+                    if (!AtomicWrite(record.PatchAddress, record.PatchBytes, record.OriginalBytes))
+                    {
+                        throw new InvalidOperationException($"Prologue at {targetFunction} was modified by someone else");
+                    }
+                }
+                else
+                {
+                    if (!BytesMatch(ReadBytes(record.PatchAddress, record.PatchBytes.Length), record.PatchBytes))
+                    {
+                        throw new InvalidOperationException($"Prologue at {targetFunction} was modified by someone else");
+                    }
+
+                    var suspension = new ThreadSuspension();
+                    try
+                    {
+                        suspension.SuspendAll();
+                        WriteBytes(record.PatchAddress, record.OriginalBytes, record.OriginalBytes.Length);
+                    }
+                    finally
+                    {
+                        suspension.ResumeAll();
+                    }
+                }
+
+                FlushInstructionCache(GetCurrentProcess(), record.PatchAddress, (UIntPtr)record.OriginalBytes.Length);
+                hooks.Remove(targetFunction);
+                uninstallCount++;
+            }
+        }
+
+        /// <summary>
+        /// Get a callable delegate for the original (un-hooked) function
+        /// </summary>
+        public T GetOriginal<T>(IntPtr targetFunction) where T : Delegate
+        {
+            lock (installLock)
+            {
+                if (hooks.TryGetValue(targetFunction, out var record))
+                {
+                    return Marshal.GetDelegateForFunctionPointer<T>(record.Trampoline);
+                }
+            }
+            return null;
+        }
+
+        /// <summary>
+        /// Snapshot of install/uninstall counters for benchmarking
+        /// </summary>
+        public HookStatistics GetStatistics()
+        {
+            lock (installLock)
+            {
+                return new HookStatistics
+                {
+                    InstalledHooks = hooks.Count,
+                    InstallCount = installCount,
+                    UninstallCount = uninstallCount,
+                    AverageInstallMicroseconds = installCount == 0 ? 0 : TicksToMicroseconds(totalInstallTicks) / installCount,
+                    MaxInstallMicroseconds = TicksToMicroseconds(maxInstallTicks),
+                    ThreadsRedirected = threadsRedirected,
+                    SuspendFallbacks = suspendFallbacks
+                };
+            }
+        }
+
+        private static double TicksToMicroseconds(long ticks)
+        {
+            return ticks * 1000000.0 / Stopwatch.Frequency;
+        }
+
+        private void InstallViaPadding(HookRecord record)
+        {
+            IntPtr padding = record.Target - HotPatchPaddingSize;
+
+            // The padding is never executed, so it can be written non-atomically
+            WriteBytes(padding, EncodeJumpRel32(padding, record.Relay), JumpRel32Size);
+            FlushInstructionCache(GetCurrentProcess(), padding, (UIntPtr)JumpRel32Size);
+
+            // jmp $-5 back into the padding
+            byte[] shortJump = { 0xEB, unchecked((byte)-(HotPatchPaddingSize + 2)) };
+            record.PatchAddress = record.Target;
+            record.OriginalBytes = ReadBytes(record.Target, shortJump.Length);
+            record.PatchBytes = shortJump;
+
+            if (!AtomicWrite(record.Target, record.OriginalBytes, shortJump))
+            {
+                throw new InvalidOperationException($"Prologue at {record.Target} changed during hot-patch");
+            }
+
+            FlushInstructionCache(GetCurrentProcess(), record.Target, (UIntPtr)shortJump.Length);
+        }
+
+        private void InstallViaCompareExchange(HookRecord record)
+        {
+            byte[] jump = EncodeJumpRel32(record.Target, record.Relay);
+            record.PatchAddress = record.Target;
+            record.OriginalBytes = ReadBytes(record.Target, jump.Length);
+            record.PatchBytes = jump;
+
+            // The jump replaces part of a single instruction, so every thread is either before it or past it
+            if (!AtomicWrite(record.Target, record.OriginalBytes, jump))
+            {
+                throw new InvalidOperationException($"Prologue at {record.Target} changed during hot-patch");
+            }
+            FlushInstructionCache(GetCurrentProcess(), record.Target, (UIntPtr)jump.Length);
+        }
+
+        private void InstallWithSuspendedThreads(HookRecord record)
+        {
+            byte[] jump = EncodeJumpRel32(record.Target, record.Relay);
+            record.PatchAddress = record.Target;
+            record.OriginalBytes = ReadBytes(record.Target, jump.Length);
+            record.PatchBytes = jump;
+
+            var suspension = new ThreadSuspension();
+            try
+            {
+                suspension.SuspendAll();
+                WriteBytes(record.Target, jump, jump.Length);
+                FlushInstructionCache(GetCurrentProcess(), record.Target, (UIntPtr)jump.Length);
+
+                // Redirect skips any thread outside the overwritten bytes
+                threadsRedirected += suspension.Redirect(record);
+            }
+            finally
+            {
+                suspension.ResumeAll();
+            }
+        }
+
+        /// <summary>
+        /// A lone atomic write is only safe when no thread can be resuming halfway through the patched bytes
+        /// </summary>
+        private static bool CanPatchWithoutSuspension(IntPtr target, byte[] prologue)
+        {
+            var first = InstructionDecoder.Decode(prologue, 0);
+            return first.IsValid && first.Length >= JumpRel32Size && FitsInAlignedQword(target, JumpRel32Size);
+        }
+
+        private static bool HasHotPatchPadding(IntPtr target)
+        {
+            byte[] padding = ReadBytes(target - HotPatchPaddingSize, HotPatchPaddingSize);
+            foreach (byte b in padding)
+            {
+                if (b != 0xCC && b != 0x90) return false;
+            }
+
+            // The first instruction must cover the 2-byte jump and the write must not straddle a qword
+            var first = InstructionDecoder.Decode(ReadBytes(target, 16), 0);
+            return first.IsValid && first.Length >= 2 && FitsInAlignedQword(target, 2);
+        }
+
+        private static bool FitsInAlignedQword(IntPtr address, int length)
+        {
+            return (address.ToInt64() & 7) + length <= 8;
+        }
+
+        private static bool BytesMatch(byte[] left, byte[] right)
+        {
+            return left.AsSpan().SequenceEqual(right);
+        }
+
+        /// <summary>
+        /// Atomically replace bytes inside the naturally aligned qword that contains them.
+        /// Fails without writing when the bytes currently there are not <paramref name="expectedBytes"/>.
+        /// </summary>
+        private static unsafe bool AtomicWrite(IntPtr address, byte[] expectedBytes, byte[] bytes)
+        {
+            long aligned = address.ToInt64() & ~7L;
+            int shift = (int)(address.ToInt64() - aligned);
+
+            uint oldProtect = MakeWritable((IntPtr)aligned, 8);
+            try
+            {
+                long* slot = (long*)aligned;
+                long current = Volatile.Read(ref *slot);
+                byte* existing = (byte*)&current;
+                for (int i = 0; i < expectedBytes.Length; i++)
+                {
+                    if (existing[shift + i] != expectedBytes[i]) return false;
+                }
+
+                long desired = current;
+                byte* patched = (byte*)&desired;
+                for (int i = 0; i < bytes.Length; i++)
+                {
+                    patched[shift + i] = bytes[i];
+                }
+                return Interlocked.CompareExchange(ref *slot, desired, current) == current;
+            }
+            finally
+            {
+                VirtualProtect((IntPtr)aligned, (UIntPtr)8, oldProtect, out _);
+            }
+        }
+
+        private static byte[] EncodeJumpRel32(IntPtr from, IntPtr to)
+        {
+            long displacement = to.ToInt64() - (from.ToInt64() + JumpRel32Size);
+            if (displacement > int.MaxValue || displacement < int.MinValue)
+            {
+                throw new InvalidOperationException($"Relay at {to} is out of rel32 range of {from}");
+            }
+
+            var jump = new byte[JumpRel32Size];
+            jump[0] = 0xE9;
+            BitConverter.GetBytes((int)displacement).CopyTo(jump, 1);
+            return jump;
+        }
+
+        private static void WriteAbsoluteJump(IntPtr at, IntPtr destination)
+        {
+            // jmp qword ptr [rip+0] followed by the 64-bit destination
+            var jump = new byte[AbsoluteJumpSize];
+            jump[0] = 0xFF;
+            jump[1] = 0x25;
+            BitConverter.GetBytes(destination.ToInt64()).CopyTo(jump, 6);
+            WriteBytes(at, jump, jump.Length);
+        }
+
+        /// <summary>
+        /// Bump-allocate executable memory within rel32 reach of the target
+        /// </summary>
+        private IntPtr AllocateCode(IntPtr nearAddress, int size)
+        {
+            int alignedSize = (size + 15) & ~15;
+
+            foreach (var page in codePages)
+            {
+                if (page.Used + alignedSize <= CodePageSize &&
+                    Math.Abs(page.Base.ToInt64() - nearAddress.ToInt64()) < MaxRel32Distance)
+                {
+                    IntPtr result = page.Base + page.Used;
+                    page.Used += alignedSize;
+                    return result;
+                }
+            }
+
+            IntPtr pageBase = AllocatePageNear(nearAddress);
+            codePages.Add(new CodePage { Base = pageBase, Used = alignedSize });
+            return pageBase;
+        }
+
+        private static IntPtr AllocatePageNear(IntPtr nearAddress)
+        {
+            long target = nearAddress.ToInt64();
+            long address = Math.Max(target - MaxRel32Distance, CodePageSize) & ~(long)(CodePageSize - 1);
+            long limit = target + MaxRel32Distance;
+
+            while (address < limit)
+            {
+                if (VirtualQuery((IntPtr)address, out var info, (UIntPtr)Marshal.SizeOf<MEMORY_BASIC_INFORMATION>()) == UIntPtr.Zero)
+                {
+                    break;
+                }
+
+                long regionEnd = info.BaseAddress.ToInt64() + (long)info.RegionSize.ToUInt64();
+                if (info.State == MEM_FREE)
+                {
+                    long candidate = (address + CodePageSize - 1) & ~(long)(CodePageSize - 1);
+                    if (candidate + CodePageSize <= regionEnd)
+                    {
+                        IntPtr page = VirtualAlloc((IntPtr)candidate, (UIntPtr)CodePageSize, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+                        if (page != IntPtr.Zero) return page;
+                    }
+                }
+
+                address = regionEnd;
+            }
+
+            throw new OutOfMemoryException($"No free memory within rel32 range of {nearAddress}");
+        }
+
+        private static byte[] ReadBytes(IntPtr address, int count)
+        {
+            var buffer = new byte[count];
+            Marshal.Copy(address, buffer, 0, count);
+            return buffer;
+        }
+
+        private static void WriteBytes(IntPtr address, byte[] bytes, int count)
+        {
+            uint oldProtect = MakeWritable(address, count);
+            Marshal.Copy(bytes, 0, address, count);
+            VirtualProtect(address, (UIntPtr)count, oldProtect, out _);
+        }
+
+        private static uint MakeWritable(IntPtr address, int count)
+        {
+            if (!VirtualProtect(address, (UIntPtr)count, PAGE_EXECUTE_READWRITE, out uint oldProtect))
+            {
+                throw new InvalidOperationException($"VirtualProtect failed at {address}: {Marshal.GetLastWin32Error()}");
+            }
+            return oldProtect;
+        }
+
+        #region Thread handling
+
+        private class SuspendedThread
+        {
+            public IntPtr Handle;
+            public long Rip;
+        }
+
+        /// <summary>
+        /// Suspends every other thread of the process. Everything is allocated before the first
+        /// SuspendThread: a suspended thread may hold the heap lock or be needed by a GC.
+        /// </summary>
+        private sealed class ThreadSuspension
+        {
+            private readonly List<int> threadIds;
+            private readonly SuspendedThread[] slots;
+            private readonly ThreadContext context = new ThreadContext();
+            private int count;
+
+            public ThreadSuspension()
+            {
+                threadIds = EnumerateOtherThreads();
+                slots = new SuspendedThread[threadIds.Count];
+                for (int i = 0; i < slots.Length; i++)
+                {
+                    slots[i] = new SuspendedThread();
+                }
+            }
+
+            public void SuspendAll()
+            {
+                for (int i = 0; i < threadIds.Count; i++)
+                {
+                    if (SuspendAndCapture(threadIds[i], context, slots[count])) count++;
+                }
+            }
+
+            /// <summary>
+            /// Move threads from the overwritten prologue to the matching offset in the trampoline
+            /// </summary>
+            public int Redirect(HookRecord record)
+            {
+                int redirected = 0;
+                for (int i = 0; i < count; i++)
+                {
+                    var thread = slots[i];
+                    long offset = thread.Rip - record.Target.ToInt64();
+                    if (offset <= 0 || offset >= record.Prologue.StolenLength) continue;
+
+                    int relocated = record.Prologue.MapOffset((int)offset);
+                    if (relocated < 0) continue;
+
+                    if (!GetThreadContext(thread.Handle, context.Pointer)) continue;
+                    context.Rip = record.Trampoline.ToInt64() + relocated;
+                    if (SetThreadContext(thread.Handle, context.Pointer)) redirected++;
+                    thread.Rip = context.Rip;
+                }
+                return redirected;
+            }
+
+            public void ResumeAll()
+            {
+                for (int i = 0; i < count; i++)
+                {
+                    ResumeThread(slots[i].Handle);
+                    CloseHandle(slots[i].Handle);
+                    slots[i].Handle = IntPtr.Zero;
+                }
+                count = 0;
+                context.Dispose();
+            }
+        }
+
+        private static List<int> EnumerateOtherThreads()
+        {
+            int currentThreadId = (int)GetCurrentThreadId();
+            var ids = new List<int>();
+            foreach (ProcessThread thread in Process.GetCurrentProcess().Threads)
+            {
+                if (thread.Id != currentThreadId) ids.Add(thread.Id);
+            }
+            return ids;
+        }
+
+        private static bool SuspendAndCapture(int threadId, ThreadContext context, SuspendedThread into)
+        {
+            IntPtr handle = OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_SET_CONTEXT, false, (uint)threadId);
+            if (handle == IntPtr.Zero) return false;
+
+            if (SuspendThread(handle) == uint.MaxValue)
+            {
+                CloseHandle(handle);
+                return false;
+            }
+
+            if (!GetThreadContext(handle, context.Pointer))
+            {
+                ResumeThread(handle);
+                CloseHandle(handle);
+                return false;
+            }
+
+            into.Handle = handle;
+            into.Rip = context.Rip;
+            return true;
+        }
+
+        /// <summary>
+        /// 16-byte aligned x64 CONTEXT buffer with control registers requested
+        /// </summary>
+        private sealed class ThreadContext : IDisposable
+        {
+            private const int ContextSize = 0x4D0;
+            private const int ContextFlagsOffset = 0x30;
+            private const int RipOffset = 0xF8;
+            private const int CONTEXT_CONTROL = 0x00100001;
+
+            private readonly IntPtr raw;
+            public IntPtr Pointer { get; }
+
+            public ThreadContext()
+            {
+                raw = Marshal.AllocHGlobal(ContextSize + 16);
+                Pointer = (IntPtr)((raw.ToInt64() + 15) & ~15L);
+                Marshal.WriteInt32(Pointer, ContextFlagsOffset, CONTEXT_CONTROL);
+            }
+
+            public long Rip
+            {
+                get => Marshal.ReadInt64(Pointer, RipOffset);
+                set => Marshal.WriteInt64(Pointer, RipOffset, value);
+            }
+
+            public void Dispose()
+            {
+                Marshal.FreeHGlobal(raw);
+            }
+        }
+
+        #endregion
+
+        #region Native methods
+
+        private const uint MEM_COMMIT = 0x1000;
+        private const uint MEM_RESERVE = 0x2000;
+        private const uint MEM_FREE = 0x10000;
+        private const uint PAGE_EXECUTE_READWRITE = 0x40;
+        private const uint THREAD_SUSPEND_RESUME = 0x0002;
+        private const uint THREAD_GET_CONTEXT = 0x0008;
+        private const uint THREAD_SET_CONTEXT = 0x0010;
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct MEMORY_BASIC_INFORMATION
+        {
+            public IntPtr BaseAddress;
+            public IntPtr AllocationBase;
+            public uint AllocationProtect;
+            public ushort PartitionId;
+            public UIntPtr RegionSize;
+            public uint State;
+            public uint Protect;
+            public uint Type;
+        }
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool VirtualProtect(IntPtr lpAddress, UIntPtr dwSize, uint flNewProtect, out uint lpflOldProtect);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern IntPtr VirtualAlloc(IntPtr lpAddress, UIntPtr dwSize, uint flAllocationType, uint flProtect);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern UIntPtr VirtualQuery(IntPtr lpAddress, out MEMORY_BASIC_INFORMATION lpBuffer, UIntPtr dwLength);
+
+        [DllImport("kernel32.dll")]
+        private static extern bool FlushInstructionCache(IntPtr hProcess, IntPtr lpBaseAddress, UIntPtr dwSize);
+
+        [DllImport("kernel32.dll")]
+        private static extern IntPtr GetCurrentProcess();
+
+        [DllImport("kernel32.dll")]
+        private static extern uint GetCurrentThreadId();
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern IntPtr OpenThread(uint dwDesiredAccess, bool bInheritHandle, uint dwThreadId);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern uint SuspendThread(IntPtr hThread);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern uint ResumeThread(IntPtr hThread);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool GetThreadContext(IntPtr hThread, IntPtr lpContext);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool SetThreadContext(IntPtr hThread, IntPtr lpContext);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool CloseHandle(IntPtr hObject);
+
+        #endregion
+    }
+}
@@ -0,0 +1,342 @@
+using System;
+
+namespace VRGameConverter.Hooking
+{
+    /// <summary>
+    /// Kind of control transfer encoded by a decoded instruction
+    /// </summary>
+    public enum BranchKind
+    {
+        None,
+        JumpRel8,          // EB cb
+        ConditionalRel8,   // 70-7F cb
+        LoopRel8,          // E0-E3 cb (loop/jrcxz)
+        JumpRel32,         // E9 cd
+        CallRel32,         // E8 cd
+        ConditionalRel32,  // 0F 80-8F cd
+        Return             // C3 / C2 iw
+    }
+
+    /// <summary>
+    /// Result of decoding a single x64 instruction
+    /// </summary>
+    public struct DecodedInstruction
+    {
+        public int Length;
+        public int OpcodeOffset;
+        public byte Opcode;
+        public bool IsRipRelative;
+        public int DisplacementOffset;
+        public BranchKind Branch;
+        public int BranchOffsetPosition;
+
+        public bool IsValid => Length > 0;
+        public bool IsRelative => IsRipRelative || Branch != BranchKind.None && Branch != BranchKind.Return;
+    }
+
+    /// <summary>
+    /// Minimal x64 length decoder used to find instruction boundaries in function prologues.
+    /// It only needs to understand what compilers emit at function entry, not the full ISA.
+    /// </summary>
+    public static class InstructionDecoder
+    {
+        public static DecodedInstruction Decode(byte[] code, int offset)
+        {
+            var result = new DecodedInstruction();
+            int pos = offset;
+            bool operandSize16 = false;
+            bool rexW = false;
+
+            // Legacy prefixes
+            while (pos < code.Length && IsLegacyPrefix(code[pos]))
+            {
+                if (code[pos] == 0x66) operandSize16 = true;
+                pos++;
+            }
+
+            // REX prefix must immediately precede the opcode
+            if (pos < code.Length && (code[pos] & 0xF0) == 0x40)
+            {
+                rexW = (code[pos] & 0x08) != 0;
+                pos++;
+            }
+
+            if (pos >= code.Length) return result;
+
+            result.OpcodeOffset = pos - offset;
+            byte op = code[pos++];
+            result.Opcode = op;
+
+            int immediate = 0;
+            bool hasModRm = false;
+
+            if (op == 0x0F)
+            {
+                if (!DecodeTwoByte(code, ref pos, ref result, offset, ref hasModRm, ref immediate)) return result;
+            }
+            else if (op == 0xC4 || op == 0xC5)
+            {
+                // VEX prefix: C5 has one payload byte, C4 has two and encodes the opcode map
+                int map = 1;
+                if (op == 0xC4)
+                {
+                    if (pos + 1 >= code.Length) return result;
+                    map = code[pos] & 0x1F;
+                    pos += 2;
+                }
+                else
+                {
+                    pos += 1;
+                }
+
+                if (pos >= code.Length) return result;
+                result.Opcode = code[pos++];
+                hasModRm = true;
+                if (map == 3) immediate = 1;
+                else if (map != 1 && map != 2) return result;
+            }
+            else
+            {
+                switch (op)
+                {
+                    // ALU r/m forms: add/or/adc/sbb/and/sub/xor/cmp
+                    case 0x00: case 0x01: case 0x02: case 0x03:
+                    case 0x08: case 0x09: case 0x0A: case 0x0B:
+                    case 0x10: case 0x11: case 0x12: case 0x13:
+                    case 0x18: case 0x19: case 0x1A: case 0x1B:
+                    case 0x20: case 0x21: case 0x22: case 0x23:
+                    case 0x28: case 0x29: case 0x2A: case 0x2B:
+                    case 0x30: case 0x31: case 0x32: case 0x33:
+                    case 0x38: case 0x39: case 0x3A: case 0x3B:
+                    case 0x63:
+                    case 0x84: case 0x85: case 0x86: case 0x87:
+                    case 0x88: case 0x89: case 0x8A: case 0x8B:
+                    case 0x8C: case 0x8D: case 0x8E: case 0x8F:
+                    case 0xD0: case 0xD1: case 0xD2: case 0xD3:
+                    case 0xFE: case 0xFF:
+                        hasModRm = true;
+                        break;
+
+                    // ALU accumulator with imm8
+                    case 0x04: case 0x0C: case 0x14: case 0x1C:
+                    case 0x24: case 0x2C: case 0x34: case 0x3C:
+                    case 0xA8: case 0x6A: case 0xCD:
+                        immediate = 1;
+                        break;
+
+                    // ALU accumulator with imm16/32
+                    case 0x05: case 0x0D: case 0x15: case 0x1D:
+                    case 0x25: case 0x2D: case 0x35: case 0x3D:
+                    case 0xA9: case 0x68:
+                        immediate = operandSize16 ? 2 : 4;
+                        break;
+
+                    case 0x69:
+                        hasModRm = true;
+                        immediate = operandSize16 ? 2 : 4;
+                        break;
+
+                    case 0x6B: case 0x80: case 0x83: case 0xC0: case 0xC1: case 0xC6:
+                        hasModRm = true;
+                        immediate = 1;
+                        break;
+
+                    case 0x81: case 0xC7:
+                        hasModRm = true;
+                        immediate = operandSize16 ? 2 : 4;
+                        break;
+
+                    case 0xF6: case 0xF7:
+                        hasModRm = true;
+                        // test r/m, imm is the only form with an immediate (reg field 0 or 1)
+                        if (pos < code.Length && ((code[pos] >> 3) & 7) <= 1)
+                        {
+                            immediate = op == 0xF6 ? 1 : (operandSize16 ? 2 : 4);
+                        }
+                        break;
+
+                    // push/pop reg, nop/xchg, cbw/cwd, leave, ret, int3, hlt
+                    case 0x50: case 0x51: case 0x52: case 0x53:
+                    case 0x54: case 0x55: case 0x56: case 0x57:
+                    case 0x58: case 0x59: case 0x5A: case 0x5B:
+                    case 0x5C: case 0x5D: case 0x5E: case 0x5F:
+                    case 0x90: case 0x91: case 0x92: case 0x93:
+                    case 0x94: case 0x95: case 0x96: case 0x97:
+                    case 0x98: case 0x99: case 0x9C: case 0x9D:
+                    case 0xC9: case 0xCC: case 0xF4:
+                        break;
+
+                    case 0xC3:
+                        result.Branch = BranchKind.Return;
+                        break;
+
+                    case 0xC2:
+                        result.Branch = BranchKind.Return;
+                        immediate = 2;
+                        break;
+
+                    case 0xB0: case 0xB1: case 0xB2: case 0xB3:
+                    case 0xB4: case 0xB5: case 0xB6: case 0xB7:
+                        immediate = 1;
+                        break;
+
+                    case 0xB8: case 0xB9: case 0xBA: case 0xBB:
+                    case 0xBC: case 0xBD: case 0xBE: case 0xBF:
+                        immediate = rexW ? 8 : (operandSize16 ? 2 : 4);
+                        break;
+
+                    case 0xEB:
+                        result.Branch = BranchKind.JumpRel8;
+                        result.BranchOffsetPosition = pos - offset;
+                        immediate = 1;
+                        break;
+
+                    case 0xE0: case 0xE1: case 0xE2: case 0xE3:
+                        result.Branch = BranchKind.LoopRel8;
+                        result.BranchOffsetPosition = pos - offset;
+                        immediate = 1;
+                        break;
+
+                    case 0xE8:
+                    case 0xE9:
+                        result.Branch = op == 0xE8 ? BranchKind.CallRel32 : BranchKind.JumpRel32;
+                        result.BranchOffsetPosition = pos - offset;
+                        immediate = 4;
+                        break;
+
+                    default:
+                        if (op >= 0x70 && op <= 0x7F)
+                        {
+                            result.Branch = BranchKind.ConditionalRel8;
+                            result.BranchOffsetPosition = pos - offset;
+                            immediate = 1;
+                            break;
+                        }
+
+                        // Unknown opcode, refuse to guess
+                        return result;
+                }
+            }
+
+            if (hasModRm && !DecodeModRm(code, ref pos, ref result, offset)) return result;
+
+            pos += immediate;
+            if (pos > code.Length) return result;
+
+            result.Length = pos - offset;
+            return result;
+        }
+
+        private static bool DecodeTwoByte(byte[] code, ref int pos, ref DecodedInstruction result, int offset,
+            ref bool hasModRm, ref int immediate)
+        {
+            if (pos >= code.Length) return false;
+            byte op = code[pos++];
+            result.Opcode = op;
+
+            if (op == 0x38)
+            {
+                // Three-byte map 0F 38
+                if (pos >= code.Length) return false;
+                pos++;
+                hasModRm = true;
+                return true;
+            }
+
+            if (op == 0x3A)
+            {
+                // Three-byte map 0F 3A always carries imm8
+                if (pos >= code.Length) return false;
+                pos++;
+                hasModRm = true;
+                immediate = 1;
+                return true;
+            }
+
+            if (op >= 0x80 && op <= 0x8F)
+            {
+                result.Branch = BranchKind.ConditionalRel32;
+                result.BranchOffsetPosition = pos - offset;
+                immediate = 4;
+                return true;
+            }
+
+            if (op >= 0xC8 && op <= 0xCF) return true;  // bswap
+            if (op == 0x05 || op == 0x0B || op == 0xA2) return true;  // syscall, ud2, cpuid
+
+            if (op == 0x70 || op == 0x71 || op == 0x72 || op == 0x73 ||
+                op == 0xA4 || op == 0xAC || op == 0xBA ||
+                op == 0xC2 || op == 0xC4 || op == 0xC5 || op == 0xC6)
+            {
+                hasModRm = true;
+                immediate = 1;
+                return true;
+            }
+
+            if ((op >= 0x10 && op <= 0x1F) ||
+                (op >= 0x28 && op <= 0x2F) ||
+                (op >= 0x40 && op <= 0x6F) ||
+                (op >= 0x74 && op <= 0x7F) ||
+                (op >= 0x90 && op <= 0x9F) ||
+                op == 0xA3 || op == 0xAB || op == 0xAF ||
+                (op >= 0xB0 && op <= 0xB7) ||
+                (op >= 0xBB && op <= 0xC1) ||
+                op == 0xC7 ||
+                op >= 0xD0)
+            {
+                hasModRm = true;
+                return true;
+            }
+
+            return false;
+        }
+
+        private static bool DecodeModRm(byte[] code, ref int pos, ref DecodedInstruction result, int offset)
+        {
+            if (pos >= code.Length) return false;
+
+            byte modrm = code[pos++];
+            int mod = modrm >> 6;
+            int rm = modrm & 7;
+
+            if (mod == 3) return true;
+
+            if (rm == 4)
+            {
+                if (pos >= code.Length) return false;
+                byte sib = code[pos++];
+                if (mod == 0 && (sib & 7) == 5)
+                {
+                    pos += 4;
+                    return pos <= code.Length;
+                }
+            }
+            else if (mod == 0 && rm == 5)
+            {
+                // [rip + disp32]
+                result.IsRipRelative = true;
+                result.DisplacementOffset = pos - offset;
+                pos += 4;
+                return pos <= code.Length;
+            }
+
+            if (mod == 1) pos += 1;
+            else if (mod == 2) pos += 4;
+
+            return pos <= code.Length;
+        }
+
+        private static bool IsLegacyPrefix(byte b)
+        {
+            switch (b)
+            {
+                case 0x26: case 0x2E: case 0x36: case 0x3E:
+                case 0x64: case 0x65: case 0x66: case 0x67:
+                case 0xF0: case 0xF2: case 0xF3:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+    }
+}
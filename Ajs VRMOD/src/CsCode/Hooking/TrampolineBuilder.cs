@@ -0,0 +1,237 @@
+using System;
+using System.Collections.Generic;
+
+namespace VRGameConverter.Hooking
+{
+    /// <summary>
+    /// Relocated copy of a function's stolen prologue instructions
+    /// </summary>
+    public class RelocatedPrologue
+    {
+        public byte[] Code;
+        public int StolenLength;
+
+        // Instruction boundaries in the original prologue and where each one landed in the trampoline
+        public int[] OriginalOffsets;
+        public int[] TrampolineOffsets;
+
+        public int MapOffset(int originalOffset)
+        {
+            int index = Array.IndexOf(OriginalOffsets, originalOffset);
+            return index >= 0 ? TrampolineOffsets[index] : -1;
+        }
+    }
+
+    /// <summary>
+    /// Copies prologue instructions to a new address, fixing up anything position-dependent:
+    /// RIP-relative operands, rel32 calls/jumps and short (rel8) branches, which are widened.
+    /// </summary>
+    public static class TrampolineBuilder
+    {
+        private const int AbsoluteJumpSize = 14;
+
+        /// <summary>
+        /// Worst-case trampoline size for a prologue, used to reserve space before the final address is known
+        /// </summary>
+        public static int MaxSize(byte[] prologue, int minimumStolen)
+        {
+            int length = 0;
+            int count = 0;
+            while (length < minimumStolen)
+            {
+                var instruction = Decode(prologue, length);
+                length += instruction.Length;
+                count++;
+            }
+
+            // Every relative branch can expand to at most a short skip plus an absolute jump
+            return length + count * (AbsoluteJumpSize + 8) + AbsoluteJumpSize;
+        }
+
+        public static RelocatedPrologue Build(byte[] prologue, int minimumStolen, long originalAddress, long trampolineAddress)
+        {
+            var code = new List<byte>();
+            var originalOffsets = new List<int>();
+            var trampolineOffsets = new List<int>();
+
+            int length = 0;
+            bool endsInJump = false;
+
+            while (length < minimumStolen)
+            {
+                var instruction = Decode(prologue, length);
+                originalOffsets.Add(length);
+                trampolineOffsets.Add(code.Count);
+
+                long instructionAddress = originalAddress + length;
+                long nextAddress = instructionAddress + instruction.Length;
+                long emitAddress = trampolineAddress + code.Count;
+
+                if (instruction.IsRipRelative)
+                {
+                    long absolute = nextAddress + BitConverter.ToInt32(prologue, length + instruction.DisplacementOffset);
+                    long displacement = absolute - (emitAddress + instruction.Length);
+                    if (!FitsRel32(displacement))
+                    {
+                        throw new NotSupportedException($"RIP-relative operand at offset {length} is out of range from the trampoline");
+                    }
+
+                    var copy = new byte[instruction.Length];
+                    Array.Copy(prologue, length, copy, 0, instruction.Length);
+                    BitConverter.GetBytes((int)displacement).CopyTo(copy, instruction.DisplacementOffset);
+                    code.AddRange(copy);
+                }
+                else if (instruction.Branch != BranchKind.None && instruction.Branch != BranchKind.Return)
+                {
+                    long destination = BranchDestination(prologue, length, instruction, nextAddress);
+                    if (destination >= originalAddress && destination < originalAddress + minimumStolen)
+                    {
+                        throw new NotSupportedException($"Branch at offset {length} jumps back into the stolen prologue");
+                    }
+
+                    EmitBranch(code, instruction, instruction.Opcode, destination, trampolineAddress);
+                    endsInJump = instruction.Branch == BranchKind.JumpRel8 || instruction.Branch == BranchKind.JumpRel32;
+                }
+                else
+                {
+                    for (int i = 0; i < instruction.Length; i++)
+                    {
+                        code.Add(prologue[length + i]);
+                    }
+                }
+
+                length += instruction.Length;
+
+                // Anything after an unconditional jump or return is not part of this path, but the patch
+                // will still cover it, so it must be inter-function padding rather than another function
+                if (endsInJump || instruction.Branch == BranchKind.Return)
+                {
+                    for (int i = length; i < minimumStolen; i++)
+                    {
+                        if (prologue[i] != 0xCC && prologue[i] != 0x90)
+                        {
+                            throw new NotSupportedException($"Function ends at offset {length}, too short to hook");
+                        }
+                    }
+                    endsInJump = true;
+                    break;
+                }
+            }
+
+            if (!endsInJump)
+            {
+                EmitAbsoluteJump(code, originalAddress + length);
+            }
+
+            return new RelocatedPrologue
+            {
+                Code = code.ToArray(),
+                StolenLength = length,
+                OriginalOffsets = originalOffsets.ToArray(),
+                TrampolineOffsets = trampolineOffsets.ToArray()
+            };
+        }
+
+        private static DecodedInstruction Decode(byte[] prologue, int offset)
+        {
+            var instruction = InstructionDecoder.Decode(prologue, offset);
+            if (!instruction.IsValid)
+            {
+                throw new NotSupportedException($"Unable to decode prologue byte 0x{prologue[offset]:X2} at offset {offset}");
+            }
+            if (instruction.Branch == BranchKind.LoopRel8)
+            {
+                throw new NotSupportedException($"loop/jrcxz at offset {offset} cannot be relocated");
+            }
+            return instruction;
+        }
+
+        private static long BranchDestination(byte[] prologue, int offset, DecodedInstruction instruction, long nextAddress)
+        {
+            int position = offset + instruction.BranchOffsetPosition;
+            switch (instruction.Branch)
+            {
+                case BranchKind.JumpRel8:
+                case BranchKind.ConditionalRel8:
+                    return nextAddress + (sbyte)prologue[position];
+                default:
+                    return nextAddress + BitConverter.ToInt32(prologue, position);
+            }
+        }
+
+        private static void EmitBranch(List<byte> code, DecodedInstruction instruction, byte opcode, long destination, long trampolineAddress)
+        {
+            long emitAddress = trampolineAddress + code.Count;
+
+            switch (instruction.Branch)
+            {
+                case BranchKind.CallRel32:
+                    {
+                        long displacement = destination - (emitAddress + 5);
+                        if (FitsRel32(displacement))
+                        {
+                            code.Add(0xE8);
+                            code.AddRange(BitConverter.GetBytes((int)displacement));
+                        }
+                        else
+                        {
+                            // call [rip+2]; jmp +8; dq destination
+                            code.AddRange(new byte[] { 0xFF, 0x15, 0x02, 0x00, 0x00, 0x00, 0xEB, 0x08 });
+                            code.AddRange(BitConverter.GetBytes(destination));
+                        }
+                        break;
+                    }
+
+                case BranchKind.JumpRel8:
+                case BranchKind.JumpRel32:
+                    {
+                        long displacement = destination - (emitAddress + 5);
+                        if (FitsRel32(displacement))
+                        {
+                            code.Add(0xE9);
+                            code.AddRange(BitConverter.GetBytes((int)displacement));
+                        }
+                        else
+                        {
+                            EmitAbsoluteJump(code, destination);
+                        }
+                        break;
+                    }
+
+                case BranchKind.ConditionalRel8:
+                case BranchKind.ConditionalRel32:
+                    {
+                        // Condition code lives in the low nibble for both 7x and 0F 8x encodings
+                        int condition = opcode & 0x0F;
+                        long displacement = destination - (emitAddress + 6);
+                        if (FitsRel32(displacement))
+                        {
+                            code.Add(0x0F);
+                            code.Add((byte)(0x80 | condition));
+                            code.AddRange(BitConverter.GetBytes((int)displacement));
+                        }
+                        else
+                        {
+                            // Inverted short jcc over an absolute jump
+                            code.Add((byte)(0x70 | (condition ^ 1)));
+                            code.Add(AbsoluteJumpSize);
+                            EmitAbsoluteJump(code, destination);
+                        }
+                        break;
+                    }
+            }
+        }
+
+        private static void EmitAbsoluteJump(List<byte> code, long destination)
+        {
+            // jmp qword ptr [rip+0]
+            code.AddRange(new byte[] { 0xFF, 0x25, 0x00, 0x00, 0x00, 0x00 });
+            code.AddRange(BitConverter.GetBytes(destination));
+        }
+
+        private static bool FitsRel32(long displacement)
+        {
+            return displacement >= int.MinValue && displacement <= int.MaxValue;
+        }
+    }
+}
@@ -0,0 +1,194 @@
+using System;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Threading;
+
+namespace VRGameConverter.Ipc
+{
+    /// <summary>
+    /// Latest-frame hand-off between processes: three slots of 32-bit pixels in a /dev/shm file, exchanged the
+    /// way SpaceWarpPipeline hands frames between threads, so the writer never waits for the reader and the
+    /// reader always gets the newest complete frame. The size is fixed for the life of the file; the writer
+    /// makes a new one when it changes and marks the old one retired, which tells the reader to open again.
+    /// </summary>
+    public sealed unsafe class SharedFrameBuffer : IDisposable
+    {
+        private const int Magic = 0x46444D56; // "VMDF"
+        private const int Version = 1;
+        private const int HeaderSize = 256;
+        private const int FreshBit = 4;
+
+        // The exchanged slot and the reader's own slot sit on cache lines of their own. The reader keeps its
+        // slot in the file so a reader that reopens picks up where the last one left off.
+        private const int MagicOffset = 0;
+        private const int VersionOffset = 4;
+        private const int WidthOffset = 8;
+        private const int HeightOffset = 12;
+        private const int FormatOffset = 16;
+        private const int RetiredOffset = 20;
+        private const int PendingOffset = 64;
+        private const int ReadOffset = 128;
+        private const int TimestampsOffset = 192;
+
+        private readonly MemoryMappedFile mappedFile;
+        private readonly MemoryMappedViewAccessor view;
+        private readonly string backingFile;
+        private readonly bool writer;
+        private byte* basePointer;
+        private int writeSlot = 0;
+
+        public int Width { get; }
+        public int Height { get; }
+
+        // Pixel format tag chosen by the writer (a VkFormat for the Vulkan layer)
+        public int Format { get; }
+
+        public static long RequiredSize(int width, int height)
+        {
+            return HeaderSize + 3L * width * height * sizeof(uint);
+        }
+
+        /// <summary>
+        /// Writer side: a new file for frames of this size, replacing any left by an earlier writer
+        /// </summary>
+        public static SharedFrameBuffer Create(string name, int width, int height, int format)
+        {
+            return new SharedFrameBuffer(SharedMemoryChannel.SharedMemoryPath(name), width, height, format);
+        }
+
+        /// <summary>
+        /// Reader side. Throws FileNotFoundException until a writer has created the file.
+        /// </summary>
+        public static SharedFrameBuffer Open(string name)
+        {
+            return new SharedFrameBuffer(SharedMemoryChannel.SharedMemoryPath(name));
+        }
+
+        private SharedFrameBuffer(string path, int width, int height, int format)
+        {
+            writer = true;
+            backingFile = path;
+            Width = width;
+            Height = height;
+            Format = format;
+
+            // A reader still holding the previous file keeps that copy until it sees it retired
+            File.Delete(backingFile);
+            long size = RequiredSize(width, height);
+            mappedFile = MemoryMappedFile.CreateFromFile(backingFile, FileMode.CreateNew, null, size, MemoryMappedFileAccess.ReadWrite);
+            view = mappedFile.CreateViewAccessor(0, size, MemoryMappedFileAccess.ReadWrite);
+            Attach();
+
+            *(int*)(basePointer + WidthOffset) = width;
+            *(int*)(basePointer + HeightOffset) = height;
+            *(int*)(basePointer + FormatOffset) = format;
+            *(int*)(basePointer + RetiredOffset) = 0;
+            *(int*)(basePointer + PendingOffset) = 1;
+            *(int*)(basePointer + ReadOffset) = 2;
+            *(int*)(basePointer + VersionOffset) = Version;
+
+            // Stamp the header last so a reader never sees a half-initialized file
+            Volatile.Write(ref *(int*)(basePointer + MagicOffset), Magic);
+        }
+
+        private SharedFrameBuffer(string path)
+        {
+            mappedFile = MemoryMappedFile.CreateFromFile(path, FileMode.Open, null, 0, MemoryMappedFileAccess.ReadWrite);
+            view = mappedFile.CreateViewAccessor(0, 0, MemoryMappedFileAccess.ReadWrite);
+            Attach();
+
+            if (view.Capacity < HeaderSize ||
+                Volatile.Read(ref *(int*)(basePointer + MagicOffset)) != Magic ||
+                *(int*)(basePointer + VersionOffset) != Version)
+            {
+                Dispose();
+                throw new InvalidOperationException($"No compatible frame buffer at {path}");
+            }
+
+            Width = *(int*)(basePointer + WidthOffset);
+            Height = *(int*)(basePointer + HeightOffset);
+            Format = *(int*)(basePointer + FormatOffset);
+            if (view.Capacity < RequiredSize(Width, Height))
+            {
+                Dispose();
+                throw new InvalidOperationException($"Frame buffer at {path} is truncated");
+            }
+        }
+
+        private void Attach()
+        {
+            view.SafeMemoryMappedViewHandle.AcquirePointer(ref basePointer);
+            basePointer += view.PointerOffset;
+        }
+
+        private ref int Pending => ref *(int*)(basePointer + PendingOffset);
+        private ref int ReadSlot => ref *(int*)(basePointer + ReadOffset);
+
+        private uint* Slot(int index) => (uint*)(basePointer + HeaderSize) + (long)index * Width * Height;
+
+        #region Writer side
+
+        /// <summary>
+        /// Where the next frame goes; handed to the reader by Publish
+        /// </summary>
+        public Span<uint> WritePixels => new Span<uint>(Slot(writeSlot), Width * Height);
+
+        public void Publish(long timestamp)
+        {
+            ((long*)(basePointer + TimestampsOffset))[writeSlot] = timestamp;
+            writeSlot = Interlocked.Exchange(ref Pending, writeSlot | FreshBit) & ~FreshBit;
+        }
+
+        #endregion
+
+        #region Reader side
+
+        /// <summary>
+        /// Swap in the newest published frame. False when nothing new has arrived since the last call; the
+        /// previous frame stays readable.
+        /// </summary>
+        public bool TryTakeLatest()
+        {
+            if ((Volatile.Read(ref Pending) & FreshBit) == 0) return false;
+            ReadSlot = Interlocked.Exchange(ref Pending, ReadSlot) & ~FreshBit;
+            return true;
+        }
+
+        public ReadOnlySpan<uint> ReadPixels => new ReadOnlySpan<uint>(Slot(ReadSlot), Width * Height);
+
+        public long ReadTimestamp => ((long*)(basePointer + TimestampsOffset))[ReadSlot];
+
+        // Set once the writer has moved on to a new file (or gone); nothing more will be published here
+        public bool Retired => Volatile.Read(ref *(int*)(basePointer + RetiredOffset)) != 0;
+
+        #endregion
+
+        public void Dispose()
+        {
+            if (basePointer != null)
+            {
+                if (writer)
+                {
+                    Volatile.Write(ref *(int*)(basePointer + RetiredOffset), 1);
+                }
+                view.SafeMemoryMappedViewHandle.ReleasePointer();
+                basePointer = null;
+            }
+
+            view?.Dispose();
+            mappedFile?.Dispose();
+
+            if (writer)
+            {
+                try
+                {
+                    File.Delete(backingFile);
+                }
+                catch (IOException)
+                {
+                    // The reader may still have it open; the file is reclaimed when both sides unmap
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,254 @@
+using System;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace VRGameConverter.Ipc
+{
+    /// <summary>
+    /// Commands the manager app can send to the injected module
+    /// </summary>
+    public enum IpcCommand
+    {
+        None,
+        TogglePerspective,
+        Recalibrate,
+        ReloadBindings,
+        RunBenchmark
+    }
+
+    /// <summary>
+    /// Metric identifiers carried in telemetry samples
+    /// </summary>
+    public enum TelemetryMetric
+    {
+        FrameTimeMs,
+        HookTimeMs,
+        LatchErrorDegrees,
+        GameCpuMs,
+        GpuWaitMs,
+        CompositorMs,
+        P95FrameTimeMs,
+        MissedFrames,
+        Bottleneck,      // FrameBottleneck value
+        TriggerLeadMs,
+        TriggerFalsePositives,
+
+        // Vulkan layer -> game (PresentLayerBridge). Timestamps are in TimeSpan ticks, since the layer's
+        // Stopwatch is not the game's under Wine.
+        LayerHookMs,       // Layer and capture time before the driver's present, stamped at its start
+        LayerPresentMs     // Time inside the driver's present, stamped at its end
+    }
+
+    [StructLayout(LayoutKind.Sequential, Pack = 4)]
+    public struct TelemetrySample
+    {
+        public long Timestamp;
+        public TelemetryMetric Metric;
+        public float Value;
+    }
+
+    /// <summary>
+    /// Which end of the channel this process is
+    /// </summary>
+    public enum ChannelSide
+    {
+        Game,     // Injected module, creates the mapping
+        Manager   // Launcher / GameProcessManager
+    }
+
+    /// <summary>
+    /// Shared-memory transport between the injected module and the manager app.
+    /// Three SPSC rings: telemetry and logs flow game -> manager, commands flow manager -> game.
+    /// After setup everything is plain memory access, so the hot path makes no syscalls and never waits.
+    /// </summary>
+    public unsafe class SharedMemoryChannel : IDisposable
+    {
+        private const int Magic = 0x444D5256; // "VRMD"
+        private const int Version = 1;
+        private const int ChannelHeaderSize = 64;
+
+        private const int TelemetryCapacity = 64 * 1024;
+        private const int LogCapacity = 256 * 1024;
+        private const int CommandCapacity = 4 * 1024;
+        private const int MaxLogBytes = 1024;
+
+        private readonly MemoryMappedFile mappedFile;
+        private readonly MemoryMappedViewAccessor view;
+        private readonly string backingFile;
+        private byte* basePointer;
+
+        private readonly SpscRingBuffer telemetry;
+        private readonly SpscRingBuffer logs;
+        private readonly SpscRingBuffer commands;
+        private readonly ChannelSide side;
+
+        public static int TotalSize =>
+            ChannelHeaderSize +
+            SpscRingBuffer.RequiredSize(TelemetryCapacity) +
+            SpscRingBuffer.RequiredSize(LogCapacity) +
+            SpscRingBuffer.RequiredSize(CommandCapacity);
+
+        /// <summary>
+        /// Game side creates the channel for its own process id, the manager opens it by the game's process id
+        /// </summary>
+        public SharedMemoryChannel(int gameProcessId, ChannelSide side)
+            : this(side, RuntimeInformation.IsOSPlatform(OSPlatform.Windows) ? $"Local\\VRMOD_{gameProcessId}" : null,
+                SharedMemoryPath($"vrmod_{gameProcessId}"))
+        {
+        }
+
+        /// <summary>
+        /// Channel backed by a /dev/shm file on every platform, for ends that aren't both Windows processes: the
+        /// Vulkan layer runs in the game's Linux process under Proton, where the game's named mappings don't
+        /// exist, while the Windows side reaches /dev/shm through Wine's Z: drive.
+        /// </summary>
+        public SharedMemoryChannel(string name, ChannelSide side)
+            : this(side, null, SharedMemoryPath(name))
+        {
+        }
+
+        private SharedMemoryChannel(ChannelSide side, string mappingName, string path)
+        {
+            this.side = side;
+            bool create = side == ChannelSide.Game;
+
+            if (OperatingSystem.IsWindows() && mappingName != null)
+            {
+                mappedFile = create
+                    ? MemoryMappedFile.CreateOrOpen(mappingName, TotalSize)
+                    : MemoryMappedFile.OpenExisting(mappingName);
+            }
+            else
+            {
+                // A reader still holding a previous session's file keeps that copy instead of seeing its rings
+                // reset underneath it
+                backingFile = path;
+                if (create) File.Delete(backingFile);
+                mappedFile = MemoryMappedFile.CreateFromFile(backingFile, create ? FileMode.CreateNew : FileMode.Open, null,
+                    create ? TotalSize : 0, MemoryMappedFileAccess.ReadWrite);
+            }
+
+            view = mappedFile.CreateViewAccessor(0, TotalSize, MemoryMappedFileAccess.ReadWrite);
+            view.SafeMemoryMappedViewHandle.AcquirePointer(ref basePointer);
+            basePointer += view.PointerOffset;
+
+            if (!create && (*(int*)basePointer != Magic || *(int*)(basePointer + 4) != Version))
+            {
+                Dispose();
+                throw new InvalidOperationException($"No compatible VRMOD channel at {mappingName ?? path}");
+            }
+
+            byte* cursor = basePointer + ChannelHeaderSize;
+            telemetry = new SpscRingBuffer(cursor, TelemetryCapacity, create);
+            cursor += SpscRingBuffer.RequiredSize(TelemetryCapacity);
+            logs = new SpscRingBuffer(cursor, LogCapacity, create);
+            cursor += SpscRingBuffer.RequiredSize(LogCapacity);
+            commands = new SpscRingBuffer(cursor, CommandCapacity, create);
+
+            if (create)
+            {
+                // Stamp the header last so the manager never sees half-initialized rings
+                *(int*)(basePointer + 4) = Version;
+                System.Threading.Volatile.Write(ref *(int*)basePointer, Magic);
+            }
+        }
+
+        /// <summary>
+        /// Where a file-backed channel lives. Named mappings aren't supported off Windows; /dev/shm gives the
+        /// same tmpfs-backed sharing.
+        /// </summary>
+        public static string SharedMemoryPath(string name)
+        {
+            if (RuntimeInformation.IsOSPlatform(OSPlatform.Windows))
+            {
+                return $"Z:\\dev\\shm\\{name}";
+            }
+            return Path.Combine(Directory.Exists("/dev/shm") ? "/dev/shm" : Path.GetTempPath(), name);
+        }
+
+        #region Game side
+
+        public bool PublishTelemetry(TelemetryMetric metric, float value, long timestamp)
+        {
+            var sample = new TelemetrySample { Timestamp = timestamp, Metric = metric, Value = value };
+            return telemetry.TryWrite(new ReadOnlySpan<byte>(&sample, sizeof(TelemetrySample)));
+        }
+
+        public bool Log(string message)
+        {
+            // Encode straight into a stack buffer to avoid allocating per message
+            int maxChars = Math.Min(message.Length, MaxLogBytes / 3);
+            byte* buffer = stackalloc byte[MaxLogBytes];
+            int length;
+            fixed (char* chars = message)
+            {
+                length = Encoding.UTF8.GetBytes(chars, maxChars, buffer, MaxLogBytes);
+            }
+            return logs.TryWrite(new ReadOnlySpan<byte>(buffer, length));
+        }
+
+        public bool TryReadCommand(out IpcCommand command)
+        {
+            int value;
+            int length = commands.TryRead(new Span<byte>(&value, sizeof(int)));
+            command = length == sizeof(int) ? (IpcCommand)value : IpcCommand.None;
+            return length >= 0;
+        }
+
+        #endregion
+
+        #region Manager side
+
+        public bool SendCommand(IpcCommand command)
+        {
+            int value = (int)command;
+            return commands.TryWrite(new ReadOnlySpan<byte>(&value, sizeof(int)));
+        }
+
+        public bool TryReadTelemetry(out TelemetrySample sample)
+        {
+            TelemetrySample result;
+            int length = telemetry.TryRead(new Span<byte>(&result, sizeof(TelemetrySample)));
+            sample = result;
+            return length == sizeof(TelemetrySample);
+        }
+
+        public bool TryReadLog(out string message)
+        {
+            byte* buffer = stackalloc byte[MaxLogBytes];
+            int length = logs.TryRead(new Span<byte>(buffer, MaxLogBytes));
+            message = length >= 0 ? Encoding.UTF8.GetString(buffer, length) : null;
+            return length >= 0;
+        }
+
+        #endregion
+
+        public long DroppedMessages => telemetry.DroppedWrites + logs.DroppedWrites + commands.DroppedWrites;
+
+        public void Dispose()
+        {
+            if (basePointer != null)
+            {
+                view.SafeMemoryMappedViewHandle.ReleasePointer();
+                basePointer = null;
+            }
+
+            view?.Dispose();
+            mappedFile?.Dispose();
+
+            if (side == ChannelSide.Game && backingFile != null)
+            {
+                try
+                {
+                    File.Delete(backingFile);
+                }
+                catch (IOException)
+                {
+                    // Manager may still have it open; the file is reclaimed when both sides unmap
+                }
+            }
+        }
+    }
+}
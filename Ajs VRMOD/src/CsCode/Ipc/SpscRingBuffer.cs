@@ -0,0 +1,145 @@
+using System;
+using System.Threading;
+
+namespace VRGameConverter.Ipc
+{
+    /// <summary>
+    /// Single-producer/single-consumer ring of variable-length records living in caller-provided memory
+    /// (typically a shared memory view). Neither side ever blocks: a full ring drops the write, an empty ring
+    /// returns false. Head and tail sit on separate cache lines so producer and consumer don't false-share.
+    /// </summary>
+    public unsafe class SpscRingBuffer
+    {
+        public const int HeaderSize = 192;
+
+        private const int HeadOffset = 0;
+        private const int TailOffset = 64;
+        private const int CapacityOffset = 128;
+        private const int RecordHeaderSize = 4;
+        private const int WrapMarker = -1;
+
+        private readonly byte* header;
+        private readonly byte* data;
+        private readonly long capacity;
+        private readonly long mask;
+
+        public long DroppedWrites { get; private set; }
+
+        /// <summary>
+        /// Total bytes needed for a ring with the given data capacity
+        /// </summary>
+        public static int RequiredSize(int capacity)
+        {
+            return HeaderSize + capacity;
+        }
+
+        /// <summary>
+        /// Attach to ring memory. The creating side passes initialize = true to stamp the header.
+        /// </summary>
+        public SpscRingBuffer(byte* memory, int capacity, bool initialize)
+        {
+            if (capacity <= 0 || (capacity & (capacity - 1)) != 0)
+            {
+                throw new ArgumentException("Ring capacity must be a power of two", nameof(capacity));
+            }
+
+            header = memory;
+            data = memory + HeaderSize;
+
+            if (initialize)
+            {
+                *(long*)(header + HeadOffset) = 0;
+                *(long*)(header + TailOffset) = 0;
+                Volatile.Write(ref *(int*)(header + CapacityOffset), capacity);
+            }
+            else if (Volatile.Read(ref *(int*)(header + CapacityOffset)) != capacity)
+            {
+                throw new InvalidOperationException("Shared ring capacity does not match");
+            }
+
+            this.capacity = capacity;
+            mask = capacity - 1;
+        }
+
+        private ref long Head => ref *(long*)(header + HeadOffset);
+        private ref long Tail => ref *(long*)(header + TailOffset);
+
+        /// <summary>
+        /// Producer side. Returns false (and counts a drop) when the consumer is too far behind.
+        /// </summary>
+        public bool TryWrite(ReadOnlySpan<byte> payload)
+        {
+            long recordSize = Align8(RecordHeaderSize + payload.Length);
+            if (recordSize > capacity / 2)
+            {
+                throw new ArgumentException("Record is too large for this ring", nameof(payload));
+            }
+
+            long tail = Tail;  // Only the producer writes the tail
+            long head = Volatile.Read(ref Head);
+
+            long offset = tail & mask;
+            long contiguous = capacity - offset;
+            long needed = recordSize <= contiguous ? recordSize : contiguous + recordSize;
+
+            if (capacity - (tail - head) < needed)
+            {
+                DroppedWrites++;
+                return false;
+            }
+
+            if (recordSize > contiguous)
+            {
+                // Not enough room before the end: mark the remainder as skipped and start over at 0
+                *(int*)(data + offset) = WrapMarker;
+                tail += contiguous;
+                offset = 0;
+            }
+
+            *(int*)(data + offset) = payload.Length;
+            payload.CopyTo(new Span<byte>(data + offset + RecordHeaderSize, payload.Length));
+
+            // Publish after the payload is in place
+            Volatile.Write(ref Tail, tail + recordSize);
+            return true;
+        }
+
+        /// <summary>
+        /// Consumer side. Copies the next record into the buffer and returns its length, or -1 when empty.
+        /// </summary>
+        public int TryRead(Span<byte> buffer)
+        {
+            long head = Head;  // Only the consumer writes the head
+            long tail = Volatile.Read(ref Tail);
+            if (head == tail) return -1;
+
+            long offset = head & mask;
+            int length = *(int*)(data + offset);
+
+            if (length == WrapMarker)
+            {
+                head += capacity - offset;
+                offset = 0;
+                length = *(int*)(data + offset);
+            }
+
+            if (length > buffer.Length)
+            {
+                throw new ArgumentException($"Buffer of {buffer.Length} bytes is too small for a {length}-byte record", nameof(buffer));
+            }
+
+            new ReadOnlySpan<byte>(data + offset + RecordHeaderSize, length).CopyTo(buffer);
+
+            // Release the slot only after the copy
+            Volatile.Write(ref Head, head + Align8(RecordHeaderSize + length));
+            return length;
+        }
+
+        public bool IsEmpty => Volatile.Read(ref Head) == Volatile.Read(ref Tail);
+
+        private static long Align8(long value)
+        {
+            return (value + 7) & ~7L;
+        }
+    }
+}
@@ -0,0 +1,169 @@
+using System;
+using System.Numerics;
+using AJS_VRMOD;
+
+namespace VRGameConverter.Output
+{
+    /// <summary>
+    /// Buttons of a standard (XInput-layout) gamepad
+    /// </summary>
+    [Flags]
+    public enum GamepadButtons : ushort
+    {
+        None = 0,
+        DPadUp = 0x0001,
+        DPadDown = 0x0002,
+        DPadLeft = 0x0004,
+        DPadRight = 0x0008,
+        Start = 0x0010,
+        Back = 0x0020,
+        LeftThumb = 0x0040,
+        RightThumb = 0x0080,
+        LeftShoulder = 0x0100,
+        RightShoulder = 0x0200,
+        A = 0x1000,
+        B = 0x2000,
+        X = 0x4000,
+        Y = 0x8000
+    }
+
+    public enum GamepadAxis
+    {
+        None,
+        LeftX,
+        LeftY,
+        RightX,
+        RightY,
+        LeftTrigger,
+        RightTrigger
+    }
+
+    /// <summary>
+    /// Parts of the game an action drives; the virtual device only takes over the groups whose hooks weren't found
+    /// </summary>
+    [Flags]
+    public enum ActionGroup
+    {
+        None = 0,
+        Movement = 1,
+        Camera = 2,
+        Combat = 4,
+        Vehicle = 8,
+        Menu = 16
+    }
+
+    /// <summary>
+    /// Snapshot of a virtual gamepad. Sticks are in [-1, 1] with +Y up, triggers in [0, 1].
+    /// </summary>
+    public struct GamepadState : IEquatable<GamepadState>
+    {
+        public GamepadButtons Buttons;
+        public Vector2 LeftStick;
+        public Vector2 RightStick;
+        public float LeftTrigger;
+        public float RightTrigger;
+
+        public void SetAxis(GamepadAxis axis, float value)
+        {
+            switch (axis)
+            {
+                case GamepadAxis.LeftX: LeftStick.X = value; break;
+                case GamepadAxis.LeftY: LeftStick.Y = value; break;
+                case GamepadAxis.RightX: RightStick.X = value; break;
+                case GamepadAxis.RightY: RightStick.Y = value; break;
+                case GamepadAxis.LeftTrigger: LeftTrigger = value; break;
+                case GamepadAxis.RightTrigger: RightTrigger = value; break;
+            }
+        }
+
+        public bool Equals(GamepadState other)
+        {
+            return Buttons == other.Buttons && LeftStick == other.LeftStick && RightStick == other.RightStick &&
+                LeftTrigger == other.LeftTrigger && RightTrigger == other.RightTrigger;
+        }
+
+        public override bool Equals(object obj) => obj is GamepadState other && Equals(other);
+        public override int GetHashCode() => HashCode.Combine(Buttons, LeftStick, RightStick, LeftTrigger, RightTrigger);
+    }
+
+    /// <summary>
+    /// What a VRAction does on the virtual gamepad: press a button and/or push an axis to a value
+    /// </summary>
+    public struct GamepadBinding
+    {
+        public ActionGroup Group;
+        public GamepadButtons Button;
+        public GamepadAxis Axis;
+        public float AxisValue;
+    }
+
+    /// <summary>
+    /// VRAction to gamepad table, indexed by the action's value so lookups don't allocate
+    /// </summary>
+    public class GamepadActionMap
+    {
+        private readonly GamepadBinding[] bindings = new GamepadBinding[VRActionSet.Capacity];
+
+        public GamepadBinding this[VRAction action] => bindings[(int)action];
+
+        public void Bind(VRAction action, ActionGroup group, GamepadButtons button)
+        {
+            bindings[(int)action] = new GamepadBinding { Group = group, Button = button };
+        }
+
+        public void Bind(VRAction action, ActionGroup group, GamepadAxis axis, float value)
+        {
+            bindings[(int)action] = new GamepadBinding { Group = group, Axis = axis, AxisValue = value };
+        }
+
+        /// <summary>
+        /// Layout most console-style open-world games default to
+        /// </summary>
+        public static GamepadActionMap CreateDefault()
+        {
+            var map = new GamepadActionMap();
+
+            map.Bind(VRAction.MoveForward, ActionGroup.Movement, GamepadAxis.LeftY, 1);
+            map.Bind(VRAction.MoveBackward, ActionGroup.Movement, GamepadAxis.LeftY, -1);
+            map.Bind(VRAction.MoveLeft, ActionGroup.Movement, GamepadAxis.LeftX, -1);
+            map.Bind(VRAction.MoveRight, ActionGroup.Movement, GamepadAxis.LeftX, 1);
+            map.Bind(VRAction.Jump, ActionGroup.Movement, GamepadButtons.A);
+            map.Bind(VRAction.Crouch, ActionGroup.Movement, GamepadButtons.B);
+            map.Bind(VRAction.Sprint, ActionGroup.Movement, GamepadButtons.LeftThumb);
+
+            map.Bind(VRAction.LookUp, ActionGroup.Camera, GamepadAxis.RightY, 1);
+            map.Bind(VRAction.LookDown, ActionGroup.Camera, GamepadAxis.RightY, -1);
+            map.Bind(VRAction.LookLeft, ActionGroup.Camera, GamepadAxis.RightX, -1);
+            map.Bind(VRAction.LookRight, ActionGroup.Camera, GamepadAxis.RightX, 1);
+
+            map.Bind(VRAction.PrimaryAction, ActionGroup.Combat, GamepadAxis.RightTrigger, 1);
+            map.Bind(VRAction.SecondaryAction, ActionGroup.Combat, GamepadAxis.LeftTrigger, 1);
+
+            map.Bind(VRAction.VehicleAccelerate, ActionGroup.Vehicle, GamepadAxis.RightTrigger, 1);
+            map.Bind(VRAction.VehicleBrake, ActionGroup.Vehicle, GamepadAxis.LeftTrigger, 1);
+            map.Bind(VRAction.VehicleSteerLeft, ActionGroup.Vehicle, GamepadAxis.LeftX, -1);
+            map.Bind(VRAction.VehicleSteerRight, ActionGroup.Vehicle, GamepadAxis.LeftX, 1);
+            map.Bind(VRAction.VehicleHandbrake, ActionGroup.Vehicle, GamepadButtons.RightShoulder);
+            map.Bind(VRAction.VehicleHorn, ActionGroup.Vehicle, GamepadButtons.LeftThumb);
+            map.Bind(VRAction.VehicleLookLeft, ActionGroup.Vehicle, GamepadAxis.RightX, -1);
+            map.Bind(VRAction.VehicleLookRight, ActionGroup.Vehicle, GamepadAxis.RightX, 1);
+
+            map.Bind(VRAction.Menu, ActionGroup.Menu, GamepadButtons.Start);
+            map.Bind(VRAction.Map, ActionGroup.Menu, GamepadButtons.Back);
+            map.Bind(VRAction.Inventory, ActionGroup.Menu, GamepadButtons.Y);
+
+            return map;
+        }
+    }
+
+    /// <summary>
+    /// OS-level virtual controller the game reads like a real one
+    /// </summary>
+    public interface IVirtualInputDevice : IDisposable
+    {
+        /// <summary>
+        /// Emit everything that changed since the last submitted state as one batch
+        /// </summary>
+        void Submit(in GamepadState state, in GamepadState previous);
+    }
+}
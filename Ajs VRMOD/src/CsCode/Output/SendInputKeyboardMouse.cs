@@ -0,0 +1,160 @@
+using System;
+using System.Numerics;
+using System.Runtime.InteropServices;
+
+namespace VRGameConverter.Output
+{
+    /// <summary>
+    /// Windows stand-in for a virtual gamepad that needs no driver: buttons become key scan codes, the left stick
+    /// becomes WASD, the right stick relative mouse motion and the triggers mouse buttons. Each submit is one SendInput call.
+    /// </summary>
+    public sealed class SendInputKeyboardMouse : IVirtualInputDevice
+    {
+        private const uint INPUT_MOUSE = 0;
+        private const uint INPUT_KEYBOARD = 1;
+        private const uint KEYEVENTF_KEYUP = 0x0002;
+        private const uint KEYEVENTF_SCANCODE = 0x0008;
+        private const uint MOUSEEVENTF_MOVE = 0x0001;
+        private const uint MOUSEEVENTF_LEFTDOWN = 0x0002;
+        private const uint MOUSEEVENTF_LEFTUP = 0x0004;
+        private const uint MOUSEEVENTF_RIGHTDOWN = 0x0008;
+        private const uint MOUSEEVENTF_RIGHTUP = 0x0010;
+
+        private const ushort ScanW = 0x11, ScanA = 0x1E, ScanS = 0x1F, ScanD = 0x20;
+        private const float StickThreshold = 0.5f;
+        private const float TriggerThreshold = 0.5f;
+
+        // Scan codes for each GamepadButtons bit (common PC defaults for open-world games)
+        private static readonly (GamepadButtons Button, ushort Scan)[] ButtonScanCodes =
+        {
+            (GamepadButtons.DPadUp, 0x02),        // 1
+            (GamepadButtons.DPadDown, 0x03),      // 2
+            (GamepadButtons.DPadLeft, 0x04),      // 3
+            (GamepadButtons.DPadRight, 0x05),     // 4
+            (GamepadButtons.Start, 0x01),         // Esc
+            (GamepadButtons.Back, 0x32),          // M
+            (GamepadButtons.LeftThumb, 0x2A),     // Left Shift
+            (GamepadButtons.RightThumb, 0x2E),    // C
+            (GamepadButtons.LeftShoulder, 0x10),  // Q
+            (GamepadButtons.RightShoulder, 0x12), // E
+            (GamepadButtons.A, 0x39),             // Space
+            (GamepadButtons.B, 0x1D),             // Left Ctrl
+            (GamepadButtons.X, 0x13),             // R
+            (GamepadButtons.Y, 0x0F)              // Tab
+        };
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct MouseInput
+        {
+            public int Dx;
+            public int Dy;
+            public uint MouseData;
+            public uint Flags;
+            public uint Time;
+            public IntPtr ExtraInfo;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct KeyboardInput
+        {
+            public ushort VirtualKey;
+            public ushort ScanCode;
+            public uint Flags;
+            public uint Time;
+            public IntPtr ExtraInfo;
+        }
+
+        [StructLayout(LayoutKind.Explicit)]
+        private struct InputUnion
+        {
+            [FieldOffset(0)] public MouseInput Mouse;
+            [FieldOffset(0)] public KeyboardInput Keyboard;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct Input
+        {
+            public uint Type;
+            public InputUnion Data;
+        }
+
+        [DllImport("user32.dll", SetLastError = true)]
+        private static extern uint SendInput(uint count, Input[] inputs, int size);
+
+        // Pixels of mouse motion per frame at full right-stick deflection
+        public float MouseSpeed { get; set; } = 18.0f;
+
+        private readonly Input[] batch = new Input[ButtonScanCodes.Length + 4 + 3];
+        private GamepadState lastSubmitted;
+
+        public void Submit(in GamepadState state, in GamepadState previous)
+        {
+            int count = 0;
+            lastSubmitted = state;
+
+            GamepadButtons changed = state.Buttons ^ previous.Buttons;
+            if (changed != GamepadButtons.None)
+            {
+                foreach (var (button, scan) in ButtonScanCodes)
+                {
+                    if ((changed & button) != 0) AddKey(ref count, scan, (state.Buttons & button) != 0);
+                }
+            }
+
+            AddStickKey(ref count, ScanW, state.LeftStick.Y > StickThreshold, previous.LeftStick.Y > StickThreshold);
+            AddStickKey(ref count, ScanS, state.LeftStick.Y < -StickThreshold, previous.LeftStick.Y < -StickThreshold);
+            AddStickKey(ref count, ScanA, state.LeftStick.X < -StickThreshold, previous.LeftStick.X < -StickThreshold);
+            AddStickKey(ref count, ScanD, state.LeftStick.X > StickThreshold, previous.LeftStick.X > StickThreshold);
+
+            AddMouseButton(ref count, state.RightTrigger > TriggerThreshold, previous.RightTrigger > TriggerThreshold,
+                MOUSEEVENTF_LEFTDOWN, MOUSEEVENTF_LEFTUP);
+            AddMouseButton(ref count, state.LeftTrigger > TriggerThreshold, previous.LeftTrigger > TriggerThreshold,
+                MOUSEEVENTF_RIGHTDOWN, MOUSEEVENTF_RIGHTUP);
+
+            // Unlike the other inputs, look motion is a rate, so it is sent every frame the stick is held
+            Vector2 look = state.RightStick * MouseSpeed;
+            if (look != Vector2.Zero)
+            {
+                batch[count].Type = INPUT_MOUSE;
+                batch[count].Data.Mouse = new MouseInput { Dx = (int)look.X, Dy = (int)-look.Y, Flags = MOUSEEVENTF_MOVE };
+                count++;
+            }
+
+            if (count > 0)
+            {
+                SendInput((uint)count, batch, Marshal.SizeOf<Input>());
+            }
+        }
+
+        private void AddStickKey(ref int count, ushort scan, bool down, bool wasDown)
+        {
+            if (down != wasDown) AddKey(ref count, scan, down);
+        }
+
+        private void AddKey(ref int count, ushort scan, bool down)
+        {
+            batch[count].Type = INPUT_KEYBOARD;
+            batch[count].Data.Keyboard = new KeyboardInput
+            {
+                ScanCode = scan,
+                Flags = KEYEVENTF_SCANCODE | (down ? 0 : KEYEVENTF_KEYUP)
+            };
+            count++;
+        }
+
+        private void AddMouseButton(ref int count, bool down, bool wasDown, uint downFlag, uint upFlag)
+        {
+            if (down == wasDown) return;
+
+            batch[count].Type = INPUT_MOUSE;
+            batch[count].Data.Mouse = new MouseInput { Flags = down ? downFlag : upFlag };
+            count++;
+        }
+
+        public void Dispose()
+        {
+            // Release anything still held so keys don't stick after the fallback is torn down
+            Submit(new GamepadState(), lastSubmitted);
+        }
+    }
+}
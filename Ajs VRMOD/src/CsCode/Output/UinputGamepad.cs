@@ -0,0 +1,215 @@
+using System;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace VRGameConverter.Output
+{
+    /// <summary>
+    /// Linux virtual gamepad through /dev/uinput, presented with the Xbox pad's button and axis codes.
+    /// Each submit is a single write() of only the changed events plus one SYN_REPORT.
+    /// </summary>
+    public sealed unsafe class UinputGamepad : IVirtualInputDevice
+    {
+        private const int O_WRONLY = 0x1;
+        private const int O_NONBLOCK = 0x800;
+
+        private const ulong UI_SET_EVBIT = 0x40045564;
+        private const ulong UI_SET_KEYBIT = 0x40045565;
+        private const ulong UI_SET_ABSBIT = 0x40045567;
+        private const ulong UI_DEV_SETUP = 0x405C5503;
+        private const ulong UI_ABS_SETUP = 0x401C5504;
+        private const ulong UI_DEV_CREATE = 0x5501;
+        private const ulong UI_DEV_DESTROY = 0x5502;
+
+        private const ushort EV_SYN = 0x00;
+        private const ushort EV_KEY = 0x01;
+        private const ushort EV_ABS = 0x03;
+        private const ushort SYN_REPORT = 0;
+
+        private const ushort ABS_X = 0x00, ABS_Y = 0x01, ABS_Z = 0x02, ABS_RX = 0x03, ABS_RY = 0x04, ABS_RZ = 0x05;
+        private const int StickRange = 32767;
+        private const int TriggerRange = 255;
+
+        // Linux key codes for each GamepadButtons bit, in bit order
+        private static readonly (GamepadButtons Button, ushort Code)[] ButtonCodes =
+        {
+            (GamepadButtons.DPadUp, 0x220),
+            (GamepadButtons.DPadDown, 0x221),
+            (GamepadButtons.DPadLeft, 0x222),
+            (GamepadButtons.DPadRight, 0x223),
+            (GamepadButtons.Start, 0x13B),
+            (GamepadButtons.Back, 0x13A),
+            (GamepadButtons.LeftThumb, 0x13D),
+            (GamepadButtons.RightThumb, 0x13E),
+            (GamepadButtons.LeftShoulder, 0x136),
+            (GamepadButtons.RightShoulder, 0x137),
+            (GamepadButtons.A, 0x130),
+            (GamepadButtons.B, 0x131),
+            (GamepadButtons.X, 0x133),
+            (GamepadButtons.Y, 0x134)
+        };
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct InputEvent
+        {
+            public long Seconds;       // struct timeval; zero lets the kernel stamp the event
+            public long Microseconds;
+            public ushort Type;
+            public ushort Code;
+            public int Value;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct UinputSetup
+        {
+            public ushort BusType;
+            public ushort Vendor;
+            public ushort Product;
+            public ushort Version;
+            public fixed byte Name[80];
+            public uint FfEffectsMax;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct UinputAbsSetup
+        {
+            public ushort Code;
+            public int Value;
+            public int Minimum;
+            public int Maximum;
+            public int Fuzz;
+            public int Flat;
+            public int Resolution;
+        }
+
+        [DllImport("libc", SetLastError = true)]
+        private static extern int open(string path, int flags);
+
+        [DllImport("libc", SetLastError = true)]
+        private static extern int close(int fd);
+
+        [DllImport("libc", SetLastError = true)]
+        private static extern nint write(int fd, void* buffer, nint count);
+
+        [DllImport("libc", SetLastError = true)]
+        private static extern int ioctl(int fd, ulong request, int value);
+
+        [DllImport("libc", SetLastError = true)]
+        private static extern int ioctl(int fd, ulong request, void* argument);
+
+        // Worst case: every button and axis changes, plus the sync
+        private readonly InputEvent[] batch = new InputEvent[ButtonCodes.Length + 6 + 1];
+        private int fd = -1;
+
+        public UinputGamepad(string name = "VRMOD Virtual Gamepad")
+        {
+            fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK);
+            if (fd < 0)
+            {
+                throw new InvalidOperationException($"Cannot open /dev/uinput (errno {Marshal.GetLastWin32Error()}); check the uinput module and permissions");
+            }
+
+            try
+            {
+                Check(ioctl(fd, UI_SET_EVBIT, EV_KEY), "UI_SET_EVBIT EV_KEY");
+                foreach (var (_, code) in ButtonCodes)
+                {
+                    Check(ioctl(fd, UI_SET_KEYBIT, code), "UI_SET_KEYBIT");
+                }
+
+                Check(ioctl(fd, UI_SET_EVBIT, EV_ABS), "UI_SET_EVBIT EV_ABS");
+                SetupAxis(ABS_X, -StickRange, StickRange);
+                SetupAxis(ABS_Y, -StickRange, StickRange);
+                SetupAxis(ABS_RX, -StickRange, StickRange);
+                SetupAxis(ABS_RY, -StickRange, StickRange);
+                SetupAxis(ABS_Z, 0, TriggerRange);
+                SetupAxis(ABS_RZ, 0, TriggerRange);
+
+                // Report as a wired Xbox 360 pad so games pick their default controller layout
+                var setup = new UinputSetup { BusType = 0x03, Vendor = 0x045E, Product = 0x028E, Version = 1 };
+                byte[] nameBytes = Encoding.ASCII.GetBytes(name);
+                for (int i = 0; i < Math.Min(nameBytes.Length, 79); i++) setup.Name[i] = nameBytes[i];
+                Check(ioctl(fd, UI_DEV_SETUP, &setup), "UI_DEV_SETUP");
+                Check(ioctl(fd, UI_DEV_CREATE, 0), "UI_DEV_CREATE");
+            }
+            catch
+            {
+                close(fd);
+                fd = -1;
+                throw;
+            }
+        }
+
+        private void SetupAxis(ushort code, int minimum, int maximum)
+        {
+            Check(ioctl(fd, UI_SET_ABSBIT, code), "UI_SET_ABSBIT");
+            var abs = new UinputAbsSetup { Code = code, Minimum = minimum, Maximum = maximum };
+            Check(ioctl(fd, UI_ABS_SETUP, &abs), "UI_ABS_SETUP");
+        }
+
+        private static void Check(int result, string operation)
+        {
+            if (result < 0)
+            {
+                throw new InvalidOperationException($"uinput {operation} failed (errno {Marshal.GetLastWin32Error()})");
+            }
+        }
+
+        public void Submit(in GamepadState state, in GamepadState previous)
+        {
+            if (fd < 0) return;
+
+            int count = 0;
+
+            GamepadButtons changed = state.Buttons ^ previous.Buttons;
+            if (changed != GamepadButtons.None)
+            {
+                foreach (var (button, code) in ButtonCodes)
+                {
+                    if ((changed & button) != 0)
+                    {
+                        batch[count++] = new InputEvent { Type = EV_KEY, Code = code, Value = (state.Buttons & button) != 0 ? 1 : 0 };
+                    }
+                }
+            }
+
+            // evdev's Y axes point down
+            AddAxis(ref count, ABS_X, Stick(state.LeftStick.X), Stick(previous.LeftStick.X));
+            AddAxis(ref count, ABS_Y, Stick(-state.LeftStick.Y), Stick(-previous.LeftStick.Y));
+            AddAxis(ref count, ABS_RX, Stick(state.RightStick.X), Stick(previous.RightStick.X));
+            AddAxis(ref count, ABS_RY, Stick(-state.RightStick.Y), Stick(-previous.RightStick.Y));
+            AddAxis(ref count, ABS_Z, Trigger(state.LeftTrigger), Trigger(previous.LeftTrigger));
+            AddAxis(ref count, ABS_RZ, Trigger(state.RightTrigger), Trigger(previous.RightTrigger));
+
+            if (count == 0) return;
+
+            batch[count++] = new InputEvent { Type = EV_SYN, Code = SYN_REPORT, Value = 0 };
+
+            fixed (InputEvent* events = batch)
+            {
+                // Non-blocking: if the queue is full the game is not reading, and dropping a frame of input is fine
+                write(fd, events, count * sizeof(InputEvent));
+            }
+        }
+
+        private void AddAxis(ref int count, ushort code, int value, int previousValue)
+        {
+            if (value != previousValue)
+            {
+                batch[count++] = new InputEvent { Type = EV_ABS, Code = code, Value = value };
+            }
+        }
+
+        private static int Stick(float value) => (int)(Math.Clamp(value, -1, 1) * StickRange);
+        private static int Trigger(float value) => (int)(Math.Clamp(value, 0, 1) * TriggerRange);
+
+        public void Dispose()
+        {
+            if (fd < 0) return;
+
+            ioctl(fd, UI_DEV_DESTROY, 0);
+            close(fd);
+            fd = -1;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+using System;
+using System.Numerics;
+using AJS_VRMOD;
+
+namespace VRGameConverter.Output
+{
+    /// <summary>
+    /// Fixed-size bitset of pressed VRActions, one bit per enum value, so a frame's input can be
+    /// compared and copied without allocating
+    /// </summary>
+    public struct VRActionSet : IEquatable<VRActionSet>
+    {
+        public const int Capacity = 128;
+
+        private ulong low;
+        private ulong high;
+
+        public bool IsEmpty => (low | high) == 0;
+
+        public void Set(VRAction action, bool pressed)
+        {
+            int bit = (int)action;
+            if (bit >= Capacity) throw new ArgumentOutOfRangeException(nameof(action), $"VRAction {action} doesn't fit in the action bitset");
+
+            ulong mask = 1UL << (bit & 63);
+            if (bit < 64) low = pressed ? low | mask : low & ~mask;
+            else high = pressed ? high | mask : high & ~mask;
+        }
+
+        public bool IsSet(VRAction action)
+        {
+            int bit = (int)action;
+            return bit < 64 ? (low & (1UL << bit)) != 0 : (high & (1UL << (bit & 63))) != 0;
+        }
+
+        public void Clear()
+        {
+            low = 0;
+            high = 0;
+        }
+
+        /// <summary>
+        /// Next set action at or after the given one, or VRAction.None when there are no more
+        /// </summary>
+        public VRAction NextSet(int fromBit)
+        {
+            if (fromBit < 64)
+            {
+                ulong bits = low & (ulong.MaxValue << fromBit);
+                if (bits != 0) return (VRAction)BitOperations.TrailingZeroCount(bits);
+                fromBit = 64;
+            }
+
+            if (fromBit < Capacity)
+            {
+                ulong bits = high & (ulong.MaxValue << (fromBit - 64));
+                if (bits != 0) return (VRAction)(64 + BitOperations.TrailingZeroCount(bits));
+            }
+
+            return VRAction.None;
+        }
+
+        public bool Equals(VRActionSet other) => low == other.low && high == other.high;
+        public override bool Equals(object obj) => obj is VRActionSet other && Equals(other);
+        public override int GetHashCode() => HashCode.Combine(low, high);
+    }
+
+    /// <summary>
+    /// Everything the controllers asked of the game this frame: mapped digital actions plus the raw analog inputs
+    /// </summary>
+    public struct VRActionState
+    {
+        public VRActionSet Digital;
+        public Vector2 LeftStick;
+        public Vector2 RightStick;
+        public float LeftTrigger;
+        public float RightTrigger;
+    }
+}
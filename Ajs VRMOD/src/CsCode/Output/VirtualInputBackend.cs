@@ -0,0 +1,87 @@
+using System;
+using System.Numerics;
+using System.Runtime.InteropServices;
+using AJS_VRMOD;
+
+namespace VRGameConverter.Output
+{
+    /// <summary>
+    /// Hook-free fallback: drives the game through an OS-level virtual controller for the action groups whose
+    /// function signatures weren't found. Only created when at least one group needs it, and only touches the
+    /// OS when the mapped state actually changes, so it costs nothing while hooks are doing the work.
+    /// </summary>
+    public sealed class VirtualInputBackend : IDisposable
+    {
+        public ActionGroup Groups { get; }
+
+        private readonly IVirtualInputDevice device;
+        private readonly GamepadActionMap map;
+        private GamepadState previous;
+
+        public VirtualInputBackend(ActionGroup groups, GamepadActionMap map = null, IVirtualInputDevice device = null)
+        {
+            Groups = groups;
+            this.map = map ?? GamepadActionMap.CreateDefault();
+            this.device = device ?? CreatePlatformDevice();
+        }
+
+        private static IVirtualInputDevice CreatePlatformDevice()
+        {
+            if (RuntimeInformation.IsOSPlatform(OSPlatform.Linux))
+            {
+                return new UinputGamepad();
+            }
+
+            // No driver-free virtual gamepad on Windows; keyboard and mouse is what every PC game accepts
+            return new SendInputKeyboardMouse();
+        }
+
+        /// <summary>
+        /// Called once per frame from the update loop; everything that changed goes out as a single batch
+        /// </summary>
+        public void Update(in VRActionState actions)
+        {
+            var state = new GamepadState();
+
+            for (var action = actions.Digital.NextSet(1); action != VRAction.None; action = actions.Digital.NextSet((int)action + 1))
+            {
+                var binding = map[action];
+                if ((binding.Group & Groups) == 0) continue;
+
+                state.Buttons |= binding.Button;
+                if (binding.Axis != GamepadAxis.None) state.SetAxis(binding.Axis, binding.AxisValue);
+            }
+
+            // Analog inputs pass straight through where they're stronger than what the digital actions produced
+            if ((Groups & (ActionGroup.Movement | ActionGroup.Vehicle)) != 0)
+            {
+                state.LeftStick = Stronger(state.LeftStick, actions.LeftStick);
+            }
+            if ((Groups & ActionGroup.Camera) != 0)
+            {
+                state.RightStick = Stronger(state.RightStick, actions.RightStick);
+            }
+            if ((Groups & (ActionGroup.Combat | ActionGroup.Vehicle)) != 0)
+            {
+                state.LeftTrigger = Math.Max(state.LeftTrigger, actions.LeftTrigger);
+                state.RightTrigger = Math.Max(state.RightTrigger, actions.RightTrigger);
+            }
+
+            // A held right stick is a look rate, which keyboard/mouse devices must keep sending
+            if (state.Equals(previous) && state.RightStick == Vector2.Zero) return;
+
+            device.Submit(state, previous);
+            previous = state;
+        }
+
+        private static Vector2 Stronger(Vector2 a, Vector2 b)
+        {
+            return b.LengthSquared() > a.LengthSquared() ? b : a;
+        }
+
+        public void Dispose()
+        {
+            device.Dispose();
+        }
+    }
+}
@@ -4,6 +4,7 @@ using System.Diagnostics;
 using System.IO;
 using System.Runtime.InteropServices;
 using Microsoft.Win32;
+using VRGameConverter.Ipc;
 
 namespace VRGameConverter.ProcessManagement
 {
@@ -470,6 +471,9 @@ namespace VRGameConverter.ProcessManagement
         // Process handle for the active game
         private Process gameProcess;
         
+        // Shared-memory link to the injected module, null until the module has created it
+        private SharedMemoryChannel channel;
+        
         /// <summary>
         /// Launch a game directly or via launcher
         /// </summary>
@@ -649,6 +653,65 @@ namespace VRGameConverter.ProcessManagement
             string exeName = Path.GetFileNameWithoutExtension(game.ExecutablePath);
             return Process.GetProcessesByName(exeName).Length > 0;
         }
+        
+        /// <summary>
+        /// Try to open the channel created by the injected module. Non-blocking; call again later if it returns false.
+        /// </summary>
+        public bool TryConnectChannel()
+        {
+            if (channel != null)
+                return true;
+                
+            if (gameProcess == null || gameProcess.HasExited)
+                return false;
+                
+            try
+            {
+                channel = new SharedMemoryChannel(gameProcess.Id, ChannelSide.Manager);
+                return true;
+            }
+            catch (Exception ex) when (ex is IOException || ex is InvalidOperationException)
+            {
+                // Module not injected yet
+                return false;
+            }
+        }
+        
+        /// <summary>
+        /// Send a command to the running game without waiting for it to be processed
+        /// </summary>
+        public bool SendCommand(IpcCommand command)
+        {
+            return TryConnectChannel() && channel.SendCommand(command);
+        }
+        
+        /// <summary>
+        /// Have the running game sweep render settings along its benchmark pose path. The game keeps running
+        /// meanwhile; the result shows up in its log and is used from then on, including later launches.
+        /// </summary>
+        public bool RunBenchmark()
+        {
+            return SendCommand(IpcCommand.RunBenchmark);
+        }
+        
+        /// <summary>
+        /// Drain logs and telemetry published by the game since the last call
+        /// </summary>
+        public void PumpMessages(Action<TelemetrySample> onTelemetry)
+        {
+            if (!TryConnectChannel())
+                return;
+                
+            while (channel.TryReadLog(out var message))
+            {
+                Console.WriteLine($"[game] {message}");
+            }
+            
+            while (channel.TryReadTelemetry(out var sample))
+            {
+                onTelemetry?.Invoke(sample);
+            }
+        }
     }
     
     // Support classes
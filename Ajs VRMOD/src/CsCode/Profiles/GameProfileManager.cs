@@ -3,6 +3,7 @@ using System.Collections.Generic;
 using System.IO;
 using System.Linq;
 using VRGameConverter.ProcessManagement;
+using VRGameConverter.Scheduling;
 
 namespace VRGameConverter.Profiles
 {
@@ -13,6 +14,7 @@ namespace VRGameConverter.Profiles
     {
         private Dictionary<string, GameProfile> profiles = new Dictionary<string, GameProfile>();
         private List<GameTypeSignature> gameSignatures = new List<GameTypeSignature>();
+        private KnownBuildTable knownBuilds = new KnownBuildTable();
 
         public GameProfileManager()
         {
@@ -151,6 +153,13 @@ namespace VRGameConverter.Profiles
 
         public GameType DetectGameType(DetectedGame game)
         {
+            // A build seen before is recognised from the executable's PE headers alone
+            GameType knownType = knownBuilds.Lookup(game.ExecutablePath, out _);
+            if (knownType != GameType.Unknown)
+            {
+                return knownType;
+            }
+
             string installPath = game.InstallPath;
 
             if (string.IsNullOrEmpty(installPath) || !Directory.Exists(installPath))
@@ -158,11 +167,20 @@ namespace VRGameConverter.Profiles
                 return GameType.Unknown;
             }
 
-            foreach (var signature in gameSignatures)
+            // The install walk is disk-bound background work; run it on the efficiency cores
+            using (ThreadPlacementManager.Shared.Enter(ThreadRole.Scanning))
             {
-                if (MatchesSignature(installPath, signature))
+                foreach (var signature in gameSignatures)
                 {
-                    return signature.GameType;
+                    if (MatchesSignature(installPath, signature))
+                    {
+                        // Remember this build so the next detection skips the walk
+                        if (PeFingerprint.TryRead(game.ExecutablePath, true, out var fingerprint))
+                        {
+                            knownBuilds.Learn(fingerprint, signature.GameType);
+                        }
+                        return signature.GameType;
+                    }
                 }
             }
 
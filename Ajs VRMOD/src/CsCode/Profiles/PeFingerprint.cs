@@ -0,0 +1,288 @@
+using System;
+using System.Buffers.Binary;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Text;
+using VRGameConverter.ProcessManagement;
+
+namespace VRGameConverter.Profiles
+{
+    /// <summary>
+    /// Identity of one build of an executable, from its PE headers. The link timestamp and image size alone
+    /// nearly always tell builds apart; the CodeView record (PDB GUID and age) settles the rest.
+    /// </summary>
+    public struct PeFingerprint
+    {
+        public ushort Machine;
+        public uint TimeDateStamp;
+        public uint SizeOfImage;
+
+        // From the debug directory's CodeView entry; empty when the build has none or it wasn't read
+        public Guid PdbGuid;
+        public uint PdbAge;
+        public string PdbName;
+
+        public bool HasCodeView => PdbGuid != Guid.Empty;
+
+        public ulong HeaderKey => ((ulong)TimeDateStamp << 32) | SizeOfImage;
+
+        public override string ToString()
+        {
+            return HasCodeView
+                ? $"{TimeDateStamp:X8}/{SizeOfImage:X} {PdbName} {PdbGuid:N}{PdbAge}"
+                : $"{TimeDateStamp:X8}/{SizeOfImage:X}";
+        }
+
+        private const int HeaderReadSize = 4096;
+        private const int DebugEntrySize = 28;
+        private const uint DebugTypeCodeView = 2;
+        private const uint CodeViewRsds = 0x53445352;  // "RSDS"
+
+        /// <summary>
+        /// Read the fingerprint with a single 4 KB read of the file's headers. With includeCodeView the debug
+        /// directory is followed too, which costs two more small reads further into the file.
+        /// </summary>
+        public static bool TryRead(string path, bool includeCodeView, out PeFingerprint fingerprint)
+        {
+            fingerprint = default;
+            if (string.IsNullOrEmpty(path)) return false;
+
+            try
+            {
+                using var file = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.ReadWrite | FileShare.Delete, 1, FileOptions.RandomAccess);
+                var header = new byte[HeaderReadSize];
+                int length = ReadAt(file, 0, header);
+
+                if (!TryParseHeaders(header.AsSpan(0, length), out fingerprint, out uint debugRva, out uint debugSize, out var sections))
+                {
+                    return false;
+                }
+
+                if (includeCodeView && debugRva != 0)
+                {
+                    ReadCodeView(file, header.AsSpan(0, length), sections, debugRva, debugSize, ref fingerprint);
+                }
+                return true;
+            }
+            catch (IOException)
+            {
+                return false;
+            }
+            catch (UnauthorizedAccessException)
+            {
+                return false;
+            }
+        }
+
+        private static bool TryParseHeaders(ReadOnlySpan<byte> data, out PeFingerprint fingerprint, out uint debugRva, out uint debugSize, out (int Offset, int Count) sections)
+        {
+            fingerprint = default;
+            debugRva = 0;
+            debugSize = 0;
+            sections = default;
+
+            if (data.Length < 0x40 || BinaryPrimitives.ReadUInt16LittleEndian(data) != 0x5A4D) return false;   // "MZ"
+
+            int pe = BinaryPrimitives.ReadInt32LittleEndian(data.Slice(0x3C));
+            if (pe <= 0 || pe + 24 > data.Length || BinaryPrimitives.ReadUInt32LittleEndian(data.Slice(pe)) != 0x00004550) return false;   // "PE\0\0"
+
+            var coff = data.Slice(pe + 4);
+            fingerprint.Machine = BinaryPrimitives.ReadUInt16LittleEndian(coff);
+            int sectionCount = BinaryPrimitives.ReadUInt16LittleEndian(coff.Slice(2));
+            fingerprint.TimeDateStamp = BinaryPrimitives.ReadUInt32LittleEndian(coff.Slice(4));
+            int optionalSize = BinaryPrimitives.ReadUInt16LittleEndian(coff.Slice(16));
+
+            int optional = pe + 24;
+            if (optional + optionalSize > data.Length || optionalSize < 96) return false;
+
+            var opt = data.Slice(optional, optionalSize);
+            ushort magic = BinaryPrimitives.ReadUInt16LittleEndian(opt);
+            int directoryCountOffset;
+            if (magic == 0x10B) directoryCountOffset = 92;         // PE32
+            else if (magic == 0x20B) directoryCountOffset = 108;   // PE32+
+            else return false;
+
+            fingerprint.SizeOfImage = BinaryPrimitives.ReadUInt32LittleEndian(opt.Slice(56));
+
+            const int debugDirectory = 6;
+            int directoryCount = (int)BinaryPrimitives.ReadUInt32LittleEndian(opt.Slice(directoryCountOffset));
+            int debugEntry = directoryCountOffset + 4 + debugDirectory * 8;
+            if (directoryCount > debugDirectory && debugEntry + 8 <= optionalSize)
+            {
+                debugRva = BinaryPrimitives.ReadUInt32LittleEndian(opt.Slice(debugEntry));
+                debugSize = BinaryPrimitives.ReadUInt32LittleEndian(opt.Slice(debugEntry + 4));
+            }
+
+            sections = (optional + optionalSize, sectionCount);
+            return true;
+        }
+
+        private static void ReadCodeView(FileStream file, ReadOnlySpan<byte> header, (int Offset, int Count) sections, uint debugRva, uint debugSize, ref PeFingerprint fingerprint)
+        {
+            long directoryOffset = RvaToFileOffset(header, sections, debugRva);
+            if (directoryOffset < 0) return;
+
+            int entries = (int)Math.Min(debugSize / DebugEntrySize, 16);
+            var directory = new byte[entries * DebugEntrySize];
+            if (ReadAt(file, directoryOffset, directory) < directory.Length) return;
+
+            for (int i = 0; i < entries; i++)
+            {
+                var entry = directory.AsSpan(i * DebugEntrySize, DebugEntrySize);
+                if (BinaryPrimitives.ReadUInt32LittleEndian(entry.Slice(12)) != DebugTypeCodeView) continue;
+
+                uint dataSize = BinaryPrimitives.ReadUInt32LittleEndian(entry.Slice(16));
+                uint pointer = BinaryPrimitives.ReadUInt32LittleEndian(entry.Slice(24));
+                if (dataSize < 24 || pointer == 0) return;
+
+                var record = new byte[Math.Min(dataSize, 1024)];
+                int read = ReadAt(file, pointer, record);
+                if (read < 24 || BinaryPrimitives.ReadUInt32LittleEndian(record) != CodeViewRsds) return;
+
+                fingerprint.PdbGuid = new Guid(record.AsSpan(4, 16));
+                fingerprint.PdbAge = BinaryPrimitives.ReadUInt32LittleEndian(record.AsSpan(20));
+
+                int end = Array.IndexOf(record, (byte)0, 24, read - 24);
+                string pdbPath = Encoding.UTF8.GetString(record, 24, (end < 0 ? read : end) - 24);
+                fingerprint.PdbName = Path.GetFileName(pdbPath.Replace('\\', '/'));
+                return;
+            }
+        }
+
+        private static long RvaToFileOffset(ReadOnlySpan<byte> header, (int Offset, int Count) sections, uint rva)
+        {
+            for (int i = 0; i < sections.Count; i++)
+            {
+                int section = sections.Offset + i * 40;
+                if (section + 40 > header.Length) break;
+
+                var entry = header.Slice(section, 40);
+                uint virtualSize = BinaryPrimitives.ReadUInt32LittleEndian(entry.Slice(8));
+                uint virtualAddress = BinaryPrimitives.ReadUInt32LittleEndian(entry.Slice(12));
+                uint rawSize = BinaryPrimitives.ReadUInt32LittleEndian(entry.Slice(16));
+                uint rawPointer = BinaryPrimitives.ReadUInt32LittleEndian(entry.Slice(20));
+
+                if (rva >= virtualAddress && rva < virtualAddress + Math.Max(virtualSize, rawSize))
+                {
+                    return rawPointer + (rva - virtualAddress);
+                }
+            }
+            return -1;
+        }
+
+        private static int ReadAt(FileStream file, long offset, byte[] buffer)
+        {
+            file.Position = offset;
+            int total = 0;
+            while (total < buffer.Length)
+            {
+                int read = file.Read(buffer, total, buffer.Length - total);
+                if (read == 0) break;
+                total += read;
+            }
+            return total;
+        }
+    }
+
+    /// <summary>
+    /// Game builds recognised before, by PE fingerprint. Starts from the seed list shipped with the mod and what
+    /// earlier sessions learned (the file next to the other per-user data), and grows every time the directory
+    /// walk identifies a new build, so a game is only ever walked once per patch.
+    /// </summary>
+    public class KnownBuildTable
+    {
+        public const string SeedFileName = "known-builds.seed.txt";
+
+        // Fully qualified: ProcessManagement has a Dictionary of its own
+        private readonly System.Collections.Generic.Dictionary<ulong, GameType> byHeader = new System.Collections.Generic.Dictionary<ulong, GameType>();
+        private readonly System.Collections.Generic.Dictionary<(Guid, uint), GameType> byPdb = new System.Collections.Generic.Dictionary<(Guid, uint), GameType>();
+        private readonly string storePath;
+
+        /// <summary>
+        /// The seed list is read-only and defaults to the one next to the mod's assembly; builds learned at run
+        /// time go to storePath.
+        /// </summary>
+        public KnownBuildTable(string storePath = null, string seedPath = null)
+        {
+            this.storePath = storePath ?? Path.Combine(
+                Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData), "AjsVRMOD", "known-builds.txt");
+            Load(seedPath ?? Path.Combine(AppContext.BaseDirectory, SeedFileName));
+            Load(this.storePath);
+        }
+
+        public int Count => byHeader.Count;
+
+        /// <summary>
+        /// Game type for the executable from its headers, or Unknown. Returns the fingerprint it read so the
+        /// caller can teach it the answer from a slower detection.
+        /// </summary>
+        public GameType Lookup(string executablePath, out PeFingerprint fingerprint)
+        {
+            fingerprint = default;
+            if (string.IsNullOrEmpty(executablePath) || !PeFingerprint.TryRead(executablePath, false, out fingerprint))
+            {
+                return GameType.Unknown;
+            }
+
+            if (byHeader.TryGetValue(fingerprint.HeaderKey, out var type)) return type;
+
+            // Same build relinked or re-signed: the PDB identity survives where the timestamp doesn't
+            if (byPdb.Count > 0 && PeFingerprint.TryRead(executablePath, true, out fingerprint) && fingerprint.HasCodeView &&
+                byPdb.TryGetValue((fingerprint.PdbGuid, fingerprint.PdbAge), out type))
+            {
+                Learn(fingerprint, type);
+                return type;
+            }
+
+            return GameType.Unknown;
+        }
+
+        public void Learn(PeFingerprint fingerprint, GameType type)
+        {
+            if (fingerprint.SizeOfImage == 0 || type == GameType.Unknown) return;
+            if (byHeader.TryGetValue(fingerprint.HeaderKey, out var existing) && existing == type) return;
+
+            byHeader[fingerprint.HeaderKey] = type;
+            if (fingerprint.HasCodeView) byPdb[(fingerprint.PdbGuid, fingerprint.PdbAge)] = type;
+
+            try
+            {
+                Directory.CreateDirectory(Path.GetDirectoryName(storePath));
+                File.AppendAllText(storePath, string.Join(" ",
+                    fingerprint.TimeDateStamp.ToString("X8"), fingerprint.SizeOfImage.ToString("X"),
+                    fingerprint.PdbGuid.ToString("N"), fingerprint.PdbAge.ToString(CultureInfo.InvariantCulture), type) + Environment.NewLine);
+            }
+            catch (IOException ex)
+            {
+                Console.WriteLine($"Could not save known build {fingerprint}: {ex.Message}");
+            }
+        }
+
+        // One build per line: link timestamp and SizeOfImage in hex, PDB GUID (all zeros without CodeView),
+        // PDB age, game type. Lines starting with # are comments.
+        private void Load(string path)
+        {
+            if (!File.Exists(path)) return;
+
+            foreach (var line in File.ReadLines(path))
+            {
+                if (line.StartsWith("#", StringComparison.Ordinal)) continue;
+
+                var fields = line.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+                if (fields.Length != 5 ||
+                    !uint.TryParse(fields[0], NumberStyles.HexNumber, CultureInfo.InvariantCulture, out uint timestamp) ||
+                    !uint.TryParse(fields[1], NumberStyles.HexNumber, CultureInfo.InvariantCulture, out uint size) ||
+                    !Guid.TryParseExact(fields[2], "N", out var guid) ||
+                    !uint.TryParse(fields[3], NumberStyles.Integer, CultureInfo.InvariantCulture, out uint age) ||
+                    !Enum.TryParse(fields[4], out GameType type))
+                {
+                    continue;
+                }
+
+                byHeader[((ulong)timestamp << 32) | size] = type;
+                if (guid != Guid.Empty) byPdb[(guid, age)] = type;
+            }
+        }
+    }
+}
@@ -0,0 +1,350 @@
+using System;
+using System.Numerics;
+using System.Runtime.CompilerServices;
+using System.Threading;
+
+namespace VRGameConverter.Rendering
+{
+    /// <summary>
+    /// Pinhole camera a captured depth buffer was rendered with. View space is right-handed:
+    /// +X right, +Y up, looking down -Z, with linear depth measured as -Z.
+    /// </summary>
+    public struct DepthCamera
+    {
+        public int Width;
+        public int Height;
+        public float FocalX;
+        public float FocalY;
+        public float CenterX;
+        public float CenterY;
+        public float NearPlane;
+        public float FarPlane;
+        public bool ReversedZ;
+
+        public static DepthCamera FromFov(int width, int height, float verticalFovDegrees, float nearPlane, float farPlane, bool reversedZ)
+        {
+            float focal = height * 0.5f / MathF.Tan(verticalFovDegrees * MathF.PI / 360.0f);
+            return new DepthCamera
+            {
+                Width = width,
+                Height = height,
+                FocalX = focal,
+                FocalY = focal,
+                CenterX = width * 0.5f,
+                CenterY = height * 0.5f,
+                NearPlane = nearPlane,
+                FarPlane = farPlane,
+                ReversedZ = reversedZ
+            };
+        }
+
+        /// <summary>
+        /// Device depth in [0,1] (D3D convention) to linear view depth
+        /// </summary>
+        public float LinearizeDepth(float deviceDepth)
+        {
+            float n = NearPlane, f = FarPlane;
+            return ReversedZ
+                ? f * n / (n + deviceDepth * (f - n))
+                : f * n / (f - deviceDepth * (f - n));
+        }
+
+        /// <summary>
+        /// View-space point to (pixel x, pixel y, linear depth); pixel y grows downward
+        /// </summary>
+        public Vector3 Project(Vector3 view)
+        {
+            float depth = -view.Z;
+            return new Vector3(CenterX + FocalX * view.X / depth, CenterY - FocalY * view.Y / depth, depth);
+        }
+
+        public Vector3 Unproject(float x, float y, float depth)
+        {
+            return new Vector3((x - CenterX) * depth / FocalX, (CenterY - y) * depth / FocalY, -depth);
+        }
+    }
+
+    /// <summary>
+    /// Result of marching a ray against a depth pyramid
+    /// </summary>
+    public struct DepthHit
+    {
+        public bool Hit;
+        public Vector3 Position;  // Same space as the ray that was marched
+        public float Distance;
+        public int Steps;
+    }
+
+    /// <summary>
+    /// Hierarchical min/max pyramid over a captured depth buffer. Rays are marched in screen space,
+    /// skipping whole cells whose depth range the ray passes in front of or behind, so a hit is
+    /// usually found in a few dozen steps instead of one per pixel.
+    /// Build bumps a sequence number around the rewrite, so a reader that raced a rebuild can tell.
+    /// </summary>
+    public sealed class DepthPyramid
+    {
+        public int Width { get; }
+        public int Height { get; }
+        public int LevelCount { get; }
+        public DepthCamera Camera { get; private set; }
+
+        // Pose of the game camera when the depth was captured, used to march rays given in tracking space
+        public Vector3 CapturePosition { get; private set; }
+        public Quaternion CaptureRotation { get; private set; } = Quaternion.Identity;
+
+        private readonly float[][] minLevels;
+        private readonly float[][] maxLevels;
+        private readonly int[] levelWidths;
+        private readonly int[] levelHeights;
+
+        // Even while the levels are stable, odd while Build is rewriting them
+        private int sequence;
+        public int Sequence => Volatile.Read(ref sequence);
+
+        public DepthPyramid(int width, int height)
+        {
+            Width = width;
+            Height = height;
+
+            int levels = 1;
+            for (int w = width, h = height; w > 1 || h > 1; w = (w + 1) / 2, h = (h + 1) / 2) levels++;
+            LevelCount = levels;
+
+            minLevels = new float[levels][];
+            maxLevels = new float[levels][];
+            levelWidths = new int[levels];
+            levelHeights = new int[levels];
+
+            for (int level = 0, w = width, h = height; level < levels; level++, w = (w + 1) / 2, h = (h + 1) / 2)
+            {
+                levelWidths[level] = w;
+                levelHeights[level] = h;
+                minLevels[level] = new float[w * h];
+                maxLevels[level] = level == 0 ? minLevels[0] : new float[w * h];
+            }
+        }
+
+        /// <summary>
+        /// Rebuild from device depth values (row-major, Width x Height) captured with the given camera and pose
+        /// </summary>
+        public void Build(ReadOnlySpan<float> deviceDepth, DepthCamera camera, Vector3 capturePosition, Quaternion captureRotation)
+        {
+            if (deviceDepth.Length < Width * Height)
+            {
+                throw new ArgumentException($"Expected {Width * Height} depth values, got {deviceDepth.Length}", nameof(deviceDepth));
+            }
+
+            Interlocked.Increment(ref sequence);
+
+            Camera = camera;
+            CapturePosition = capturePosition;
+            CaptureRotation = captureRotation;
+
+            float[] baseLevel = minLevels[0];
+            for (int i = 0; i < Width * Height; i++)
+            {
+                baseLevel[i] = camera.LinearizeDepth(deviceDepth[i]);
+            }
+
+            for (int level = 1; level < LevelCount; level++)
+            {
+                Downsample(level);
+            }
+
+            Interlocked.Increment(ref sequence);
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        private void Downsample(int level)
+        {
+            int srcWidth = levelWidths[level - 1], srcHeight = levelHeights[level - 1];
+            float[] srcMin = minLevels[level - 1], srcMax = maxLevels[level - 1];
+            float[] dstMin = minLevels[level], dstMax = maxLevels[level];
+            int width = levelWidths[level], height = levelHeights[level];
+
+            for (int y = 0; y < height; y++)
+            {
+                // Odd sizes: the last cell covers the remaining single row/column
+                int y0 = y * 2, y1 = Math.Min(y0 + 1, srcHeight - 1);
+                for (int x = 0; x < width; x++)
+                {
+                    int x0 = x * 2, x1 = Math.Min(x0 + 1, srcWidth - 1);
+
+                    dstMin[y * width + x] = Math.Min(
+                        Math.Min(srcMin[y0 * srcWidth + x0], srcMin[y0 * srcWidth + x1]),
+                        Math.Min(srcMin[y1 * srcWidth + x0], srcMin[y1 * srcWidth + x1]));
+                    dstMax[y * width + x] = Math.Max(
+                        Math.Max(srcMax[y0 * srcWidth + x0], srcMax[y0 * srcWidth + x1]),
+                        Math.Max(srcMax[y1 * srcWidth + x0], srcMax[y1 * srcWidth + x1]));
+                }
+            }
+        }
+
+        public float LinearDepthAt(int x, int y)
+        {
+            return minLevels[0][y * Width + x];
+        }
+
+        /// <summary>
+        /// March a ray given in tracking space (the space of the capture pose)
+        /// </summary>
+        public DepthHit MarchFromWorld(Vector3 origin, Vector3 direction, float maxDistance, float thickness = 0.25f, int maxSteps = 64)
+        {
+            var toView = Quaternion.Inverse(CaptureRotation);
+            var hit = March(Vector3.Transform(origin - CapturePosition, toView), Vector3.Transform(direction, toView),
+                maxDistance, thickness, maxSteps);
+
+            if (hit.Hit)
+            {
+                hit.Position = Vector3.Transform(hit.Position, CaptureRotation) + CapturePosition;
+            }
+            return hit;
+        }
+
+        /// <summary>
+        /// MarchFromWorld for readers on other threads than the builder: returns false, and a hit that
+        /// must be discarded, when the pyramid was rebuilt while the ray was marched
+        /// </summary>
+        public bool TryMarchFromWorld(Vector3 origin, Vector3 direction, float maxDistance, out DepthHit hit,
+            float thickness = 0.25f, int maxSteps = 64)
+        {
+            int before = Volatile.Read(ref sequence);
+            if ((before & 1) != 0)
+            {
+                hit = default;
+                return false;
+            }
+
+            // Indices are clamped inside the march, so reading torn data is harmless; it's only thrown away
+            hit = MarchFromWorld(origin, direction, maxDistance, thickness, maxSteps);
+            Interlocked.MemoryBarrier();
+            return Volatile.Read(ref sequence) == before;
+        }
+
+        /// <summary>
+        /// March a view-space ray through the pyramid. Surfaces are treated as slabs of the given thickness,
+        /// so rays can pass behind foreground objects.
+        /// </summary>
+        public DepthHit March(Vector3 origin, Vector3 direction, float maxDistance, float thickness = 0.25f, int maxSteps = 64)
+        {
+            return MarchCore(origin, direction, maxDistance, thickness, maxSteps, true);
+        }
+
+        /// <summary>
+        /// Same traversal pinned to the finest level (one step per pixel), as the reference for March
+        /// </summary>
+        public DepthHit MarchReference(Vector3 origin, Vector3 direction, float maxDistance, float thickness = 0.25f)
+        {
+            return MarchCore(origin, direction, maxDistance, thickness, Width + Height + 2, false);
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        private DepthHit MarchCore(Vector3 origin, Vector3 direction, float maxDistance, float thickness, int maxSteps, bool hierarchical)
+        {
+            var result = new DepthHit();
+            if (direction.LengthSquared() < 1e-12f) return result;
+
+            direction = Vector3.Normalize(direction);
+            Vector3 start = origin;
+            Vector3 end = origin + direction * maxDistance;
+
+            // Clip the segment to the part in front of the near plane
+            float near = Camera.NearPlane;
+            float startDepth = -start.Z, endDepth = -end.Z;
+            if (startDepth < near && endDepth < near) return result;
+            if (startDepth < near) start += (end - start) * ((near - startDepth) / (endDepth - startDepth));
+            else if (endDepth < near) end = start + (end - start) * ((startDepth - near) / (startDepth - endDepth));
+
+            Vector3 p0 = Camera.Project(start);
+            Vector3 p1 = Camera.Project(end);
+
+            // Inverse depth is linear in screen space, which makes the ray's depth along the segment exact
+            float x0 = p0.X, y0 = p0.Y, dx = p1.X - p0.X, dy = p1.Y - p0.Y;
+            float inv0 = 1.0f / p0.Z, invDelta = 1.0f / p1.Z - inv0;
+
+            // Restrict the segment to the screen rectangle
+            float sBegin = 0, sEnd = 1;
+            if (!ClipAxis(x0, dx, Width, ref sBegin, ref sEnd) || !ClipAxis(y0, dy, Height, ref sBegin, ref sEnd))
+            {
+                return result;
+            }
+
+            float pixelLength = MathF.Sqrt(dx * dx + dy * dy);
+            float nudge = 0.01f / Math.Max(1.0f, pixelLength);
+
+            float s = sBegin;
+            int level = 0;
+            int steps = 0;
+
+            while (steps < maxSteps && s <= sEnd)
+            {
+                steps++;
+
+                int cellSize = 1 << level;
+                int cx = Math.Clamp((int)((x0 + dx * s) / cellSize), 0, levelWidths[level] - 1);
+                int cy = Math.Clamp((int)((y0 + dy * s) / cellSize), 0, levelHeights[level] - 1);
+
+                // Parameter where the segment leaves the current cell
+                float sExit = sEnd;
+                if (dx > 0) sExit = Math.Min(sExit, ((cx + 1) * cellSize - x0) / dx);
+                else if (dx < 0) sExit = Math.Min(sExit, (cx * cellSize - x0) / dx);
+                if (dy > 0) sExit = Math.Min(sExit, ((cy + 1) * cellSize - y0) / dy);
+                else if (dy < 0) sExit = Math.Min(sExit, (cy * cellSize - y0) / dy);
+                sExit = Math.Max(sExit, s);
+
+                float depthIn = 1.0f / (inv0 + invDelta * s);
+                float depthOut = 1.0f / (inv0 + invDelta * sExit);
+                float rayNear = Math.Min(depthIn, depthOut);
+                float rayFar = Math.Max(depthIn, depthOut);
+
+                int index = cy * levelWidths[level] + cx;
+                float cellMin = minLevels[level][index];
+                float cellMax = maxLevels[level][index];
+
+                if (rayFar < cellMin || rayNear > cellMax + thickness)
+                {
+                    // Entirely in front of or behind everything in this cell: skip it and try a coarser one
+                    s = sExit + nudge;
+                    if (hierarchical && level < LevelCount - 1) level++;
+                    continue;
+                }
+
+                if (level > 0)
+                {
+                    level--;
+                    continue;
+                }
+
+                // Finest level: the ray enters the surface slab inside this pixel
+                float sHit = s;
+                if (depthIn < cellMin && Math.Abs(invDelta) > 1e-12f)
+                {
+                    sHit = Math.Clamp((1.0f / cellMin - inv0) / invDelta, s, sExit);
+                }
+
+                float hitDepth = 1.0f / (inv0 + invDelta * sHit);
+                result.Hit = true;
+                result.Position = Camera.Unproject(x0 + dx * sHit, y0 + dy * sHit, hitDepth);
+                result.Distance = Vector3.Distance(origin, result.Position);
+                break;
+            }
+
+            result.Steps = steps;
+            return result;
+        }
+
+        private static bool ClipAxis(float start, float delta, int size, ref float sBegin, ref float sEnd)
+        {
+            if (Math.Abs(delta) < 1e-12f)
+            {
+                return start >= 0 && start < size;
+            }
+
+            float a = (0 - start) / delta;
+            float b = (size - 1e-3f - start) / delta;
+            sBegin = Math.Max(sBegin, Math.Min(a, b));
+            sEnd = Math.Min(sEnd, Math.Max(a, b));
+            return sBegin <= sEnd;
+        }
+    }
+}
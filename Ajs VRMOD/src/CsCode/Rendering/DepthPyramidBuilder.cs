@@ -0,0 +1,128 @@
+using System;
+using System.Diagnostics;
+using System.Numerics;
+using System.Threading;
+
+namespace VRGameConverter.Rendering
+{
+    /// <summary>
+    /// Builds depth pyramids on a worker thread from captures the render thread hands over, so Present only
+    /// pays for the readback copy. Captures and pyramids each rotate through three buffers: the render thread
+    /// always has a staging buffer to fill, and a pyramid is only rebuilt two publishes after readers last saw it.
+    /// Readers that may hold one longer still use DepthPyramid.TryMarchFromWorld.
+    /// </summary>
+    public sealed class DepthPyramidBuilder : IDisposable
+    {
+        public int Width { get; }
+        public int Height { get; }
+
+        public double LastBuildMilliseconds { get; private set; }
+        public long BuildCount => Interlocked.Read(ref buildCount);
+
+        private const int FreshBit = 4;
+
+        private struct Capture
+        {
+            public float[] Depth;
+            public DepthCamera Camera;
+            public Vector3 Position;
+            public Quaternion Rotation;
+        }
+
+        // Staging triple buffer: the render thread owns writeSlot, the worker readSlot, pendingSlot is the handoff
+        private readonly Capture[] captures = new Capture[3];
+        private int writeSlot = 0;
+        private int pendingSlot = 1;
+        private int readSlot = 2;
+
+        // Pyramids: one published, the other two taken in turn by the worker
+        private readonly DepthPyramid[] pyramids = new DepthPyramid[3];
+        private DepthPyramid published;
+        private int nextPyramid = 0;
+        private long buildCount;
+
+        private readonly AutoResetEvent captured = new AutoResetEvent(false);
+        private readonly Thread worker;
+        private volatile bool running = true;
+
+        public DepthPyramidBuilder(int width, int height)
+        {
+            Width = width;
+            Height = height;
+
+            for (int i = 0; i < 3; i++)
+            {
+                captures[i].Depth = new float[width * height];
+                pyramids[i] = new DepthPyramid(width, height);
+            }
+
+            worker = new Thread(Run)
+            {
+                Name = "Depth pyramid",
+                IsBackground = true
+            };
+            worker.Start();
+        }
+
+        /// <summary>
+        /// Most recently built pyramid, or null before the first capture has been built
+        /// </summary>
+        public DepthPyramid Latest => Volatile.Read(ref published);
+
+        /// <summary>
+        /// Render thread: the buffer the next readback should be copied into
+        /// </summary>
+        public float[] CaptureBuffer => captures[writeSlot].Depth;
+
+        /// <summary>
+        /// Render thread: hand the filled CaptureBuffer to the worker. Never blocks; an unbuilt earlier capture is replaced.
+        /// </summary>
+        public void Submit(DepthCamera camera, Vector3 capturePosition, Quaternion captureRotation)
+        {
+            captures[writeSlot].Camera = camera;
+            captures[writeSlot].Position = capturePosition;
+            captures[writeSlot].Rotation = captureRotation;
+
+            writeSlot = Interlocked.Exchange(ref pendingSlot, writeSlot | FreshBit) & ~FreshBit;
+            captured.Set();
+        }
+
+        private void Run()
+        {
+            while (running)
+            {
+                captured.WaitOne();
+
+                if ((Volatile.Read(ref pendingSlot) & FreshBit) == 0) continue;
+                readSlot = Interlocked.Exchange(ref pendingSlot, readSlot) & ~FreshBit;
+
+                // Never the published pyramid, and never the one published just before it
+                var target = pyramids[nextPyramid];
+                if (target == Volatile.Read(ref published))
+                {
+                    nextPyramid = (nextPyramid + 1) % 3;
+                    target = pyramids[nextPyramid];
+                }
+                nextPyramid = (nextPyramid + 1) % 3;
+
+                long start = Stopwatch.GetTimestamp();
+                var capture = captures[readSlot];
+                target.Build(capture.Depth, capture.Camera, capture.Position, capture.Rotation);
+                LastBuildMilliseconds = (Stopwatch.GetTimestamp() - start) * 1000.0 / Stopwatch.Frequency;
+
+                Volatile.Write(ref published, target);
+                Interlocked.Increment(ref buildCount);
+            }
+        }
+
+        public void Dispose()
+        {
+            running = false;
+            captured.Set();
+            worker.Join();
+
+            // The event is left to the finalizer: a present that fetched this instance just before it was
+            // replaced may still submit to it
+        }
+    }
+}
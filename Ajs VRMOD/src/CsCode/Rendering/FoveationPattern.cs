@@ -0,0 +1,80 @@
+using System;
+using System.Numerics;
+
+namespace VRGameConverter.Rendering
+{
+    /// <summary>
+    /// Coarse pixel shading rate, one shader invocation per block of the given size
+    /// </summary>
+    public enum ShadingRate
+    {
+        Full,       // 1x1
+        Half,       // 2x2
+        Quarter     // 4x4
+    }
+
+    /// <summary>
+    /// Fixed foveation for one eye: full-rate shading around the lens centre, then rings of coarser rates
+    /// toward the edges where the lens blurs anyway. Radii are in the [0,1] eye-buffer space, measured as an
+    /// ellipse so they follow the buffer's aspect like the lens does.
+    /// </summary>
+    public class FoveationPattern
+    {
+        // Full-rate and half-rate outer radii per level; level 0 is off
+        private static readonly float[] FullRadii = { float.MaxValue, 0.50f, 0.42f, 0.35f };
+        private static readonly float[] HalfRadii = { float.MaxValue, float.MaxValue, 0.62f, 0.50f };
+
+        public int Level { get; }
+        public Vector2 Center { get; }
+        public float FullRadius { get; }
+        public float HalfRadius { get; }
+
+        public FoveationPattern(int eye, int level, float lensOffsetX = 0.03f)
+        {
+            Level = Math.Clamp(level, 0, FullRadii.Length - 1);
+
+            // Same nasal offset as the lens-ellipse hidden-area mesh
+            Center = new Vector2(0.5f + (eye == 0 ? lensOffsetX : -lensOffsetX), 0.5f);
+            FullRadius = FullRadii[Level];
+            HalfRadius = HalfRadii[Level];
+        }
+
+        public ShadingRate RateAt(float u, float v)
+        {
+            float radius = Vector2.Distance(new Vector2(u, v), Center);
+            if (radius <= FullRadius) return ShadingRate.Full;
+            return radius <= HalfRadius ? ShadingRate.Half : ShadingRate.Quarter;
+        }
+
+        /// <summary>
+        /// Shader invocations relative to full-rate shading, sampled at the given resolution
+        /// </summary>
+        public float ShadingCost(int width, int height)
+        {
+            if (Level == 0) return 1.0f;
+
+            double cost = 0;
+            for (int y = 0; y < height; y++)
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    switch (RateAt((x + 0.5f) / width, (y + 0.5f) / height))
+                    {
+                        case ShadingRate.Full: cost += 1.0; break;
+                        case ShadingRate.Half: cost += 1.0 / 4; break;
+                        default: cost += 1.0 / 16; break;
+                    }
+                }
+            }
+            return (float)(cost / (width * height));
+        }
+
+        public override string ToString()
+        {
+            if (Level == 0) return "foveation off";
+            return HalfRadius == float.MaxValue
+                ? $"foveation level {Level}: full rate within {FullRadius:F2}, half beyond"
+                : $"foveation level {Level}: full rate within {FullRadius:F2}, half within {HalfRadius:F2}, quarter beyond";
+        }
+    }
+}
@@ -0,0 +1,110 @@
+using System;
+using System.IO;
+using System.Text;
+
+namespace VRGameConverter.Rendering
+{
+    /// <summary>
+    /// CPU copy of a presented frame, packed RGBA8 (R in the low byte). Reads and writes binary PPM (P6)
+    /// so recorded frame sequences can be processed offline.
+    /// </summary>
+    public class FrameImage
+    {
+        public int Width { get; }
+        public int Height { get; }
+        public uint[] Pixels { get; }
+
+        public FrameImage(int width, int height)
+        {
+            Width = width;
+            Height = height;
+            Pixels = new uint[width * height];
+        }
+
+        public static uint Pack(int r, int g, int b)
+        {
+            return (uint)r | ((uint)g << 8) | ((uint)b << 16) | 0xFF000000u;
+        }
+
+        /// <summary>
+        /// Rec. 709 luma of every pixel, in [0, 255]
+        /// </summary>
+        public void ToLuma(float[] destination)
+        {
+            for (int i = 0; i < Pixels.Length; i++)
+            {
+                uint p = Pixels[i];
+                destination[i] = 0.2126f * (p & 0xFF) + 0.7152f * ((p >> 8) & 0xFF) + 0.0722f * ((p >> 16) & 0xFF);
+            }
+        }
+
+        public static FrameImage ReadPpm(string path)
+        {
+            using (var stream = new BufferedStream(File.OpenRead(path)))
+            {
+                if (ReadToken(stream) != "P6")
+                    throw new InvalidDataException($"{path} is not a binary PPM file");
+
+                int width = int.Parse(ReadToken(stream));
+                int height = int.Parse(ReadToken(stream));
+                int maxValue = int.Parse(ReadToken(stream));
+                if (maxValue != 255)
+                    throw new NotSupportedException($"{path}: only 8-bit PPM is supported");
+
+                var image = new FrameImage(width, height);
+                var row = new byte[width * 3];
+                for (int y = 0; y < height; y++)
+                {
+                    if (stream.Read(row, 0, row.Length) != row.Length)
+                        throw new InvalidDataException($"{path} is truncated");
+
+                    for (int x = 0; x < width; x++)
+                    {
+                        image.Pixels[y * width + x] = Pack(row[x * 3], row[x * 3 + 1], row[x * 3 + 2]);
+                    }
+                }
+                return image;
+            }
+        }
+
+        public static void WritePpm(string path, FrameImage image)
+        {
+            using (var stream = new BufferedStream(File.Create(path)))
+            {
+                var header = Encoding.ASCII.GetBytes($"P6\n{image.Width} {image.Height}\n255\n");
+                stream.Write(header, 0, header.Length);
+
+                foreach (uint p in image.Pixels)
+                {
+                    stream.WriteByte((byte)p);
+                    stream.WriteByte((byte)(p >> 8));
+                    stream.WriteByte((byte)(p >> 16));
+                }
+            }
+        }
+
+        private static string ReadToken(Stream stream)
+        {
+            var token = new StringBuilder();
+            int c;
+
+            // Skip whitespace and comments, then read up to (and consume) the next whitespace byte
+            while ((c = stream.ReadByte()) != -1)
+            {
+                if (c == '#')
+                {
+                    while ((c = stream.ReadByte()) != -1 && c != '\n') { }
+                    continue;
+                }
+                if (!char.IsWhiteSpace((char)c)) break;
+            }
+
+            while (c != -1 && !char.IsWhiteSpace((char)c))
+            {
+                token.Append((char)c);
+                c = stream.ReadByte();
+            }
+            return token.ToString();
+        }
+    }
+}
@@ -0,0 +1,175 @@
+using System;
+using System.Collections.Generic;
+using System.Numerics;
+
+namespace VRGameConverter.Rendering
+{
+    /// <summary>
+    /// Triangles covering the lens-occluded region of one eye buffer, in normalized [0,1] texture coordinates
+    /// </summary>
+    public class HiddenAreaMesh
+    {
+        public Vector2[] Vertices { get; set; } = Array.Empty<Vector2>();  // Triangle list
+
+        public int TriangleCount => Vertices.Length / 3;
+
+        /// <summary>
+        /// Fallback when the runtime doesn't provide a mesh: everything outside an ellipse inscribed
+        /// in the eye buffer, with the ellipse centre shifted toward the nose by lensOffsetX
+        /// </summary>
+        public static HiddenAreaMesh CreateFromLensEllipse(int eye, float radiusX = 0.53f, float radiusY = 0.56f,
+            float lensOffsetX = 0.03f, int segments = 48)
+        {
+            // Left eye's lens centre sits right of the buffer centre, the right eye's to the left
+            float centerX = 0.5f + (eye == 0 ? lensOffsetX : -lensOffsetX);
+            var center = new Vector2(centerX, 0.5f);
+            var vertices = new List<Vector2>(segments * 9);
+
+            for (int i = 0; i < segments; i++)
+            {
+                float a0 = 2 * MathF.PI * i / segments;
+                float a1 = 2 * MathF.PI * (i + 1) / segments;
+
+                var inner0 = center + new Vector2(radiusX * MathF.Cos(a0), radiusY * MathF.Sin(a0));
+                var inner1 = center + new Vector2(radiusX * MathF.Cos(a1), radiusY * MathF.Sin(a1));
+
+                // Project each ellipse point outward onto the buffer border
+                var outer0 = ProjectToBorder(center, inner0);
+                var outer1 = ProjectToBorder(center, inner1);
+
+                vertices.Add(inner0);
+                vertices.Add(outer0);
+                vertices.Add(outer1);
+                vertices.Add(inner0);
+                vertices.Add(outer1);
+                vertices.Add(inner1);
+
+                // When the two rays hit different edges the chord cuts off a buffer corner; fill it
+                bool vertical0 = OnVerticalEdge(outer0);
+                bool vertical1 = OnVerticalEdge(outer1);
+                if (vertical0 != vertical1)
+                {
+                    var corner = vertical0 ? new Vector2(outer0.X, outer1.Y) : new Vector2(outer1.X, outer0.Y);
+                    vertices.Add(outer0);
+                    vertices.Add(corner);
+                    vertices.Add(outer1);
+                }
+            }
+
+            return new HiddenAreaMesh { Vertices = vertices.ToArray() };
+        }
+
+        private static bool OnVerticalEdge(Vector2 point)
+        {
+            return point.X <= 1e-4f || point.X >= 1 - 1e-4f;
+        }
+
+        private static Vector2 ProjectToBorder(Vector2 center, Vector2 point)
+        {
+            Vector2 direction = point - center;
+            float scale = float.MaxValue;
+
+            if (direction.X > 0) scale = Math.Min(scale, (1 - center.X) / direction.X);
+            if (direction.X < 0) scale = Math.Min(scale, -center.X / direction.X);
+            if (direction.Y > 0) scale = Math.Min(scale, (1 - center.Y) / direction.Y);
+            if (direction.Y < 0) scale = Math.Min(scale, -center.Y / direction.Y);
+
+            // Points already outside the buffer stay where they are (their triangles are clipped away)
+            return scale < 1 ? point : center + direction * scale;
+        }
+
+        /// <summary>
+        /// CPU rasterization of the mesh at the given resolution; returns the number of pixels whose
+        /// centres the mesh covers, i.e. pixels the game no longer has to shade
+        /// </summary>
+        public int CountCoveredPixels(int width, int height)
+        {
+            var covered = new bool[width * height];
+            int count = 0;
+
+            for (int t = 0; t + 2 < Vertices.Length; t += 3)
+            {
+                var a = Vertices[t] * new Vector2(width, height);
+                var b = Vertices[t + 1] * new Vector2(width, height);
+                var c = Vertices[t + 2] * new Vector2(width, height);
+
+                float area = Edge(a, b, c);
+                if (MathF.Abs(area) < 1e-6f) continue;
+
+                int minX = Math.Max(0, (int)MathF.Floor(Math.Min(a.X, Math.Min(b.X, c.X))));
+                int maxX = Math.Min(width - 1, (int)MathF.Ceiling(Math.Max(a.X, Math.Max(b.X, c.X))));
+                int minY = Math.Max(0, (int)MathF.Floor(Math.Min(a.Y, Math.Min(b.Y, c.Y))));
+                int maxY = Math.Min(height - 1, (int)MathF.Ceiling(Math.Max(a.Y, Math.Max(b.Y, c.Y))));
+
+                for (int y = minY; y <= maxY; y++)
+                {
+                    for (int x = minX; x <= maxX; x++)
+                    {
+                        var p = new Vector2(x + 0.5f, y + 0.5f);
+                        float w0 = Edge(b, c, p) * area;
+                        float w1 = Edge(c, a, p) * area;
+                        float w2 = Edge(a, b, p) * area;
+
+                        // Same sign as the triangle's area means inside, regardless of winding
+                        if (w0 >= 0 && w1 >= 0 && w2 >= 0 && !covered[y * width + x])
+                        {
+                            covered[y * width + x] = true;
+                            count++;
+                        }
+                    }
+                }
+            }
+
+            return count;
+        }
+
+        private static float Edge(Vector2 a, Vector2 b, Vector2 p)
+        {
+            return (b.X - a.X) * (p.Y - a.Y) - (b.Y - a.Y) * (p.X - a.X);
+        }
+    }
+
+    /// <summary>
+    /// Pixel savings of a hidden-area mesh at a given eye-buffer resolution
+    /// </summary>
+    public struct HiddenAreaCoverage
+    {
+        public int Width;
+        public int Height;
+        public int HiddenPixels;
+
+        public int TotalPixels => Width * Height;
+        public float HiddenFraction => TotalPixels == 0 ? 0 : (float)HiddenPixels / TotalPixels;
+
+        public static HiddenAreaCoverage Measure(HiddenAreaMesh mesh, int width, int height)
+        {
+            return new HiddenAreaCoverage
+            {
+                Width = width,
+                Height = height,
+                HiddenPixels = mesh.CountCoveredPixels(width, height)
+            };
+        }
+
+        /// <summary>
+        /// The same mesh over a viewport of another size, without rasterizing it again. The mesh is in
+        /// normalized coordinates, so the hidden fraction carries over (to within edge pixels).
+        /// </summary>
+        public HiddenAreaCoverage ScaledTo(int width, int height)
+        {
+            if (width == Width && height == Height) return this;
+
+            return new HiddenAreaCoverage
+            {
+                Width = width,
+                Height = height,
+                HiddenPixels = (int)Math.Round((double)HiddenPixels * width * height / Math.Max(1, TotalPixels))
+            };
+        }
+
+        public override string ToString()
+        {
+            return $"{HiddenPixels} of {TotalPixels} pixels ({HiddenFraction:P1}) culled at {Width}x{Height}";
+        }
+    }
+}
@@ -0,0 +1,182 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+
+namespace VRGameConverter.Rendering
+{
+    /// <summary>
+    /// One combination of render settings tried by the benchmark, with its measured frame times
+    /// </summary>
+    public class BenchmarkCandidate
+    {
+        public float ResolutionScale { get; set; }
+        public int FoveationLevel { get; set; }
+        public StereoMode StereoMode { get; set; }
+
+        // Filled from the present hook
+        internal double[] FrameTimes;
+        internal int FrameCount;
+
+        public double MeanMilliseconds { get; internal set; }
+        public double P95Milliseconds { get; internal set; }
+        public bool HoldsRefreshRate { get; internal set; }
+
+        public override string ToString()
+        {
+            return $"scale {ResolutionScale:F2}, foveation {FoveationLevel}, {StereoMode}: mean {MeanMilliseconds:F2} ms, p95 {P95Milliseconds:F2} ms" +
+                (HoldsRefreshRate ? "" : " (misses refresh)");
+        }
+    }
+
+    /// <summary>
+    /// Sweeps resolution scale, foveation level and stereo mode while replaying a pose path, timing each
+    /// combination through the present hook. The result is the highest-quality combination whose 95th
+    /// percentile frame time fits the headset refresh interval, picking the faster stereo mode at equal quality.
+    /// </summary>
+    public sealed class PerformanceBenchmark
+    {
+        private static readonly float[] ResolutionScales = { 1.0f, 0.9f, 0.8f, 0.7f, 0.6f };
+        private static readonly int[] FoveationLevels = { 0, 1, 2, 3 };
+        private static readonly StereoMode[] StereoModes = { StereoMode.DualPass, StereoMode.AlternateEye };
+
+        public IReadOnlyList<BenchmarkCandidate> Candidates => candidates;
+        public BenchmarkCandidate Best { get; private set; }
+        public bool IsComplete { get; private set; }
+
+        private readonly List<BenchmarkCandidate> candidates = new List<BenchmarkCandidate>();
+        private readonly PosePath posePath;
+        private readonly double refreshMilliseconds;
+        private readonly int warmupFrames;
+        private readonly int measuredFrames;
+
+        private int currentIndex = -1;
+        private BenchmarkCandidate current;
+        private int framesSeen = 0;
+        private readonly Stopwatch replayClock = new Stopwatch();
+
+        public PerformanceBenchmark(PosePath posePath, float refreshRate, int warmupFrames = 60, int measuredFrames = 300)
+        {
+            this.posePath = posePath;
+            this.refreshMilliseconds = 1000.0 / refreshRate;
+            this.warmupFrames = warmupFrames;
+            this.measuredFrames = measuredFrames;
+
+            foreach (float scale in ResolutionScales)
+            {
+                foreach (int foveation in FoveationLevels)
+                {
+                    foreach (var stereoMode in StereoModes)
+                    {
+                        candidates.Add(new BenchmarkCandidate
+                        {
+                            ResolutionScale = scale,
+                            FoveationLevel = foveation,
+                            StereoMode = stereoMode,
+                            FrameTimes = new double[measuredFrames]
+                        });
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// Pose to feed the game instead of live tracking; every candidate replays the path from its start
+        /// </summary>
+        public HeadPose CurrentPose()
+        {
+            return posePath.Sample((float)replayClock.Elapsed.TotalSeconds);
+        }
+
+        /// <summary>
+        /// Called from the present hook with the time since the previous present
+        /// </summary>
+        public void RecordFrame(double frameMilliseconds)
+        {
+            var candidate = Volatile.Read(ref current);
+            if (candidate == null) return;
+
+            // Let the game settle after a settings change before measuring
+            if (Interlocked.Increment(ref framesSeen) <= warmupFrames) return;
+
+            int slot = candidate.FrameCount;
+            if (slot < candidate.FrameTimes.Length)
+            {
+                candidate.FrameTimes[slot] = frameMilliseconds;
+                Volatile.Write(ref candidate.FrameCount, slot + 1);
+            }
+        }
+
+        /// <summary>
+        /// Called once per game update. Moves on to the next candidate once the current one has enough frames and
+        /// writes it into the settings; returns true whenever the settings were changed and need re-applying.
+        /// </summary>
+        public bool Advance(RenderSettings settings)
+        {
+            if (IsComplete) return false;
+
+            if (current != null && Volatile.Read(ref current.FrameCount) < measuredFrames) return false;
+
+            if (current != null) Score(current);
+
+            if (++currentIndex < candidates.Count)
+            {
+                var next = candidates[currentIndex];
+                settings.ResolutionScale = next.ResolutionScale;
+                settings.FoveationLevel = next.FoveationLevel;
+                settings.StereoMode = next.StereoMode;
+
+                Volatile.Write(ref framesSeen, 0);
+                Volatile.Write(ref current, next);
+                replayClock.Restart();
+                return true;
+            }
+
+            Volatile.Write(ref current, null);
+            replayClock.Stop();
+            Best = ChooseBest();
+            settings.ResolutionScale = Best.ResolutionScale;
+            settings.FoveationLevel = Best.FoveationLevel;
+            settings.StereoMode = Best.StereoMode;
+            IsComplete = true;
+            return true;
+        }
+
+        private void Score(BenchmarkCandidate candidate)
+        {
+            var times = new double[candidate.FrameCount];
+            Array.Copy(candidate.FrameTimes, times, times.Length);
+            Array.Sort(times);
+
+            double sum = 0;
+            foreach (double t in times) sum += t;
+
+            candidate.MeanMilliseconds = sum / Math.Max(1, times.Length);
+            candidate.P95Milliseconds = times.Length == 0 ? double.MaxValue : times[(int)((times.Length - 1) * 0.95)];
+            // Small tolerance so vsync-locked frames that land exactly on the interval still count
+            candidate.HoldsRefreshRate = candidate.P95Milliseconds <= refreshMilliseconds * 1.05;
+        }
+
+        private BenchmarkCandidate ChooseBest()
+        {
+            BenchmarkCandidate best = null;
+            foreach (var candidate in candidates)
+            {
+                if (best == null || IsBetter(candidate, best)) best = candidate;
+            }
+            return best;
+        }
+
+        private static bool IsBetter(BenchmarkCandidate a, BenchmarkCandidate b)
+        {
+            // Nothing holds refresh: just take the fastest
+            if (a.HoldsRefreshRate != b.HoldsRefreshRate) return a.HoldsRefreshRate;
+            if (!a.HoldsRefreshRate) return a.P95Milliseconds < b.P95Milliseconds;
+
+            // Among those that hold refresh: sharpest image first, then least foveation, then fastest
+            if (a.ResolutionScale != b.ResolutionScale) return a.ResolutionScale > b.ResolutionScale;
+            if (a.FoveationLevel != b.FoveationLevel) return a.FoveationLevel < b.FoveationLevel;
+            return a.P95Milliseconds < b.P95Milliseconds;
+        }
+    }
+}
@@ -0,0 +1,114 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Numerics;
+
+namespace VRGameConverter.Rendering
+{
+    /// <summary>
+    /// Timed sequence of head poses that can be replayed in place of live tracking.
+    /// Stored as CSV: seconds, position x/y/z, rotation x/y/z/w.
+    /// </summary>
+    public class PosePath
+    {
+        private readonly List<float> times = new List<float>();
+        private readonly List<Vector3> positions = new List<Vector3>();
+        private readonly List<Quaternion> rotations = new List<Quaternion>();
+
+        public int Count => times.Count;
+        public float Duration => times.Count == 0 ? 0 : times[times.Count - 1];
+
+        public void Add(float time, Vector3 position, Quaternion rotation)
+        {
+            if (times.Count > 0 && time < times[times.Count - 1])
+            {
+                throw new ArgumentException("Poses must be added in time order", nameof(time));
+            }
+
+            times.Add(time);
+            positions.Add(position);
+            rotations.Add(rotation);
+        }
+
+        /// <summary>
+        /// Pose at a time, interpolated between the recorded samples; loops past the end
+        /// </summary>
+        public HeadPose Sample(float time)
+        {
+            if (times.Count == 0) return new HeadPose { Position = Vector3.Zero, Rotation = Quaternion.Identity };
+
+            if (Duration > 0) time %= Duration;
+
+            int upper = times.BinarySearch(time);
+            if (upper < 0) upper = ~upper;
+            if (upper == 0 || upper >= times.Count)
+            {
+                int index = Math.Clamp(upper, 0, times.Count - 1);
+                return new HeadPose { Position = positions[index], Rotation = rotations[index] };
+            }
+
+            int lower = upper - 1;
+            float t = (time - times[lower]) / Math.Max(1e-6f, times[upper] - times[lower]);
+            return new HeadPose
+            {
+                Position = Vector3.Lerp(positions[lower], positions[upper], t),
+                Rotation = Quaternion.Slerp(rotations[lower], rotations[upper], t)
+            };
+        }
+
+        /// <summary>
+        /// Default benchmark path: a standing look-around that sweeps a full turn with some pitch,
+        /// so every direction of the scene gets rendered
+        /// </summary>
+        public static PosePath CreateLookAround(float seconds = 20.0f, float eyeHeight = 1.7f)
+        {
+            var path = new PosePath();
+            const int samples = 240;
+
+            for (int i = 0; i <= samples; i++)
+            {
+                float t = (float)i / samples;
+                float yaw = t * 2 * MathF.PI;
+                float pitch = 0.25f * MathF.Sin(t * 4 * MathF.PI);
+                path.Add(t * seconds, new Vector3(0, eyeHeight, 0), Quaternion.CreateFromYawPitchRoll(yaw, pitch, 0));
+            }
+
+            return path;
+        }
+
+        public static PosePath Load(string path)
+        {
+            var result = new PosePath();
+            foreach (string line in File.ReadLines(path))
+            {
+                if (string.IsNullOrWhiteSpace(line) || line.StartsWith("#")) continue;
+
+                var v = line.Split(',');
+                if (v.Length < 8)
+                {
+                    throw new InvalidDataException($"{path}: expected 8 values per line, got '{line}'");
+                }
+
+                float F(int i) => float.Parse(v[i], CultureInfo.InvariantCulture);
+                result.Add(F(0), new Vector3(F(1), F(2), F(3)), new Quaternion(F(4), F(5), F(6), F(7)));
+            }
+            return result;
+        }
+
+        public void Save(string path)
+        {
+            using (var writer = new StreamWriter(path))
+            {
+                writer.WriteLine("# seconds,px,py,pz,qx,qy,qz,qw");
+                for (int i = 0; i < times.Count; i++)
+                {
+                    Vector3 p = positions[i];
+                    Quaternion q = rotations[i];
+                    writer.WriteLine(string.Format(CultureInfo.InvariantCulture, "{0},{1},{2},{3},{4},{5},{6},{7}",
+                        times[i], p.X, p.Y, p.Z, q.X, q.Y, q.Z, q.W));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,255 @@
+using System;
+using System.Numerics;
+using VRGameConverter.Tracking;
+
+namespace VRGameConverter.Rendering
+{
+    /// <summary>
+    /// Work injected into the game's frame through the render hooks
+    /// </summary>
+    public interface IRenderPass
+    {
+        /// <summary>
+        /// Called from the scene-pass hook right before the game renders the given eye
+        /// </summary>
+        void Execute(IntPtr deviceContext, int eye);
+    }
+
+    /// <summary>
+    /// VR runtimes that can report the lens-occluded area of each eye (e.g. OpenVR's GetHiddenAreaMesh)
+    /// </summary>
+    public interface IHiddenAreaMeshProvider
+    {
+        string HeadsetModel { get; }
+        HiddenAreaMesh GetHiddenAreaMesh(int eye);
+    }
+
+    /// <summary>
+    /// Graphics-API specific writer that rasterizes a mesh into the bound depth/stencil buffer
+    /// (depth at the near plane, stencil ref 1) so the game's pixel shaders are rejected there
+    /// </summary>
+    public interface IStencilMaskWriter
+    {
+        void WriteMask(IntPtr deviceContext, int eye, HiddenAreaMesh mesh);
+    }
+
+    /// <summary>
+    /// Graphics-API specific viewport and scissor override, so the game renders into the top-left
+    /// width x height of its eye buffer; the compositor backend samples the same rectangle
+    /// </summary>
+    public interface IViewportWriter
+    {
+        void SetViewport(IntPtr deviceContext, int eye, int width, int height);
+    }
+
+    /// <summary>
+    /// Graphics-API specific variable-rate shading: binds a shading-rate image built from the pattern
+    /// </summary>
+    public interface IShadingRateWriter
+    {
+        void WriteShadingRate(IntPtr deviceContext, int eye, FoveationPattern pattern);
+    }
+
+    /// <summary>
+    /// Graphics-API specific copy of the game's depth buffer to the CPU, point-sampled to the requested size.
+    /// Should return the latest completed copy (staging ring) rather than stall on the current frame.
+    /// </summary>
+    public interface IDepthReadback
+    {
+        bool TryReadDepth(IntPtr swapChain, float[] destination, int width, int height);
+    }
+
+    /// <summary>
+    /// Graphics-API specific access to what space warp needs from the presented frame, point-sampled to the requested size
+    /// </summary>
+    public interface IMotionReadback
+    {
+        /// <summary>
+        /// The game's TAA velocity buffer as pixel motion since the previous frame (x, y interleaved);
+        /// false when the game's TAA inputs aren't hooked
+        /// </summary>
+        bool TryReadMotionVectors(IntPtr swapChain, float[] destination, int width, int height);
+
+        /// <summary>
+        /// The presented frame, point-sampled to the destination's size: what gets extrapolated, and the
+        /// optical-flow fallback's input
+        /// </summary>
+        bool TryReadColor(IntPtr swapChain, FrameImage destination);
+    }
+
+    /// <summary>
+    /// Graphics-API specific submit of a synthesized frame to the compositor in place of repeating the last
+    /// game frame; the frame is at space warp resolution and is scaled up by the sink
+    /// </summary>
+    public interface ISynthesizedFrameSink
+    {
+        void SubmitSynthesized(FrameImage frame, long displayTimestamp);
+    }
+
+    /// <summary>
+    /// Graphics-API specific patch of the view transform in the game's camera constant buffer
+    /// (the writer applies the per-eye offset)
+    /// </summary>
+    public interface ICameraConstantsWriter
+    {
+        void WriteViewPose(IntPtr deviceContext, int eye, Vector3 position, Quaternion rotation);
+    }
+
+    /// <summary>
+    /// Re-samples the head pose right before the scene pass and patches it into the camera constants,
+    /// replacing the older pose the camera hook used earlier in the frame
+    /// </summary>
+    public class LateLatchPass : IRenderPass
+    {
+        private readonly PoseLatch latch;
+        private readonly ICameraConstantsWriter writer;
+        private readonly Func<HeadPose, HeadPose> toCameraSpace;
+        private HeadPose cameraPose;
+
+        public LateLatchPass(PoseLatch latch, ICameraConstantsWriter writer, Func<HeadPose, HeadPose> toCameraSpace)
+        {
+            this.latch = latch;
+            this.writer = writer;
+            this.toCameraSpace = toCameraSpace;
+        }
+
+        public void Execute(IntPtr deviceContext, int eye)
+        {
+            // One latch per frame so both eyes (and the compositor) see the same pose. Alternate-eye frames
+            // only have one pass, which may be either eye, so "first pass since the last present" decides.
+            if (eye == 0 || !latch.HasUnsubmittedLatch)
+            {
+                cameraPose = toCameraSpace(latch.Latch().Pose);
+            }
+
+            writer?.WriteViewPose(deviceContext, eye, cameraPose.Position, cameraPose.Rotation);
+        }
+    }
+
+    /// <summary>
+    /// Shrinks the game's viewport to the tuned resolution scale times the adaptive one
+    /// </summary>
+    public class ResolutionScalePass : IRenderPass
+    {
+        private readonly IViewportWriter writer;
+
+        public int Width { get; }
+        public int Height { get; }
+
+        public ResolutionScalePass(IViewportWriter writer, RenderSettings settings)
+        {
+            this.writer = writer;
+            Width = settings.ScaledEyeWidth;
+            Height = settings.ScaledEyeHeight;
+        }
+
+        public void Execute(IntPtr deviceContext, int eye)
+        {
+            writer?.SetViewport(deviceContext, eye, Width, Height);
+        }
+    }
+
+    /// <summary>
+    /// Binds the fixed-foveation shading rates for each eye before the game's scene pass
+    /// </summary>
+    public class FoveationPass : IRenderPass
+    {
+        private readonly FoveationPattern[] patterns;
+        private readonly IShadingRateWriter writer;
+
+        public FoveationPass(int level, IShadingRateWriter writer)
+        {
+            this.writer = writer;
+            patterns = new[] { new FoveationPattern(0, level), new FoveationPattern(1, level) };
+        }
+
+        public void Execute(IntPtr deviceContext, int eye)
+        {
+            if (writer == null || eye < 0 || eye >= patterns.Length) return;
+
+            writer.WriteShadingRate(deviceContext, eye, patterns[eye]);
+        }
+    }
+
+    /// <summary>
+    /// Masks the lens-occluded corners of each eye buffer before the game's scene pass
+    /// </summary>
+    public class HiddenAreaMeshPass : IRenderPass
+    {
+        private readonly HiddenAreaMesh[] meshes;
+        private readonly IStencilMaskWriter writer;
+        private HiddenAreaCoverage[] viewportCoverage;
+
+        // Measured at the full eye-buffer size
+        public HiddenAreaCoverage[] Coverage { get; }
+        public long PixelsSavedTotal { get; private set; }
+
+        public HiddenAreaMeshPass(HiddenAreaMesh[] meshes, IStencilMaskWriter writer, int eyeWidth, int eyeHeight)
+        {
+            this.meshes = meshes;
+            this.writer = writer;
+
+            // Coverage only depends on the mesh and resolution, so measure it once up front
+            Coverage = new HiddenAreaCoverage[meshes.Length];
+            for (int eye = 0; eye < meshes.Length; eye++)
+            {
+                Coverage[eye] = HiddenAreaCoverage.Measure(meshes[eye], eyeWidth, eyeHeight);
+                Console.WriteLine($"Hidden-area mesh eye {eye}: {Coverage[eye]}");
+            }
+            viewportCoverage = Coverage;
+        }
+
+        /// <summary>
+        /// True when this pass was built for the same meshes, writer and eye-buffer size, so it can be kept
+        /// </summary>
+        public bool Matches(HiddenAreaMesh[] meshes, IStencilMaskWriter writer, int eyeWidth, int eyeHeight)
+        {
+            return this.meshes == meshes && this.writer == writer && Coverage.Length > 0 &&
+                Coverage[0].Width == eyeWidth && Coverage[0].Height == eyeHeight;
+        }
+
+        /// <summary>
+        /// The mask is drawn into the viewport the game renders to; rescale the savings to it
+        /// </summary>
+        public void SetViewport(int width, int height)
+        {
+            var scaled = new HiddenAreaCoverage[Coverage.Length];
+            for (int eye = 0; eye < Coverage.Length; eye++)
+            {
+                scaled[eye] = Coverage[eye].ScaledTo(width, height);
+            }
+            viewportCoverage = scaled;
+        }
+
+        public void Execute(IntPtr deviceContext, int eye)
+        {
+            if (writer == null || eye < 0 || eye >= meshes.Length) return;
+
+            writer.WriteMask(deviceContext, eye, meshes[eye]);
+            PixelsSavedTotal += viewportCoverage[eye].HiddenPixels;
+        }
+
+        /// <summary>
+        /// Meshes for the active headset: cached in the settings, else from the runtime, else the lens-ellipse fallback
+        /// </summary>
+        public static HiddenAreaMesh[] ResolveMeshes(RenderSettings settings, IHiddenAreaMeshProvider provider)
+        {
+            string headset = provider?.HeadsetModel ?? settings.ActiveHeadset ?? "Generic";
+
+            if (settings.HiddenAreaMeshCache.TryGetValue(headset, out var cached))
+            {
+                return cached;
+            }
+
+            var meshes = new HiddenAreaMesh[2];
+            for (int eye = 0; eye < 2; eye++)
+            {
+                meshes[eye] = provider?.GetHiddenAreaMesh(eye) ?? HiddenAreaMesh.CreateFromLensEllipse(eye);
+            }
+
+            settings.HiddenAreaMeshCache[headset] = meshes;
+            settings.ActiveHeadset = headset;
+            return meshes;
+        }
+    }
+}
@@ -0,0 +1,80 @@
+using System;
+using System.Collections.Generic;
+
+namespace VRGameConverter.Rendering
+{
+    /// <summary>
+    /// How the two eye views are produced from the game's single camera
+    /// </summary>
+    public enum StereoMode
+    {
+        AlternateEye,  // One eye per game frame (AER): half the cost, each eye updates at half rate
+        DualPass       // Both eyes every frame: full cost, no eye-to-eye latency
+    }
+
+    /// <summary>
+    /// Per-game rendering options for the eye buffers
+    /// </summary>
+    public class RenderSettings
+    {
+        // Per-eye render target size
+        public int EyeWidth { get; set; } = 2016;
+        public int EyeHeight { get; set; } = 2240;
+
+        // Tuned per game by the benchmark mode
+        public float ResolutionScale { get; set; } = 1.0f;
+        public int FoveationLevel { get; set; } = 0;  // 0 = off, 3 = most aggressive
+        public StereoMode StereoMode { get; set; } = StereoMode.DualPass;
+
+        // Runtime adaptation from the frame analyzer, on top of the tuned ResolutionScale
+        public bool AdaptiveQualityEnabled { get; set; } = true;
+        public float DynamicResolutionScale { get; set; } = 1.0f;
+        public float MinDynamicResolutionScale { get; set; } = 0.6f;
+
+        // Viewport the game renders into with both scales applied; even, so 2x2 shading-rate tiles
+        // and half-resolution effects stay aligned
+        public int ScaledEyeWidth => Math.Max(2, (int)(EyeWidth * EffectiveResolutionScale) & ~1);
+        public int ScaledEyeHeight => Math.Max(2, (int)(EyeHeight * EffectiveResolutionScale) & ~1);
+        private float EffectiveResolutionScale => Math.Clamp(ResolutionScale * DynamicResolutionScale, 0.1f, 1.0f);
+
+        // Optional recorded pose path (see PosePath) for the benchmark; a look-around is used when unset
+        public string BenchmarkPosePath { get; set; }
+
+        // Stencil out the lens-occluded corners before the game's scene pass
+        public bool HiddenAreaMeshEnabled { get; set; } = true;
+
+        // Hidden-area meshes per headset model ([0] = left eye, [1] = right eye), so the runtime
+        // only has to be asked once per headset
+        public Dictionary<string, HiddenAreaMesh[]> HiddenAreaMeshCache { get; set; } = new Dictionary<string, HiddenAreaMesh[]>();
+        public string ActiveHeadset { get; set; }
+
+        // Depth readback for controller pointing; a low resolution is plenty for ray marching
+        public bool DepthCaptureEnabled { get; set; } = true;
+        public int DepthCaptureWidth { get; set; } = 512;
+        public int DepthCaptureHeight { get; set; } = 512;
+
+        // The game camera's projection, needed to turn device depth back into distances
+        public float GameVerticalFovDegrees { get; set; } = 90.0f;
+        public float DepthNearPlane { get; set; } = 0.1f;
+        public float DepthFarPlane { get; set; } = 5000.0f;
+        public bool DepthReversedZ { get; set; } = true;
+
+        // Headset refresh rate the game is being presented at
+        public float HeadsetRefreshRate { get; set; } = 90.0f;
+
+        // Synthesize in-between frames when the game falls below the refresh rate
+        public bool SpaceWarpEnabled { get; set; } = true;
+        public int SpaceWarpWidth { get; set; } = 480;
+        public int SpaceWarpHeight { get; set; } = 270;
+        public int SpaceWarpBlockSize { get; set; } = 8;
+        public int SpaceWarpSearchRadius { get; set; } = 16;
+
+        /// <summary>
+        /// Copy for handing to the render thread; the hidden-area mesh cache stays shared
+        /// </summary>
+        public RenderSettings Clone()
+        {
+            return (RenderSettings)MemberwiseClone();
+        }
+    }
+}
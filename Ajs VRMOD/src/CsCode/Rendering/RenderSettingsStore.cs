@@ -0,0 +1,77 @@
+using System;
+using System.Globalization;
+using System.IO;
+using System.Text;
+
+namespace VRGameConverter.Rendering
+{
+    /// <summary>
+    /// The render settings the benchmark tunes, kept per game next to the other per-user data so the chosen
+    /// combination is used from the next launch on. Only the tuned fields are stored; everything else keeps
+    /// coming from the game's profile.
+    /// </summary>
+    public class RenderSettingsStore
+    {
+        private readonly string storePath;
+
+        public RenderSettingsStore(string gameName, string storePath = null)
+        {
+            this.storePath = storePath ?? Path.Combine(
+                Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData), "AjsVRMOD", $"render-settings-{gameName}.txt");
+        }
+
+        /// <summary>
+        /// Copy previously saved values into the settings; false when nothing has been saved for this game
+        /// </summary>
+        public bool Load(RenderSettings settings)
+        {
+            if (!File.Exists(storePath)) return false;
+
+            bool loaded = false;
+            foreach (var line in File.ReadLines(storePath))
+            {
+                var fields = line.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+                if (fields.Length != 2) continue;
+
+                switch (fields[0])
+                {
+                    case "ResolutionScale" when float.TryParse(fields[1], NumberStyles.Float, CultureInfo.InvariantCulture, out float scale):
+                        settings.ResolutionScale = scale;
+                        loaded = true;
+                        break;
+                    case "FoveationLevel" when int.TryParse(fields[1], NumberStyles.Integer, CultureInfo.InvariantCulture, out int level):
+                        settings.FoveationLevel = level;
+                        loaded = true;
+                        break;
+                    case "StereoMode" when Enum.TryParse(fields[1], out StereoMode mode):
+                        settings.StereoMode = mode;
+                        loaded = true;
+                        break;
+                }
+            }
+            return loaded;
+        }
+
+        public void Save(RenderSettings settings)
+        {
+            var text = new StringBuilder()
+                .Append("ResolutionScale ").AppendLine(settings.ResolutionScale.ToString("R", CultureInfo.InvariantCulture))
+                .Append("FoveationLevel ").AppendLine(settings.FoveationLevel.ToString(CultureInfo.InvariantCulture))
+                .Append("StereoMode ").AppendLine(settings.StereoMode.ToString());
+
+            try
+            {
+                Directory.CreateDirectory(Path.GetDirectoryName(storePath));
+
+                // Write aside and swap, so a crash mid-save never leaves a truncated file
+                string temporary = storePath + ".tmp";
+                File.WriteAllText(temporary, text.ToString());
+                File.Move(temporary, storePath, true);
+            }
+            catch (IOException ex)
+            {
+                Console.WriteLine($"Could not save render settings: {ex.Message}");
+            }
+        }
+    }
+}
@@ -0,0 +1,339 @@
+using System;
+using System.Collections.Generic;
+using System.Numerics;
+using System.Runtime.CompilerServices;
+
+namespace VRGameConverter.Rendering
+{
+    /// <summary>
+    /// Per-block screen motion between the two most recent game frames, in pixels per game frame
+    /// </summary>
+    public sealed class MotionVectorField
+    {
+        public int BlockSize { get; }
+        public int BlocksX { get; }
+        public int BlocksY { get; }
+        public Vector2[] Vectors { get; }
+
+        public MotionVectorField(int width, int height, int blockSize)
+        {
+            BlockSize = blockSize;
+            BlocksX = (width + blockSize - 1) / blockSize;
+            BlocksY = (height + blockSize - 1) / blockSize;
+            Vectors = new Vector2[BlocksX * BlocksY];
+        }
+
+        /// <summary>
+        /// Motion at a pixel, bilinearly interpolated between block centres
+        /// </summary>
+        public Vector2 Sample(float x, float y)
+        {
+            float fx = Math.Clamp(x / BlockSize - 0.5f, 0, BlocksX - 1);
+            float fy = Math.Clamp(y / BlockSize - 0.5f, 0, BlocksY - 1);
+            int x0 = (int)fx, y0 = (int)fy;
+            int x1 = Math.Min(x0 + 1, BlocksX - 1), y1 = Math.Min(y0 + 1, BlocksY - 1);
+            float tx = fx - x0, ty = fy - y0;
+
+            Vector2 top = Vector2.Lerp(Vectors[y0 * BlocksX + x0], Vectors[y0 * BlocksX + x1], tx);
+            Vector2 bottom = Vector2.Lerp(Vectors[y1 * BlocksX + x0], Vectors[y1 * BlocksX + x1], tx);
+            return Vector2.Lerp(top, bottom, ty);
+        }
+    }
+
+    /// <summary>
+    /// Synthesizes in-between frames when the game renders below the headset refresh rate. Motion comes from
+    /// the game's own TAA velocity buffer when it is hooked, otherwise from block-matching optical flow on luma.
+    /// The newest frame is then pushed further along that motion. Deterministic: the same inputs always give
+    /// bit-identical output, so recorded sequences can be replayed to check quality.
+    /// </summary>
+    public sealed class SpaceWarp
+    {
+        public int Width { get; }
+        public int Height { get; }
+        public int SearchRadius { get; }
+        public MotionVectorField Motion { get; }
+
+        // Whether the current field came from the game rather than optical flow
+        public bool UsingGameMotionVectors { get; private set; }
+
+        private float[] previousLuma;
+        private float[] currentLuma;
+        private bool hasPrevious = false;
+        private readonly Vector2[] lastVectors;
+
+        public SpaceWarp(int width, int height, int blockSize = 16, int searchRadius = 16)
+        {
+            Width = width;
+            Height = height;
+            SearchRadius = searchRadius;
+            Motion = new MotionVectorField(width, height, blockSize);
+
+            previousLuma = new float[width * height];
+            currentLuma = new float[width * height];
+            lastVectors = new Vector2[Motion.Vectors.Length];
+        }
+
+        /// <summary>
+        /// Use the game's per-pixel motion vectors (x, y interleaved, pixels since the previous frame)
+        /// </summary>
+        public void SubmitMotionVectors(ReadOnlySpan<float> perPixel)
+        {
+            int blockSize = Motion.BlockSize;
+            for (int by = 0; by < Motion.BlocksY; by++)
+            {
+                for (int bx = 0; bx < Motion.BlocksX; bx++)
+                {
+                    // Average over the block
+                    Vector2 sum = Vector2.Zero;
+                    int count = 0;
+                    int yEnd = Math.Min(Height, (by + 1) * blockSize), xEnd = Math.Min(Width, (bx + 1) * blockSize);
+                    for (int y = by * blockSize; y < yEnd; y++)
+                    {
+                        for (int x = bx * blockSize; x < xEnd; x++)
+                        {
+                            int i = (y * Width + x) * 2;
+                            sum += new Vector2(perPixel[i], perPixel[i + 1]);
+                            count++;
+                        }
+                    }
+                    Motion.Vectors[by * Motion.BlocksX + bx] = sum / count;
+                }
+            }
+
+            UsingGameMotionVectors = true;
+        }
+
+        /// <summary>
+        /// Optical-flow fallback: estimate motion from this frame's luma against the previous one
+        /// </summary>
+        public void SubmitLuma(ReadOnlySpan<float> luma)
+        {
+            (previousLuma, currentLuma) = (currentLuma, previousLuma);
+            luma.Slice(0, currentLuma.Length).CopyTo(currentLuma);
+            UsingGameMotionVectors = false;
+
+            if (!hasPrevious)
+            {
+                hasPrevious = true;
+                Array.Clear(Motion.Vectors, 0, Motion.Vectors.Length);
+                return;
+            }
+
+            EstimateFlow();
+        }
+
+        private void EstimateFlow()
+        {
+            int blocksX = Motion.BlocksX;
+            Array.Copy(Motion.Vectors, lastVectors, lastVectors.Length);
+
+            for (int by = 0; by < Motion.BlocksY; by++)
+            {
+                for (int bx = 0; bx < blocksX; bx++)
+                {
+                    // Start from the cheapest of the spatial and temporal predictors, then refine with a shrinking diamond
+                    Vector2 best = Vector2.Zero;
+                    float bestCost = BlockCost(bx, by, best);
+
+                    TryCandidate(bx, by, lastVectors[by * blocksX + bx], ref best, ref bestCost);
+                    if (bx > 0) TryCandidate(bx, by, Motion.Vectors[by * blocksX + bx - 1], ref best, ref bestCost);
+                    if (by > 0) TryCandidate(bx, by, Motion.Vectors[(by - 1) * blocksX + bx], ref best, ref bestCost);
+
+                    for (int step = Math.Max(1, SearchRadius / 4); step >= 1; step /= 2)
+                    {
+                        bool improved = true;
+                        while (improved)
+                        {
+                            improved = false;
+                            Vector2 center = best;
+                            improved |= TryCandidate(bx, by, center + new Vector2(step, 0), ref best, ref bestCost);
+                            improved |= TryCandidate(bx, by, center + new Vector2(-step, 0), ref best, ref bestCost);
+                            improved |= TryCandidate(bx, by, center + new Vector2(0, step), ref best, ref bestCost);
+                            improved |= TryCandidate(bx, by, center + new Vector2(0, -step), ref best, ref bestCost);
+                        }
+                    }
+
+                    Motion.Vectors[by * blocksX + bx] = best;
+                }
+            }
+        }
+
+        private bool TryCandidate(int bx, int by, Vector2 candidate, ref Vector2 best, ref float bestCost)
+        {
+            // Integer vectors within the search window only
+            candidate = new Vector2(MathF.Round(candidate.X), MathF.Round(candidate.Y));
+            if (Math.Abs(candidate.X) > SearchRadius || Math.Abs(candidate.Y) > SearchRadius) return false;
+
+            float cost = BlockCost(bx, by, candidate);
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                best = candidate;
+                return true;
+            }
+            return false;
+        }
+
+        /// <summary>
+        /// Sum of absolute differences between the block in the current frame and where it came from in the previous one,
+        /// plus a small penalty on vector length so flat areas settle on zero motion
+        /// </summary>
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        private float BlockCost(int bx, int by, Vector2 vector)
+        {
+            int blockSize = Motion.BlockSize;
+            int vx = (int)vector.X, vy = (int)vector.Y;
+            int yEnd = Math.Min(Height, (by + 1) * blockSize), xEnd = Math.Min(Width, (bx + 1) * blockSize);
+            float sad = 0;
+
+            for (int y = by * blockSize; y < yEnd; y++)
+            {
+                int sy = Math.Clamp(y - vy, 0, Height - 1);
+                for (int x = bx * blockSize; x < xEnd; x++)
+                {
+                    int sx = Math.Clamp(x - vx, 0, Width - 1);
+                    sad += Math.Abs(currentLuma[y * Width + x] - previousLuma[sy * Width + sx]);
+                }
+            }
+
+            return sad + 4.0f * (Math.Abs(vx) + Math.Abs(vy));
+        }
+
+        /// <summary>
+        /// Synthesize the frame a fraction t of a game frame after the newest one by continuing its motion
+        /// (t = 0.5 gives the in-between frame when the game runs at half the headset rate)
+        /// </summary>
+        public void Extrapolate(FrameImage source, FrameImage destination, float t)
+        {
+            Extrapolate(Motion, source, destination, t);
+        }
+
+        /// <summary>
+        /// Extrapolate with a copy of the motion field, so frames can be synthesized on another thread
+        /// while the next field is being estimated
+        /// </summary>
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        public static void Extrapolate(MotionVectorField motion, FrameImage source, FrameImage destination, float t)
+        {
+            int width = source.Width, height = source.Height;
+            if (destination.Width != width || destination.Height != height ||
+                motion.BlocksX != (width + motion.BlockSize - 1) / motion.BlockSize ||
+                motion.BlocksY != (height + motion.BlockSize - 1) / motion.BlockSize)
+            {
+                throw new ArgumentException($"Frames and motion field must all be {width}x{height}");
+            }
+
+            for (int y = 0; y < height; y++)
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    // Backward mapping: take the colour from where the content at this pixel was t frames ago
+                    Vector2 vector = motion.Sample(x + 0.5f, y + 0.5f);
+                    destination.Pixels[y * width + x] = SampleBilinear(source, x - vector.X * t, y - vector.Y * t);
+                }
+            }
+        }
+
+        private static uint SampleBilinear(FrameImage image, float x, float y)
+        {
+            x = Math.Clamp(x, 0, image.Width - 1);
+            y = Math.Clamp(y, 0, image.Height - 1);
+            int x0 = (int)x, y0 = (int)y;
+            int x1 = Math.Min(x0 + 1, image.Width - 1), y1 = Math.Min(y0 + 1, image.Height - 1);
+            float tx = x - x0, ty = y - y0;
+
+            uint p00 = image.Pixels[y0 * image.Width + x0], p10 = image.Pixels[y0 * image.Width + x1];
+            uint p01 = image.Pixels[y1 * image.Width + x0], p11 = image.Pixels[y1 * image.Width + x1];
+
+            uint result = 0xFF000000u;
+            for (int shift = 0; shift < 24; shift += 8)
+            {
+                float top = ((p00 >> shift) & 0xFF) * (1 - tx) + ((p10 >> shift) & 0xFF) * tx;
+                float bottom = ((p01 >> shift) & 0xFF) * (1 - tx) + ((p11 >> shift) & 0xFF) * tx;
+                result |= (uint)(top * (1 - ty) + bottom * ty + 0.5f) << shift;
+            }
+            return result;
+        }
+
+        /// <summary>
+        /// Offline check against a recorded full-rate sequence: every other frame is dropped, re-synthesized from the
+        /// frames before it, and compared with the real one. Repeating the last frame is the baseline being beaten.
+        /// </summary>
+        public static SpaceWarpReport ValidateSequence(IReadOnlyList<string> framePaths, int blockSize = 16, int searchRadius = 16)
+        {
+            if (framePaths.Count < 4)
+            {
+                throw new ArgumentException("Need at least four frames to validate", nameof(framePaths));
+            }
+
+            var first = FrameImage.ReadPpm(framePaths[0]);
+            var warp = new SpaceWarp(first.Width, first.Height, blockSize, searchRadius);
+            var luma = new float[first.Width * first.Height];
+            var synthesized = new FrameImage(first.Width, first.Height);
+            var report = new SpaceWarpReport();
+
+            // Game frames are the even indices; the motion between two of them spans two headset frames
+            first.ToLuma(luma);
+            warp.SubmitLuma(luma);
+
+            for (int i = 2; i + 1 < framePaths.Count; i += 2)
+            {
+                var gameFrame = FrameImage.ReadPpm(framePaths[i]);
+                var actual = FrameImage.ReadPpm(framePaths[i + 1]);
+
+                gameFrame.ToLuma(luma);
+                warp.SubmitLuma(luma);
+                warp.Extrapolate(gameFrame, synthesized, 0.5f);
+
+                report.Add(Psnr(synthesized, actual), Psnr(gameFrame, actual));
+            }
+
+            Console.WriteLine($"Space warp on {framePaths.Count} frames: {report}");
+            return report;
+        }
+
+        public static double Psnr(FrameImage a, FrameImage b)
+        {
+            double sumSquared = 0;
+            for (int i = 0; i < a.Pixels.Length; i++)
+            {
+                for (int shift = 0; shift < 24; shift += 8)
+                {
+                    int d = (int)((a.Pixels[i] >> shift) & 0xFF) - (int)((b.Pixels[i] >> shift) & 0xFF);
+                    sumSquared += d * d;
+                }
+            }
+
+            double mse = sumSquared / (a.Pixels.Length * 3.0);
+            return mse == 0 ? double.PositiveInfinity : 10 * Math.Log10(255.0 * 255.0 / mse);
+        }
+    }
+
+    /// <summary>
+    /// Quality of synthesized frames against the real ones, versus simply repeating the previous frame
+    /// </summary>
+    public class SpaceWarpReport
+    {
+        public int Frames { get; private set; }
+        public double MeanPsnr { get; private set; }
+        public double MeanRepeatPsnr { get; private set; }
+        public double WorstPsnr { get; private set; } = double.PositiveInfinity;
+
+        public void Add(double psnr, double repeatPsnr)
+        {
+            // Identical frames give infinite PSNR; cap so the means stay finite
+            psnr = Math.Min(psnr, 100);
+            repeatPsnr = Math.Min(repeatPsnr, 100);
+
+            Frames++;
+            MeanPsnr += (psnr - MeanPsnr) / Frames;
+            MeanRepeatPsnr += (repeatPsnr - MeanRepeatPsnr) / Frames;
+            WorstPsnr = Math.Min(WorstPsnr, psnr);
+        }
+
+        public override string ToString()
+        {
+            return $"{Frames} synthesized frames, mean PSNR {MeanPsnr:F2} dB (worst {WorstPsnr:F2}) vs {MeanRepeatPsnr:F2} dB repeating frames";
+        }
+    }
+}
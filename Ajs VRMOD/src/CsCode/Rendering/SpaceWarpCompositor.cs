@@ -0,0 +1,80 @@
+using System;
+using System.Diagnostics;
+using System.Threading;
+using VRGameConverter.Tracking;
+
+namespace VRGameConverter.Rendering
+{
+    /// <summary>
+    /// Headset-rate consumer of a SpaceWarpPipeline: wakes a frame ahead of every display time and, while the
+    /// pipeline is Active, sends the sink a frame extrapolated to that time. Follows the runtime's display
+    /// times when it has them, else paces itself at the refresh rate.
+    /// </summary>
+    public sealed class SpaceWarpCompositor : IDisposable
+    {
+        private readonly SpaceWarpPipeline pipeline;
+        private readonly ISynthesizedFrameSink sink;
+        private readonly IDisplayTimeSource displayTimes;
+        private readonly long fallbackPeriodTicks;
+
+        private readonly Thread thread;
+        private volatile bool running = true;
+        private long framesSynthesized;
+
+        public long FramesSynthesized => Interlocked.Read(ref framesSynthesized);
+
+        public SpaceWarpCompositor(SpaceWarpPipeline pipeline, ISynthesizedFrameSink sink, IDisplayTimeSource displayTimes, double refreshRate)
+        {
+            this.pipeline = pipeline;
+            this.sink = sink;
+            this.displayTimes = displayTimes;
+            fallbackPeriodTicks = (long)(Stopwatch.Frequency / refreshRate);
+
+            thread = new Thread(Run)
+            {
+                Name = "Space warp compositor",
+                IsBackground = true
+            };
+            thread.Start();
+        }
+
+        private void Run()
+        {
+            var output = new FrameImage(pipeline.Width, pipeline.Height);
+            long lastDisplay = 0;
+
+            while (running)
+            {
+                if (displayTimes == null || !displayTimes.TryGetPredictedDisplayTime(out long display, out long period))
+                {
+                    period = fallbackPeriodTicks;
+                    display = lastDisplay != 0 ? lastDisplay + period : Stopwatch.GetTimestamp() + period;
+                }
+
+                // The runtime hasn't moved on to the next frame yet
+                if (display <= lastDisplay)
+                {
+                    Thread.Sleep(1);
+                    continue;
+                }
+
+                long wakeAt = display - period;
+                int sleepMilliseconds = (int)((wakeAt - Stopwatch.GetTimestamp()) * 1000 / Stopwatch.Frequency);
+                if (sleepMilliseconds > 0) Thread.Sleep(sleepMilliseconds);
+                lastDisplay = display;
+
+                if (pipeline.Active && pipeline.TrySynthesize(display, output))
+                {
+                    sink.SubmitSynthesized(output, display);
+                    Interlocked.Increment(ref framesSynthesized);
+                }
+            }
+        }
+
+        public void Dispose()
+        {
+            running = false;
+            thread.Join();
+        }
+    }
+}
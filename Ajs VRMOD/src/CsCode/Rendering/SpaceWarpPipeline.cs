@@ -0,0 +1,192 @@
+using System;
+using System.Diagnostics;
+using System.Threading;
+
+namespace VRGameConverter.Rendering
+{
+    /// <summary>
+    /// Runs space warp across three threads. The present hook copies the game's motion vectors (when its TAA
+    /// inputs are hooked) and colour into a capture and moves on; a worker turns each capture into a motion field,
+    /// keeping the optical-flow history from frame to frame; and the compositor (SpaceWarpCompositor) extrapolates
+    /// the newest game frame to each headset frame's display time. Each hand-off is a three-slot buffer, so no
+    /// side ever waits on another.
+    /// </summary>
+    public sealed class SpaceWarpPipeline : IDisposable
+    {
+        public int Width { get; }
+        public int Height { get; }
+        public int BlockSize { get; }
+        public int SearchRadius { get; }
+
+        // Set by the present hook when the game falls behind the headset; synthesized frames are only sent while set
+        public bool Active
+        {
+            get => active;
+            set => active = value;
+        }
+
+        public double LastEstimateMilliseconds { get; private set; }
+        public double LastSynthesisMilliseconds { get; private set; }
+        public long FramesEstimated => Interlocked.Read(ref framesEstimated);
+
+        private const int FreshBit = 4;
+
+        private sealed class Capture
+        {
+            public float[] MotionVectors;
+            public bool HasMotionVectors;
+            public FrameImage Color;
+            public long PresentTimestamp;
+        }
+
+        private sealed class WarpFrame
+        {
+            public MotionVectorField Motion;
+            public FrameImage Color;
+            public long PresentTimestamp;
+            public long FramePeriodTicks;
+        }
+
+        // Present hook -> worker: the hook owns captureWrite, the worker captureRead
+        private readonly Capture[] captures = new Capture[3];
+        private int captureWrite = 0;
+        private int capturePending = 1;
+        private int captureRead = 2;
+
+        // Worker -> compositor, same scheme
+        private readonly WarpFrame[] frames = new WarpFrame[3];
+        private int frameWrite = 0;
+        private int framePending = 1;
+        private int frameRead = 2;
+        private bool hasFrame = false;
+
+        // Worker only: the estimator and its history survive as long as the pipeline does
+        private readonly SpaceWarp warp;
+        private readonly float[] luma;
+        private long lastPresentTimestamp = 0;
+
+        private readonly AutoResetEvent captured = new AutoResetEvent(false);
+        private readonly Thread worker;
+        private volatile bool active;
+        private volatile bool running = true;
+        private long framesEstimated;
+
+        public SpaceWarpPipeline(int width, int height, int blockSize, int searchRadius)
+        {
+            Width = width;
+            Height = height;
+            BlockSize = blockSize;
+            SearchRadius = searchRadius;
+
+            warp = new SpaceWarp(width, height, blockSize, searchRadius);
+            luma = new float[width * height];
+
+            for (int i = 0; i < 3; i++)
+            {
+                captures[i] = new Capture { MotionVectors = new float[width * height * 2], Color = new FrameImage(width, height) };
+                frames[i] = new WarpFrame { Motion = new MotionVectorField(width, height, blockSize), Color = new FrameImage(width, height) };
+            }
+
+            worker = new Thread(Run)
+            {
+                Name = "Space warp flow",
+                IsBackground = true
+            };
+            worker.Start();
+        }
+
+        /// <summary>
+        /// Present hook: where the game's motion vectors go (x, y interleaved, pixels since the previous frame)
+        /// </summary>
+        public float[] MotionVectorBuffer => captures[captureWrite].MotionVectors;
+
+        /// <summary>
+        /// Present hook: where the presented colour goes, at the pipeline's resolution
+        /// </summary>
+        public FrameImage ColorBuffer => captures[captureWrite].Color;
+
+        /// <summary>
+        /// Present hook: hand over the filled buffers. Without motion vectors the worker estimates flow from the colour.
+        /// </summary>
+        public void Submit(bool hasMotionVectors, long presentTimestamp)
+        {
+            var capture = captures[captureWrite];
+            capture.HasMotionVectors = hasMotionVectors;
+            capture.PresentTimestamp = presentTimestamp;
+
+            captureWrite = Interlocked.Exchange(ref capturePending, captureWrite | FreshBit) & ~FreshBit;
+            captured.Set();
+        }
+
+        private void Run()
+        {
+            while (running)
+            {
+                captured.WaitOne();
+
+                if ((Volatile.Read(ref capturePending) & FreshBit) == 0) continue;
+                captureRead = Interlocked.Exchange(ref capturePending, captureRead) & ~FreshBit;
+                var capture = captures[captureRead];
+
+                long start = Stopwatch.GetTimestamp();
+                if (capture.HasMotionVectors)
+                {
+                    warp.SubmitMotionVectors(capture.MotionVectors);
+                }
+                else
+                {
+                    capture.Color.ToLuma(luma);
+                    warp.SubmitLuma(luma);
+                }
+                LastEstimateMilliseconds = (Stopwatch.GetTimestamp() - start) * 1000.0 / Stopwatch.Frequency;
+
+                var frame = frames[frameWrite];
+                Array.Copy(warp.Motion.Vectors, frame.Motion.Vectors, frame.Motion.Vectors.Length);
+                Array.Copy(capture.Color.Pixels, frame.Color.Pixels, frame.Color.Pixels.Length);
+                frame.PresentTimestamp = capture.PresentTimestamp;
+                frame.FramePeriodTicks = lastPresentTimestamp != 0 ? capture.PresentTimestamp - lastPresentTimestamp : 0;
+                lastPresentTimestamp = capture.PresentTimestamp;
+
+                frameWrite = Interlocked.Exchange(ref framePending, frameWrite | FreshBit) & ~FreshBit;
+                Interlocked.Increment(ref framesEstimated);
+            }
+        }
+
+        /// <summary>
+        /// Compositor side: extrapolate the newest game frame to the given display time. False when there is
+        /// nothing to synthesize from yet or the game frame is still current (the compositor shows it as is).
+        /// Must only be called from one thread.
+        /// </summary>
+        public bool TrySynthesize(long displayTimestamp, FrameImage destination)
+        {
+            if ((Volatile.Read(ref framePending) & FreshBit) != 0)
+            {
+                frameRead = Interlocked.Exchange(ref framePending, frameRead) & ~FreshBit;
+                hasFrame = true;
+            }
+
+            var frame = frames[frameRead];
+            if (!hasFrame || frame.FramePeriodTicks <= 0) return false;
+
+            // Motion is per game frame; never push content further than one frame ahead
+            float t = (float)(displayTimestamp - frame.PresentTimestamp) / frame.FramePeriodTicks;
+            if (t <= 0.05f) return false;
+            t = Math.Min(t, 1.0f);
+
+            long start = Stopwatch.GetTimestamp();
+            SpaceWarp.Extrapolate(frame.Motion, frame.Color, destination, t);
+            LastSynthesisMilliseconds = (Stopwatch.GetTimestamp() - start) * 1000.0 / Stopwatch.Frequency;
+            return true;
+        }
+
+        public void Dispose()
+        {
+            running = false;
+            captured.Set();
+            worker.Join();
+
+            // The event is left to the finalizer: a present that fetched this instance just before it was
+            // replaced may still submit to it
+        }
+    }
+}
@@ -0,0 +1,144 @@
+using System;
+using System.Diagnostics;
+using System.Globalization;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using System.Threading;
+
+namespace VRGameConverter.Scheduling
+{
+    /// <summary>
+    /// First-call, tier-0 and tiered-up cost of one warmed-up path
+    /// </summary>
+    public struct WarmupTiming
+    {
+        public string Name;
+        public double FirstMicroseconds;
+        public double Tier0Microseconds;   // Right after the first burst of calls, before any promotion
+        public double SteadyMicroseconds;  // After the last tier-up round
+        public int Rounds;
+
+        public override string ToString()
+        {
+            return $"{Name}: first {FirstMicroseconds:F1} us, tier 0 {Tier0Microseconds:F1} us, " +
+                $"steady {SteadyMicroseconds:F1} us after {Rounds} rounds";
+        }
+    }
+
+    /// <summary>
+    /// Runs hot paths before the game needs them, so JIT compilation and cold caches are paid for during loading
+    /// instead of as hitches in the first frames. Methods are compiled up front with PrepareMethod, which gives
+    /// tier-0 code (fully optimized only for AggressiveOptimization methods, which is why the per-frame hook
+    /// bodies carry it). Everything they call is promoted by tiered compilation, and the runtime only starts
+    /// counting calls once no new method has been compiled for its tiering delay, so the paths are exercised in
+    /// rounds separated by that delay until another round no longer makes them faster.
+    /// </summary>
+    public static class HotPathWarmup
+    {
+        // Calls after which call counting promotes a method (the runtime's threshold is 30)
+        public const int TierUpCalls = 32;
+
+        // How long the runtime waits without new tier-0 compiles before it starts counting calls: 100 ms unless
+        // DOTNET_TC_CallCountingDelayMs says otherwise, and ten times that on a single processor
+        public static int TieringDelayMilliseconds { get; } = ReadTieringDelay();
+
+        // Instrumented tiering (PGO) takes two promotions; a third round confirms nothing is left
+        public const int MaxRounds = 4;
+
+        private const BindingFlags AllDeclared =
+            BindingFlags.Public | BindingFlags.NonPublic | BindingFlags.Instance | BindingFlags.Static | BindingFlags.DeclaredOnly;
+
+        /// <summary>
+        /// JIT every concrete method and constructor declared on the type, including private hook bodies that
+        /// would otherwise first compile on the game's thread. Returns how many were prepared.
+        /// </summary>
+        public static int PrepareType(Type type)
+        {
+            if (type.ContainsGenericParameters) return 0;
+
+            int prepared = 0;
+            foreach (MethodBase method in type.GetMethods(AllDeclared))
+            {
+                prepared += Prepare(method) ? 1 : 0;
+            }
+            foreach (MethodBase constructor in type.GetConstructors(AllDeclared))
+            {
+                prepared += Prepare(constructor) ? 1 : 0;
+            }
+            foreach (var nested in type.GetNestedTypes(BindingFlags.Public | BindingFlags.NonPublic))
+            {
+                prepared += PrepareType(nested);
+            }
+            return prepared;
+        }
+
+        private static bool Prepare(MethodBase method)
+        {
+            if (method.IsAbstract || method.ContainsGenericParameters) return false;
+            if ((method.Attributes & MethodAttributes.PinvokeImpl) != 0) return false;
+
+            try
+            {
+                RuntimeHelpers.PrepareMethod(method.MethodHandle);
+                return true;
+            }
+            catch (ArgumentException)
+            {
+                // Runtime-implemented methods (delegate Invoke and friends) can't be prepared
+                return false;
+            }
+        }
+
+        /// <summary>
+        /// Run a path until tiered compilation has promoted it, timing the first call, the tier-0 code and the
+        /// final code. Blocks for a few tiering delays per path, so only call it while the game is loading.
+        /// </summary>
+        public static WarmupTiming Run(string name, Action iteration, int maxRounds = MaxRounds)
+        {
+            var timing = new WarmupTiming { Name = name, FirstMicroseconds = Measure(iteration, 1) };
+
+            // These calls fall inside the delay that compiling this path just started, so they don't count
+            Measure(iteration, TierUpCalls);
+            timing.Tier0Microseconds = Measure(iteration, 8);
+            timing.SteadyMicroseconds = timing.Tier0Microseconds;
+
+            // A quiet gap a little longer than the delay lets counting start; the same gap after the calls
+            // covers the background compile
+            int gap = TieringDelayMilliseconds * 3 / 2;
+            for (int round = 1; round <= maxRounds; round++)
+            {
+                Thread.Sleep(gap);
+                Measure(iteration, TierUpCalls);
+                Thread.Sleep(gap);
+
+                double steady = Measure(iteration, 8);
+                timing.Rounds = round;
+
+                bool improved = steady < timing.SteadyMicroseconds * 0.95;
+                timing.SteadyMicroseconds = Math.Min(timing.SteadyMicroseconds, steady);
+                if (!improved && round > 1) break;
+            }
+
+            return timing;
+        }
+
+        private static int ReadTieringDelay()
+        {
+            // Hex, like every runtime DWORD setting
+            string configured = Environment.GetEnvironmentVariable("DOTNET_TC_CallCountingDelayMs");
+            if (configured != null && configured.StartsWith("0x", StringComparison.OrdinalIgnoreCase)) configured = configured.Substring(2);
+            int delay = int.TryParse(configured, NumberStyles.HexNumber, CultureInfo.InvariantCulture, out int parsed) ? parsed : 100;
+            return Environment.ProcessorCount == 1 ? delay * 10 : delay;
+        }
+
+        private static double Measure(Action iteration, int calls)
+        {
+            long start = Stopwatch.GetTimestamp();
+            for (int i = 0; i < calls; i++)
+            {
+                iteration();
+            }
+            return (Stopwatch.GetTimestamp() - start) * 1e6 / Stopwatch.Frequency / calls;
+        }
+    }
+}
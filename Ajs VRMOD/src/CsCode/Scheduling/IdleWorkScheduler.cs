@@ -0,0 +1,232 @@
+using System;
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using System.Runtime;
+using System.Threading;
+
+namespace VRGameConverter.Scheduling
+{
+    /// <summary>
+    /// How sensitive the current game state is to frame hitches
+    /// </summary>
+    public enum GameActivityState
+    {
+        Gameplay,   // Every frame counts, no maintenance allowed
+        Menu,       // Pause/map/inventory menus
+        Loading     // Loading screens or the simulation is not ticking
+    }
+
+    /// <summary>
+    /// Defers expensive maintenance (cache flushes, index builds, GC, profile saves) to loading screens and menus.
+    /// While the player is in gameplay the managed runtime is kept in low-latency / no-GC mode.
+    /// The VR thread only detects the activity state; the work itself and every GC mode change (including
+    /// the blocking collection that arms the no-GC region) run on a background worker outside gameplay.
+    /// </summary>
+    public class IdleWorkScheduler
+    {
+        public static IdleWorkScheduler Shared { get; } = new IdleWorkScheduler();
+
+        // Time without a gameplay tick (camera update) before we treat the game as loading
+        public TimeSpan LoadingDetectionDelay { get; set; } = TimeSpan.FromMilliseconds(500);
+
+        // Allocation budget for the no-GC region held during gameplay
+        public long NoGCRegionBytes { get; set; } = 64 * 1024 * 1024;
+
+        public GameActivityState State => state;
+
+        private readonly ConcurrentQueue<IdleWorkItem> queue = new ConcurrentQueue<IdleWorkItem>();
+        private readonly AutoResetEvent wake = new AutoResetEvent(false);
+        private readonly Thread worker;
+        private long lastGameplayTick = Stopwatch.GetTimestamp();
+        private volatile GameActivityState state = GameActivityState.Loading;
+        private volatile bool menuOpen = false;
+        private volatile bool loadingScreen = false;
+
+        // Owned by the worker thread
+        private bool lowLatency = false;
+        private bool noGCArmed = false;
+        private bool noGCAttempted = false;
+        private bool gcDeferred = false;
+
+        // The worker also wakes on its own, to re-arm the region after menu work
+        private static readonly TimeSpan WorkerPollInterval = TimeSpan.FromMilliseconds(250);
+
+        private class IdleWorkItem
+        {
+            public string Name;
+            public Action Work;
+        }
+
+        public IdleWorkScheduler()
+        {
+            worker = new Thread(RunWorker)
+            {
+                Name = "Idle work",
+                IsBackground = true,
+                Priority = ThreadPriority.BelowNormal
+            };
+            worker.Start();
+        }
+
+        /// <summary>
+        /// Queue work that must never run during gameplay frames. Safe to call from any thread.
+        /// </summary>
+        public void Enqueue(string name, Action work)
+        {
+            queue.Enqueue(new IdleWorkItem { Name = name, Work = work });
+            if (state != GameActivityState.Gameplay) wake.Set();
+        }
+
+        public int PendingCount => queue.Count;
+
+        /// <summary>
+        /// Called from gameplay-only hooks (camera update) to show the simulation is ticking
+        /// </summary>
+        public void NotifyGameplayTick()
+        {
+            Interlocked.Exchange(ref lastGameplayTick, Stopwatch.GetTimestamp());
+        }
+
+        public void SetMenuOpen(bool open)
+        {
+            menuOpen = open;
+        }
+
+        public void SetLoadingScreen(bool loading)
+        {
+            loadingScreen = loading;
+        }
+
+        /// <summary>
+        /// Called once per VR frame after all subsystems have updated. Only hands state changes to the worker.
+        /// </summary>
+        public void OnFrame()
+        {
+            var newState = DetectState();
+            if (newState != state)
+            {
+                Console.WriteLine($"Activity state: {state} -> {newState} ({queue.Count} idle work items pending)");
+                state = newState;
+                wake.Set();
+            }
+        }
+
+        private GameActivityState DetectState()
+        {
+            if (loadingScreen) return GameActivityState.Loading;
+            if (menuOpen) return GameActivityState.Menu;
+
+            long sinceTick = Stopwatch.GetTimestamp() - Interlocked.Read(ref lastGameplayTick);
+            if (sinceTick > LoadingDetectionDelay.TotalSeconds * Stopwatch.Frequency)
+            {
+                return GameActivityState.Loading;
+            }
+
+            return GameActivityState.Gameplay;
+        }
+
+        private void RunWorker()
+        {
+            while (true)
+            {
+                wake.WaitOne(WorkerPollInterval);
+
+                if (state == GameActivityState.Gameplay)
+                {
+                    if (!lowLatency) EnterLowLatencyMode();
+                    continue;
+                }
+
+                if (lowLatency) ExitLowLatencyMode();
+                Drain();
+
+                // Pay for the no-GC region's blocking collection now, while a hitch can't be seen
+                if (!noGCAttempted && NoGCRegionBytes > 0 && queue.IsEmpty && state != GameActivityState.Gameplay)
+                {
+                    ArmNoGCRegion();
+                }
+            }
+        }
+
+        private void EnterLowLatencyMode()
+        {
+            // Already NoGCRegion when the worker armed it during the loading screen; the runtime ignores the change then
+            GCSettings.LatencyMode = GCLatencyMode.SustainedLowLatency;
+            lowLatency = true;
+            gcDeferred = true;
+        }
+
+        private void ExitLowLatencyMode()
+        {
+            DisarmNoGCRegion();
+            GCSettings.LatencyMode = GCLatencyMode.Interactive;
+            lowLatency = false;
+            noGCAttempted = false;
+
+            // Collect whatever gameplay allocated while we have the time
+            if (gcDeferred)
+            {
+                gcDeferred = false;
+                Enqueue("Deferred GC", () => GC.Collect(GC.MaxGeneration, GCCollectionMode.Optimized, blocking: true, compacting: true));
+            }
+        }
+
+        private void ArmNoGCRegion()
+        {
+            // One attempt per idle stretch: a failed attempt still costs a full blocking collection
+            noGCAttempted = true;
+            try
+            {
+                // Fails if the runtime can't reserve the budget; sustained low latency still applies
+                noGCArmed = GC.TryStartNoGCRegion(NoGCRegionBytes);
+            }
+            catch (ArgumentOutOfRangeException)
+            {
+                Console.WriteLine($"No-GC region of {NoGCRegionBytes} bytes exceeds the ephemeral segment, using low-latency GC only");
+                NoGCRegionBytes = 0;
+            }
+            catch (InvalidOperationException)
+            {
+                // Someone else already holds a region
+            }
+        }
+
+        private void DisarmNoGCRegion()
+        {
+            if (!noGCArmed) return;
+            noGCArmed = false;
+            noGCAttempted = false;
+
+            if (GCSettings.LatencyMode == GCLatencyMode.NoGCRegion)
+            {
+                try
+                {
+                    GC.EndNoGCRegion();
+                }
+                catch (InvalidOperationException)
+                {
+                    // The region was ended by the runtime after the budget was exceeded
+                }
+            }
+        }
+
+        private void Drain()
+        {
+            // Re-check the state between items so gameplay never waits on more than the item in flight
+            while (state != GameActivityState.Gameplay && queue.TryDequeue(out var item))
+            {
+                // Work may allocate freely and the deferred GC would end the region anyway
+                DisarmNoGCRegion();
+
+                try
+                {
+                    item.Work();
+                }
+                catch (Exception ex)
+                {
+                    Console.WriteLine($"Idle work '{item.Name}' failed: {ex.Message}");
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,494 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Threading;
+
+namespace VRGameConverter.Scheduling
+{
+    /// <summary>
+    /// One hardware thread as the OS numbers it
+    /// </summary>
+    public struct LogicalProcessor
+    {
+        public int Id;              // Windows: group * 64 + bit; Linux: cpu number
+        public int Core;            // Physical core; SMT siblings share it
+        public bool Efficiency;     // E-core on hybrid parts
+        public bool IsSmtSibling;   // Second (or later) hardware thread of its core
+    }
+
+    /// <summary>
+    /// Logical processors with their physical cores, core types and SMT siblings
+    /// </summary>
+    public sealed class CpuTopology
+    {
+        public IReadOnlyList<LogicalProcessor> Processors { get; }
+        public bool IsHybrid => Processors.Any(p => p.Efficiency);
+        public bool HasSmt => Processors.Any(p => p.IsSmtSibling);
+        public int PhysicalCores => Processors.Select(p => p.Core).Distinct().Count();
+
+        public CpuTopology(IReadOnlyList<LogicalProcessor> processors)
+        {
+            Processors = processors;
+        }
+
+        public override string ToString()
+        {
+            int efficiency = Processors.Where(p => p.Efficiency).Select(p => p.Core).Distinct().Count();
+            return $"{Processors.Count} logical on {PhysicalCores} cores ({PhysicalCores - efficiency}P + {efficiency}E), SMT {(HasSmt ? "on" : "off")}";
+        }
+
+        public static CpuTopology Detect()
+        {
+            List<LogicalProcessor> processors = null;
+            try
+            {
+                processors = RuntimeInformation.IsOSPlatform(OSPlatform.Windows) ? DetectWindows() : DetectLinux();
+            }
+            catch (Exception ex) when (ex is IOException || ex is UnauthorizedAccessException || ex is FormatException)
+            {
+                Console.WriteLine($"CPU topology detection failed: {ex.Message}");
+            }
+
+            if (processors == null || processors.Count == 0)
+            {
+                // Nothing known: every processor its own performance core
+                processors = Enumerable.Range(0, Environment.ProcessorCount)
+                    .Select(i => new LogicalProcessor { Id = i, Core = i })
+                    .ToList();
+            }
+
+            return new CpuTopology(processors.OrderBy(p => p.Id).ToList());
+        }
+
+        #region Windows
+
+        private const int RelationProcessorCore = 0;
+        private const int ProcessorRelationshipOffset = 8;
+
+        private static unsafe List<LogicalProcessor> DetectWindows()
+        {
+            uint length = 0;
+            GetLogicalProcessorInformationEx(RelationProcessorCore, IntPtr.Zero, ref length);
+            if (length == 0) return null;
+
+            IntPtr buffer = Marshal.AllocHGlobal((int)length);
+            try
+            {
+                if (!GetLogicalProcessorInformationEx(RelationProcessorCore, buffer, ref length)) return null;
+
+                var processors = new List<LogicalProcessor>();
+                var efficiencyClasses = new List<byte>();
+                byte* record = (byte*)buffer;
+                byte* end = record + length;
+                int core = 0;
+
+                // SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX records; PROCESSOR_RELATIONSHIP follows the 8-byte header:
+                // Flags, EfficiencyClass, 20 reserved bytes, GroupCount, then GROUP_AFFINITY { Mask, Group } at +24
+                for (; record < end; record += *(uint*)(record + 4), core++)
+                {
+                    if (*(int*)record != RelationProcessorCore) continue;
+
+                    byte* relationship = record + ProcessorRelationshipOffset;
+                    byte efficiencyClass = relationship[1];
+                    ulong mask = *(ulong*)(relationship + 24);
+                    ushort group = *(ushort*)(relationship + 32);
+
+                    bool first = true;
+                    for (int bit = 0; bit < 64; bit++)
+                    {
+                        if ((mask & (1UL << bit)) == 0) continue;
+
+                        processors.Add(new LogicalProcessor { Id = group * 64 + bit, Core = core, IsSmtSibling = !first });
+                        efficiencyClasses.Add(efficiencyClass);
+                        first = false;
+                    }
+                }
+
+                // Higher efficiency class is the faster core; only hybrid parts report more than one
+                byte fastest = efficiencyClasses.Count > 0 ? efficiencyClasses.Max() : (byte)0;
+                for (int i = 0; i < processors.Count; i++)
+                {
+                    var processor = processors[i];
+                    processor.Efficiency = efficiencyClasses[i] < fastest;
+                    processors[i] = processor;
+                }
+                return processors;
+            }
+            finally
+            {
+                Marshal.FreeHGlobal(buffer);
+            }
+        }
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool GetLogicalProcessorInformationEx(int relationshipType, IntPtr buffer, ref uint returnedLength);
+
+        #endregion
+
+        #region Linux
+
+        private const string CpuRoot = "/sys/devices/system/cpu";
+
+        private static List<LogicalProcessor> DetectLinux()
+        {
+            if (!Directory.Exists(CpuRoot)) return null;
+
+            var online = File.Exists(Path.Combine(CpuRoot, "online"))
+                ? ParseCpuList(File.ReadAllText(Path.Combine(CpuRoot, "online")))
+                : new HashSet<int>(Enumerable.Range(0, Environment.ProcessorCount));
+
+            // Intel hybrid parts expose each core type as its own PMU; ARM big.LITTLE reports capacities instead
+            var atoms = File.Exists("/sys/devices/cpu_atom/cpus")
+                ? ParseCpuList(File.ReadAllText("/sys/devices/cpu_atom/cpus"))
+                : new HashSet<int>();
+            var capacities = new Dictionary<int, int>();
+
+            var processors = new List<LogicalProcessor>();
+            var cores = new Dictionary<(int Package, int Core), int>();
+            foreach (int cpu in online.OrderBy(c => c))
+            {
+                string topology = Path.Combine(CpuRoot, $"cpu{cpu}", "topology");
+                int package = ReadInt(Path.Combine(topology, "physical_package_id"), 0);
+                int coreId = ReadInt(Path.Combine(topology, "core_id"), cpu);
+
+                bool sibling = cores.TryGetValue((package, coreId), out int core);
+                if (!sibling)
+                {
+                    core = cores.Count;
+                    cores[(package, coreId)] = core;
+                }
+
+                int capacity = ReadInt(Path.Combine(CpuRoot, $"cpu{cpu}", "cpu_capacity"), -1);
+                if (capacity > 0) capacities[cpu] = capacity;
+
+                processors.Add(new LogicalProcessor { Id = cpu, Core = core, IsSmtSibling = sibling, Efficiency = atoms.Contains(cpu) });
+            }
+
+            if (atoms.Count == 0 && capacities.Count > 0)
+            {
+                int largest = capacities.Values.Max();
+                for (int i = 0; i < processors.Count; i++)
+                {
+                    var processor = processors[i];
+                    processor.Efficiency = capacities.TryGetValue(processor.Id, out int capacity) && capacity < largest;
+                    processors[i] = processor;
+                }
+            }
+            return processors;
+        }
+
+        private static int ReadInt(string path, int fallback)
+        {
+            return File.Exists(path) && int.TryParse(File.ReadAllText(path).Trim(), out int value) ? value : fallback;
+        }
+
+        /// <summary>
+        /// Kernel cpulist format, e.g. "0-5,8,10-11"
+        /// </summary>
+        private static HashSet<int> ParseCpuList(string list)
+        {
+            var cpus = new HashSet<int>();
+            foreach (var part in list.Trim().Split(',', StringSplitOptions.RemoveEmptyEntries))
+            {
+                int dash = part.IndexOf('-');
+                int first = int.Parse(dash < 0 ? part : part.Substring(0, dash));
+                int last = dash < 0 ? first : int.Parse(part.Substring(dash + 1));
+                for (int cpu = first; cpu <= last; cpu++) cpus.Add(cpu);
+            }
+            return cpus;
+        }
+
+        #endregion
+    }
+
+    /// <summary>
+    /// What one of our threads does, which decides where it runs
+    /// </summary>
+    public enum ThreadRole
+    {
+        Tracking,       // Pose sampling; latency-critical
+        FramePacing,    // The VR runtime's frame loop (xrWaitFrame); latency-critical, on a core of its own
+        Input,      // Per-frame work that shouldn't share the tracking core
+        Scanning    // Signature scans, install walks, indexing; throughput only
+    }
+
+    public class ThreadPlacementSettings
+    {
+        public bool Enabled { get; set; } = true;
+
+        // Keep a physical core (both its hardware threads) each for tracking and frame pacing; none of our other
+        // threads go there
+        public bool DedicatedTrackingCore { get; set; } = true;
+
+        // Logical processor for tracking, or -1 to take the last performance core (core 0 is where the OS
+        // and most games' main threads tend to sit)
+        public int TrackingProcessor { get; set; } = -1;
+
+        // Logical processor for frame pacing, or -1 for the performance core before the tracking one. Shares
+        // the tracking core only on a machine with a single performance core.
+        public int FramePacingProcessor { get; set; } = -1;
+
+        // Priority of both latency-critical roles
+        public ThreadPriority TrackingPriority { get; set; } = ThreadPriority.Highest;
+
+        // On hybrid parts scanning runs on E-cores only; elsewhere on the SMT siblings the game uses least
+        public bool ScanningOnEfficiencyCores { get; set; } = true;
+
+        public ThreadPriority ScanningPriority { get; set; } = ThreadPriority.BelowNormal;
+    }
+
+    /// <summary>
+    /// Puts our threads on cores that suit them, so they compete as little as possible with the game's render
+    /// and worker threads. Dedicated threads call Place once when they start; work that borrows a thread for a
+    /// while (a scan on the loading thread) takes an Enter scope, which puts the old affinity back afterwards.
+    /// </summary>
+    public sealed class ThreadPlacementManager
+    {
+        public static ThreadPlacementManager Shared { get; } = new ThreadPlacementManager();
+
+        private ThreadPlacementSettings settings = new ThreadPlacementSettings();
+        private CpuTopology topology;
+        private readonly object configureLock = new object();
+
+        private int trackingProcessor = -1;
+        private int framePacingProcessor = -1;
+        private int[] inputProcessors = Array.Empty<int>();
+        private int[] scanningProcessors = Array.Empty<int>();
+
+        public CpuTopology Topology => topology;
+        public int TrackingProcessor => trackingProcessor;
+        public int FramePacingProcessor => framePacingProcessor;
+
+        /// <summary>
+        /// Plan against a known topology instead of the detected one
+        /// </summary>
+        public ThreadPlacementManager(CpuTopology topology = null)
+        {
+            this.topology = topology;
+        }
+
+        public void Configure(ThreadPlacementSettings settings)
+        {
+            lock (configureLock)
+            {
+                this.settings = settings;
+                topology ??= CpuTopology.Detect();
+                Plan();
+            }
+
+            Console.WriteLine($"Thread placement: {topology}; tracking on cpu {trackingProcessor}, frame pacing on cpu {framePacingProcessor}, " +
+                $"input on {inputProcessors.Length}, scanning on {scanningProcessors.Length} logical processors");
+        }
+
+        private void Plan()
+        {
+            var all = topology.Processors;
+
+            var performance = all.Where(p => !p.Efficiency).ToList();
+            if (performance.Count == 0) performance = all.ToList();
+
+            trackingProcessor = all.Any(p => p.Id == settings.TrackingProcessor)
+                ? settings.TrackingProcessor
+                : performance.Where(p => !p.IsSmtSibling).Select(p => p.Id).DefaultIfEmpty(performance[performance.Count - 1].Id).Max();
+            int trackingCore = all.First(p => p.Id == trackingProcessor).Core;
+
+            // The roomscale sampler and the OpenXR frame loop both wake on a deadline; on one processor each
+            // would sit behind the other
+            framePacingProcessor = all.Any(p => p.Id == settings.FramePacingProcessor)
+                ? settings.FramePacingProcessor
+                : performance.Where(p => !p.IsSmtSibling && p.Core != trackingCore).Select(p => p.Id).DefaultIfEmpty(trackingProcessor).Max();
+            int framePacingCore = all.First(p => p.Id == framePacingProcessor).Core;
+
+            // With dedicated cores, their SMT siblings stay idle too so they can't steal cycles
+            bool Available(LogicalProcessor p) => !settings.DedicatedTrackingCore || (p.Core != trackingCore && p.Core != framePacingCore);
+
+            inputProcessors = performance.Where(Available).Select(p => p.Id).ToArray();
+
+            var efficiency = all.Where(p => p.Efficiency && Available(p)).ToList();
+            var siblings = all.Where(p => p.IsSmtSibling && Available(p)).ToList();
+            scanningProcessors = (settings.ScanningOnEfficiencyCores && efficiency.Count > 0 ? efficiency
+                : siblings.Count > 0 ? siblings
+                : all.Where(Available).ToList()).Select(p => p.Id).ToArray();
+
+            // A machine too small to set anything aside: don't restrict at all
+            if (inputProcessors.Length == 0) inputProcessors = all.Select(p => p.Id).ToArray();
+            if (scanningProcessors.Length == 0) scanningProcessors = inputProcessors;
+        }
+
+        /// <summary>
+        /// Pin the calling thread for its role for the rest of its life. Call first thing in a dedicated thread.
+        /// </summary>
+        public void Place(ThreadRole role)
+        {
+            if (!EnsurePlanned()) return;
+
+            SetCurrentThreadAffinity(ProcessorsFor(role), out _);
+            Thread.CurrentThread.Priority = PriorityFor(role);
+        }
+
+        /// <summary>
+        /// Run the calling thread in the given role until the scope is disposed
+        /// </summary>
+        public PlacementScope Enter(ThreadRole role)
+        {
+            if (!EnsurePlanned()) return default;
+
+            var thread = Thread.CurrentThread;
+            var previousPriority = thread.Priority;
+            if (!SetCurrentThreadAffinity(ProcessorsFor(role), out var previousAffinity)) return default;
+
+            thread.Priority = PriorityFor(role);
+            return new PlacementScope(previousAffinity, previousPriority);
+        }
+
+        private bool EnsurePlanned()
+        {
+            if (!settings.Enabled) return false;
+            if (topology == null) Configure(settings);
+            return true;
+        }
+
+        internal int[] ProcessorsFor(ThreadRole role)
+        {
+            switch (role)
+            {
+                case ThreadRole.Tracking:
+                    return new[] { trackingProcessor };
+                case ThreadRole.FramePacing:
+                    return new[] { framePacingProcessor };
+                case ThreadRole.Scanning:
+                    return scanningProcessors;
+                default:
+                    return inputProcessors;
+            }
+        }
+
+        private ThreadPriority PriorityFor(ThreadRole role)
+        {
+            switch (role)
+            {
+                case ThreadRole.Tracking:
+                case ThreadRole.FramePacing:
+                    return settings.TrackingPriority;
+                case ThreadRole.Scanning:
+                    return settings.ScanningPriority;
+                default:
+                    return ThreadPriority.AboveNormal;
+            }
+        }
+
+        /// <summary>
+        /// Undoes an Enter on dispose
+        /// </summary>
+        public readonly struct PlacementScope : IDisposable
+        {
+            private readonly ulong[] previousAffinity;
+            private readonly ThreadPriority previousPriority;
+
+            internal PlacementScope(ulong[] previousAffinity, ThreadPriority previousPriority)
+            {
+                this.previousAffinity = previousAffinity;
+                this.previousPriority = previousPriority;
+            }
+
+            public void Dispose()
+            {
+                if (previousAffinity == null) return;
+
+                RestoreCurrentThreadAffinity(previousAffinity);
+                Thread.CurrentThread.Priority = previousPriority;
+            }
+        }
+
+        #region Native methods
+
+        // Affinity is kept as a bitset over logical processor ids; 1024 covers every machine Linux builds for by default
+        private const int MaskWords = 16;
+
+        private static unsafe bool SetCurrentThreadAffinity(int[] processors, out ulong[] previous)
+        {
+            previous = null;
+            if (processors.Length == 0) return false;
+
+            if (RuntimeInformation.IsOSPlatform(OSPlatform.Windows))
+            {
+                // A thread runs in one processor group; take the group of the first processor
+                int group = processors[0] / 64;
+                var affinity = new GroupAffinity { Group = (ushort)group };
+                foreach (int id in processors)
+                {
+                    if (id / 64 == group) affinity.Mask |= 1UL << (id % 64);
+                }
+
+                GroupAffinity old;
+                if (!SetThreadGroupAffinity(GetCurrentThread(), &affinity, &old)) return false;
+
+                previous = new ulong[MaskWords];
+                if (old.Group < MaskWords) previous[old.Group] = old.Mask;
+                return true;
+            }
+
+            var mask = stackalloc ulong[MaskWords];
+            var saved = new ulong[MaskWords];
+            fixed (ulong* savedPointer = saved)
+            {
+                if (sched_getaffinity(0, MaskWords * sizeof(ulong), savedPointer) != 0) return false;
+            }
+
+            foreach (int id in processors)
+            {
+                if (id < MaskWords * 64) mask[id / 64] |= 1UL << (id % 64);
+            }
+            if (sched_setaffinity(0, MaskWords * sizeof(ulong), mask) != 0) return false;
+
+            previous = saved;
+            return true;
+        }
+
+        private static unsafe void RestoreCurrentThreadAffinity(ulong[] previous)
+        {
+            if (RuntimeInformation.IsOSPlatform(OSPlatform.Windows))
+            {
+                for (int group = 0; group < previous.Length; group++)
+                {
+                    if (previous[group] == 0) continue;
+
+                    var affinity = new GroupAffinity { Mask = previous[group], Group = (ushort)group };
+                    SetThreadGroupAffinity(GetCurrentThread(), &affinity, null);
+                    return;
+                }
+                return;
+            }
+
+            fixed (ulong* mask = previous)
+            {
+                sched_setaffinity(0, previous.Length * sizeof(ulong), mask);
+            }
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct GroupAffinity
+        {
+            public ulong Mask;
+            public ushort Group;
+            public ushort Reserved0, Reserved1, Reserved2;
+        }
+
+        [DllImport("kernel32.dll")]
+        private static extern IntPtr GetCurrentThread();
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern unsafe bool SetThreadGroupAffinity(IntPtr thread, GroupAffinity* groupAffinity, GroupAffinity* previousGroupAffinity);
+
+        // pid 0 is the calling thread
+        [DllImport("libc", SetLastError = true)]
+        private static extern unsafe int sched_setaffinity(int pid, nint cpusetSize, ulong* mask);
+
+        [DllImport("libc", SetLastError = true)]
+        private static extern unsafe int sched_getaffinity(int pid, nint cpusetSize, ulong* mask);
+
+        #endregion
+    }
+}
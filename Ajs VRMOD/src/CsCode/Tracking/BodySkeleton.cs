@@ -0,0 +1,82 @@
+using System;
+using System.Collections.Generic;
+using System.Numerics;
+
+namespace VRGameConverter.Tracking
+{
+    /// <summary>
+    /// Bones the body solver drives, mapped to the game skeleton's bone indices by the profile
+    /// </summary>
+    public enum BodyBone
+    {
+        Pelvis,
+        Spine,
+        Chest,
+        LeftUpperArm,
+        LeftForearm,
+        LeftHand,
+        RightUpperArm,
+        RightForearm,
+        RightHand,
+        LeftThigh,
+        LeftShin,
+        LeftFoot,
+        RightThigh,
+        RightShin,
+        RightFoot
+    }
+
+    /// <summary>
+    /// Solved world transform for one game bone
+    /// </summary>
+    public struct BoneOverride
+    {
+        public int BoneIndex;
+        public Vector3 Position;
+        public Quaternion Rotation;
+    }
+
+    /// <summary>
+    /// Engine-specific write of bone overrides into the skeleton the game just finished animating
+    /// (bone matrix layout, local versus model space)
+    /// </summary>
+    public interface ISkeletonWriter
+    {
+        void WriteBones(IntPtr skeleton, IntPtr boneTransforms, int boneCount, ReadOnlySpan<BoneOverride> overrides);
+    }
+
+    /// <summary>
+    /// Proportions of the first-person body and how the solver runs
+    /// </summary>
+    public class BodySettings
+    {
+        public bool Enabled { get; set; } = true;
+
+        // Metres; scaled along with the player's height by the calibration
+        public float PelvisToChest { get; set; } = 0.3f;
+        public float ChestToNeck { get; set; } = 0.25f;
+        public float NeckToEyes { get; set; } = 0.12f;
+        public float ShoulderWidth { get; set; } = 0.36f;
+        public float UpperArmLength { get; set; } = 0.29f;
+        public float ForearmLength { get; set; } = 0.27f;
+        public float HipWidth { get; set; } = 0.2f;
+        public float ThighLength { get; set; } = 0.45f;
+        public float ShinLength { get; set; } = 0.43f;
+
+        public float MaxElbowBendDegrees { get; set; } = 150f;
+        public float MaxKneeBendDegrees { get; set; } = 140f;
+        public float MaxSpineBendDegrees { get; set; } = 35f;
+
+        // Legs are only solved when feet trackers are present, unless this is set
+        public bool SolveLegsWithoutTrackers { get; set; } = false;
+
+        public int Iterations { get; set; } = 10;
+        public float Tolerance { get; set; } = 0.002f;
+
+        // Solve time above this is logged
+        public double BudgetMilliseconds { get; set; } = 0.2;
+
+        // Game skeleton bone index for each solved bone; bones missing here are left to the game's animation
+        public Dictionary<BodyBone, int> BoneIndices { get; set; } = new Dictionary<BodyBone, int>();
+    }
+}
@@ -0,0 +1,269 @@
+using System;
+using System.Numerics;
+using System.Runtime.CompilerServices;
+
+namespace VRGameConverter.Tracking
+{
+    /// <summary>
+    /// FABRIK for several joint chains at once. Chains share a joint count and sit side by side in
+    /// Vector&lt;float&gt; lanes, joint-major, so one pass of the loop moves the same joint of every chain.
+    /// Each chain starts from a pose bent toward its pole, and every bone after the first is held within a
+    /// cone around its parent, which keeps elbows and knees bending the right way.
+    /// </summary>
+    public sealed class ChainIkSolver
+    {
+        private readonly int jointCount;
+        private readonly int lanes;
+
+        // Joint positions [joint * lanes + chain]
+        private readonly float[] jointX, jointY, jointZ;
+
+        // Bone lengths [bone * lanes + chain], bone i from joint i to joint i + 1
+        private readonly float[] boneLength;
+
+        // Per chain [chain]
+        private readonly float[] rootX, rootY, rootZ;
+        private readonly float[] targetX, targetY, targetZ;
+        private readonly float[] poleX, poleY, poleZ;
+        private readonly float[] coneCos, coneSin;
+
+        public int ChainCount { get; }
+        public int JointCount => jointCount;
+
+        public ChainIkSolver(int chainCount, int jointCount)
+        {
+            if (jointCount < 2) throw new ArgumentOutOfRangeException(nameof(jointCount), "A chain needs at least one bone");
+
+            ChainCount = chainCount;
+            this.jointCount = jointCount;
+
+            // Pad to whole vectors so the loop never needs a scalar tail
+            int width = Vector<float>.Count;
+            lanes = (chainCount + width - 1) / width * width;
+
+            jointX = new float[jointCount * lanes];
+            jointY = new float[jointCount * lanes];
+            jointZ = new float[jointCount * lanes];
+            boneLength = new float[(jointCount - 1) * lanes];
+            rootX = new float[lanes];
+            rootY = new float[lanes];
+            rootZ = new float[lanes];
+            targetX = new float[lanes];
+            targetY = new float[lanes];
+            targetZ = new float[lanes];
+            poleX = new float[lanes];
+            poleY = new float[lanes];
+            poleZ = new float[lanes];
+            coneCos = new float[lanes];
+            coneSin = new float[lanes];
+
+            for (int chain = 0; chain < lanes; chain++)
+            {
+                coneCos[chain] = -1;
+                poleY[chain] = 1;
+            }
+        }
+
+        /// <summary>
+        /// Bone lengths from root to tip, and how far each bone may bend away from its parent
+        /// </summary>
+        public void SetChain(int chain, ReadOnlySpan<float> lengths, float maxBendDegrees)
+        {
+            if (lengths.Length != jointCount - 1) throw new ArgumentException($"Expected {jointCount - 1} bone lengths", nameof(lengths));
+
+            for (int bone = 0; bone < lengths.Length; bone++)
+            {
+                boneLength[bone * lanes + chain] = lengths[bone];
+            }
+
+            float limit = Math.Clamp(maxBendDegrees, 0, 180) * MathF.PI / 180;
+            coneCos[chain] = MathF.Cos(limit);
+            coneSin[chain] = MathF.Sin(limit);
+        }
+
+        /// <summary>
+        /// Where the chain is anchored, where its tip should reach, and the direction its middle joints bend toward
+        /// </summary>
+        public void SetGoal(int chain, Vector3 root, Vector3 target, Vector3 pole)
+        {
+            rootX[chain] = root.X;
+            rootY[chain] = root.Y;
+            rootZ[chain] = root.Z;
+            targetX[chain] = target.X;
+            targetY[chain] = target.Y;
+            targetZ[chain] = target.Z;
+            poleX[chain] = pole.X;
+            poleY[chain] = pole.Y;
+            poleZ[chain] = pole.Z;
+        }
+
+        public Vector3 GetJoint(int chain, int joint)
+        {
+            int i = joint * lanes + chain;
+            return new Vector3(jointX[i], jointY[i], jointZ[i]);
+        }
+
+        /// <summary>
+        /// World rotation of a solved bone: +Y along the bone, +Z toward the chain's pole
+        /// </summary>
+        public Quaternion GetBoneRotation(int chain, int bone)
+        {
+            var along = GetJoint(chain, bone + 1) - GetJoint(chain, bone);
+            if (along.LengthSquared() < 1e-12f) return Quaternion.Identity;
+            along = Vector3.Normalize(along);
+
+            var pole = new Vector3(poleX[chain], poleY[chain], poleZ[chain]);
+            var toward = pole - along * Vector3.Dot(pole, along);
+            if (toward.LengthSquared() < 1e-12f)
+            {
+                // Pole parallel to the bone: any perpendicular will do
+                toward = MathF.Abs(along.Y) < 0.9f ? Vector3.Cross(along, Vector3.UnitY) : Vector3.Cross(along, Vector3.UnitX);
+            }
+            toward = Vector3.Normalize(toward);
+            var side = Vector3.Cross(along, toward);
+
+            // Rows are where the local axes end up
+            var basis = new Matrix4x4(
+                side.X, side.Y, side.Z, 0,
+                along.X, along.Y, along.Z, 0,
+                toward.X, toward.Y, toward.Z, 0,
+                0, 0, 0, 1);
+            return Quaternion.CreateFromRotationMatrix(basis);
+        }
+
+        /// <summary>
+        /// Solve every chain. Stops early for a block of chains once all their tips are within tolerance.
+        /// </summary>
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        public void Solve(int iterations, float tolerance)
+        {
+            int width = Vector<float>.Count;
+            var toleranceSquared = new Vector<float>(tolerance * tolerance);
+
+            for (int block = 0; block < lanes; block += width)
+            {
+                var root = Load(rootX, rootY, rootZ, block);
+                var target = Load(targetX, targetY, targetZ, block);
+                var pole = Load(poleX, poleY, poleZ, block);
+                var cosLimit = new Vector<float>(coneCos, block);
+                var sinLimit = new Vector<float>(coneSin, block);
+
+                Seed(block, root, target, pole);
+
+                for (int iteration = 0; iteration < iterations; iteration++)
+                {
+                    // Backward: pin the tip to the target and pull each joint after it
+                    int tip = (jointCount - 1) * lanes + block;
+                    Store(jointX, jointY, jointZ, tip, target);
+                    var child = target;
+                    for (int joint = jointCount - 2; joint >= 0; joint--)
+                    {
+                        int i = joint * lanes + block;
+                        var length = new Vector<float>(boneLength, i);
+                        var current = Load(jointX, jointY, jointZ, i);
+                        var placed = child + Normalize(current - child) * length;
+                        Store(jointX, jointY, jointZ, i, placed);
+                        child = placed;
+                    }
+
+                    // Forward: pin the root and push each joint out again, inside its cone
+                    Store(jointX, jointY, jointZ, block, root);
+                    var parent = root;
+                    var parentDirection = new Vec3();
+                    for (int joint = 0; joint < jointCount - 1; joint++)
+                    {
+                        int i = joint * lanes + block;
+                        int next = i + lanes;
+                        var length = new Vector<float>(boneLength, i);
+                        var direction = Normalize(Load(jointX, jointY, jointZ, next) - parent);
+                        if (joint > 0)
+                        {
+                            direction = LimitToCone(direction, parentDirection, cosLimit, sinLimit);
+                        }
+                        var placed = parent + direction * length;
+                        Store(jointX, jointY, jointZ, next, placed);
+                        parent = placed;
+                        parentDirection = direction;
+                    }
+
+                    var miss = parent - target;
+                    if (Vector.LessThanOrEqualAll(Dot(miss, miss), toleranceSquared)) break;
+                }
+            }
+        }
+
+        private void Seed(int block, in Vec3 root, in Vec3 target, in Vec3 pole)
+        {
+            // Straight toward the target, with the middle joints pushed out toward the pole so the
+            // solve settles on the pole side instead of wherever last frame left it
+            var direction = Normalize(target - root);
+            var bend = Normalize(pole - direction * Dot(pole, direction));
+
+            var along = Vector<float>.Zero;
+            Store(jointX, jointY, jointZ, block, root);
+            for (int joint = 1; joint < jointCount; joint++)
+            {
+                var length = new Vector<float>(boneLength, (joint - 1) * lanes + block);
+                along += length;
+                var offset = joint < jointCount - 1 ? length * 0.25f : Vector<float>.Zero;
+                Store(jointX, jointY, jointZ, joint * lanes + block, root + direction * along + bend * offset);
+            }
+        }
+
+        private static Vec3 LimitToCone(in Vec3 direction, in Vec3 axis, Vector<float> cosLimit, Vector<float> sinLimit)
+        {
+            // Outside the cone: rotate back onto its edge, in the plane of the axis and the direction
+            var cos = Dot(direction, axis);
+            var outside = Vector.LessThan(cos, cosLimit);
+            if (outside == Vector<int>.Zero) return direction;
+
+            var perpendicular = Normalize(direction - axis * cos);
+            var clamped = axis * cosLimit + perpendicular * sinLimit;
+            return new Vec3(
+                Vector.ConditionalSelect(outside, clamped.X, direction.X),
+                Vector.ConditionalSelect(outside, clamped.Y, direction.Y),
+                Vector.ConditionalSelect(outside, clamped.Z, direction.Z));
+        }
+
+        private static Vec3 Load(float[] x, float[] y, float[] z, int index)
+        {
+            return new Vec3(new Vector<float>(x, index), new Vector<float>(y, index), new Vector<float>(z, index));
+        }
+
+        private static void Store(float[] x, float[] y, float[] z, int index, in Vec3 value)
+        {
+            value.X.CopyTo(x, index);
+            value.Y.CopyTo(y, index);
+            value.Z.CopyTo(z, index);
+        }
+
+        private static Vector<float> Dot(in Vec3 a, in Vec3 b) => a.X * b.X + a.Y * b.Y + a.Z * b.Z;
+
+        private static Vec3 Normalize(in Vec3 v)
+        {
+            // Zero-length stays zero rather than turning into NaN
+            var length = Vector.SquareRoot(Dot(v, v));
+            var scale = Vector.ConditionalSelect(Vector.GreaterThan(length, new Vector<float>(1e-6f)), Vector<float>.One / length, Vector<float>.Zero);
+            return v * scale;
+        }
+
+        /// <summary>
+        /// One 3D vector per lane
+        /// </summary>
+        private readonly struct Vec3
+        {
+            public readonly Vector<float> X, Y, Z;
+
+            public Vec3(Vector<float> x, Vector<float> y, Vector<float> z)
+            {
+                X = x;
+                Y = y;
+                Z = z;
+            }
+
+            public static Vec3 operator +(in Vec3 a, in Vec3 b) => new Vec3(a.X + b.X, a.Y + b.Y, a.Z + b.Z);
+            public static Vec3 operator -(in Vec3 a, in Vec3 b) => new Vec3(a.X - b.X, a.Y - b.Y, a.Z - b.Z);
+            public static Vec3 operator *(in Vec3 a, Vector<float> s) => new Vec3(a.X * s, a.Y * s, a.Z * s);
+        }
+    }
+}
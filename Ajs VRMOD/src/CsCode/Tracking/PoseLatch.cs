@@ -0,0 +1,257 @@
+using System;
+using System.Diagnostics;
+using System.Numerics;
+
+namespace VRGameConverter.Tracking
+{
+    /// <summary>
+    /// Head pose sampled at the scene-submit point and predicted forward to when the frame will be displayed
+    /// </summary>
+    public struct LatchedPose
+    {
+        public HeadPose Pose;
+        public long SampleTimestamp;   // Stopwatch ticks when the runtime was sampled
+        public long DisplayTimestamp;  // Predicted photon time the pose was extrapolated to
+        public long FrameIndex;
+    }
+
+    /// <summary>
+    /// How far the latched prediction was from where the head actually was at display time
+    /// </summary>
+    public struct LatchStatistics
+    {
+        public long Frames;
+        public double MeanRotationErrorDegrees;
+        public double MaxRotationErrorDegrees;
+        public double MeanPositionErrorMillimeters;
+        public double MeanLatchToDisplayMilliseconds;
+
+        public override string ToString()
+        {
+            return $"{Frames} frames, rotation error mean {MeanRotationErrorDegrees:F3} deg (max {MaxRotationErrorDegrees:F3}), " +
+                $"position error mean {MeanPositionErrorMillimeters:F2} mm, latch to display {MeanLatchToDisplayMilliseconds:F2} ms";
+        }
+    }
+
+    /// <summary>
+    /// Runtimes that run their own frame loop and know when the next frame will reach the display
+    /// </summary>
+    public interface IDisplayTimeSource
+    {
+        /// <summary>
+        /// Predicted display time of the frame being rendered, in Stopwatch ticks; false before the first frame
+        /// </summary>
+        bool TryGetPredictedDisplayTime(out long displayTimestamp, out long displayPeriodTicks);
+    }
+
+    /// <summary>
+    /// Runtimes whose frame loop is driven from the game's present instead of a thread of their own
+    /// </summary>
+    public interface IRuntimeFrameLoop
+    {
+        /// <summary>
+        /// Handle runtime events and run one frame; blocks in the runtime's frame wait. False when there was no
+        /// frame to run (session not running, or the runtime paces itself).
+        /// </summary>
+        bool RunFrame();
+    }
+
+    /// <summary>
+    /// Late latching: the head pose is re-sampled as late as possible (right before the game's scene pass)
+    /// instead of using whatever the update loop stored earlier in the frame, then extrapolated to the predicted
+    /// display time. The same latched pose goes to the compositor, and once the display time has passed it is
+    /// compared with the real head pose to keep track of the remaining error.
+    /// </summary>
+    public sealed class PoseLatch
+    {
+        private const int LogInterval = 900;
+
+        private readonly Func<HeadPose> sampler;
+
+        // Velocity estimate from consecutive samples
+        private HeadPose lastSample;
+        private long lastSampleTimestamp = 0;
+        private Vector3 linearVelocity = Vector3.Zero;
+        private Vector3 angularVelocity = Vector3.Zero;  // Axis scaled by radians per second
+
+        // Submitted frames still waiting for their display time to pass, oldest first. With a display time
+        // one or two frames out there are usually two or three in flight.
+        private const int MaxPending = 8;
+        private readonly LatchedPose[] pending = new LatchedPose[MaxPending];
+        private int pendingStart = 0;
+        private int pendingCount = 0;
+        private long submittedFrameIndex = 0;
+
+        // Scene submit to photons, tracked from present timings
+        private double latchToPresentSeconds = 0.005;
+        private double refreshSeconds = 1.0 / 90.0;
+
+        private LatchStatistics statistics;
+        private long frameIndex = 0;
+
+        public LatchedPose Current { get; private set; }
+        public double LastRotationErrorDegrees { get; private set; }
+
+        public LatchStatistics Statistics => statistics;
+
+        // When set, the runtime's own display prediction replaces the estimate from present timings
+        public IDisplayTimeSource DisplayTimes { get; set; }
+
+        public PoseLatch(Func<HeadPose> sampler)
+        {
+            this.sampler = sampler;
+        }
+
+        public double SecondsToDisplay => latchToPresentSeconds + refreshSeconds;
+
+        /// <summary>
+        /// True between a Latch and the Submit that sends it, i.e. this frame already has its pose
+        /// </summary>
+        public bool HasUnsubmittedLatch => Current.FrameIndex != 0 && Current.FrameIndex != submittedFrameIndex;
+
+        /// <summary>
+        /// Sample the runtime now and predict to display time. Called from the scene-submit hook.
+        /// </summary>
+        public LatchedPose Latch()
+        {
+            long now = Stopwatch.GetTimestamp();
+            var sample = sampler();
+
+            if (lastSampleTimestamp != 0)
+            {
+                MeasurePending(sample, now);
+                UpdateVelocity(sample, now);
+            }
+
+            lastSample = sample;
+            lastSampleTimestamp = now;
+
+            double ahead = SecondsToDisplay;
+            if (DisplayTimes != null && DisplayTimes.TryGetPredictedDisplayTime(out long display, out long period))
+            {
+                // A frame that has already gone out is replaced by the one after it
+                while (display <= now && period > 0) display += period;
+                if (display > now) ahead = (double)(display - now) / Stopwatch.Frequency;
+            }
+
+            Current = new LatchedPose
+            {
+                Pose = Predict(sample, (float)ahead),
+                SampleTimestamp = now,
+                DisplayTimestamp = now + (long)(ahead * Stopwatch.Frequency),
+                FrameIndex = ++frameIndex
+            };
+            return Current;
+        }
+
+        /// <summary>
+        /// Called from the present hook: the latched pose is what the compositor gets for this frame
+        /// </summary>
+        public LatchedPose Submit(double refreshRate)
+        {
+            long now = Stopwatch.GetTimestamp();
+            var submitted = Current;
+
+            // A present without a new latch resubmits the same frame; only measure it once
+            if (submitted.FrameIndex != 0 && submitted.FrameIndex != submittedFrameIndex)
+            {
+                submittedFrameIndex = submitted.FrameIndex;
+
+                // Refine the latency estimate used by the next prediction
+                double latchToPresent = (double)(now - submitted.SampleTimestamp) / Stopwatch.Frequency;
+                latchToPresentSeconds += (latchToPresent - latchToPresentSeconds) * 0.1;
+                refreshSeconds = 1.0 / refreshRate;
+
+                // Full means the latch has stalled for many frames; the oldest entry is the least useful
+                if (pendingCount == MaxPending)
+                {
+                    pendingStart = (pendingStart + 1) % MaxPending;
+                    pendingCount--;
+                }
+                pending[(pendingStart + pendingCount) % MaxPending] = submitted;
+                pendingCount++;
+            }
+
+            return submitted;
+        }
+
+        private void UpdateVelocity(HeadPose sample, long now)
+        {
+            float dt = (float)(now - lastSampleTimestamp) / Stopwatch.Frequency;
+            if (dt <= 1e-4f) return;
+
+            linearVelocity = (sample.Position - lastSample.Position) / dt;
+
+            // World-frame rotation taking the previous orientation to this one, on the short arc
+            var delta = Quaternion.Normalize(sample.Rotation * Quaternion.Inverse(lastSample.Rotation));
+            if (delta.W < 0) delta = Quaternion.Negate(delta);
+
+            float angle = 2 * MathF.Acos(Math.Min(1.0f, delta.W));
+            var axis = new Vector3(delta.X, delta.Y, delta.Z);
+            angularVelocity = axis.LengthSquared() > 1e-12f ? Vector3.Normalize(axis) * (angle / dt) : Vector3.Zero;
+        }
+
+        private HeadPose Predict(HeadPose sample, float seconds)
+        {
+            var rotation = sample.Rotation;
+            float speed = angularVelocity.Length();
+            if (speed > 1e-6f)
+            {
+                rotation = Quaternion.Normalize(Quaternion.CreateFromAxisAngle(angularVelocity / speed, speed * seconds) * rotation);
+            }
+
+            return new HeadPose
+            {
+                Position = sample.Position + linearVelocity * seconds,
+                Rotation = rotation
+            };
+        }
+
+        /// <summary>
+        /// Every submitted frame whose display time now lies between the last two samples has its prediction
+        /// compared with the head pose interpolated at that time
+        /// </summary>
+        private void MeasurePending(HeadPose sample, long now)
+        {
+            while (pendingCount > 0)
+            {
+                var frame = pending[pendingStart];
+                if (frame.DisplayTimestamp > now) break;
+
+                pendingStart = (pendingStart + 1) % MaxPending;
+                pendingCount--;
+
+                // Displayed before the previous sample, while nothing was latching: no pose to compare with
+                if (frame.DisplayTimestamp >= lastSampleTimestamp)
+                {
+                    Measure(frame, sample, now);
+                }
+            }
+        }
+
+        private void Measure(LatchedPose frame, HeadPose sample, long now)
+        {
+            float t = (float)(frame.DisplayTimestamp - lastSampleTimestamp) / Math.Max(1, now - lastSampleTimestamp);
+            var displayedRotation = Quaternion.Slerp(lastSample.Rotation, sample.Rotation, t);
+            var displayedPosition = Vector3.Lerp(lastSample.Position, sample.Position, t);
+
+            var error = Quaternion.Normalize(frame.Pose.Rotation * Quaternion.Inverse(displayedRotation));
+            double rotationError = 2 * Math.Acos(Math.Min(1.0, Math.Abs(error.W))) * 180.0 / Math.PI;
+            double positionError = Vector3.Distance(frame.Pose.Position, displayedPosition) * 1000.0;
+            double latchToDisplay = (double)(frame.DisplayTimestamp - frame.SampleTimestamp) * 1000.0 / Stopwatch.Frequency;
+
+            LastRotationErrorDegrees = rotationError;
+
+            long n = ++statistics.Frames;
+            statistics.MeanRotationErrorDegrees += (rotationError - statistics.MeanRotationErrorDegrees) / n;
+            statistics.MaxRotationErrorDegrees = Math.Max(statistics.MaxRotationErrorDegrees, rotationError);
+            statistics.MeanPositionErrorMillimeters += (positionError - statistics.MeanPositionErrorMillimeters) / n;
+            statistics.MeanLatchToDisplayMilliseconds += (latchToDisplay - statistics.MeanLatchToDisplayMilliseconds) / n;
+
+            if (n % LogInterval == 0)
+            {
+                Console.WriteLine($"Late latch: {statistics}");
+            }
+        }
+    }
+}
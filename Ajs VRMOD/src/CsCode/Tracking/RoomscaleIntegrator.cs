@@ -0,0 +1,171 @@
+using System;
+using System.Diagnostics;
+using System.Numerics;
+using System.Threading;
+using VRGameConverter.Scheduling;
+
+namespace VRGameConverter.Tracking
+{
+    /// <summary>
+    /// Physical walking in the play space, sampled at tracking rate on its own thread and handed to the game
+    /// once per movement tick. Positions are quantized to a fixed-point grid and the differences between
+    /// consecutive quantized samples are added atomically, so the deltas telescope: whatever the game's tick
+    /// rate, the total it receives is exactly where the head is now minus where it started, with nothing
+    /// dropped between ticks and nothing applied twice.
+    /// </summary>
+    public sealed class RoomscaleIntegrator : IDisposable
+    {
+        // Fixed-point units per metre (0.1 mm)
+        private const double UnitsPerMeter = 10000.0;
+
+        // Below this much time to the next sample the thread spins: Sleep(1) can overshoot by a millisecond or more
+        private static readonly long SpinTicks = Stopwatch.Frequency * 3 / 2000;
+
+        private readonly Func<HeadPose> sampler;
+        private readonly long periodTicks;
+        private readonly float maxStepMeters;
+
+        // Accumulated, not yet consumed (fixed point); written by the tracking thread, swapped out by the game
+        private long pendingX = 0;
+        private long pendingZ = 0;
+
+        // Tracking thread only
+        private long lastX, lastZ;
+        private bool hasLast = false;
+
+        private readonly Thread thread;
+        private volatile bool running = true;
+
+        public long Samples { get; private set; }
+        public long DiscardedSteps { get; private set; }
+
+        /// <summary>
+        /// The sampler must return the head in play space (calibrated, but not moved by the game) and be safe
+        /// to call off the game thread. Steps longer than maxStepMeters between samples are tracking glitches
+        /// or recenters and are dropped. With no sampler no thread is started and the owner feeds Sample itself.
+        /// </summary>
+        public RoomscaleIntegrator(Func<HeadPose> sampler, int sampleRateHz = 500, float maxStepMeters = 0.25f)
+        {
+            this.sampler = sampler;
+            this.maxStepMeters = maxStepMeters;
+            periodTicks = Stopwatch.Frequency / Math.Max(1, sampleRateHz);
+            if (sampler == null) return;
+
+            thread = new Thread(Run)
+            {
+                Name = "Roomscale sampler",
+                IsBackground = true,
+                Priority = ThreadPriority.AboveNormal
+            };
+            thread.Start();
+        }
+
+        private void Run()
+        {
+            ThreadPlacementManager.Shared.Place(ThreadRole.Tracking);
+
+            long next = Stopwatch.GetTimestamp();
+            while (running)
+            {
+                Sample(sampler().Position);
+
+                next += periodTicks;
+                long remaining = next - Stopwatch.GetTimestamp();
+                if (remaining < -periodTicks)
+                {
+                    // Fell behind (thread starved); don't try to catch up with a burst of samples
+                    next = Stopwatch.GetTimestamp();
+                    continue;
+                }
+
+                while (remaining > 0 && running)
+                {
+                    if (remaining > SpinTicks)
+                    {
+                        Thread.Sleep(1);
+                    }
+                    else
+                    {
+                        Thread.SpinWait(20);
+                    }
+                    remaining = next - Stopwatch.GetTimestamp();
+                }
+            }
+        }
+
+        /// <summary>
+        /// Add one head position. Normally called from the sampling thread; only one caller at a time.
+        /// </summary>
+        public void Sample(Vector3 position)
+        {
+            // Only horizontal motion; crouching and leaning are the camera's business
+            long x = (long)Math.Round(position.X * UnitsPerMeter);
+            long z = (long)Math.Round(position.Z * UnitsPerMeter);
+            Samples++;
+
+            if (hasLast)
+            {
+                long dx = x - lastX;
+                long dz = z - lastZ;
+                double step = Math.Sqrt((double)dx * dx + (double)dz * dz) / UnitsPerMeter;
+
+                if (step <= maxStepMeters)
+                {
+                    Interlocked.Add(ref pendingX, dx);
+                    Interlocked.Add(ref pendingZ, dz);
+                }
+                else
+                {
+                    DiscardedSteps++;
+                }
+            }
+
+            lastX = x;
+            lastZ = z;
+            hasLast = true;
+        }
+
+        /// <summary>
+        /// Everything walked since the last call, in play-space metres. Call once per game movement tick.
+        /// </summary>
+        public Vector3 TakeDelta()
+        {
+            long x = Interlocked.Exchange(ref pendingX, 0);
+            long z = Interlocked.Exchange(ref pendingZ, 0);
+            return new Vector3((float)(x / UnitsPerMeter), 0, (float)(z / UnitsPerMeter));
+        }
+
+        /// <summary>
+        /// Everything walked since the last call, turned from play space into the game's heading (the rotation
+        /// that takes play-space forward to the direction the game world calls forward). Only the heading's yaw
+        /// is used, so the result stays horizontal and keeps its length.
+        /// </summary>
+        public Vector3 TakeDelta(Quaternion heading)
+        {
+            Vector3 delta = TakeDelta();
+            return Vector3.Transform(delta, Yaw(heading));
+        }
+
+        /// <summary>
+        /// The rotation about the vertical axis contained in a rotation, with pitch and roll removed
+        /// </summary>
+        public static Quaternion Yaw(Quaternion rotation)
+        {
+            Vector3 forward = Vector3.Transform(-Vector3.UnitZ, rotation);
+            if (forward.X * forward.X + forward.Z * forward.Z < 1e-8f)
+            {
+                // Looking straight up or down; forward has no heading, so take it from where up leans
+                Vector3 up = Vector3.Transform(Vector3.UnitY, rotation);
+                forward = forward.Y > 0 ? -up : up;
+            }
+            float yaw = MathF.Atan2(-forward.X, -forward.Z);
+            return Quaternion.CreateFromAxisAngle(Vector3.UnitY, yaw);
+        }
+
+        public void Dispose()
+        {
+            running = false;
+            thread?.Join();
+        }
+    }
+}
@@ -0,0 +1,215 @@
+using System;
+using System.Diagnostics;
+using System.Numerics;
+using System.Threading;
+
+namespace VRGameConverter.Tracking
+{
+    /// <summary>
+    /// What a generic tracker is strapped to, as assigned in the runtime
+    /// </summary>
+    public enum TrackedDeviceRole
+    {
+        Generic,
+        Waist,
+        Chest,
+        LeftFoot,
+        RightFoot,
+        LeftKnee,
+        RightKnee,
+        LeftElbow,
+        RightElbow
+    }
+
+    /// <summary>
+    /// Runtimes that can stream extra trackers and finger skeletons. Sources write on their own thread at the
+    /// device's native rate; the game thread only ever reads the latest sample.
+    /// </summary>
+    public interface ITrackedDeviceSource
+    {
+        void Start(TrackedDeviceBuffers buffers);
+    }
+
+    /// <summary>
+    /// Latest pose of every generic tracker plus both hands' finger joints, in fixed structure-of-arrays storage
+    /// allocated once up front. Each device and each hand has its own sequence counter (odd while a write is in
+    /// progress), so a single writer per device never blocks and readers retry the rare torn read instead of locking.
+    /// </summary>
+    public sealed class TrackedDeviceBuffers
+    {
+        // OpenXR hand joint layout: palm, wrist, then four thumb and five joints per finger
+        public const int HandJointCount = 26;
+
+        // A device that hasn't reported for this long has lost tracking
+        private static readonly long StaleTicks = Stopwatch.Frequency / 4;
+
+        private readonly TrackedDeviceRole[] roles;
+        private readonly int[] sequence;
+        private readonly long[] timestamp;
+        private readonly float[] positionX, positionY, positionZ;
+        private readonly float[] rotationX, rotationY, rotationZ, rotationW;
+        private readonly object registerLock = new object();
+        private int deviceCount = 0;
+
+        // Both hands back to back: left joints 0..25, right joints 26..51
+        private readonly int[] handSequence = new int[2];
+        private readonly long[] handTimestamp = new long[2];
+        private readonly float[] jointX = new float[2 * HandJointCount];
+        private readonly float[] jointY = new float[2 * HandJointCount];
+        private readonly float[] jointZ = new float[2 * HandJointCount];
+        private readonly float[] jointRotationX = new float[2 * HandJointCount];
+        private readonly float[] jointRotationY = new float[2 * HandJointCount];
+        private readonly float[] jointRotationZ = new float[2 * HandJointCount];
+        private readonly float[] jointRotationW = new float[2 * HandJointCount];
+
+        public int Capacity => roles.Length;
+        public int DeviceCount => Volatile.Read(ref deviceCount);
+
+        public TrackedDeviceBuffers(int capacity)
+        {
+            roles = new TrackedDeviceRole[capacity];
+            sequence = new int[capacity];
+            timestamp = new long[capacity];
+            positionX = new float[capacity];
+            positionY = new float[capacity];
+            positionZ = new float[capacity];
+            rotationX = new float[capacity];
+            rotationY = new float[capacity];
+            rotationZ = new float[capacity];
+            rotationW = new float[capacity];
+        }
+
+        /// <summary>
+        /// Claim a slot for a tracker when the source first sees it; returns -1 when the buffers are full.
+        /// Sources may register from any thread. A slot's role is in place before readers can see the slot.
+        /// </summary>
+        public int Register(TrackedDeviceRole role)
+        {
+            lock (registerLock)
+            {
+                int index = deviceCount;
+                if (index >= Capacity)
+                {
+                    Console.WriteLine($"Tracker buffer full, ignoring {role} tracker");
+                    return -1;
+                }
+
+                roles[index] = role;
+                Volatile.Write(ref deviceCount, index + 1);
+                return index;
+            }
+        }
+
+        public TrackedDeviceRole GetRole(int device) => roles[device];
+
+        /// <summary>
+        /// Store a new sample. Only the source that registered the device may write it.
+        /// </summary>
+        public void Write(int device, Vector3 position, Quaternion rotation, long sampleTimestamp)
+        {
+            // Full fence on the way in, so the data stores can't be seen before the odd count
+            int start = Interlocked.Increment(ref sequence[device]);
+
+            positionX[device] = position.X;
+            positionY[device] = position.Y;
+            positionZ[device] = position.Z;
+            rotationX[device] = rotation.X;
+            rotationY[device] = rotation.Y;
+            rotationZ[device] = rotation.Z;
+            rotationW[device] = rotation.W;
+            timestamp[device] = sampleTimestamp;
+
+            Volatile.Write(ref sequence[device], start + 1);
+        }
+
+        /// <summary>
+        /// Latest sample of a device; false when it has never reported or has gone stale
+        /// </summary>
+        public bool TryRead(int device, out Vector3 position, out Quaternion rotation)
+        {
+            long sampleTimestamp;
+            var spin = new SpinWait();
+            while (true)
+            {
+                int before = Volatile.Read(ref sequence[device]);
+                if ((before & 1) == 0)
+                {
+                    position = new Vector3(positionX[device], positionY[device], positionZ[device]);
+                    rotation = new Quaternion(rotationX[device], rotationY[device], rotationZ[device], rotationW[device]);
+                    sampleTimestamp = timestamp[device];
+
+                    Interlocked.MemoryBarrier();
+                    if (Volatile.Read(ref sequence[device]) == before) break;
+                }
+
+                // The writer is mid-sample; on a busy core it may need this one to finish
+                spin.SpinOnce();
+            }
+
+            return sampleTimestamp != 0 && Stopwatch.GetTimestamp() - sampleTimestamp < StaleTicks;
+        }
+
+        /// <summary>
+        /// Store a full finger skeleton for one hand
+        /// </summary>
+        public void WriteHand(ControllerHand hand, ReadOnlySpan<Vector3> positions, ReadOnlySpan<Quaternion> rotations, long sampleTimestamp)
+        {
+            if (positions.Length < HandJointCount || rotations.Length < HandJointCount)
+            {
+                throw new ArgumentException($"A hand skeleton needs {HandJointCount} joints");
+            }
+
+            int h = HandIndex(hand);
+            int offset = h * HandJointCount;
+            int start = Interlocked.Increment(ref handSequence[h]);
+
+            for (int j = 0; j < HandJointCount; j++)
+            {
+                jointX[offset + j] = positions[j].X;
+                jointY[offset + j] = positions[j].Y;
+                jointZ[offset + j] = positions[j].Z;
+                jointRotationX[offset + j] = rotations[j].X;
+                jointRotationY[offset + j] = rotations[j].Y;
+                jointRotationZ[offset + j] = rotations[j].Z;
+                jointRotationW[offset + j] = rotations[j].W;
+            }
+            handTimestamp[h] = sampleTimestamp;
+
+            Volatile.Write(ref handSequence[h], start + 1);
+        }
+
+        /// <summary>
+        /// Copy a hand's latest finger skeleton into caller-owned spans; false when the hand isn't tracked
+        /// </summary>
+        public bool TryReadHand(ControllerHand hand, Span<Vector3> positions, Span<Quaternion> rotations)
+        {
+            int h = HandIndex(hand);
+            int offset = h * HandJointCount;
+            long sampleTimestamp;
+            var spin = new SpinWait();
+
+            while (true)
+            {
+                int before = Volatile.Read(ref handSequence[h]);
+                if ((before & 1) == 0)
+                {
+                    for (int j = 0; j < HandJointCount; j++)
+                    {
+                        positions[j] = new Vector3(jointX[offset + j], jointY[offset + j], jointZ[offset + j]);
+                        rotations[j] = new Quaternion(jointRotationX[offset + j], jointRotationY[offset + j], jointRotationZ[offset + j], jointRotationW[offset + j]);
+                    }
+                    sampleTimestamp = handTimestamp[h];
+
+                    Interlocked.MemoryBarrier();
+                    if (Volatile.Read(ref handSequence[h]) == before) break;
+                }
+
+                spin.SpinOnce();
+            }
+
+            return sampleTimestamp != 0 && Stopwatch.GetTimestamp() - sampleTimestamp < StaleTicks;
+        }
+
+        private static int HandIndex(ControllerHand hand) => hand == ControllerHand.Left ? 0 : 1;
+    }
+}
@@ -0,0 +1,253 @@
+using System;
+using System.Numerics;
+
+namespace VRGameConverter.Tracking
+{
+    /// <summary>
+    /// Spaces a tracked pose passes through on its way into the game, each the child of the one before
+    /// </summary>
+    public enum TransformSpace
+    {
+        Tracking,   // Raw runtime space
+        Play,       // Calibrated: scale, offset and rotation from the camera settings
+        Game        // Relative to the game's character or camera root
+    }
+
+    /// <summary>
+    /// Uniform scale, then rotation, then translation. Enough for every step from runtime space to game space,
+    /// and unlike a general matrix the rotation composes exactly onto device orientations.
+    /// </summary>
+    public struct SpaceTransform : IEquatable<SpaceTransform>
+    {
+        public Vector3 Translation;
+        public Quaternion Rotation;
+        public float Scale;
+
+        public static SpaceTransform Identity => new SpaceTransform { Rotation = Quaternion.Identity, Scale = 1 };
+
+        public SpaceTransform(Vector3 translation, Quaternion rotation, float scale)
+        {
+            Translation = translation;
+            Rotation = rotation;
+            Scale = scale;
+        }
+
+        /// <summary>
+        /// This transform followed by the parent's
+        /// </summary>
+        public SpaceTransform Then(in SpaceTransform parent)
+        {
+            return new SpaceTransform(
+                parent.TransformPoint(Translation),
+                parent.Rotation * Rotation,
+                parent.Scale * Scale);
+        }
+
+        public Vector3 TransformPoint(Vector3 point) => Vector3.Transform(point * Scale, Rotation) + Translation;
+
+        public Quaternion TransformRotation(Quaternion rotation) => Rotation * rotation;
+
+        public bool Equals(SpaceTransform other) =>
+            Translation == other.Translation && Rotation == other.Rotation && Scale == other.Scale;
+        public override bool Equals(object obj) => obj is SpaceTransform other && Equals(other);
+        public override int GetHashCode() => HashCode.Combine(Translation, Rotation, Scale);
+    }
+
+    /// <summary>
+    /// Runtimes that report controller poses separately from the controller button state. Extra trackers
+    /// stream in through ITrackedDeviceSource instead.
+    /// </summary>
+    public interface ITrackedPoseProvider
+    {
+        RawVRPose GetControllerPose(ControllerHand hand);
+    }
+
+    /// <summary>
+    /// Poses of every tracked device for one frame in structure-of-arrays form, so the whole set can be moved
+    /// between spaces in one vectorized pass. The headset and both hands have fixed slots; trackers follow.
+    /// </summary>
+    public sealed class TrackedPoseBatch
+    {
+        public const int Head = 0;
+        public const int LeftHand = 1;
+        public const int RightHand = 2;
+        public const int FirstTracker = 3;
+
+        public readonly float[] PositionX, PositionY, PositionZ;
+        public readonly float[] RotationX, RotationY, RotationZ, RotationW;
+
+        public int Count { get; set; }
+        public int Capacity => PositionX.Length;
+
+        public TrackedPoseBatch(int capacity)
+        {
+            if (capacity < FirstTracker) throw new ArgumentOutOfRangeException(nameof(capacity), "The batch needs room for the headset and both hands");
+
+            PositionX = new float[capacity];
+            PositionY = new float[capacity];
+            PositionZ = new float[capacity];
+            RotationX = new float[capacity];
+            RotationY = new float[capacity];
+            RotationZ = new float[capacity];
+            RotationW = new float[capacity];
+        }
+
+        public static int SlotFor(ControllerHand hand) => hand == ControllerHand.Left ? LeftHand : RightHand;
+
+        public void Set(int index, Vector3 position, Quaternion rotation)
+        {
+            PositionX[index] = position.X;
+            PositionY[index] = position.Y;
+            PositionZ[index] = position.Z;
+            RotationX[index] = rotation.X;
+            RotationY[index] = rotation.Y;
+            RotationZ[index] = rotation.Z;
+            RotationW[index] = rotation.W;
+        }
+
+        public Vector3 GetPosition(int index) => new Vector3(PositionX[index], PositionY[index], PositionZ[index]);
+
+        public Quaternion GetRotation(int index) => new Quaternion(RotationX[index], RotationY[index], RotationZ[index], RotationW[index]);
+    }
+
+    /// <summary>
+    /// Tracking space → calibrated play space → game space, with each space's transform to tracking space
+    /// cached and only recomputed when it or a parent changed. Calibration changes rarely and the game root
+    /// at most once a frame, so the composed transform is nearly always ready when the batch is transformed.
+    /// </summary>
+    public sealed class TransformGraph
+    {
+        private const int SpaceCount = 3;
+
+        private readonly SpaceTransform[] local = new SpaceTransform[SpaceCount];
+        private readonly SpaceTransform[] world = new SpaceTransform[SpaceCount];
+        private readonly bool[] dirty = new bool[SpaceCount];
+
+        // Bumped whenever any cached world transform changes, for consumers that cache derived data
+        public int Version { get; private set; }
+
+        public TransformGraph()
+        {
+            for (int i = 0; i < SpaceCount; i++)
+            {
+                local[i] = SpaceTransform.Identity;
+                world[i] = SpaceTransform.Identity;
+            }
+        }
+
+        public SpaceTransform GetLocal(TransformSpace space) => local[(int)space];
+
+        public void SetLocal(TransformSpace space, in SpaceTransform transform)
+        {
+            if (space == TransformSpace.Tracking) throw new ArgumentException("Tracking space is the root and has no transform", nameof(space));
+
+            int index = (int)space;
+            if (local[index].Equals(transform)) return;
+
+            local[index] = transform;
+            dirty[index] = true;
+        }
+
+        /// <summary>
+        /// Play space from the camera settings
+        /// </summary>
+        public void SetCalibration(float positionScale, Vector3 positionOffset, Quaternion rotationOffset)
+        {
+            SetLocal(TransformSpace.Play, new SpaceTransform(positionOffset, rotationOffset, positionScale));
+        }
+
+        /// <summary>
+        /// Where play space sits relative to the game's character or camera root
+        /// </summary>
+        public void SetGameRoot(Vector3 position, Quaternion rotation)
+        {
+            SetLocal(TransformSpace.Game, new SpaceTransform(position, rotation, 1));
+        }
+
+        /// <summary>
+        /// From tracking space into the given space
+        /// </summary>
+        public SpaceTransform GetWorld(TransformSpace space)
+        {
+            Resolve();
+            return world[(int)space];
+        }
+
+        private void Resolve()
+        {
+            bool parentChanged = false;
+            for (int i = 1; i < SpaceCount; i++)
+            {
+                if (!dirty[i] && !parentChanged) continue;
+
+                // Into the parent space first, then from the parent into this one
+                world[i] = world[i - 1].Then(local[i]);
+                dirty[i] = false;
+                parentChanged = true;
+            }
+
+            if (parentChanged) Version++;
+        }
+
+        /// <summary>
+        /// Move every pose in the batch from tracking space into the given space, in place
+        /// </summary>
+        public void TransformBatch(TrackedPoseBatch batch, TransformSpace space)
+        {
+            var transform = GetWorld(space);
+
+            // Scaled rotation matrix rows for the positions; System.Numerics is row-vector, so p' = p * M
+            var m = Matrix4x4.CreateFromQuaternion(transform.Rotation);
+            float s = transform.Scale;
+            float m11 = m.M11 * s, m12 = m.M12 * s, m13 = m.M13 * s;
+            float m21 = m.M21 * s, m22 = m.M22 * s, m23 = m.M23 * s;
+            float m31 = m.M31 * s, m32 = m.M32 * s, m33 = m.M33 * s;
+            var t = transform.Translation;
+            var r = transform.Rotation;
+
+            float[] px = batch.PositionX, py = batch.PositionY, pz = batch.PositionZ;
+            float[] qx = batch.RotationX, qy = batch.RotationY, qz = batch.RotationZ, qw = batch.RotationW;
+            int count = batch.Count;
+            int i = 0;
+
+            if (Vector.IsHardwareAccelerated)
+            {
+                int width = Vector<float>.Count;
+                for (; i <= count - width; i += width)
+                {
+                    var x = new Vector<float>(px, i);
+                    var y = new Vector<float>(py, i);
+                    var z = new Vector<float>(pz, i);
+                    (x * m11 + y * m21 + z * m31 + new Vector<float>(t.X)).CopyTo(px, i);
+                    (x * m12 + y * m22 + z * m32 + new Vector<float>(t.Y)).CopyTo(py, i);
+                    (x * m13 + y * m23 + z * m33 + new Vector<float>(t.Z)).CopyTo(pz, i);
+
+                    // Hamilton product r * q with r fixed for the whole batch
+                    var ax = new Vector<float>(qx, i);
+                    var ay = new Vector<float>(qy, i);
+                    var az = new Vector<float>(qz, i);
+                    var aw = new Vector<float>(qw, i);
+                    (aw * r.X + ax * r.W + az * r.Y - ay * r.Z).CopyTo(qx, i);
+                    (aw * r.Y + ay * r.W + ax * r.Z - az * r.X).CopyTo(qy, i);
+                    (aw * r.Z + az * r.W + ay * r.X - ax * r.Y).CopyTo(qz, i);
+                    (aw * r.W - ax * r.X - ay * r.Y - az * r.Z).CopyTo(qw, i);
+                }
+            }
+
+            // Remainder, and the whole batch without SIMD; a headset and two hands is usually all there is
+            for (; i < count; i++)
+            {
+                float x = px[i], y = py[i], z = pz[i];
+                px[i] = x * m11 + y * m21 + z * m31 + t.X;
+                py[i] = x * m12 + y * m22 + z * m32 + t.Y;
+                pz[i] = x * m13 + y * m23 + z * m33 + t.Z;
+
+                var q = r * new Quaternion(qx[i], qy[i], qz[i], qw[i]);
+                qx[i] = q.X;
+                qy[i] = q.Y;
+                qz[i] = q.Z;
+                qw[i] = q.W;
+            }
+        }
+    }
+}
@@ -0,0 +1,220 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace VRGameConverter.VR
+{
+    public enum OpenXRGraphicsApi
+    {
+        D3D11,
+        D3D12,
+        Vulkan
+    }
+
+    /// <summary>
+    /// The game's graphics device in the form xrCreateSession takes it (an XrGraphicsBinding*KHR struct in native
+    /// memory), with the extension that enables it. The session renders through the game's own device, so the
+    /// binding has to come from the game: FromSwapChain finds it from the swap chain the present hook sees.
+    /// </summary>
+    public sealed unsafe class OpenXRGraphicsBinding : IDisposable
+    {
+        public OpenXRGraphicsApi Api { get; }
+
+        // XrGraphicsBinding*KHR, chained onto XrSessionCreateInfo.next
+        public IntPtr Pointer { get; private set; }
+
+        public string Extension
+        {
+            get
+            {
+                switch (Api)
+                {
+                    case OpenXRGraphicsApi.D3D11:
+                        return "XR_KHR_D3D11_enable";
+                    case OpenXRGraphicsApi.D3D12:
+                        return "XR_KHR_D3D12_enable";
+                    default:
+                        return "XR_KHR_vulkan_enable";
+                }
+            }
+        }
+
+        // xrGet*GraphicsRequirementsKHR, which the runtime requires before xrCreateSession, and its struct type
+        public string RequirementsFunction
+        {
+            get
+            {
+                switch (Api)
+                {
+                    case OpenXRGraphicsApi.D3D11:
+                        return "xrGetD3D11GraphicsRequirementsKHR";
+                    case OpenXRGraphicsApi.D3D12:
+                        return "xrGetD3D12GraphicsRequirementsKHR";
+                    default:
+                        return "xrGetVulkanGraphicsRequirementsKHR";
+                }
+            }
+        }
+
+        public int RequirementsType
+        {
+            get
+            {
+                switch (Api)
+                {
+                    case OpenXRGraphicsApi.D3D11:
+                        return XR_TYPE_GRAPHICS_REQUIREMENTS_D3D11_KHR;
+                    case OpenXRGraphicsApi.D3D12:
+                        return XR_TYPE_GRAPHICS_REQUIREMENTS_D3D12_KHR;
+                    default:
+                        return XR_TYPE_GRAPHICS_REQUIREMENTS_VULKAN_KHR;
+                }
+            }
+        }
+
+        private OpenXRGraphicsBinding(OpenXRGraphicsApi api, int size)
+        {
+            Api = api;
+            Pointer = Marshal.AllocHGlobal(size);
+            new Span<byte>((void*)Pointer, size).Clear();
+        }
+
+        public static OpenXRGraphicsBinding D3D11(IntPtr device)
+        {
+            var binding = new OpenXRGraphicsBinding(OpenXRGraphicsApi.D3D11, sizeof(XrGraphicsBindingD3D11KHR));
+            *(XrGraphicsBindingD3D11KHR*)binding.Pointer = new XrGraphicsBindingD3D11KHR
+            {
+                Type = XR_TYPE_GRAPHICS_BINDING_D3D11_KHR,
+                Device = device
+            };
+            return binding;
+        }
+
+        public static OpenXRGraphicsBinding D3D12(IntPtr device, IntPtr queue)
+        {
+            var binding = new OpenXRGraphicsBinding(OpenXRGraphicsApi.D3D12, sizeof(XrGraphicsBindingD3D12KHR));
+            *(XrGraphicsBindingD3D12KHR*)binding.Pointer = new XrGraphicsBindingD3D12KHR
+            {
+                Type = XR_TYPE_GRAPHICS_BINDING_D3D12_KHR,
+                Device = device,
+                Queue = queue
+            };
+            return binding;
+        }
+
+        public static OpenXRGraphicsBinding Vulkan(IntPtr instance, IntPtr physicalDevice, IntPtr device, uint queueFamilyIndex, uint queueIndex)
+        {
+            var binding = new OpenXRGraphicsBinding(OpenXRGraphicsApi.Vulkan, sizeof(XrGraphicsBindingVulkanKHR));
+            *(XrGraphicsBindingVulkanKHR*)binding.Pointer = new XrGraphicsBindingVulkanKHR
+            {
+                Type = XR_TYPE_GRAPHICS_BINDING_VULKAN_KHR,
+                Instance = instance,
+                PhysicalDevice = physicalDevice,
+                Device = device,
+                QueueFamilyIndex = queueFamilyIndex,
+                QueueIndex = queueIndex
+            };
+            return binding;
+        }
+
+        /// <summary>
+        /// Binding for the device behind a DXGI swap chain, or null when it is neither D3D11 nor D3D12. A D3D12
+        /// swap chain's "device" is the command queue it presents on, which also gives the device.
+        /// </summary>
+        public static OpenXRGraphicsBinding FromSwapChain(IntPtr swapChain)
+        {
+            if (swapChain == IntPtr.Zero || !RuntimeInformation.IsOSPlatform(OSPlatform.Windows)) return null;
+
+            if (TryGetDevice(swapChain, IID_ID3D11Device, out var d3d11Device))
+            {
+                // The session holds its own reference; ours goes once the pointer is copied
+                var binding = D3D11(d3d11Device);
+                Release(d3d11Device);
+                return binding;
+            }
+
+            if (TryGetDevice(swapChain, IID_ID3D12CommandQueue, out var queue))
+            {
+                OpenXRGraphicsBinding binding = null;
+                if (TryGetDevice(queue, IID_ID3D12Device, out var d3d12Device))
+                {
+                    binding = D3D12(d3d12Device, queue);
+                    Release(d3d12Device);
+                }
+                Release(queue);
+                return binding;
+            }
+
+            return null;
+        }
+
+        public void Dispose()
+        {
+            if (Pointer == IntPtr.Zero) return;
+            Marshal.FreeHGlobal(Pointer);
+            Pointer = IntPtr.Zero;
+        }
+
+        #region Native methods
+
+        private const int XR_TYPE_GRAPHICS_BINDING_VULKAN_KHR = 1000025000;
+        private const int XR_TYPE_GRAPHICS_REQUIREMENTS_VULKAN_KHR = 1000025002;
+        private const int XR_TYPE_GRAPHICS_BINDING_D3D11_KHR = 1000027000;
+        private const int XR_TYPE_GRAPHICS_REQUIREMENTS_D3D11_KHR = 1000027002;
+        private const int XR_TYPE_GRAPHICS_BINDING_D3D12_KHR = 1000028000;
+        private const int XR_TYPE_GRAPHICS_REQUIREMENTS_D3D12_KHR = 1000028002;
+
+        private static readonly Guid IID_ID3D11Device = new Guid("db6f6ddb-ac77-4e88-8253-819df9bbf140");
+        private static readonly Guid IID_ID3D12Device = new Guid("189819f1-1db6-4b57-be54-1821339b85f7");
+        private static readonly Guid IID_ID3D12CommandQueue = new Guid("0ec870a6-5d7e-4c22-8cfc-5baae07616ed");
+
+        // IDXGIDeviceSubObject::GetDevice and ID3D12DeviceChild::GetDevice both sit at vtable slot 7
+        private const int GetDeviceSlot = 7;
+        private const int ReleaseSlot = 2;
+
+        private static bool TryGetDevice(IntPtr child, Guid iid, out IntPtr device)
+        {
+            IntPtr result = IntPtr.Zero;
+            var getDevice = (delegate* unmanaged[Stdcall]<IntPtr, Guid*, IntPtr*, int>)(*(IntPtr**)child)[GetDeviceSlot];
+            int hr = getDevice(child, &iid, &result);
+            device = result;
+            return hr >= 0 && result != IntPtr.Zero;
+        }
+
+        private static void Release(IntPtr unknown)
+        {
+            var release = (delegate* unmanaged[Stdcall]<IntPtr, uint>)(*(IntPtr**)unknown)[ReleaseSlot];
+            release(unknown);
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrGraphicsBindingD3D11KHR
+        {
+            public int Type;
+            public void* Next;
+            public IntPtr Device;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrGraphicsBindingD3D12KHR
+        {
+            public int Type;
+            public void* Next;
+            public IntPtr Device;
+            public IntPtr Queue;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrGraphicsBindingVulkanKHR
+        {
+            public int Type;
+            public void* Next;
+            public IntPtr Instance;
+            public IntPtr PhysicalDevice;
+            public IntPtr Device;
+            public uint QueueFamilyIndex;
+            public uint QueueIndex;
+        }
+
+        #endregion
+    }
+}
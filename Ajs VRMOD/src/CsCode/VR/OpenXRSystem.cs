@@ -0,0 +1,1332 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Numerics;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading;
+using VRGameConverter.Diagnostics;
+using VRGameConverter.Scheduling;
+using VRGameConverter.Tracking;
+
+namespace VRGameConverter.VR
+{
+    public class OpenXRSettings
+    {
+        public string ApplicationName { get; set; } = "Ajs VRMOD";
+
+        // Session without a graphics binding or compositor (XR_MND_headless), e.g. Monado's headless driver.
+        // The frame loop, timing and tracking all run as normal, so the whole path can be timed without a headset.
+        public bool Headless { get; set; } = Environment.GetEnvironmentVariable("AJSVRMOD_OPENXR_HEADLESS") == "1";
+
+        // The game's device (OpenXRGraphicsBinding.FromSwapChain); required unless headless
+        public OpenXRGraphicsBinding GraphicsBinding { get; set; }
+
+        // Run xrWaitFrame/xrBeginFrame/xrEndFrame on a thread of our own. Off by default: the present hook drives
+        // the frames (RenderSystem.RuntimeFrames), so the runtime's wait paces the game rather than a thread of ours.
+        public bool DriveFrameLoop { get; set; } = false;
+
+        // Play-space origin: STAGE (floor, room centre) or LOCAL (seated, head at start)
+        public bool UseStageSpace { get; set; } = true;
+
+        // How often body trackers and finger skeletons are located, when the runtime has them
+        public int TrackedDeviceRateHz { get; set; } = 250;
+    }
+
+    /// <summary>
+    /// Frame loop timings, kept as running means
+    /// </summary>
+    public struct OpenXRFrameStatistics
+    {
+        public long Frames;
+        public long SkippedRenders;                    // Frames the runtime said not to render
+        public double MeanWaitMilliseconds;            // Blocked in xrWaitFrame
+        public double MeanBeginToEndMilliseconds;      // xrBeginFrame through xrEndFrame returning
+        public double MeanDisplayLeadMilliseconds;     // xrWaitFrame return to predicted display time
+        public double DisplayPeriodMilliseconds;
+
+        public override string ToString()
+        {
+            return $"{Frames} frames ({SkippedRenders} not rendered), wait {MeanWaitMilliseconds:F2} ms, " +
+                $"begin to end {MeanBeginToEndMilliseconds:F3} ms, display lead {MeanDisplayLeadMilliseconds:F2} ms, " +
+                $"period {DisplayPeriodMilliseconds:F2} ms";
+        }
+    }
+
+    /// <summary>
+    /// OpenXR runtime through the Khronos loader. Runs the frame loop, converts the runtime's predicted display
+    /// times to Stopwatch ticks for pose prediction, and reads the head from the VIEW space and the hands from
+    /// grip-pose actions. Runtime clock conversion uses XR_KHR_win32_convert_performance_counter_time on
+    /// Windows and XR_KHR_convert_timespec_time elsewhere, both of which map onto Stopwatch's clock.
+    /// Body trackers (XR_HTCX_vive_tracker_interaction) and finger skeletons (XR_EXT_hand_tracking) are used
+    /// when the runtime offers them, located on a thread of their own.
+    /// </summary>
+    public sealed unsafe class OpenXRSystem : IVRSystem, ITrackedPoseProvider, ITrackedDeviceSource, IDisplayTimeSource, IDisposable
+    {
+        private const int LogInterval = 900;
+
+        private readonly OpenXRSettings settings;
+
+        private ulong instance;
+        private ulong systemId;
+        private ulong session;
+        private ulong playSpace;
+        private ulong viewSpace;
+
+        private ulong actionSet;
+        private ulong gripAction;
+        private ulong triggerAction;
+        private ulong thumbstickAction;
+        private readonly ulong[] handPaths = new ulong[2];
+        private readonly ulong[] handSpaces = new ulong[2];
+
+        // Tracker roles as the vive tracker extension names them; a space per role, located whether or not a
+        // tracker is assigned to it
+        private static readonly (TrackedDeviceRole Role, string Name)[] TrackerRoles =
+        {
+            (TrackedDeviceRole.Waist, "waist"),
+            (TrackedDeviceRole.Chest, "chest"),
+            (TrackedDeviceRole.LeftFoot, "left_foot"),
+            (TrackedDeviceRole.RightFoot, "right_foot"),
+            (TrackedDeviceRole.LeftKnee, "left_knee"),
+            (TrackedDeviceRole.RightKnee, "right_knee"),
+            (TrackedDeviceRole.LeftElbow, "left_elbow"),
+            (TrackedDeviceRole.RightElbow, "right_elbow")
+        };
+        private bool trackersEnabled = false;
+        private bool handTrackingEnabled = false;
+        private ulong trackerAction;
+        private ulong[] trackerPaths = Array.Empty<ulong>();
+        private ulong[] trackerSpaces = Array.Empty<ulong>();
+        private readonly ulong[] handTrackers = new ulong[2];
+        private LocateHandJointsEXT locateHandJoints;
+
+        private ConvertTimeToCounter timeToCounter;
+        private ConvertCounterToTime counterToTime;
+
+        private volatile int sessionState = XR_SESSION_STATE_UNKNOWN;
+        private bool sessionRunning = false;
+
+        // Latest xrWaitFrame result, published as one pair so readers never mix two frames
+        private long predictedDisplayTimestamp = 0;
+        private long predictedDisplayPeriodTicks = 0;
+        private readonly object frameTimeLock = new object();
+        private long lastXrDisplayTime = 0;
+
+        private OpenXRFrameStatistics statistics;
+
+        private Thread frameThread;
+        private Thread deviceThread;
+        private TrackedDeviceBuffers deviceBuffers;
+        private volatile bool running = true;
+
+        public OpenXRFrameStatistics Statistics => statistics;
+        public bool IsHeadless => settings.Headless;
+        public bool DrivesFrameLoop => frameThread != null;
+
+        public OpenXRSystem() : this(new OpenXRSettings())
+        {
+        }
+
+        public OpenXRSystem(OpenXRSettings settings)
+        {
+            this.settings = settings;
+
+            if (!settings.Headless && settings.GraphicsBinding == null)
+            {
+                throw new VRInitializationException("OpenXR needs the game's graphics binding or headless mode");
+            }
+
+            try
+            {
+                CreateInstance();
+                CreateSession();
+                CreateActions();
+                CreateHandTrackers();
+            }
+            catch (DllNotFoundException)
+            {
+                throw new VRInitializationException("OpenXR loader not found");
+            }
+            catch (EntryPointNotFoundException ex)
+            {
+                Dispose();
+                throw new VRInitializationException($"OpenXR loader is missing {ex.Message}");
+            }
+            catch (VRInitializationException)
+            {
+                Dispose();
+                throw;
+            }
+
+            if (settings.DriveFrameLoop)
+            {
+                frameThread = new Thread(RunFrameLoop)
+                {
+                    Name = "OpenXR frame loop",
+                    IsBackground = true,
+                    Priority = ThreadPriority.AboveNormal
+                };
+                frameThread.Start();
+            }
+        }
+
+        private void CreateInstance()
+        {
+            bool windows = RuntimeInformation.IsOSPlatform(OSPlatform.Windows);
+            var extensions = new List<string>
+            {
+                windows ? "XR_KHR_win32_convert_performance_counter_time" : "XR_KHR_convert_timespec_time"
+            };
+            extensions.Add(settings.Headless ? "XR_MND_headless" : settings.GraphicsBinding.Extension);
+
+            // Optional: without them trackers and fingers just never report
+            var available = EnumerateExtensions();
+            trackersEnabled = available.Contains("XR_HTCX_vive_tracker_interaction");
+            handTrackingEnabled = available.Contains("XR_EXT_hand_tracking");
+            if (trackersEnabled) extensions.Add("XR_HTCX_vive_tracker_interaction");
+            if (handTrackingEnabled) extensions.Add("XR_EXT_hand_tracking");
+
+            var names = new IntPtr[extensions.Count];
+            try
+            {
+                for (int i = 0; i < names.Length; i++) names[i] = Marshal.StringToCoTaskMemUTF8(extensions[i]);
+
+                fixed (IntPtr* namePointers = names)
+                {
+                    var info = new XrInstanceCreateInfo
+                    {
+                        Type = XR_TYPE_INSTANCE_CREATE_INFO,
+                        EnabledExtensionCount = (uint)names.Length,
+                        EnabledExtensionNames = namePointers
+                    };
+                    CopyString(settings.ApplicationName, info.ApplicationInfo.ApplicationName, 128);
+                    CopyString("VRGameConverter", info.ApplicationInfo.EngineName, 128);
+                    info.ApplicationInfo.ApiVersion = XR_API_VERSION_1_0;
+
+                    ulong created;
+                    Check(xrCreateInstance(&info, &created), "xrCreateInstance");
+                    instance = created;
+                }
+            }
+            finally
+            {
+                foreach (var name in names) Marshal.FreeCoTaskMem(name);
+            }
+
+            var systemInfo = new XrSystemGetInfo { Type = XR_TYPE_SYSTEM_GET_INFO, FormFactor = XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY };
+            ulong system;
+            Check(xrGetSystem(instance, &systemInfo, &system), "xrGetSystem");
+            systemId = system;
+
+            if (windows)
+            {
+                timeToCounter = GetFunction<ConvertTimeToCounter>("xrConvertTimeToWin32PerformanceCounterKHR");
+                counterToTime = GetFunction<ConvertCounterToTime>("xrConvertWin32PerformanceCounterToTimeKHR");
+            }
+            else
+            {
+                timeToCounter = GetFunction<ConvertTimeToCounter>("xrConvertTimeToTimespecTimeKHR");
+                counterToTime = GetFunction<ConvertCounterToTime>("xrConvertTimespecTimeToTimeKHR");
+            }
+        }
+
+        private static HashSet<string> EnumerateExtensions()
+        {
+            var names = new HashSet<string>();
+            uint count;
+            if (xrEnumerateInstanceExtensionProperties(null, 0, &count, null) < 0 || count == 0) return names;
+
+            var properties = new XrExtensionProperties[count];
+            for (int i = 0; i < properties.Length; i++) properties[i].Type = XR_TYPE_EXTENSION_PROPERTIES;
+
+            fixed (XrExtensionProperties* first = properties)
+            {
+                if (xrEnumerateInstanceExtensionProperties(null, count, &count, first) < 0) return names;
+
+                for (int i = 0; i < count; i++)
+                {
+                    names.Add(Marshal.PtrToStringUTF8((IntPtr)first[i].ExtensionName));
+                }
+            }
+            return names;
+        }
+
+        private void CreateSession()
+        {
+            if (!settings.Headless)
+            {
+                CheckGraphicsRequirements(settings.GraphicsBinding);
+            }
+
+            var info = new XrSessionCreateInfo
+            {
+                Type = XR_TYPE_SESSION_CREATE_INFO,
+                Next = settings.Headless ? null : (void*)settings.GraphicsBinding.Pointer,
+                SystemId = systemId
+            };
+            ulong created;
+            Check(xrCreateSession(instance, &info, &created), "xrCreateSession");
+            session = created;
+
+            playSpace = CreateReferenceSpace(settings.UseStageSpace ? XR_REFERENCE_SPACE_TYPE_STAGE : XR_REFERENCE_SPACE_TYPE_LOCAL);
+            viewSpace = CreateReferenceSpace(XR_REFERENCE_SPACE_TYPE_VIEW);
+        }
+
+        private void CheckGraphicsRequirements(OpenXRGraphicsBinding binding)
+        {
+            // Runtimes refuse a session whose requirements were never asked for. The game's device already
+            // exists, so all that's left to do with the answer is report it.
+            var getRequirements = GetFunction<GetGraphicsRequirements>(binding.RequirementsFunction);
+            var requirements = stackalloc byte[64];
+            new Span<byte>(requirements, 64).Clear();
+            *(int*)requirements = binding.RequirementsType;
+            Check(getRequirements(instance, systemId, requirements), binding.RequirementsFunction);
+        }
+
+        private ulong CreateReferenceSpace(int type)
+        {
+            var info = new XrReferenceSpaceCreateInfo
+            {
+                Type = XR_TYPE_REFERENCE_SPACE_CREATE_INFO,
+                ReferenceSpaceType = type,
+                PoseInReferenceSpace = XrPosef.Identity
+            };
+            ulong space;
+            int result = xrCreateReferenceSpace(session, &info, &space);
+            if (result < 0 && type == XR_REFERENCE_SPACE_TYPE_STAGE)
+            {
+                // Not every runtime has a stage set up; LOCAL always exists
+                Console.WriteLine("OpenXR: no stage space, using local space");
+                return CreateReferenceSpace(XR_REFERENCE_SPACE_TYPE_LOCAL);
+            }
+            Check(result, "xrCreateReferenceSpace");
+            return space;
+        }
+
+        private void CreateActions()
+        {
+            handPaths[0] = StringToPath("/user/hand/left");
+            handPaths[1] = StringToPath("/user/hand/right");
+
+            var setInfo = new XrActionSetCreateInfo { Type = XR_TYPE_ACTION_SET_CREATE_INFO };
+            CopyString("gameplay", setInfo.ActionSetName, 64);
+            CopyString("Gameplay", setInfo.LocalizedActionSetName, 128);
+            ulong set;
+            Check(xrCreateActionSet(instance, &setInfo, &set), "xrCreateActionSet");
+            actionSet = set;
+
+            gripAction = CreateAction("grip_pose", "Hand pose", XR_ACTION_TYPE_POSE_INPUT);
+            triggerAction = CreateAction("trigger", "Trigger", XR_ACTION_TYPE_FLOAT_INPUT);
+            thumbstickAction = CreateAction("thumbstick", "Thumbstick", XR_ACTION_TYPE_VECTOR2F_INPUT);
+
+            // Runtimes remap these onto whatever controllers are actually connected
+            SuggestBindings("/interaction_profiles/oculus/touch_controller");
+            SuggestBindings("/interaction_profiles/valve/index_controller");
+
+            // Actions can't be added once the set is attached, so the tracker one goes in now
+            if (trackersEnabled) CreateTrackerAction();
+
+            ulong attachSet = actionSet;
+            var attach = new XrSessionActionSetsAttachInfo { Type = XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO, CountActionSets = 1, ActionSets = &attachSet };
+            Check(xrAttachSessionActionSets(session, &attach), "xrAttachSessionActionSets");
+
+            for (int hand = 0; hand < 2; hand++)
+            {
+                var spaceInfo = new XrActionSpaceCreateInfo
+                {
+                    Type = XR_TYPE_ACTION_SPACE_CREATE_INFO,
+                    Action = gripAction,
+                    SubactionPath = handPaths[hand],
+                    PoseInActionSpace = XrPosef.Identity
+                };
+                ulong space;
+                Check(xrCreateActionSpace(session, &spaceInfo, &space), "xrCreateActionSpace");
+                handSpaces[hand] = space;
+            }
+
+            trackerSpaces = new ulong[trackerPaths.Length];
+            for (int tracker = 0; tracker < trackerPaths.Length; tracker++)
+            {
+                var spaceInfo = new XrActionSpaceCreateInfo
+                {
+                    Type = XR_TYPE_ACTION_SPACE_CREATE_INFO,
+                    Action = trackerAction,
+                    SubactionPath = trackerPaths[tracker],
+                    PoseInActionSpace = XrPosef.Identity
+                };
+                ulong space;
+                Check(xrCreateActionSpace(session, &spaceInfo, &space), "xrCreateActionSpace");
+                trackerSpaces[tracker] = space;
+            }
+        }
+
+        private void CreateTrackerAction()
+        {
+            trackerPaths = new ulong[TrackerRoles.Length];
+            for (int i = 0; i < TrackerRoles.Length; i++)
+            {
+                trackerPaths[i] = StringToPath($"/user/vive_tracker_htcx/role/{TrackerRoles[i].Name}");
+            }
+            trackerAction = CreateAction("tracker_pose", "Tracker pose", XR_ACTION_TYPE_POSE_INPUT, trackerPaths);
+
+            var bindings = stackalloc XrActionSuggestedBinding[TrackerRoles.Length];
+            for (int i = 0; i < TrackerRoles.Length; i++)
+            {
+                bindings[i] = new XrActionSuggestedBinding
+                {
+                    Action = trackerAction,
+                    Binding = StringToPath($"/user/vive_tracker_htcx/role/{TrackerRoles[i].Name}/input/grip/pose")
+                };
+            }
+
+            var info = new XrInteractionProfileSuggestedBinding
+            {
+                Type = XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING,
+                InteractionProfile = StringToPath("/interaction_profiles/htc/vive_tracker_htcx"),
+                CountSuggestedBindings = (uint)TrackerRoles.Length,
+                SuggestedBindings = bindings
+            };
+            int result = xrSuggestInteractionProfileBindings(instance, &info);
+            if (result < 0)
+            {
+                Console.WriteLine($"OpenXR: tracker bindings rejected ({result})");
+                trackersEnabled = false;
+                trackerPaths = Array.Empty<ulong>();
+            }
+        }
+
+        private void CreateHandTrackers()
+        {
+            if (!handTrackingEnabled) return;
+
+            var createHandTracker = GetFunction<CreateHandTrackerEXT>("xrCreateHandTrackerEXT");
+            locateHandJoints = GetFunction<LocateHandJointsEXT>("xrLocateHandJointsEXT");
+
+            for (int hand = 0; hand < 2; hand++)
+            {
+                var info = new XrHandTrackerCreateInfoEXT
+                {
+                    Type = XR_TYPE_HAND_TRACKER_CREATE_INFO_EXT,
+                    Hand = hand == 0 ? XR_HAND_LEFT_EXT : XR_HAND_RIGHT_EXT,
+                    HandJointSet = XR_HAND_JOINT_SET_DEFAULT_EXT
+                };
+                ulong tracker;
+                int result = createHandTracker(session, &info, &tracker);
+                if (result < 0)
+                {
+                    // The extension is there but this system has no hand tracking
+                    Console.WriteLine($"OpenXR: no hand tracking ({result})");
+                    handTrackingEnabled = false;
+                    return;
+                }
+                handTrackers[hand] = tracker;
+            }
+        }
+
+        private ulong CreateAction(string name, string localizedName, int type)
+        {
+            return CreateAction(name, localizedName, type, handPaths);
+        }
+
+        private ulong CreateAction(string name, string localizedName, int type, ulong[] subactionPaths)
+        {
+            fixed (ulong* subactions = subactionPaths)
+            {
+                var info = new XrActionCreateInfo
+                {
+                    Type = XR_TYPE_ACTION_CREATE_INFO,
+                    ActionType = type,
+                    CountSubactionPaths = (uint)subactionPaths.Length,
+                    SubactionPaths = subactions
+                };
+                CopyString(name, info.ActionName, 64);
+                CopyString(localizedName, info.LocalizedActionName, 128);
+
+                ulong action;
+                Check(xrCreateAction(actionSet, &info, &action), "xrCreateAction");
+                return action;
+            }
+        }
+
+        private void SuggestBindings(string profile)
+        {
+            var bindings = stackalloc XrActionSuggestedBinding[6];
+            int count = 0;
+            foreach (var hand in new[] { "left", "right" })
+            {
+                bindings[count++] = new XrActionSuggestedBinding { Action = gripAction, Binding = StringToPath($"/user/hand/{hand}/input/grip/pose") };
+                bindings[count++] = new XrActionSuggestedBinding { Action = triggerAction, Binding = StringToPath($"/user/hand/{hand}/input/trigger/value") };
+                bindings[count++] = new XrActionSuggestedBinding { Action = thumbstickAction, Binding = StringToPath($"/user/hand/{hand}/input/thumbstick") };
+            }
+
+            var info = new XrInteractionProfileSuggestedBinding
+            {
+                Type = XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING,
+                InteractionProfile = StringToPath(profile),
+                CountSuggestedBindings = (uint)count,
+                SuggestedBindings = bindings
+            };
+
+            // A runtime that doesn't know a profile just rejects its suggestions
+            int result = xrSuggestInteractionProfileBindings(instance, &info);
+            if (result < 0) Console.WriteLine($"OpenXR: bindings for {profile} rejected ({result})");
+        }
+
+        private void RunFrameLoop()
+        {
+            // xrWaitFrame wakes this thread once per display refresh; it shouldn't have to wait for a core, least
+            // of all the one the roomscale sampler is on
+            ThreadPlacementManager.Shared.Place(ThreadRole.FramePacing);
+
+            int failures = 0;
+            while (running)
+            {
+                PollEvents();
+
+                if (!sessionRunning)
+                {
+                    // Nothing to time until the runtime says the session is ready
+                    Thread.Sleep(10);
+                    continue;
+                }
+
+                // A failing xrWaitFrame returns at once; back off (2, 4 ... 64 ms) rather than spin on it
+                if (RunFrame())
+                {
+                    failures = 0;
+                }
+                else
+                {
+                    failures = Math.Min(failures + 1, 6);
+                    Thread.Sleep(1 << failures);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Handle runtime events; starts and stops the session as the runtime asks. Called by the frame loop,
+        /// or by whoever drives the frames when DriveFrameLoop is off.
+        /// </summary>
+        public void PollEvents()
+        {
+            var buffer = new XrEventDataBuffer();
+            while (true)
+            {
+                buffer.Type = XR_TYPE_EVENT_DATA_BUFFER;
+                buffer.Next = null;
+                if (xrPollEvent(instance, &buffer) != XR_SUCCESS) break;
+
+                if (buffer.Type != XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED) continue;
+
+                var changed = (XrEventDataSessionStateChanged*)&buffer;
+                sessionState = changed->State;
+
+                switch (changed->State)
+                {
+                    case XR_SESSION_STATE_READY:
+                        var begin = new XrSessionBeginInfo { Type = XR_TYPE_SESSION_BEGIN_INFO, PrimaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO };
+                        sessionRunning = xrBeginSession(session, &begin) >= 0;
+                        break;
+
+                    case XR_SESSION_STATE_STOPPING:
+                        xrEndSession(session);
+                        sessionRunning = false;
+                        break;
+
+                    case XR_SESSION_STATE_EXITING:
+                    case XR_SESSION_STATE_LOSS_PENDING:
+                        sessionRunning = false;
+                        running = false;
+                        break;
+                }
+            }
+        }
+
+        /// <summary>
+        /// One xrWaitFrame / xrBeginFrame / xrEndFrame round with no layers of our own. Returns false when the
+        /// session isn't running.
+        /// </summary>
+        public bool RunFrame()
+        {
+            if (!sessionRunning) return false;
+
+            long waitStart = Stopwatch.GetTimestamp();
+            var waitInfo = new XrFrameWaitInfo { Type = XR_TYPE_FRAME_WAIT_INFO };
+            var frameState = new XrFrameState { Type = XR_TYPE_FRAME_STATE };
+            if (xrWaitFrame(session, &waitInfo, &frameState) < 0) return false;
+            long waitEnd = Stopwatch.GetTimestamp();
+
+            // Driven from the present hook, the wait holds the game's own frame; our loop thread's doesn't
+            if (Thread.CurrentThread != frameThread)
+            {
+                FrameAnalyzer.Shared.AddCompositorWait(waitEnd - waitStart);
+            }
+
+            PublishFrameTiming(frameState.PredictedDisplayTime, frameState.PredictedDisplayPeriod);
+
+            var beginInfo = new XrFrameBeginInfo { Type = XR_TYPE_FRAME_BEGIN_INFO };
+            xrBeginFrame(session, &beginInfo);
+
+            // Input follows the frame: one sync, then every reader of this frame sees the same state
+            if (sessionState == XR_SESSION_STATE_FOCUSED)
+            {
+                var active = new XrActiveActionSet { ActionSet = actionSet };
+                var sync = new XrActionsSyncInfo { Type = XR_TYPE_ACTIONS_SYNC_INFO, CountActiveActionSets = 1, ActiveActionSets = &active };
+                xrSyncActions(session, &sync);
+            }
+
+            var endInfo = new XrFrameEndInfo
+            {
+                Type = XR_TYPE_FRAME_END_INFO,
+                DisplayTime = frameState.PredictedDisplayTime,
+                EnvironmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE
+            };
+            xrEndFrame(session, &endInfo);
+            long endTime = Stopwatch.GetTimestamp();
+
+            RecordFrame(waitStart, waitEnd, endTime, frameState.ShouldRender != 0);
+            return true;
+        }
+
+        private void PublishFrameTiming(long displayTime, long displayPeriod)
+        {
+            long displayTimestamp = ToTimestamp(displayTime);
+            long periodTicks = (long)(displayPeriod * (double)Stopwatch.Frequency / 1e9);
+
+            lock (frameTimeLock)
+            {
+                lastXrDisplayTime = displayTime;
+                predictedDisplayTimestamp = displayTimestamp;
+                predictedDisplayPeriodTicks = periodTicks;
+            }
+        }
+
+        private void RecordFrame(long waitStart, long waitEnd, long endTime, bool shouldRender)
+        {
+            double toMs = 1000.0 / Stopwatch.Frequency;
+            long n = ++statistics.Frames;
+            if (!shouldRender) statistics.SkippedRenders++;
+
+            TryGetPredictedDisplayTime(out long display, out long period);
+            statistics.MeanWaitMilliseconds += ((waitEnd - waitStart) * toMs - statistics.MeanWaitMilliseconds) / n;
+            statistics.MeanBeginToEndMilliseconds += ((endTime - waitEnd) * toMs - statistics.MeanBeginToEndMilliseconds) / n;
+            statistics.MeanDisplayLeadMilliseconds += ((display - waitEnd) * toMs - statistics.MeanDisplayLeadMilliseconds) / n;
+            statistics.DisplayPeriodMilliseconds = period * toMs;
+
+            if (n % LogInterval == 0)
+            {
+                Console.WriteLine($"OpenXR frame loop: {statistics}");
+            }
+        }
+
+        /// <summary>
+        /// Stream body trackers and finger skeletons into the buffers. Trackers get a slot the first time
+        /// they report, so roles nobody assigned never take one.
+        /// </summary>
+        public void Start(TrackedDeviceBuffers buffers)
+        {
+            if (deviceThread != null) return;
+            if (!trackersEnabled && !handTrackingEnabled)
+            {
+                Console.WriteLine("OpenXR: runtime has no body trackers or hand tracking");
+                return;
+            }
+
+            deviceBuffers = buffers;
+            deviceThread = new Thread(RunDeviceLoop)
+            {
+                Name = "OpenXR trackers",
+                IsBackground = true
+            };
+            deviceThread.Start();
+        }
+
+        private void RunDeviceLoop()
+        {
+            const int Unregistered = -1;
+            const int NoRoom = -2;
+
+            var trackerSlots = new int[trackerSpaces.Length];
+            Array.Fill(trackerSlots, Unregistered);
+            var joints = new XrHandJointLocationEXT[TrackedDeviceBuffers.HandJointCount];
+            var jointPositions = new Vector3[TrackedDeviceBuffers.HandJointCount];
+            var jointRotations = new Quaternion[TrackedDeviceBuffers.HandJointCount];
+            int interval = 1000 / Math.Max(1, settings.TrackedDeviceRateHz);
+
+            while (running)
+            {
+                if (!sessionRunning)
+                {
+                    Thread.Sleep(10);
+                    continue;
+                }
+
+                long time = CurrentXrTime();
+                long now = Stopwatch.GetTimestamp();
+
+                for (int tracker = 0; tracker < trackerSpaces.Length; tracker++)
+                {
+                    if (trackerSlots[tracker] == NoRoom || !TryLocate(trackerSpaces[tracker], time, out var position, out var rotation)) continue;
+
+                    if (trackerSlots[tracker] == Unregistered)
+                    {
+                        int slot = deviceBuffers.Register(TrackerRoles[tracker].Role);
+                        trackerSlots[tracker] = slot >= 0 ? slot : NoRoom;
+                        if (slot < 0) continue;
+                    }
+                    deviceBuffers.Write(trackerSlots[tracker], position, rotation, now);
+                }
+
+                for (int hand = 0; hand < 2 && handTrackingEnabled; hand++)
+                {
+                    if (LocateHand(hand, time, joints, jointPositions, jointRotations))
+                    {
+                        deviceBuffers.WriteHand(hand == 0 ? ControllerHand.Left : ControllerHand.Right, jointPositions, jointRotations, now);
+                    }
+                }
+
+                Thread.Sleep(interval);
+            }
+        }
+
+        private bool LocateHand(int hand, long time, XrHandJointLocationEXT[] joints, Vector3[] positions, Quaternion[] rotations)
+        {
+            fixed (XrHandJointLocationEXT* first = joints)
+            {
+                var info = new XrHandJointsLocateInfoEXT { Type = XR_TYPE_HAND_JOINTS_LOCATE_INFO_EXT, BaseSpace = playSpace, Time = time };
+                var locations = new XrHandJointLocationsEXT
+                {
+                    Type = XR_TYPE_HAND_JOINT_LOCATIONS_EXT,
+                    JointCount = (uint)joints.Length,
+                    JointLocations = first
+                };
+                if (time == 0 || locateHandJoints(handTrackers[hand], &info, &locations) < 0 || locations.IsActive == 0) return false;
+            }
+
+            // A skeleton with any joint missing would bend the hand into nonsense; treat it as untracked
+            const ulong valid = XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT;
+            for (int j = 0; j < joints.Length; j++)
+            {
+                if ((joints[j].LocationFlags & valid) != valid) return false;
+
+                var pose = joints[j].Pose;
+                positions[j] = new Vector3(pose.PositionX, pose.PositionY, pose.PositionZ);
+                rotations[j] = new Quaternion(pose.OrientationX, pose.OrientationY, pose.OrientationZ, pose.OrientationW);
+            }
+            return true;
+        }
+
+        public bool TryGetPredictedDisplayTime(out long displayTimestamp, out long displayPeriodTicks)
+        {
+            lock (frameTimeLock)
+            {
+                displayTimestamp = predictedDisplayTimestamp;
+                displayPeriodTicks = predictedDisplayPeriodTicks;
+            }
+            return displayTimestamp != 0;
+        }
+
+        public RawVRPose GetHeadsetPose()
+        {
+            return Locate(viewSpace, CurrentXrTime());
+        }
+
+        /// <summary>
+        /// Headset pose as the runtime predicts it for the frame being rendered, using its own motion model
+        /// </summary>
+        public RawVRPose GetPredictedHeadsetPose()
+        {
+            long displayTime;
+            lock (frameTimeLock) displayTime = lastXrDisplayTime;
+            return Locate(viewSpace, displayTime != 0 ? displayTime : CurrentXrTime());
+        }
+
+        public RawVRPose GetControllerPose(ControllerHand hand)
+        {
+            return Locate(handSpaces[HandIndex(hand)], CurrentXrTime());
+        }
+
+        public ControllerState GetControllerState(ControllerHand hand)
+        {
+            int index = HandIndex(hand);
+            var state = new ControllerState();
+
+            var info = new XrActionStateGetInfo { Type = XR_TYPE_ACTION_STATE_GET_INFO, Action = triggerAction, SubactionPath = handPaths[index] };
+            var trigger = new XrActionStateFloat { Type = XR_TYPE_ACTION_STATE_FLOAT };
+            if (xrGetActionStateFloat(session, &info, &trigger) >= 0 && trigger.IsActive != 0)
+            {
+                state.TriggerValue = trigger.CurrentState;
+            }
+
+            info.Action = thumbstickAction;
+            var stick = new XrActionStateVector2f { Type = XR_TYPE_ACTION_STATE_VECTOR2F };
+            if (xrGetActionStateVector2f(session, &info, &stick) >= 0 && stick.IsActive != 0)
+            {
+                state.ThumbstickPosition = new Vector2(stick.X, stick.Y);
+            }
+
+            var pose = GetControllerPose(hand);
+            state.Position = pose.Position;
+            state.Rotation = pose.Rotation;
+            return state;
+        }
+
+        private static int HandIndex(ControllerHand hand) => hand == ControllerHand.Left ? 0 : 1;
+
+        /// <summary>
+        /// Pose of a space in play space; false unless both position and orientation are tracked
+        /// </summary>
+        private bool TryLocate(ulong space, long time, out Vector3 position, out Quaternion rotation)
+        {
+            position = Vector3.Zero;
+            rotation = Quaternion.Identity;
+
+            var location = new XrSpaceLocation { Type = XR_TYPE_SPACE_LOCATION };
+            if (space == 0 || time == 0 || xrLocateSpace(space, playSpace, time, &location) < 0) return false;
+
+            const ulong valid = XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT;
+            if ((location.LocationFlags & valid) != valid) return false;
+
+            var pose = location.Pose;
+            position = new Vector3(pose.PositionX, pose.PositionY, pose.PositionZ);
+            rotation = new Quaternion(pose.OrientationX, pose.OrientationY, pose.OrientationZ, pose.OrientationW);
+            return true;
+        }
+
+        private RawVRPose Locate(ulong space, long time)
+        {
+            var location = new XrSpaceLocation { Type = XR_TYPE_SPACE_LOCATION };
+            if (space == 0 || time == 0 || xrLocateSpace(space, playSpace, time, &location) < 0)
+            {
+                return new RawVRPose { Position = Vector3.Zero, Rotation = Quaternion.Identity };
+            }
+
+            var pose = location.Pose;
+            bool orientationValid = (location.LocationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) != 0;
+            bool positionValid = (location.LocationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) != 0;
+            return new RawVRPose
+            {
+                Position = positionValid ? new Vector3(pose.PositionX, pose.PositionY, pose.PositionZ) : Vector3.Zero,
+                Rotation = orientationValid ? new Quaternion(pose.OrientationX, pose.OrientationY, pose.OrientationZ, pose.OrientationW) : Quaternion.Identity
+            };
+        }
+
+        // Stopwatch is QueryPerformanceCounter on Windows and CLOCK_MONOTONIC in nanoseconds elsewhere,
+        // which are exactly the clocks the two conversion extensions speak
+
+        private long CurrentXrTime()
+        {
+            long xrTime = 0;
+            if (counterToTime == null) return 0;
+
+            if (RuntimeInformation.IsOSPlatform(OSPlatform.Windows))
+            {
+                long counter = Stopwatch.GetTimestamp();
+                counterToTime(instance, &counter, &xrTime);
+            }
+            else
+            {
+                long nanoseconds = (long)(Stopwatch.GetTimestamp() * (1e9 / Stopwatch.Frequency));
+                var timespec = new Timespec { Seconds = nanoseconds / 1000000000, Nanoseconds = nanoseconds % 1000000000 };
+                counterToTime(instance, &timespec, &xrTime);
+            }
+            return xrTime;
+        }
+
+        private long ToTimestamp(long xrTime)
+        {
+            if (RuntimeInformation.IsOSPlatform(OSPlatform.Windows))
+            {
+                long counter = 0;
+                timeToCounter(instance, xrTime, &counter);
+                return counter;
+            }
+
+            var timespec = new Timespec();
+            timeToCounter(instance, xrTime, &timespec);
+            double nanoseconds = timespec.Seconds * 1e9 + timespec.Nanoseconds;
+            return (long)(nanoseconds * Stopwatch.Frequency / 1e9);
+        }
+
+        private ulong StringToPath(string path)
+        {
+            ulong result;
+            Check(xrStringToPath(instance, path, &result), $"xrStringToPath({path})");
+            return result;
+        }
+
+        private T GetFunction<T>(string name) where T : Delegate
+        {
+            IntPtr function;
+            Check(xrGetInstanceProcAddr(instance, name, &function), $"xrGetInstanceProcAddr({name})");
+            return Marshal.GetDelegateForFunctionPointer<T>(function);
+        }
+
+        private static void CopyString(string value, byte* destination, int capacity)
+        {
+            int length = Encoding.UTF8.GetBytes(value, new Span<byte>(destination, capacity - 1));
+            destination[length] = 0;
+        }
+
+        private static void Check(int result, string call)
+        {
+            if (result < 0)
+            {
+                throw new VRInitializationException($"OpenXR {call} failed ({result})");
+            }
+        }
+
+        public void Dispose()
+        {
+            running = false;
+            if (frameThread != null && frameThread != Thread.CurrentThread) frameThread.Join();
+            frameThread = null;
+            deviceThread?.Join();
+            deviceThread = null;
+
+            // Destroying the instance destroys the session, spaces and actions with it
+            if (instance != 0)
+            {
+                if (sessionRunning) xrEndSession(session);
+                xrDestroyInstance(instance);
+                instance = 0;
+                session = 0;
+            }
+        }
+
+        #region Native methods
+
+        private const string Loader = "openxr_loader";
+
+        private const int XR_SUCCESS = 0;
+        private const ulong XR_API_VERSION_1_0 = 1UL << 48;
+
+        private const int XR_TYPE_EXTENSION_PROPERTIES = 2;
+        private const int XR_TYPE_INSTANCE_CREATE_INFO = 3;
+        private const int XR_TYPE_SYSTEM_GET_INFO = 4;
+        private const int XR_TYPE_SESSION_CREATE_INFO = 8;
+        private const int XR_TYPE_SESSION_BEGIN_INFO = 10;
+        private const int XR_TYPE_FRAME_END_INFO = 12;
+        private const int XR_TYPE_EVENT_DATA_BUFFER = 16;
+        private const int XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED = 18;
+        private const int XR_TYPE_ACTION_STATE_FLOAT = 24;
+        private const int XR_TYPE_ACTION_STATE_VECTOR2F = 25;
+        private const int XR_TYPE_ACTION_SET_CREATE_INFO = 28;
+        private const int XR_TYPE_ACTION_CREATE_INFO = 29;
+        private const int XR_TYPE_FRAME_WAIT_INFO = 33;
+        private const int XR_TYPE_REFERENCE_SPACE_CREATE_INFO = 37;
+        private const int XR_TYPE_ACTION_SPACE_CREATE_INFO = 38;
+        private const int XR_TYPE_SPACE_LOCATION = 42;
+        private const int XR_TYPE_FRAME_STATE = 44;
+        private const int XR_TYPE_FRAME_BEGIN_INFO = 46;
+        private const int XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING = 51;
+        private const int XR_TYPE_ACTION_STATE_GET_INFO = 58;
+        private const int XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO = 60;
+        private const int XR_TYPE_ACTIONS_SYNC_INFO = 61;
+        private const int XR_TYPE_HAND_TRACKER_CREATE_INFO_EXT = 1000051001;
+        private const int XR_TYPE_HAND_JOINTS_LOCATE_INFO_EXT = 1000051002;
+        private const int XR_TYPE_HAND_JOINT_LOCATIONS_EXT = 1000051003;
+
+        private const int XR_HAND_LEFT_EXT = 1;
+        private const int XR_HAND_RIGHT_EXT = 2;
+        private const int XR_HAND_JOINT_SET_DEFAULT_EXT = 0;
+
+        private const int XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY = 1;
+        private const int XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO = 2;
+        private const int XR_ENVIRONMENT_BLEND_MODE_OPAQUE = 1;
+
+        private const int XR_REFERENCE_SPACE_TYPE_VIEW = 1;
+        private const int XR_REFERENCE_SPACE_TYPE_LOCAL = 2;
+        private const int XR_REFERENCE_SPACE_TYPE_STAGE = 3;
+
+        private const int XR_ACTION_TYPE_FLOAT_INPUT = 2;
+        private const int XR_ACTION_TYPE_VECTOR2F_INPUT = 3;
+        private const int XR_ACTION_TYPE_POSE_INPUT = 4;
+
+        private const int XR_SESSION_STATE_UNKNOWN = 0;
+        private const int XR_SESSION_STATE_READY = 2;
+        private const int XR_SESSION_STATE_FOCUSED = 5;
+        private const int XR_SESSION_STATE_STOPPING = 6;
+        private const int XR_SESSION_STATE_LOSS_PENDING = 7;
+        private const int XR_SESSION_STATE_EXITING = 8;
+
+        private const ulong XR_SPACE_LOCATION_ORIENTATION_VALID_BIT = 0x1;
+        private const ulong XR_SPACE_LOCATION_POSITION_VALID_BIT = 0x2;
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrExtensionProperties
+        {
+            public int Type;
+            public void* Next;
+            public fixed byte ExtensionName[128];
+            public uint ExtensionVersion;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrApplicationInfo
+        {
+            public fixed byte ApplicationName[128];
+            public uint ApplicationVersion;
+            public fixed byte EngineName[128];
+            public uint EngineVersion;
+            public ulong ApiVersion;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrInstanceCreateInfo
+        {
+            public int Type;
+            public void* Next;
+            public ulong CreateFlags;
+            public XrApplicationInfo ApplicationInfo;
+            public uint EnabledApiLayerCount;
+            public IntPtr* EnabledApiLayerNames;
+            public uint EnabledExtensionCount;
+            public IntPtr* EnabledExtensionNames;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrSystemGetInfo
+        {
+            public int Type;
+            public void* Next;
+            public int FormFactor;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrSessionCreateInfo
+        {
+            public int Type;
+            public void* Next;
+            public ulong CreateFlags;
+            public ulong SystemId;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrSessionBeginInfo
+        {
+            public int Type;
+            public void* Next;
+            public int PrimaryViewConfigurationType;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrPosef
+        {
+            public float OrientationX, OrientationY, OrientationZ, OrientationW;
+            public float PositionX, PositionY, PositionZ;
+
+            public static XrPosef Identity => new XrPosef { OrientationW = 1 };
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrReferenceSpaceCreateInfo
+        {
+            public int Type;
+            public void* Next;
+            public int ReferenceSpaceType;
+            public XrPosef PoseInReferenceSpace;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrActionSpaceCreateInfo
+        {
+            public int Type;
+            public void* Next;
+            public ulong Action;
+            public ulong SubactionPath;
+            public XrPosef PoseInActionSpace;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrSpaceLocation
+        {
+            public int Type;
+            public void* Next;
+            public ulong LocationFlags;
+            public XrPosef Pose;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrActionSetCreateInfo
+        {
+            public int Type;
+            public void* Next;
+            public fixed byte ActionSetName[64];
+            public fixed byte LocalizedActionSetName[128];
+            public uint Priority;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrActionCreateInfo
+        {
+            public int Type;
+            public void* Next;
+            public fixed byte ActionName[64];
+            public int ActionType;
+            public uint CountSubactionPaths;
+            public ulong* SubactionPaths;
+            public fixed byte LocalizedActionName[128];
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrActionSuggestedBinding
+        {
+            public ulong Action;
+            public ulong Binding;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrInteractionProfileSuggestedBinding
+        {
+            public int Type;
+            public void* Next;
+            public ulong InteractionProfile;
+            public uint CountSuggestedBindings;
+            public XrActionSuggestedBinding* SuggestedBindings;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrSessionActionSetsAttachInfo
+        {
+            public int Type;
+            public void* Next;
+            public uint CountActionSets;
+            public ulong* ActionSets;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrActiveActionSet
+        {
+            public ulong ActionSet;
+            public ulong SubactionPath;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrActionsSyncInfo
+        {
+            public int Type;
+            public void* Next;
+            public uint CountActiveActionSets;
+            public XrActiveActionSet* ActiveActionSets;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrActionStateGetInfo
+        {
+            public int Type;
+            public void* Next;
+            public ulong Action;
+            public ulong SubactionPath;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrActionStateFloat
+        {
+            public int Type;
+            public void* Next;
+            public float CurrentState;
+            public uint ChangedSinceLastSync;
+            public long LastChangeTime;
+            public uint IsActive;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrActionStateVector2f
+        {
+            public int Type;
+            public void* Next;
+            public float X, Y;
+            public uint ChangedSinceLastSync;
+            public long LastChangeTime;
+            public uint IsActive;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrFrameWaitInfo
+        {
+            public int Type;
+            public void* Next;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrFrameState
+        {
+            public int Type;
+            public void* Next;
+            public long PredictedDisplayTime;      // Runtime clock, nanoseconds
+            public long PredictedDisplayPeriod;
+            public uint ShouldRender;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrFrameBeginInfo
+        {
+            public int Type;
+            public void* Next;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrFrameEndInfo
+        {
+            public int Type;
+            public void* Next;
+            public long DisplayTime;
+            public int EnvironmentBlendMode;
+            public uint LayerCount;
+            public void** Layers;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrEventDataBuffer
+        {
+            public int Type;
+            public void* Next;
+            public fixed byte Varying[4000];
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrEventDataSessionStateChanged
+        {
+            public int Type;
+            public void* Next;
+            public ulong Session;
+            public int State;
+            public long Time;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrHandTrackerCreateInfoEXT
+        {
+            public int Type;
+            public void* Next;
+            public int Hand;
+            public int HandJointSet;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrHandJointsLocateInfoEXT
+        {
+            public int Type;
+            public void* Next;
+            public ulong BaseSpace;
+            public long Time;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrHandJointLocationEXT
+        {
+            public ulong LocationFlags;
+            public XrPosef Pose;
+            public float Radius;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct XrHandJointLocationsEXT
+        {
+            public int Type;
+            public void* Next;
+            public uint IsActive;
+            public uint JointCount;
+            public XrHandJointLocationEXT* JointLocations;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct Timespec
+        {
+            public long Seconds;
+            public long Nanoseconds;
+        }
+
+        // The D3D11, D3D12 and Vulkan requirement queries share a shape; OpenXRGraphicsBinding picks the one
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        private delegate int GetGraphicsRequirements(ulong instance, ulong systemId, void* requirements);
+
+        // Both conversion extensions share a shape: (instance, time, out platform time) and the reverse;
+        // the platform time is a LARGE_INTEGER or a struct timespec
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        private delegate int ConvertTimeToCounter(ulong instance, long time, void* platformTime);
+
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        private delegate int ConvertCounterToTime(ulong instance, void* platformTime, long* time);
+
+        // XR_EXT_hand_tracking, looked up through xrGetInstanceProcAddr like every extension function
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        private delegate int CreateHandTrackerEXT(ulong session, XrHandTrackerCreateInfoEXT* createInfo, ulong* handTracker);
+
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        private delegate int LocateHandJointsEXT(ulong handTracker, XrHandJointsLocateInfoEXT* locateInfo, XrHandJointLocationsEXT* locations);
+
+        [DllImport(Loader)]
+        private static extern int xrEnumerateInstanceExtensionProperties(byte* layerName, uint propertyCapacityInput, uint* propertyCountOutput, XrExtensionProperties* properties);
+
+        [DllImport(Loader)]
+        private static extern int xrCreateInstance(XrInstanceCreateInfo* createInfo, ulong* instance);
+
+        [DllImport(Loader)]
+        private static extern int xrDestroyInstance(ulong instance);
+
+        [DllImport(Loader)]
+        private static extern int xrGetInstanceProcAddr(ulong instance, [MarshalAs(UnmanagedType.LPUTF8Str)] string name, IntPtr* function);
+
+        [DllImport(Loader)]
+        private static extern int xrGetSystem(ulong instance, XrSystemGetInfo* getInfo, ulong* systemId);
+
+        [DllImport(Loader)]
+        private static extern int xrStringToPath(ulong instance, [MarshalAs(UnmanagedType.LPUTF8Str)] string pathString, ulong* path);
+
+        [DllImport(Loader)]
+        private static extern int xrCreateSession(ulong instance, XrSessionCreateInfo* createInfo, ulong* session);
+
+        [DllImport(Loader)]
+        private static extern int xrBeginSession(ulong session, XrSessionBeginInfo* beginInfo);
+
+        [DllImport(Loader)]
+        private static extern int xrEndSession(ulong session);
+
+        [DllImport(Loader)]
+        private static extern int xrPollEvent(ulong instance, XrEventDataBuffer* eventData);
+
+        [DllImport(Loader)]
+        private static extern int xrCreateReferenceSpace(ulong session, XrReferenceSpaceCreateInfo* createInfo, ulong* space);
+
+        [DllImport(Loader)]
+        private static extern int xrCreateActionSpace(ulong session, XrActionSpaceCreateInfo* createInfo, ulong* space);
+
+        [DllImport(Loader)]
+        private static extern int xrLocateSpace(ulong space, ulong baseSpace, long time, XrSpaceLocation* location);
+
+        [DllImport(Loader)]
+        private static extern int xrCreateActionSet(ulong instance, XrActionSetCreateInfo* createInfo, ulong* actionSet);
+
+        [DllImport(Loader)]
+        private static extern int xrCreateAction(ulong actionSet, XrActionCreateInfo* createInfo, ulong* action);
+
+        [DllImport(Loader)]
+        private static extern int xrSuggestInteractionProfileBindings(ulong instance, XrInteractionProfileSuggestedBinding* suggestedBindings);
+
+        [DllImport(Loader)]
+        private static extern int xrAttachSessionActionSets(ulong session, XrSessionActionSetsAttachInfo* attachInfo);
+
+        [DllImport(Loader)]
+        private static extern int xrSyncActions(ulong session, XrActionsSyncInfo* syncInfo);
+
+        [DllImport(Loader)]
+        private static extern int xrGetActionStateFloat(ulong session, XrActionStateGetInfo* getInfo, XrActionStateFloat* state);
+
+        [DllImport(Loader)]
+        private static extern int xrGetActionStateVector2f(ulong session, XrActionStateGetInfo* getInfo, XrActionStateVector2f* state);
+
+        [DllImport(Loader)]
+        private static extern int xrWaitFrame(ulong session, XrFrameWaitInfo* frameWaitInfo, XrFrameState* frameState);
+
+        [DllImport(Loader)]
+        private static extern int xrBeginFrame(ulong session, XrFrameBeginInfo* frameBeginInfo);
+
+        [DllImport(Loader)]
+        private static extern int xrEndFrame(ulong session, XrFrameEndInfo* frameEndInfo);
+
+        #endregion
+    }
+}
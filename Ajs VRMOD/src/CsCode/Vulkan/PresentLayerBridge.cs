@@ -0,0 +1,121 @@
+using System;
+using System.Diagnostics;
+using System.IO;
+using VRGameConverter.Diagnostics;
+using VRGameConverter.Ipc;
+
+namespace VRGameConverter.Vulkan
+{
+    /// <summary>
+    /// The mod's end of the Vulkan layer (VulkanPresentLayer), which runs in a runtime of its own inside the
+    /// game's Linux process. Its present timings come over a SharedMemoryChannel and go into the mod's
+    /// FrameAnalyzer: under DXVK the layer sees the real present, which happens on DXVK's own thread after the
+    /// DXGI Present we hook has returned. Captured frames come separately (PresentLayerReadback).
+    /// </summary>
+    public sealed class PresentLayerBridge : IDisposable
+    {
+        // The layer counts as present once it has sent something this recently
+        private static readonly long LiveTicks = Stopwatch.Frequency;
+
+        private readonly SharedMemoryChannel channel;
+
+        // Layer timestamps (TimeSpan ticks) are mapped onto our Stopwatch at the first sample; the analyzer
+        // only looks at differences, so a constant offset between the two clocks doesn't matter
+        private long layerOrigin = long.MinValue;
+        private long localOrigin;
+        private long pendingHookTicks = 0;
+        private long lastReceived = 0;
+
+        public long PresentsReceived { get; private set; }
+
+        private PresentLayerBridge(SharedMemoryChannel channel)
+        {
+            this.channel = channel;
+        }
+
+        /// <summary>
+        /// Connect to the layer of this launch session, or null when it isn't running (not under Proton, not a
+        /// Vulkan game, or not started yet)
+        /// </summary>
+        public static PresentLayerBridge TryConnect()
+        {
+            return TryConnect(VulkanPresentLayer.ChannelName);
+        }
+
+        public static PresentLayerBridge TryConnect(string channelName)
+        {
+            if (!File.Exists(SharedMemoryChannel.SharedMemoryPath(channelName))) return null;
+
+            try
+            {
+                return new PresentLayerBridge(new SharedMemoryChannel(channelName, ChannelSide.Manager));
+            }
+            catch (Exception e) when (e is IOException || e is InvalidOperationException || e is UnauthorizedAccessException)
+            {
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// Whether the layer has sent timings in the last second. A bridge that stays quiet belongs to a layer
+        /// that has gone (a channel left from an earlier run) and can be dropped.
+        /// </summary>
+        public bool Live => lastReceived != 0 && Stopwatch.GetTimestamp() - lastReceived < LiveTicks;
+
+        /// <summary>
+        /// Hand every present received since the last call to the analyzer, and forward the layer's log lines.
+        /// Returns Live: while it is true these timings replace the DXGI hook's, which under DXVK only measure
+        /// how long it takes to queue a present. Call from one thread only.
+        /// </summary>
+        public bool Drain(FrameAnalyzer analyzer)
+        {
+            while (channel.TryReadTelemetry(out var sample))
+            {
+                long now = Stopwatch.GetTimestamp();
+                lastReceived = now;
+                if (layerOrigin == long.MinValue)
+                {
+                    layerOrigin = sample.Timestamp;
+                    localOrigin = now;
+                }
+
+                long ticks = (long)(sample.Value * Stopwatch.Frequency / 1000.0);
+                switch (sample.Metric)
+                {
+                    case TelemetryMetric.LayerHookMs:
+                        pendingHookTicks += ticks;
+                        break;
+
+                    case TelemetryMetric.LayerPresentMs:
+                        // AddHookTime measures up to now, so the layer's time is added as if it had just started
+                        if (pendingHookTicks > 0)
+                        {
+                            analyzer.AddHookTime(Stopwatch.GetTimestamp() - pendingHookTicks);
+                            pendingHookTicks = 0;
+                        }
+
+                        long presentEnd = ToLocal(sample.Timestamp);
+                        analyzer.EndFrame(presentEnd - ticks, presentEnd);
+                        PresentsReceived++;
+                        break;
+                }
+            }
+
+            while (channel.TryReadLog(out var message))
+            {
+                Console.WriteLine($"Vulkan layer: {message}");
+            }
+            return Live;
+        }
+
+        private long ToLocal(long layerTimestamp)
+        {
+            return localOrigin + (long)((layerTimestamp - layerOrigin) * ((double)Stopwatch.Frequency / TimeSpan.TicksPerSecond));
+        }
+
+        public void Dispose()
+        {
+            channel.Dispose();
+        }
+    }
+}
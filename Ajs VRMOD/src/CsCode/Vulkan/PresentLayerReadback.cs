@@ -0,0 +1,101 @@
+using System;
+using System.Diagnostics;
+using System.IO;
+using VRGameConverter.Ipc;
+using VRGameConverter.Rendering;
+
+namespace VRGameConverter.Vulkan
+{
+    /// <summary>
+    /// Space warp's colour source under Proton on Vulkan: the frames the layer's SwapchainCapture publishes,
+    /// point-sampled to the pipeline's size. Only the present thread touches it, and it looks for a new frame
+    /// buffer by itself when the layer makes one (a new swapchain size) or the one it has stops updating (left
+    /// from an earlier run), so it can stay in place for the whole session.
+    /// </summary>
+    public sealed class PresentLayerReadback : IMotionReadback, IDisposable
+    {
+        private static readonly long RetryTicks = Stopwatch.Frequency;
+        private static readonly long StaleTicks = 2 * Stopwatch.Frequency;
+
+        private readonly string frameBufferName;
+        private SharedFrameBuffer frames;
+        private long nextAttempt = 0;
+        private long lastFrame = 0;
+
+        public PresentLayerReadback() : this(VulkanPresentLayer.FrameBufferName)
+        {
+        }
+
+        public PresentLayerReadback(string frameBufferName)
+        {
+            this.frameBufferName = frameBufferName;
+        }
+
+        // The layer only sees the presented image; the game's TAA inputs take the D3D hooks
+        public bool TryReadMotionVectors(IntPtr swapChain, float[] destination, int width, int height)
+        {
+            return false;
+        }
+
+        /// <summary>
+        /// The newest frame the layer captured, point-sampled to the destination. False until capture is running
+        /// (AJSVRMOD_VK_CAPTURE=1 in the game's environment) and between swapchain sizes.
+        /// </summary>
+        public bool TryReadColor(IntPtr swapChain, FrameImage destination)
+        {
+            long now = Stopwatch.GetTimestamp();
+            if (frames != null && (frames.Retired || now - lastFrame > StaleTicks))
+            {
+                frames.Dispose();
+                frames = null;
+            }
+
+            if (frames == null)
+            {
+                // Called every present; looking for the file once a second is plenty
+                if (now < nextAttempt) return false;
+                nextAttempt = now + RetryTicks;
+
+                try
+                {
+                    frames = SharedFrameBuffer.Open(frameBufferName);
+                }
+                catch (Exception e) when (e is IOException || e is InvalidOperationException || e is UnauthorizedAccessException)
+                {
+                    return false;
+                }
+                lastFrame = now;
+            }
+
+            if (frames.TryTakeLatest()) lastFrame = now;
+            if (frames.ReadTimestamp == 0) return false;
+
+            Resample(frames.ReadPixels, frames.Width, frames.Height, IsBgra(frames.Format), destination);
+            return true;
+        }
+
+        // VK_FORMAT_B8G8R8A8_UNORM and _SRGB; the R8G8B8A8 formats are already in FrameImage's order
+        private static bool IsBgra(int format) => format == 44 || format == 50;
+
+        private static void Resample(ReadOnlySpan<uint> source, int sourceWidth, int sourceHeight, bool bgra, FrameImage destination)
+        {
+            var pixels = destination.Pixels;
+            for (int y = 0; y < destination.Height; y++)
+            {
+                int sourceRow = (int)((y + 0.5f) * sourceHeight / destination.Height) * sourceWidth;
+                int row = y * destination.Width;
+                for (int x = 0; x < destination.Width; x++)
+                {
+                    uint p = source[sourceRow + (int)((x + 0.5f) * sourceWidth / destination.Width)];
+                    pixels[row + x] = bgra ? (p & 0xFF00FF00u) | ((p >> 16) & 0xFFu) | ((p & 0xFFu) << 16) : p;
+                }
+            }
+        }
+
+        public void Dispose()
+        {
+            frames?.Dispose();
+            frames = null;
+        }
+    }
+}
@@ -0,0 +1,668 @@
+using System;
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using System.Threading;
+using VRGameConverter.Ipc;
+
+namespace VRGameConverter.Vulkan
+{
+    /// <summary>
+    /// Eye-buffer capture for the Vulkan layer: every presented frame, HUD included, goes to the mod through a
+    /// SharedFrameBuffer (PresentLayerBridge reads it as the space warp colour source). The present thread only
+    /// records a copy into host memory and submits it on the game's own queue, chained between the game's
+    /// semaphores and the present; a worker waits for each copy and publishes it. When all three copies are
+    /// still in flight the frame is skipped rather than waited for.
+    /// </summary>
+    internal sealed unsafe class SwapchainCapture : IPresentObserver
+    {
+        private const int SlotCount = 3;
+
+        private const int Free = 0;
+        private const int Submitted = 1;
+
+        private const int VK_TIMEOUT = 2;
+        private const int VK_STRUCTURE_TYPE_SUBMIT_INFO = 4;
+        private const int VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO = 5;
+        private const int VK_STRUCTURE_TYPE_FENCE_CREATE_INFO = 8;
+        private const int VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO = 9;
+        private const int VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO = 12;
+        private const int VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO = 39;
+        private const int VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO = 40;
+        private const int VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO = 42;
+        private const int VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER = 44;
+        private const int VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER = 45;
+
+        private const int VK_FORMAT_R8G8B8A8_UNORM = 37;
+        private const int VK_FORMAT_R8G8B8A8_SRGB = 43;
+        private const int VK_FORMAT_B8G8R8A8_UNORM = 44;
+        private const int VK_FORMAT_B8G8R8A8_SRGB = 50;
+
+        private const int VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL = 6;
+        private const int VK_IMAGE_LAYOUT_PRESENT_SRC_KHR = 1000001002;
+
+        private const uint VK_QUEUE_GRAPHICS_BIT = 0x1;
+        private const uint VK_QUEUE_COMPUTE_BIT = 0x2;
+        private const uint VK_QUEUE_TRANSFER_BIT = 0x4;
+        private const uint VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT = 0x2;
+        private const uint VK_MEMORY_PROPERTY_HOST_COHERENT_BIT = 0x4;
+        private const uint VK_MEMORY_PROPERTY_HOST_CACHED_BIT = 0x8;
+        private const uint VK_BUFFER_USAGE_TRANSFER_DST_BIT = 0x2;
+        private const uint VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT = 0x2;
+        private const uint VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT = 0x1;
+        private const uint VK_FENCE_CREATE_SIGNALED_BIT = 0x1;
+        private const uint VK_ACCESS_TRANSFER_READ_BIT = 0x800;
+        private const uint VK_ACCESS_TRANSFER_WRITE_BIT = 0x1000;
+        private const uint VK_ACCESS_HOST_READ_BIT = 0x2000;
+        private const uint VK_PIPELINE_STAGE_TRANSFER_BIT = 0x1000;
+        private const uint VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT = 0x2000;
+        private const uint VK_PIPELINE_STAGE_HOST_BIT = 0x4000;
+        private const uint VK_IMAGE_ASPECT_COLOR_BIT = 0x1;
+        private const uint VK_QUEUE_FAMILY_IGNORED = ~0u;
+        private const ulong VK_WHOLE_SIZE = ~0ul;
+
+        #region Vulkan structures
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkCreateInfo
+        {
+            public int SType;
+            public void* PNext;
+            public uint Flags;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkCommandPoolCreateInfo
+        {
+            public int SType;
+            public void* PNext;
+            public uint Flags;
+            public uint QueueFamilyIndex;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkCommandBufferAllocateInfo
+        {
+            public int SType;
+            public void* PNext;
+            public ulong CommandPool;
+            public int Level;
+            public uint CommandBufferCount;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkCommandBufferBeginInfo
+        {
+            public int SType;
+            public void* PNext;
+            public uint Flags;
+            public void* PInheritanceInfo;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkBufferCreateInfo
+        {
+            public int SType;
+            public void* PNext;
+            public uint Flags;
+            public ulong Size;
+            public uint Usage;
+            public int SharingMode;
+            public uint QueueFamilyIndexCount;
+            public uint* PQueueFamilyIndices;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkMemoryRequirements
+        {
+            public ulong Size;
+            public ulong Alignment;
+            public uint MemoryTypeBits;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkMemoryAllocateInfo
+        {
+            public int SType;
+            public void* PNext;
+            public ulong AllocationSize;
+            public uint MemoryTypeIndex;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkImageSubresourceRange
+        {
+            public uint AspectMask;
+            public uint BaseMipLevel;
+            public uint LevelCount;
+            public uint BaseArrayLayer;
+            public uint LayerCount;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkImageMemoryBarrier
+        {
+            public int SType;
+            public void* PNext;
+            public uint SrcAccessMask;
+            public uint DstAccessMask;
+            public int OldLayout;
+            public int NewLayout;
+            public uint SrcQueueFamilyIndex;
+            public uint DstQueueFamilyIndex;
+            public ulong Image;
+            public VkImageSubresourceRange SubresourceRange;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkBufferMemoryBarrier
+        {
+            public int SType;
+            public void* PNext;
+            public uint SrcAccessMask;
+            public uint DstAccessMask;
+            public uint SrcQueueFamilyIndex;
+            public uint DstQueueFamilyIndex;
+            public ulong Buffer;
+            public ulong Offset;
+            public ulong Size;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkBufferImageCopy
+        {
+            public ulong BufferOffset;
+            public uint BufferRowLength;
+            public uint BufferImageHeight;
+            public uint AspectMask;
+            public uint MipLevel;
+            public uint BaseArrayLayer;
+            public uint LayerCount;
+            public int OffsetX, OffsetY, OffsetZ;
+            public uint Width, Height, Depth;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkSubmitInfo
+        {
+            public int SType;
+            public void* PNext;
+            public uint WaitSemaphoreCount;
+            public ulong* PWaitSemaphores;
+            public uint* PWaitDstStageMask;
+            public uint CommandBufferCount;
+            public IntPtr* PCommandBuffers;
+            public uint SignalSemaphoreCount;
+            public ulong* PSignalSemaphores;
+        }
+
+        #endregion
+
+        /// <summary>
+        /// The next layer's functions for one device, resolved once
+        /// </summary>
+        private sealed class DeviceFunctions
+        {
+            public delegate* unmanaged<IntPtr, VkCommandPoolCreateInfo*, void*, ulong*, int> CreateCommandPool;
+            public delegate* unmanaged<IntPtr, ulong, void*, void> DestroyCommandPool;
+            public delegate* unmanaged<IntPtr, VkCommandBufferAllocateInfo*, IntPtr*, int> AllocateCommandBuffers;
+            public delegate* unmanaged<IntPtr, VkCommandBufferBeginInfo*, int> BeginCommandBuffer;
+            public delegate* unmanaged<IntPtr, int> EndCommandBuffer;
+            public delegate* unmanaged<IntPtr, uint, uint, uint, uint, void*, uint, VkBufferMemoryBarrier*, uint, VkImageMemoryBarrier*, void> CmdPipelineBarrier;
+            public delegate* unmanaged<IntPtr, ulong, int, ulong, uint, VkBufferImageCopy*, void> CmdCopyImageToBuffer;
+            public delegate* unmanaged<IntPtr, uint, VkSubmitInfo*, ulong, int> QueueSubmit;
+            public delegate* unmanaged<IntPtr, VkCreateInfo*, void*, ulong*, int> CreateFence;
+            public delegate* unmanaged<IntPtr, ulong, void*, void> DestroyFence;
+            public delegate* unmanaged<IntPtr, uint, ulong*, uint, ulong, int> WaitForFences;
+            public delegate* unmanaged<IntPtr, uint, ulong*, int> ResetFences;
+            public delegate* unmanaged<IntPtr, VkCreateInfo*, void*, ulong*, int> CreateSemaphore;
+            public delegate* unmanaged<IntPtr, ulong, void*, void> DestroySemaphore;
+            public delegate* unmanaged<IntPtr, VkBufferCreateInfo*, void*, ulong*, int> CreateBuffer;
+            public delegate* unmanaged<IntPtr, ulong, void*, void> DestroyBuffer;
+            public delegate* unmanaged<IntPtr, ulong, VkMemoryRequirements*, void> GetBufferMemoryRequirements;
+            public delegate* unmanaged<IntPtr, VkMemoryAllocateInfo*, void*, ulong*, int> AllocateMemory;
+            public delegate* unmanaged<IntPtr, ulong, void*, void> FreeMemory;
+            public delegate* unmanaged<IntPtr, ulong, ulong, ulong, int> BindBufferMemory;
+            public delegate* unmanaged<IntPtr, ulong, ulong, ulong, uint, void**, int> MapMemory;
+
+            public DeviceFunctions(VulkanPresentLayer.DeviceDispatch dispatch)
+            {
+                CreateCommandPool = (delegate* unmanaged<IntPtr, VkCommandPoolCreateInfo*, void*, ulong*, int>)dispatch.Function("vkCreateCommandPool");
+                DestroyCommandPool = (delegate* unmanaged<IntPtr, ulong, void*, void>)dispatch.Function("vkDestroyCommandPool");
+                AllocateCommandBuffers = (delegate* unmanaged<IntPtr, VkCommandBufferAllocateInfo*, IntPtr*, int>)dispatch.Function("vkAllocateCommandBuffers");
+                BeginCommandBuffer = (delegate* unmanaged<IntPtr, VkCommandBufferBeginInfo*, int>)dispatch.Function("vkBeginCommandBuffer");
+                EndCommandBuffer = (delegate* unmanaged<IntPtr, int>)dispatch.Function("vkEndCommandBuffer");
+                CmdPipelineBarrier = (delegate* unmanaged<IntPtr, uint, uint, uint, uint, void*, uint, VkBufferMemoryBarrier*, uint, VkImageMemoryBarrier*, void>)dispatch.Function("vkCmdPipelineBarrier");
+                CmdCopyImageToBuffer = (delegate* unmanaged<IntPtr, ulong, int, ulong, uint, VkBufferImageCopy*, void>)dispatch.Function("vkCmdCopyImageToBuffer");
+                QueueSubmit = (delegate* unmanaged<IntPtr, uint, VkSubmitInfo*, ulong, int>)dispatch.Function("vkQueueSubmit");
+                CreateFence = (delegate* unmanaged<IntPtr, VkCreateInfo*, void*, ulong*, int>)dispatch.Function("vkCreateFence");
+                DestroyFence = (delegate* unmanaged<IntPtr, ulong, void*, void>)dispatch.Function("vkDestroyFence");
+                WaitForFences = (delegate* unmanaged<IntPtr, uint, ulong*, uint, ulong, int>)dispatch.Function("vkWaitForFences");
+                ResetFences = (delegate* unmanaged<IntPtr, uint, ulong*, int>)dispatch.Function("vkResetFences");
+                CreateSemaphore = (delegate* unmanaged<IntPtr, VkCreateInfo*, void*, ulong*, int>)dispatch.Function("vkCreateSemaphore");
+                DestroySemaphore = (delegate* unmanaged<IntPtr, ulong, void*, void>)dispatch.Function("vkDestroySemaphore");
+                CreateBuffer = (delegate* unmanaged<IntPtr, VkBufferCreateInfo*, void*, ulong*, int>)dispatch.Function("vkCreateBuffer");
+                DestroyBuffer = (delegate* unmanaged<IntPtr, ulong, void*, void>)dispatch.Function("vkDestroyBuffer");
+                GetBufferMemoryRequirements = (delegate* unmanaged<IntPtr, ulong, VkMemoryRequirements*, void>)dispatch.Function("vkGetBufferMemoryRequirements");
+                AllocateMemory = (delegate* unmanaged<IntPtr, VkMemoryAllocateInfo*, void*, ulong*, int>)dispatch.Function("vkAllocateMemory");
+                FreeMemory = (delegate* unmanaged<IntPtr, ulong, void*, void>)dispatch.Function("vkFreeMemory");
+                BindBufferMemory = (delegate* unmanaged<IntPtr, ulong, ulong, ulong, int>)dispatch.Function("vkBindBufferMemory");
+                MapMemory = (delegate* unmanaged<IntPtr, ulong, ulong, ulong, uint, void**, int>)dispatch.Function("vkMapMemory");
+            }
+        }
+
+        private sealed class Slot
+        {
+            public Target Owner;
+            public int Index;
+            public IntPtr CommandBuffer;
+            public ulong Fence;
+            public ulong Buffer;
+            public ulong Memory;
+            public uint* Mapped;
+            public int State;
+            public long Timestamp;
+        }
+
+        /// <summary>
+        /// Capture resources for one swapchain
+        /// </summary>
+        private sealed class Target
+        {
+            public IntPtr Device;
+            public VulkanPresentLayer.DeviceDispatch Dispatch;
+            public DeviceFunctions Functions;
+            public ulong Swapchain;
+            public uint Width;
+            public uint Height;
+            public int Format;
+            public ulong CommandPool;
+            public uint QueueFamily;
+            public readonly Slot[] Slots = new Slot[SlotCount];
+
+            // The semaphores the present waits on in place of the game's: native memory, so the present info
+            // can point at them
+            public ulong* Semaphores;
+            public int Next;
+            public bool Failed;
+        }
+
+        private readonly string frameBufferName;
+        private readonly ConcurrentDictionary<ulong, Target> targets = new ConcurrentDictionary<ulong, Target>();
+        private readonly ConcurrentQueue<Slot> submitted = new ConcurrentQueue<Slot>();
+        private readonly AutoResetEvent submittedEvent = new AutoResetEvent(false);
+        private readonly object frameLock = new object();
+        private readonly Thread worker;
+        private volatile Target active;
+        private SharedFrameBuffer frames;
+
+        public SwapchainCapture(string frameBufferName)
+        {
+            this.frameBufferName = frameBufferName;
+
+            worker = new Thread(Run)
+            {
+                Name = "Vulkan layer capture",
+                IsBackground = true
+            };
+            worker.Start();
+        }
+
+        public bool RequiresTransferSource => true;
+
+        public void OnSwapchainCreated(IntPtr device, ulong swapchain, uint width, uint height, int format, ulong[] images)
+        {
+            if (format != VK_FORMAT_R8G8B8A8_UNORM && format != VK_FORMAT_R8G8B8A8_SRGB &&
+                format != VK_FORMAT_B8G8R8A8_UNORM && format != VK_FORMAT_B8G8R8A8_SRGB)
+            {
+                VulkanPresentLayer.Log($"capture skips swapchain format {format}; only 8-bit RGBA and BGRA are copied");
+                return;
+            }
+
+            var dispatch = VulkanPresentLayer.FindDevice(device);
+            if (dispatch == null || dispatch.SetDeviceLoaderData == null) return;
+
+            var target = new Target
+            {
+                Device = device,
+                Dispatch = dispatch,
+                Functions = new DeviceFunctions(dispatch),
+                Swapchain = swapchain,
+                Width = width,
+                Height = height,
+                Format = format,
+                Semaphores = (ulong*)NativeMemory.AllocZeroed(SlotCount, sizeof(ulong))
+            };
+
+            if (!CreateBuffers(target))
+            {
+                DestroyTarget(target);
+                VulkanPresentLayer.Log("capture could not allocate readback buffers");
+                return;
+            }
+
+            // The newest swapchain is the one being shown; the mod gets frames at its size
+            lock (frameLock)
+            {
+                if (frames == null || frames.Width != width || frames.Height != height || frames.Format != format)
+                {
+                    // The old writer goes first: disposing it deletes the file by name
+                    frames?.Dispose();
+                    frames = SharedFrameBuffer.Create(frameBufferName, (int)width, (int)height, format);
+                }
+            }
+
+            targets[swapchain] = target;
+            active = target;
+        }
+
+        public void OnSwapchainDestroyed(IntPtr device, ulong swapchain)
+        {
+            if (!targets.TryRemove(swapchain, out var target)) return;
+            if (active == target) active = null;
+
+            // The worker lets go of each slot once its copy is done; give the GPU a second to finish. A copy
+            // still outstanding after that keeps its resources, which are leaked rather than pulled from under it.
+            var stopwatch = Stopwatch.StartNew();
+            foreach (var slot in target.Slots)
+            {
+                while (slot != null && Volatile.Read(ref slot.State) != Free)
+                {
+                    if (stopwatch.ElapsedMilliseconds > 1000)
+                    {
+                        VulkanPresentLayer.Log("capture copy did not finish; its resources are left behind");
+                        return;
+                    }
+                    Thread.Sleep(1);
+                }
+            }
+            DestroyTarget(target);
+        }
+
+        public void OnPresent(in PresentedImage image)
+        {
+            var target = active;
+            if (target == null || target.Swapchain != image.Swapchain || target.Failed) return;
+            if (!VulkanPresentLayer.TryGetQueueFamily(image.Queue, out uint family)) return;
+
+            if (target.CommandPool == 0 && !CreateCommands(target, family))
+            {
+                target.Failed = true;
+                return;
+            }
+            if (family != target.QueueFamily) return;
+
+            var slot = target.Slots[target.Next];
+            if (Volatile.Read(ref slot.State) != Free) return;
+
+            var presentInfo = (VulkanPresentLayer.VkPresentInfoKHR*)image.PresentInfo;
+            if (!RecordAndSubmit(target, slot, image, presentInfo)) return;
+
+            // The present now waits for the copy, which waited for the game
+            presentInfo->WaitSemaphoreCount = 1;
+            presentInfo->PWaitSemaphores = target.Semaphores + slot.Index;
+
+            target.Next = (target.Next + 1) % SlotCount;
+            slot.Timestamp = VulkanPresentLayer.ToTimeSpanTicks(Stopwatch.GetTimestamp());
+            Volatile.Write(ref slot.State, Submitted);
+            submitted.Enqueue(slot);
+            submittedEvent.Set();
+        }
+
+        private bool RecordAndSubmit(Target target, Slot slot, in PresentedImage image, VulkanPresentLayer.VkPresentInfoKHR* presentInfo)
+        {
+            var f = target.Functions;
+            IntPtr commandBuffer = slot.CommandBuffer;
+
+            var begin = new VkCommandBufferBeginInfo
+            {
+                SType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                Flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+            };
+            if (f.BeginCommandBuffer(commandBuffer, &begin) != VulkanPresentLayer.VK_SUCCESS) return false;
+
+            var range = new VkImageSubresourceRange { AspectMask = VK_IMAGE_ASPECT_COLOR_BIT, LevelCount = 1, LayerCount = 1 };
+            var toTransfer = new VkImageMemoryBarrier
+            {
+                SType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                DstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+                OldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                NewLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                SrcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                DstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                Image = image.Image,
+                SubresourceRange = range
+            };
+
+            // The semaphore wait happens at the transfer stage, so the barrier chains from there
+            f.CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, null, 0, null, 1, &toTransfer);
+
+            var region = new VkBufferImageCopy
+            {
+                AspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                LayerCount = 1,
+                Width = target.Width,
+                Height = target.Height,
+                Depth = 1
+            };
+            f.CmdCopyImageToBuffer(commandBuffer, image.Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot.Buffer, 1, &region);
+
+            var toPresent = toTransfer;
+            toPresent.SrcAccessMask = 0;
+            toPresent.DstAccessMask = 0;
+            toPresent.OldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            toPresent.NewLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+            var toHost = new VkBufferMemoryBarrier
+            {
+                SType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                SrcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                DstAccessMask = VK_ACCESS_HOST_READ_BIT,
+                SrcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                DstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                Buffer = slot.Buffer,
+                Size = VK_WHOLE_SIZE
+            };
+            f.CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 0, null, 1, &toHost, 1, &toPresent);
+
+            if (f.EndCommandBuffer(commandBuffer) != VulkanPresentLayer.VK_SUCCESS) return false;
+
+            uint waitCount = presentInfo->WaitSemaphoreCount;
+            uint* waitStages = stackalloc uint[(int)Math.Max(1, waitCount)];
+            for (int i = 0; i < waitCount; i++)
+            {
+                waitStages[i] = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            }
+
+            ulong fence = slot.Fence;
+            f.ResetFences(target.Device, 1, &fence);
+
+            var submit = new VkSubmitInfo
+            {
+                SType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                WaitSemaphoreCount = waitCount,
+                PWaitSemaphores = presentInfo->PWaitSemaphores,
+                PWaitDstStageMask = waitStages,
+                CommandBufferCount = 1,
+                PCommandBuffers = &commandBuffer,
+                SignalSemaphoreCount = 1,
+                PSignalSemaphores = target.Semaphores + slot.Index
+            };
+            return f.QueueSubmit(image.Queue, 1, &submit, fence) == VulkanPresentLayer.VK_SUCCESS;
+        }
+
+        private void Run()
+        {
+            while (true)
+            {
+                if (!submitted.TryPeek(out var slot))
+                {
+                    submittedEvent.WaitOne();
+                    continue;
+                }
+
+                var target = slot.Owner;
+                ulong fence = slot.Fence;
+                int result = target.Functions.WaitForFences(target.Device, 1, &fence, 1, 1000000000);
+                if (result == VK_TIMEOUT) continue;
+
+                submitted.TryDequeue(out _);
+                if (result == VulkanPresentLayer.VK_SUCCESS)
+                {
+                    Publish(target, slot);
+                }
+                else
+                {
+                    // Device lost: nothing more will come back from this swapchain
+                    target.Failed = true;
+                }
+                Volatile.Write(ref slot.State, Free);
+            }
+        }
+
+        private void Publish(Target target, Slot slot)
+        {
+            lock (frameLock)
+            {
+                var destination = frames;
+                if (destination == null || destination.Width != target.Width || destination.Height != target.Height ||
+                    destination.Format != target.Format) return;
+
+                new ReadOnlySpan<uint>(slot.Mapped, (int)(target.Width * target.Height)).CopyTo(destination.WritePixels);
+                destination.Publish(slot.Timestamp);
+            }
+        }
+
+        #region Resources
+
+        private static bool CreateBuffers(Target target)
+        {
+            var f = target.Functions;
+            ulong size = (ulong)target.Width * target.Height * sizeof(uint);
+
+            for (int i = 0; i < SlotCount; i++)
+            {
+                var slot = new Slot { Owner = target, Index = i };
+                target.Slots[i] = slot;
+
+                var bufferInfo = new VkBufferCreateInfo
+                {
+                    SType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+                    Size = size,
+                    Usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT
+                };
+                ulong buffer;
+                if (f.CreateBuffer(target.Device, &bufferInfo, null, &buffer) != VulkanPresentLayer.VK_SUCCESS) return false;
+                slot.Buffer = buffer;
+
+                VkMemoryRequirements requirements;
+                f.GetBufferMemoryRequirements(target.Device, slot.Buffer, &requirements);
+                int memoryType = FindHostMemory(target.Dispatch.MemoryTypeFlags, requirements.MemoryTypeBits);
+                if (memoryType < 0) return false;
+
+                var allocateInfo = new VkMemoryAllocateInfo
+                {
+                    SType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+                    AllocationSize = requirements.Size,
+                    MemoryTypeIndex = (uint)memoryType
+                };
+                ulong memory;
+                if (f.AllocateMemory(target.Device, &allocateInfo, null, &memory) != VulkanPresentLayer.VK_SUCCESS) return false;
+                slot.Memory = memory;
+                if (f.BindBufferMemory(target.Device, slot.Buffer, slot.Memory, 0) != VulkanPresentLayer.VK_SUCCESS) return false;
+
+                void* mapped;
+                if (f.MapMemory(target.Device, slot.Memory, 0, VK_WHOLE_SIZE, 0, &mapped) != VulkanPresentLayer.VK_SUCCESS) return false;
+                slot.Mapped = (uint*)mapped;
+
+                // Signalled, so the first reset before a submit has something to reset
+                var fenceInfo = new VkCreateInfo { SType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, Flags = VK_FENCE_CREATE_SIGNALED_BIT };
+                ulong fence;
+                if (f.CreateFence(target.Device, &fenceInfo, null, &fence) != VulkanPresentLayer.VK_SUCCESS) return false;
+                slot.Fence = fence;
+
+                var semaphoreInfo = new VkCreateInfo { SType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+                if (f.CreateSemaphore(target.Device, &semaphoreInfo, null, target.Semaphores + i) != VulkanPresentLayer.VK_SUCCESS) return false;
+            }
+            return true;
+        }
+
+        // Host-visible and coherent so the worker reads it without flushes; cached when there is a choice,
+        // since the worker reads every byte
+        private static int FindHostMemory(uint[] memoryTypeFlags, uint allowedTypes)
+        {
+            const uint required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            int found = -1;
+            for (int i = 0; i < memoryTypeFlags.Length; i++)
+            {
+                if ((allowedTypes & (1u << i)) == 0 || (memoryTypeFlags[i] & required) != required) continue;
+                if ((memoryTypeFlags[i] & VK_MEMORY_PROPERTY_HOST_CACHED_BIT) != 0) return i;
+                if (found < 0) found = i;
+            }
+            return found;
+        }
+
+        // On the first present, once the queue (and so the command pool's family) is known
+        private static bool CreateCommands(Target target, uint family)
+        {
+            var f = target.Functions;
+            var flags = target.Dispatch.QueueFamilyFlags;
+            if (family >= flags.Length || (flags[family] & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT)) == 0)
+            {
+                VulkanPresentLayer.Log($"capture needs transfer on the present queue; family {family} has none");
+                return false;
+            }
+
+            var poolInfo = new VkCommandPoolCreateInfo
+            {
+                SType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                Flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+                QueueFamilyIndex = family
+            };
+            ulong pool;
+            if (f.CreateCommandPool(target.Device, &poolInfo, null, &pool) != VulkanPresentLayer.VK_SUCCESS) return false;
+            target.CommandPool = pool;
+            target.QueueFamily = family;
+
+            IntPtr* commandBuffers = stackalloc IntPtr[SlotCount];
+            var allocateInfo = new VkCommandBufferAllocateInfo
+            {
+                SType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                CommandPool = pool,
+                CommandBufferCount = SlotCount
+            };
+            if (f.AllocateCommandBuffers(target.Device, &allocateInfo, commandBuffers) != VulkanPresentLayer.VK_SUCCESS) return false;
+
+            for (int i = 0; i < SlotCount; i++)
+            {
+                // Dispatchable handles made below the loader carry no dispatch table until the loader writes one
+                if (target.Dispatch.SetDeviceLoaderData(target.Device, commandBuffers[i]) != VulkanPresentLayer.VK_SUCCESS) return false;
+                target.Slots[i].CommandBuffer = commandBuffers[i];
+            }
+            return true;
+        }
+
+        private static void DestroyTarget(Target target)
+        {
+            var f = target.Functions;
+            IntPtr device = target.Device;
+
+            // Freeing the pool frees its command buffers; freeing memory unmaps it
+            if (target.CommandPool != 0) f.DestroyCommandPool(device, target.CommandPool, null);
+            foreach (var slot in target.Slots)
+            {
+                if (slot == null) continue;
+                if (slot.Fence != 0) f.DestroyFence(device, slot.Fence, null);
+                if (slot.Buffer != 0) f.DestroyBuffer(device, slot.Buffer, null);
+                if (slot.Memory != 0) f.FreeMemory(device, slot.Memory, null);
+            }
+            for (int i = 0; i < SlotCount; i++)
+            {
+                if (target.Semaphores[i] != 0) f.DestroySemaphore(device, target.Semaphores[i], null);
+            }
+            NativeMemory.Free(target.Semaphores);
+        }
+
+        #endregion
+    }
+}
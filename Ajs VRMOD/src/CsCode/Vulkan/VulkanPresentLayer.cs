@@ -0,0 +1,870 @@
+using System;
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using System.IO;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Text;
+using VRGameConverter.Ipc;
+
+namespace VRGameConverter.Vulkan
+{
+    /// <summary>
+    /// One image on its way to the screen, as seen by the present layer
+    /// </summary>
+    public unsafe struct PresentedImage
+    {
+        public IntPtr Device;
+        public IntPtr Queue;
+        public ulong Swapchain;
+        public uint ImageIndex;
+        public ulong Image;            // VkImage of the swapchain image being presented
+        public uint Width;
+        public uint Height;
+        public int Format;             // VkFormat
+
+        // The layer's copy of the VkPresentInfoKHR about to be forwarded. An observer that records GPU copies
+        // of the image must wait on its semaphores and may point pWaitSemaphores at its own before the present
+        // goes on.
+        public void* PresentInfo;
+    }
+
+    /// <summary>
+    /// Eye-buffer and HUD capture backends. Called on the game's present thread, so keep it to recording
+    /// commands; anything slow belongs on another thread.
+    /// </summary>
+    public interface IPresentObserver
+    {
+        // Asked before swapchains are created: whether their images need TRANSFER_SRC usage for copying out
+        bool RequiresTransferSource { get; }
+
+        void OnSwapchainCreated(IntPtr device, ulong swapchain, uint width, uint height, int format, ulong[] images);
+        void OnSwapchainDestroyed(IntPtr device, ulong swapchain);
+        void OnPresent(in PresentedImage image);
+    }
+
+    /// <summary>
+    /// What the layer costs per present, kept as running means
+    /// </summary>
+    public struct PresentLayerStatistics
+    {
+        public long Presents;
+        public double MeanLayerNanoseconds;         // Our own bookkeeping, excluding the observer and the driver
+        public double MeanObserverMicroseconds;
+        public double MeanPresentMilliseconds;      // Inside the next layer's / driver's vkQueuePresentKHR
+
+        public override string ToString()
+        {
+            return $"{Presents} presents, layer {MeanLayerNanoseconds:F0} ns, observer {MeanObserverMicroseconds:F1} us, " +
+                $"driver present {MeanPresentMilliseconds:F2} ms";
+        }
+    }
+
+    /// <summary>
+    /// Vulkan implicit layer for games running on Vulkan under Proton (DXVK for D3D9-11, VKD3D-Proton for D3D12).
+    /// Sits between the translation layer and the driver, so present interception, frame timing and swapchain
+    /// capture work without any Windows-side hooks. Built as a NativeAOT shared library (src/VkLayer); the
+    /// loader finds it through VkLayer_ajs_vrmod.json and talks to it only through the three exported entry
+    /// points.
+    ///
+    /// The library carries its own runtime, so nothing here is shared with the mod in the game's Windows
+    /// process: frame timings and logs go over a SharedMemoryChannel and captured frames over a
+    /// SharedFrameBuffer, both of which the mod reads through PresentLayerBridge.
+    /// </summary>
+    public static unsafe class VulkanPresentLayer
+    {
+        private const int LogInterval = 900;
+
+        internal const int VK_SUCCESS = 0;
+        private const int VK_ERROR_OUT_OF_HOST_MEMORY = -1;
+        private const int VK_ERROR_INITIALIZATION_FAILED = -3;
+        private const int VK_STRUCTURE_TYPE_LOADER_INSTANCE_CREATE_INFO = 47;
+        private const int VK_STRUCTURE_TYPE_LOADER_DEVICE_CREATE_INFO = 48;
+        private const int VK_LAYER_LINK_INFO = 0;
+        private const int VK_LOADER_DATA_CALLBACK = 1;
+        private const int LAYER_NEGOTIATE_INTERFACE_STRUCT = 1;
+        private const uint VK_IMAGE_USAGE_TRANSFER_SRC_BIT = 0x1;
+
+        // Loader chain structures (vk_layer.h)
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkNegotiateLayerInterface
+        {
+            public int SType;
+            public void* PNext;
+            public uint LoaderLayerInterfaceVersion;
+            public IntPtr PfnGetInstanceProcAddr;
+            public IntPtr PfnGetDeviceProcAddr;
+            public IntPtr PfnGetPhysicalDeviceProcAddr;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkLayerInstanceLink
+        {
+            public VkLayerInstanceLink* PNext;
+            public IntPtr PfnNextGetInstanceProcAddr;
+            public IntPtr PfnNextGetPhysicalDeviceProcAddr;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkLayerDeviceLink
+        {
+            public VkLayerDeviceLink* PNext;
+            public IntPtr PfnNextGetInstanceProcAddr;
+            public IntPtr PfnNextGetDeviceProcAddr;
+        }
+
+        // VkLayerInstanceCreateInfo and VkLayerDeviceCreateInfo share this shape. The union holds the link
+        // (LayerInfo) for VK_LAYER_LINK_INFO and the loader's SetDeviceLoaderData for VK_LOADER_DATA_CALLBACK.
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkLayerCreateInfo
+        {
+            public int SType;
+            public void* PNext;
+            public int Function;
+            public void* LayerInfo;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct VkDeviceQueueInfo2
+        {
+            public int SType;
+            public void* PNext;
+            public uint Flags;
+            public uint QueueFamilyIndex;
+            public uint QueueIndex;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkQueueFamilyProperties
+        {
+            public uint QueueFlags;
+            public uint QueueCount;
+            public uint TimestampValidBits;
+            public uint MinImageTransferGranularityWidth;
+            public uint MinImageTransferGranularityHeight;
+            public uint MinImageTransferGranularityDepth;
+        }
+
+        // VkPhysicalDeviceMemoryProperties: the count, then 32 (propertyFlags, heapIndex) pairs; the heaps after
+        // them aren't needed
+        private const int MemoryPropertiesSize = 520;
+        private const int MaxMemoryTypes = 32;
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkBaseStructure
+        {
+            public int SType;
+            public void* PNext;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct VkSwapchainCreateInfoKHR
+        {
+            public int SType;
+            public void* PNext;
+            public uint Flags;
+            public ulong Surface;
+            public uint MinImageCount;
+            public int ImageFormat;
+            public int ImageColorSpace;
+            public uint ImageWidth;
+            public uint ImageHeight;
+            public uint ImageArrayLayers;
+            public uint ImageUsage;
+            public int ImageSharingMode;
+            public uint QueueFamilyIndexCount;
+            public uint* PQueueFamilyIndices;
+            public int PreTransform;
+            public int CompositeAlpha;
+            public int PresentMode;
+            public uint Clipped;
+            public ulong OldSwapchain;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct VkPresentInfoKHR
+        {
+            public int SType;
+            public void* PNext;
+            public uint WaitSemaphoreCount;
+            public ulong* PWaitSemaphores;
+            public uint SwapchainCount;
+            public ulong* PSwapchains;
+            public uint* PImageIndices;
+            public int* PResults;
+        }
+
+        private sealed class InstanceDispatch
+        {
+            public IntPtr Instance;
+            public delegate* unmanaged<IntPtr, byte*, IntPtr> GetInstanceProcAddr;
+            public delegate* unmanaged<IntPtr, void*, void> DestroyInstance;
+        }
+
+        /// <summary>
+        /// The next layer's device functions, and what observers need to record their own commands on the device
+        /// </summary>
+        internal sealed class DeviceDispatch
+        {
+            public IntPtr Device;
+            public delegate* unmanaged<IntPtr, byte*, IntPtr> GetDeviceProcAddr;
+            public delegate* unmanaged<IntPtr, void*, void> DestroyDevice;
+            public delegate* unmanaged<IntPtr, uint, uint, IntPtr*, void> GetDeviceQueue;
+            public delegate* unmanaged<IntPtr, VkDeviceQueueInfo2*, IntPtr*, void> GetDeviceQueue2;
+            public delegate* unmanaged<IntPtr, VkSwapchainCreateInfoKHR*, void*, ulong*, int> CreateSwapchain;
+            public delegate* unmanaged<IntPtr, ulong, void*, void> DestroySwapchain;
+            public delegate* unmanaged<IntPtr, ulong, uint*, ulong*, int> GetSwapchainImages;
+            public delegate* unmanaged<IntPtr, VkPresentInfoKHR*, int> QueuePresent;
+
+            // Command buffers a layer allocates itself need the loader's dispatch pointer written into them
+            public delegate* unmanaged<IntPtr, IntPtr, int> SetDeviceLoaderData;
+
+            // VkQueueFlags per queue family, VkMemoryPropertyFlags per memory type
+            public uint[] QueueFamilyFlags;
+            public uint[] MemoryTypeFlags;
+
+            public IntPtr Function(string name) => Lookup(GetDeviceProcAddr, Device, name);
+        }
+
+        private sealed class SwapchainInfo
+        {
+            public uint Width;
+            public uint Height;
+            public int Format;
+            public ulong[] Images;
+        }
+
+        // Keyed by the loader's dispatch table pointer, the first word of every dispatchable handle; a queue
+        // shares its device's key, a physical device its instance's
+        private static readonly ConcurrentDictionary<IntPtr, InstanceDispatch> instances = new ConcurrentDictionary<IntPtr, InstanceDispatch>();
+        private static readonly ConcurrentDictionary<IntPtr, DeviceDispatch> devices = new ConcurrentDictionary<IntPtr, DeviceDispatch>();
+        private static readonly ConcurrentDictionary<ulong, SwapchainInfo> swapchains = new ConcurrentDictionary<ulong, SwapchainInfo>();
+        private static readonly ConcurrentDictionary<IntPtr, uint> queueFamilies = new ConcurrentDictionary<IntPtr, uint>();
+
+        // Presents can come from more than one thread (one per swapchain in DXVK); the channel's rings and the
+        // statistics each take a single writer
+        private static readonly object presentLock = new object();
+        private static readonly object startLock = new object();
+        private static bool started = false;
+        private static SharedMemoryChannel channel;
+
+        private static PresentLayerStatistics statistics;
+        private static long lastPresentEnd = 0;
+
+        public static IPresentObserver Observer { get; set; }
+        public static PresentLayerStatistics Statistics => statistics;
+
+        // Game pacing between presents, the same measure RenderSystem takes from the DXGI present hook
+        public static double LastFrameMilliseconds { get; private set; }
+
+        // The mod and the layer are started from the same launch environment, so the session they meet in comes
+        // from there: the launcher's session id, else the Steam app id
+        public static string SessionName =>
+            Environment.GetEnvironmentVariable("AJSVRMOD_SESSION") ?? Environment.GetEnvironmentVariable("SteamAppId") ?? "default";
+
+        public static string ChannelName => $"vrmod_layer_{SessionName}";
+        public static string FrameBufferName => $"vrmod_layer_{SessionName}_frame";
+
+        private static IntPtr DispatchKey(IntPtr handle) => *(IntPtr*)handle;
+
+        internal static DeviceDispatch FindDevice(IntPtr device)
+        {
+            return device != IntPtr.Zero && devices.TryGetValue(DispatchKey(device), out var dispatch) ? dispatch : null;
+        }
+
+        internal static bool TryGetQueueFamily(IntPtr queue, out uint family)
+        {
+            return queueFamilies.TryGetValue(queue, out family);
+        }
+
+        /// <summary>
+        /// Open the channel to the mod, and start frame capture when asked for (AJSVRMOD_VK_CAPTURE=1), on the
+        /// first instance. Neither is needed for the game to run, so failing here only costs the feature.
+        /// </summary>
+        private static void Start()
+        {
+            lock (startLock)
+            {
+                if (started) return;
+                started = true;
+
+                try
+                {
+                    channel = new SharedMemoryChannel(ChannelName, ChannelSide.Game);
+                }
+                catch (Exception e) when (e is IOException || e is UnauthorizedAccessException)
+                {
+                    Console.WriteLine($"Vulkan layer: no channel to the mod ({e.Message}); timings stay in this process");
+                }
+
+                if (Observer == null && Environment.GetEnvironmentVariable("AJSVRMOD_VK_CAPTURE") == "1")
+                {
+                    Observer = new SwapchainCapture(FrameBufferName);
+                }
+            }
+        }
+
+        internal static void Log(string message)
+        {
+            Console.WriteLine($"Vulkan layer: {message}");
+            lock (presentLock)
+            {
+                channel?.Log(message);
+            }
+        }
+
+        // Entry points are called from native code, where an exception would take the game down with it
+        private static void Failed(string function, Exception e)
+        {
+            try
+            {
+                Log($"{function} failed: {e}");
+            }
+            catch
+            {
+                // Nowhere left to report it
+            }
+        }
+
+        #region Loader entry points
+
+        [UnmanagedCallersOnly(EntryPoint = "vkNegotiateLoaderLayerInterfaceVersion")]
+        private static int NegotiateLoaderLayerInterfaceVersion(VkNegotiateLayerInterface* negotiate)
+        {
+            try
+            {
+                return Negotiate(negotiate);
+            }
+            catch (Exception e)
+            {
+                Failed("vkNegotiateLoaderLayerInterfaceVersion", e);
+                return VK_ERROR_INITIALIZATION_FAILED;
+            }
+        }
+
+        private static int Negotiate(VkNegotiateLayerInterface* negotiate)
+        {
+            if (negotiate == null || negotiate->SType != LAYER_NEGOTIATE_INTERFACE_STRUCT) return VK_ERROR_INITIALIZATION_FAILED;
+
+            // Interface 2 is all we need: the loader calls our GetInstanceProcAddr/GetDeviceProcAddr directly
+            negotiate->LoaderLayerInterfaceVersion = Math.Min(negotiate->LoaderLayerInterfaceVersion, 2u);
+            negotiate->PfnGetInstanceProcAddr = (IntPtr)(delegate* unmanaged<IntPtr, byte*, IntPtr>)&GetInstanceProcAddr;
+            negotiate->PfnGetDeviceProcAddr = (IntPtr)(delegate* unmanaged<IntPtr, byte*, IntPtr>)&GetDeviceProcAddr;
+            negotiate->PfnGetPhysicalDeviceProcAddr = IntPtr.Zero;
+            return VK_SUCCESS;
+        }
+
+        [UnmanagedCallersOnly(EntryPoint = "vkGetInstanceProcAddr")]
+        private static IntPtr GetInstanceProcAddr(IntPtr instance, byte* name)
+        {
+            try
+            {
+                return InstanceProcAddr(instance, name);
+            }
+            catch (Exception e)
+            {
+                Failed("vkGetInstanceProcAddr", e);
+                return IntPtr.Zero;
+            }
+        }
+
+        private static IntPtr InstanceProcAddr(IntPtr instance, byte* name)
+        {
+            IntPtr own = InstanceFunction(name);
+            if (own == IntPtr.Zero) own = DeviceFunction(name);
+            if (own != IntPtr.Zero) return own;
+
+            if (instance == IntPtr.Zero || !instances.TryGetValue(DispatchKey(instance), out var dispatch)) return IntPtr.Zero;
+            return dispatch.GetInstanceProcAddr(instance, name);
+        }
+
+        [UnmanagedCallersOnly(EntryPoint = "vkGetDeviceProcAddr")]
+        private static IntPtr GetDeviceProcAddr(IntPtr device, byte* name)
+        {
+            try
+            {
+                return DeviceProcAddr(device, name);
+            }
+            catch (Exception e)
+            {
+                Failed("vkGetDeviceProcAddr", e);
+                return IntPtr.Zero;
+            }
+        }
+
+        private static IntPtr DeviceProcAddr(IntPtr device, byte* name)
+        {
+            IntPtr own = DeviceFunction(name);
+            if (own != IntPtr.Zero) return own;
+
+            if (device == IntPtr.Zero || !devices.TryGetValue(DispatchKey(device), out var dispatch)) return IntPtr.Zero;
+            return dispatch.GetDeviceProcAddr(device, name);
+        }
+
+        private static IntPtr InstanceFunction(byte* name)
+        {
+            if (NameIs(name, "vkGetInstanceProcAddr")) return (IntPtr)(delegate* unmanaged<IntPtr, byte*, IntPtr>)&GetInstanceProcAddr;
+            if (NameIs(name, "vkCreateInstance")) return (IntPtr)(delegate* unmanaged<void*, void*, IntPtr*, int>)&CreateInstance;
+            if (NameIs(name, "vkDestroyInstance")) return (IntPtr)(delegate* unmanaged<IntPtr, void*, void>)&DestroyInstance;
+            if (NameIs(name, "vkCreateDevice")) return (IntPtr)(delegate* unmanaged<IntPtr, void*, void*, IntPtr*, int>)&CreateDevice;
+            return IntPtr.Zero;
+        }
+
+        private static IntPtr DeviceFunction(byte* name)
+        {
+            if (NameIs(name, "vkGetDeviceProcAddr")) return (IntPtr)(delegate* unmanaged<IntPtr, byte*, IntPtr>)&GetDeviceProcAddr;
+            if (NameIs(name, "vkDestroyDevice")) return (IntPtr)(delegate* unmanaged<IntPtr, void*, void>)&DestroyDevice;
+            if (NameIs(name, "vkGetDeviceQueue")) return (IntPtr)(delegate* unmanaged<IntPtr, uint, uint, IntPtr*, void>)&GetDeviceQueue;
+            if (NameIs(name, "vkGetDeviceQueue2")) return (IntPtr)(delegate* unmanaged<IntPtr, VkDeviceQueueInfo2*, IntPtr*, void>)&GetDeviceQueue2;
+            if (NameIs(name, "vkCreateSwapchainKHR")) return (IntPtr)(delegate* unmanaged<IntPtr, VkSwapchainCreateInfoKHR*, void*, ulong*, int>)&CreateSwapchain;
+            if (NameIs(name, "vkDestroySwapchainKHR")) return (IntPtr)(delegate* unmanaged<IntPtr, ulong, void*, void>)&DestroySwapchain;
+            if (NameIs(name, "vkQueuePresentKHR")) return (IntPtr)(delegate* unmanaged<IntPtr, VkPresentInfoKHR*, int>)&QueuePresent;
+            return IntPtr.Zero;
+        }
+
+        private static bool NameIs(byte* name, string expected)
+        {
+            if (name == null) return false;
+            for (int i = 0; i < expected.Length; i++)
+            {
+                if (name[i] != expected[i]) return false;
+            }
+            return name[expected.Length] == 0;
+        }
+
+        #endregion
+
+        #region Instance and device
+
+        private static VkLayerCreateInfo* FindLayerInfo(void* next, int structureType, int function)
+        {
+            var chain = (VkLayerCreateInfo*)next;
+            while (chain != null && !(chain->SType == structureType && chain->Function == function))
+            {
+                chain = (VkLayerCreateInfo*)chain->PNext;
+            }
+            return chain;
+        }
+
+        [UnmanagedCallersOnly]
+        private static int CreateInstance(void* createInfo, void* allocator, IntPtr* instance)
+        {
+            try
+            {
+                Start();
+                return CreateInstanceCore(createInfo, allocator, instance);
+            }
+            catch (Exception e)
+            {
+                Failed("vkCreateInstance", e);
+                return VK_ERROR_OUT_OF_HOST_MEMORY;
+            }
+        }
+
+        private static int CreateInstanceCore(void* createInfo, void* allocator, IntPtr* instance)
+        {
+            var chain = FindLayerInfo(((VkBaseStructure*)createInfo)->PNext, VK_STRUCTURE_TYPE_LOADER_INSTANCE_CREATE_INFO, VK_LAYER_LINK_INFO);
+            if (chain == null) return VK_ERROR_INITIALIZATION_FAILED;
+
+            var link = (VkLayerInstanceLink*)chain->LayerInfo;
+            var nextGetInstanceProcAddr = (delegate* unmanaged<IntPtr, byte*, IntPtr>)link->PfnNextGetInstanceProcAddr;
+
+            // Hand the rest of the chain to the next layer
+            chain->LayerInfo = link->PNext;
+
+            var nextCreate = (delegate* unmanaged<void*, void*, IntPtr*, int>)Lookup(nextGetInstanceProcAddr, IntPtr.Zero, "vkCreateInstance");
+            if (nextCreate == null) return VK_ERROR_INITIALIZATION_FAILED;
+
+            int result = nextCreate(createInfo, allocator, instance);
+            if (result != VK_SUCCESS) return result;
+
+            instances[DispatchKey(*instance)] = new InstanceDispatch
+            {
+                Instance = *instance,
+                GetInstanceProcAddr = nextGetInstanceProcAddr,
+                DestroyInstance = (delegate* unmanaged<IntPtr, void*, void>)Lookup(nextGetInstanceProcAddr, *instance, "vkDestroyInstance")
+            };
+            return VK_SUCCESS;
+        }
+
+        [UnmanagedCallersOnly]
+        private static void DestroyInstance(IntPtr instance, void* allocator)
+        {
+            try
+            {
+                if (instance == IntPtr.Zero || !instances.TryRemove(DispatchKey(instance), out var dispatch)) return;
+                dispatch.DestroyInstance(instance, allocator);
+            }
+            catch (Exception e)
+            {
+                Failed("vkDestroyInstance", e);
+            }
+        }
+
+        [UnmanagedCallersOnly]
+        private static int CreateDevice(IntPtr physicalDevice, void* createInfo, void* allocator, IntPtr* device)
+        {
+            try
+            {
+                return CreateDeviceCore(physicalDevice, createInfo, allocator, device);
+            }
+            catch (Exception e)
+            {
+                Failed("vkCreateDevice", e);
+                return VK_ERROR_OUT_OF_HOST_MEMORY;
+            }
+        }
+
+        private static int CreateDeviceCore(IntPtr physicalDevice, void* createInfo, void* allocator, IntPtr* device)
+        {
+            void* next = ((VkBaseStructure*)createInfo)->PNext;
+            var chain = FindLayerInfo(next, VK_STRUCTURE_TYPE_LOADER_DEVICE_CREATE_INFO, VK_LAYER_LINK_INFO);
+            if (chain == null || !instances.TryGetValue(DispatchKey(physicalDevice), out var instance)) return VK_ERROR_INITIALIZATION_FAILED;
+
+            var loaderData = FindLayerInfo(next, VK_STRUCTURE_TYPE_LOADER_DEVICE_CREATE_INFO, VK_LOADER_DATA_CALLBACK);
+
+            var link = (VkLayerDeviceLink*)chain->LayerInfo;
+            var nextGetInstanceProcAddr = (delegate* unmanaged<IntPtr, byte*, IntPtr>)link->PfnNextGetInstanceProcAddr;
+            var nextGetDeviceProcAddr = (delegate* unmanaged<IntPtr, byte*, IntPtr>)link->PfnNextGetDeviceProcAddr;
+            chain->LayerInfo = link->PNext;
+
+            var nextCreate = (delegate* unmanaged<IntPtr, void*, void*, IntPtr*, int>)Lookup(nextGetInstanceProcAddr, instance.Instance, "vkCreateDevice");
+            if (nextCreate == null) return VK_ERROR_INITIALIZATION_FAILED;
+
+            int result = nextCreate(physicalDevice, createInfo, allocator, device);
+            if (result != VK_SUCCESS) return result;
+
+            IntPtr created = *device;
+            devices[DispatchKey(created)] = new DeviceDispatch
+            {
+                Device = created,
+                GetDeviceProcAddr = nextGetDeviceProcAddr,
+                DestroyDevice = (delegate* unmanaged<IntPtr, void*, void>)Lookup(nextGetDeviceProcAddr, created, "vkDestroyDevice"),
+                GetDeviceQueue = (delegate* unmanaged<IntPtr, uint, uint, IntPtr*, void>)Lookup(nextGetDeviceProcAddr, created, "vkGetDeviceQueue"),
+                GetDeviceQueue2 = (delegate* unmanaged<IntPtr, VkDeviceQueueInfo2*, IntPtr*, void>)Lookup(nextGetDeviceProcAddr, created, "vkGetDeviceQueue2"),
+                CreateSwapchain = (delegate* unmanaged<IntPtr, VkSwapchainCreateInfoKHR*, void*, ulong*, int>)Lookup(nextGetDeviceProcAddr, created, "vkCreateSwapchainKHR"),
+                DestroySwapchain = (delegate* unmanaged<IntPtr, ulong, void*, void>)Lookup(nextGetDeviceProcAddr, created, "vkDestroySwapchainKHR"),
+                GetSwapchainImages = (delegate* unmanaged<IntPtr, ulong, uint*, ulong*, int>)Lookup(nextGetDeviceProcAddr, created, "vkGetSwapchainImagesKHR"),
+                QueuePresent = (delegate* unmanaged<IntPtr, VkPresentInfoKHR*, int>)Lookup(nextGetDeviceProcAddr, created, "vkQueuePresentKHR"),
+                SetDeviceLoaderData = loaderData != null ? (delegate* unmanaged<IntPtr, IntPtr, int>)loaderData->LayerInfo : null,
+                QueueFamilyFlags = QueryQueueFamilies(instance, physicalDevice),
+                MemoryTypeFlags = QueryMemoryTypes(instance, physicalDevice)
+            };
+            return VK_SUCCESS;
+        }
+
+        private static uint[] QueryQueueFamilies(InstanceDispatch instance, IntPtr physicalDevice)
+        {
+            var query = (delegate* unmanaged<IntPtr, uint*, VkQueueFamilyProperties*, void>)Lookup(
+                instance.GetInstanceProcAddr, instance.Instance, "vkGetPhysicalDeviceQueueFamilyProperties");
+
+            uint count = 0;
+            query(physicalDevice, &count, null);
+            var properties = new VkQueueFamilyProperties[count];
+            fixed (VkQueueFamilyProperties* pointer = properties)
+            {
+                query(physicalDevice, &count, pointer);
+            }
+
+            var flags = new uint[count];
+            for (int i = 0; i < count; i++)
+            {
+                flags[i] = properties[i].QueueFlags;
+            }
+            return flags;
+        }
+
+        private static uint[] QueryMemoryTypes(InstanceDispatch instance, IntPtr physicalDevice)
+        {
+            var query = (delegate* unmanaged<IntPtr, byte*, void>)Lookup(
+                instance.GetInstanceProcAddr, instance.Instance, "vkGetPhysicalDeviceMemoryProperties");
+
+            byte* properties = stackalloc byte[MemoryPropertiesSize];
+            query(physicalDevice, properties);
+
+            uint count = Math.Min(*(uint*)properties, MaxMemoryTypes);
+            var flags = new uint[count];
+            for (int i = 0; i < count; i++)
+            {
+                flags[i] = *(uint*)(properties + 4 + i * 8);
+            }
+            return flags;
+        }
+
+        [UnmanagedCallersOnly]
+        private static void DestroyDevice(IntPtr device, void* allocator)
+        {
+            try
+            {
+                if (device == IntPtr.Zero || !devices.TryRemove(DispatchKey(device), out var dispatch)) return;
+
+                foreach (var queue in queueFamilies.Keys)
+                {
+                    if (DispatchKey(queue) == DispatchKey(device)) queueFamilies.TryRemove(queue, out _);
+                }
+                dispatch.DestroyDevice(device, allocator);
+            }
+            catch (Exception e)
+            {
+                Failed("vkDestroyDevice", e);
+            }
+        }
+
+        // Observers record on the queue being presented from, so they need to know its family
+        [UnmanagedCallersOnly]
+        private static void GetDeviceQueue(IntPtr device, uint queueFamilyIndex, uint queueIndex, IntPtr* queue)
+        {
+            try
+            {
+                if (!devices.TryGetValue(DispatchKey(device), out var dispatch)) return;
+                dispatch.GetDeviceQueue(device, queueFamilyIndex, queueIndex, queue);
+                if (*queue != IntPtr.Zero) queueFamilies[*queue] = queueFamilyIndex;
+            }
+            catch (Exception e)
+            {
+                Failed("vkGetDeviceQueue", e);
+            }
+        }
+
+        [UnmanagedCallersOnly]
+        private static void GetDeviceQueue2(IntPtr device, VkDeviceQueueInfo2* queueInfo, IntPtr* queue)
+        {
+            try
+            {
+                if (!devices.TryGetValue(DispatchKey(device), out var dispatch)) return;
+                dispatch.GetDeviceQueue2(device, queueInfo, queue);
+                if (*queue != IntPtr.Zero) queueFamilies[*queue] = queueInfo->QueueFamilyIndex;
+            }
+            catch (Exception e)
+            {
+                Failed("vkGetDeviceQueue2", e);
+            }
+        }
+
+        private static IntPtr Lookup(delegate* unmanaged<IntPtr, byte*, IntPtr> getProcAddr, IntPtr handle, string name)
+        {
+            // Setup path only; names are short ASCII
+            byte* buffer = stackalloc byte[64];
+            int length = Encoding.ASCII.GetBytes(name, new Span<byte>(buffer, 63));
+            buffer[length] = 0;
+            return getProcAddr(handle, buffer);
+        }
+
+        #endregion
+
+        #region Swapchain and present
+
+        [UnmanagedCallersOnly]
+        private static int CreateSwapchain(IntPtr device, VkSwapchainCreateInfoKHR* createInfo, void* allocator, ulong* swapchain)
+        {
+            try
+            {
+                return CreateSwapchainCore(device, createInfo, allocator, swapchain);
+            }
+            catch (Exception e)
+            {
+                Failed("vkCreateSwapchainKHR", e);
+                return VK_ERROR_OUT_OF_HOST_MEMORY;
+            }
+        }
+
+        private static int CreateSwapchainCore(IntPtr device, VkSwapchainCreateInfoKHR* createInfo, void* allocator, ulong* swapchain)
+        {
+            if (!devices.TryGetValue(DispatchKey(device), out var dispatch)) return VK_ERROR_INITIALIZATION_FAILED;
+
+            // Copy out of the game's images needs them created as transfer sources
+            var info = *createInfo;
+            var observer = Observer;
+            if (observer != null && observer.RequiresTransferSource)
+            {
+                info.ImageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+            }
+
+            int result = dispatch.CreateSwapchain(device, &info, allocator, swapchain);
+            if (result != VK_SUCCESS) return result;
+
+            uint count = 0;
+            dispatch.GetSwapchainImages(device, *swapchain, &count, null);
+            var images = new ulong[count];
+            fixed (ulong* imagePointer = images)
+            {
+                dispatch.GetSwapchainImages(device, *swapchain, &count, imagePointer);
+            }
+
+            swapchains[*swapchain] = new SwapchainInfo
+            {
+                Width = info.ImageWidth,
+                Height = info.ImageHeight,
+                Format = info.ImageFormat,
+                Images = images
+            };
+            Log($"swapchain {info.ImageWidth}x{info.ImageHeight}, format {info.ImageFormat}, {count} images");
+
+            // The swapchain exists whatever the observer makes of it
+            try
+            {
+                observer?.OnSwapchainCreated(device, *swapchain, info.ImageWidth, info.ImageHeight, info.ImageFormat, images);
+            }
+            catch (Exception e)
+            {
+                DropObserver(observer, e);
+            }
+            return VK_SUCCESS;
+        }
+
+        [UnmanagedCallersOnly]
+        private static void DestroySwapchain(IntPtr device, ulong swapchain, void* allocator)
+        {
+            try
+            {
+                if (!devices.TryGetValue(DispatchKey(device), out var dispatch)) return;
+
+                var observer = Observer;
+                if (swapchains.TryRemove(swapchain, out _) && observer != null)
+                {
+                    try
+                    {
+                        observer.OnSwapchainDestroyed(device, swapchain);
+                    }
+                    catch (Exception e)
+                    {
+                        DropObserver(observer, e);
+                    }
+                }
+                dispatch.DestroySwapchain(device, swapchain, allocator);
+            }
+            catch (Exception e)
+            {
+                Failed("vkDestroySwapchainKHR", e);
+            }
+        }
+
+        [UnmanagedCallersOnly]
+        private static int QueuePresent(IntPtr queue, VkPresentInfoKHR* presentInfo)
+        {
+            try
+            {
+                return QueuePresentCore(queue, presentInfo);
+            }
+            catch (Exception e)
+            {
+                Failed("vkQueuePresentKHR", e);
+                return VK_ERROR_OUT_OF_HOST_MEMORY;
+            }
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        private static int QueuePresentCore(IntPtr queue, VkPresentInfoKHR* presentInfo)
+        {
+            long start = Stopwatch.GetTimestamp();
+            if (!devices.TryGetValue(DispatchKey(queue), out var dispatch)) return VK_ERROR_INITIALIZATION_FAILED;
+
+            if (lastPresentEnd != 0)
+            {
+                LastFrameMilliseconds = (start - lastPresentEnd) * 1000.0 / Stopwatch.Frequency;
+            }
+
+            // Observers may swap the wait semaphores, which must not touch the game's own struct
+            var info = *presentInfo;
+
+            long observerTicks = 0;
+            var observer = Observer;
+            if (observer != null)
+            {
+                long observerStart = Stopwatch.GetTimestamp();
+                try
+                {
+                    NotifyPresent(observer, dispatch.Device, queue, &info);
+                }
+                catch (Exception e)
+                {
+                    DropObserver(observer, e);
+                }
+                observerTicks = Stopwatch.GetTimestamp() - observerStart;
+            }
+
+            // Time inside the real present is the game waiting on the GPU and the display
+            long presentStart = Stopwatch.GetTimestamp();
+            int result = dispatch.QueuePresent(queue, &info);
+            long presentEnd = Stopwatch.GetTimestamp();
+
+            lock (presentLock)
+            {
+                lastPresentEnd = presentEnd;
+                PublishTimings(start, presentStart, presentEnd);
+
+                long layerTicks = (presentStart - start - observerTicks) + (Stopwatch.GetTimestamp() - presentEnd);
+                RecordPresent(layerTicks, observerTicks, presentEnd - presentStart);
+            }
+            return result;
+        }
+
+        private static void NotifyPresent(IPresentObserver observer, IntPtr device, IntPtr queue, VkPresentInfoKHR* presentInfo)
+        {
+            for (uint i = 0; i < presentInfo->SwapchainCount; i++)
+            {
+                ulong swapchain = presentInfo->PSwapchains[i];
+                if (!swapchains.TryGetValue(swapchain, out var info)) continue;
+
+                uint index = presentInfo->PImageIndices[i];
+                var image = new PresentedImage
+                {
+                    Device = device,
+                    Queue = queue,
+                    Swapchain = swapchain,
+                    ImageIndex = index,
+                    Image = index < info.Images.Length ? info.Images[index] : 0,
+                    Width = info.Width,
+                    Height = info.Height,
+                    Format = info.Format,
+                    PresentInfo = presentInfo
+                };
+                observer.OnPresent(image);
+            }
+        }
+
+        // A failing observer is dropped rather than retried on every present; the game carries on without capture
+        private static void DropObserver(IPresentObserver observer, Exception e)
+        {
+            if (Observer == observer) Observer = null;
+            Failed(observer.GetType().Name, e);
+        }
+
+        /// <summary>
+        /// The present as the mod's FrameAnalyzer takes it (PresentLayerBridge feeds it in): the layer's own time
+        /// as hook time, and the driver's present. Stamped in TimeSpan ticks, which mean the same on both sides.
+        /// </summary>
+        private static void PublishTimings(long start, long presentStart, long presentEnd)
+        {
+            if (channel == null) return;
+
+            double toMilliseconds = 1000.0 / Stopwatch.Frequency;
+            channel.PublishTelemetry(TelemetryMetric.LayerHookMs, (float)((presentStart - start) * toMilliseconds), ToTimeSpanTicks(start));
+            channel.PublishTelemetry(TelemetryMetric.LayerPresentMs, (float)((presentEnd - presentStart) * toMilliseconds), ToTimeSpanTicks(presentEnd));
+        }
+
+        internal static long ToTimeSpanTicks(long timestamp)
+        {
+            return (long)(timestamp * ((double)TimeSpan.TicksPerSecond / Stopwatch.Frequency));
+        }
+
+        private static void RecordPresent(long layerTicks, long observerTicks, long presentTicks)
+        {
+            double frequency = Stopwatch.Frequency;
+            long n = ++statistics.Presents;
+            statistics.MeanLayerNanoseconds += (layerTicks * 1e9 / frequency - statistics.MeanLayerNanoseconds) / n;
+            statistics.MeanObserverMicroseconds += (observerTicks * 1e6 / frequency - statistics.MeanObserverMicroseconds) / n;
+            statistics.MeanPresentMilliseconds += (presentTicks * 1e3 / frequency - statistics.MeanPresentMilliseconds) / n;
+
+            if (n % LogInterval == 0)
+            {
+                string message = statistics.ToString();
+                Console.WriteLine($"Vulkan layer: {message}");
+                channel?.Log(message);
+            }
+        }
+
+        #endregion
+    }
+}
@@ -0,0 +1,343 @@
+using System;
+using System.Collections.Generic;
+using System.Numerics;
+using System.Runtime.InteropServices;
+using System.Threading;
+using VRGameConverter.Hooking;
+
+namespace VRGameConverter.World
+{
+    /// <summary>
+    /// What the subsystems care about an entity being, mapped from the game's own type ids by the profile
+    /// </summary>
+    public enum EntityKind : byte
+    {
+        Unknown,
+        Character,
+        Vehicle,
+        Prop,
+        Pickup
+    }
+
+    /// <summary>
+    /// Where things are in the game's entity pool. Offsets are bytes; entries are an array of entity pointers.
+    /// </summary>
+    public class EntityPoolLayout
+    {
+        public int EntriesOffset { get; set; }       // Pool → pointer to the entity pointer array
+        public int CountOffset { get; set; }         // Pool → int32 number of slots
+        public int PositionOffset { get; set; }      // Entity → Vector3 world position
+        public int ExtentsOffset { get; set; }       // Entity → Vector3 bounding box half extents
+        public int TypeOffset { get; set; }          // Entity → int32 game type id
+
+        // Slot holding the local player, whose position centres the mirror
+        public int PlayerSlot { get; set; } = 0;
+
+        // Only entities this close to the player are mirrored, up to Capacity of them
+        public float Radius { get; set; } = 60.0f;
+        public int Capacity { get; set; } = 512;
+
+        public Dictionary<int, EntityKind> TypeKinds { get; set; } = new Dictionary<int, EntityKind>();
+    }
+
+    /// <summary>
+    /// One game tick's worth of nearby entities, one array per field. Capture bumps a sequence number around
+    /// the rewrite, so a reader that raced one can tell.
+    /// </summary>
+    public sealed class EntitySnapshot
+    {
+        public readonly IntPtr[] Address;
+        public readonly float[] PositionX, PositionY, PositionZ;
+        public readonly float[] ExtentX, ExtentY, ExtentZ;
+        public readonly int[] TypeId;
+        public readonly EntityKind[] Kind;
+
+        public int Count { get; internal set; }
+        public long Tick { get; internal set; }
+        public Vector3 PlayerPosition { get; internal set; }
+
+        // More entities were in range than fit; the farthest part of the pool walk was cut off
+        public bool Truncated { get; internal set; }
+
+        // Even while the snapshot is stable, odd while Capture is rewriting it
+        private int sequence;
+        public int Sequence => Volatile.Read(ref sequence);
+
+        public EntitySnapshot(int capacity)
+        {
+            Address = new IntPtr[capacity];
+            PositionX = new float[capacity];
+            PositionY = new float[capacity];
+            PositionZ = new float[capacity];
+            ExtentX = new float[capacity];
+            ExtentY = new float[capacity];
+            ExtentZ = new float[capacity];
+            TypeId = new int[capacity];
+            Kind = new EntityKind[capacity];
+        }
+
+        public Vector3 GetPosition(int index) => new Vector3(PositionX[index], PositionY[index], PositionZ[index]);
+
+        internal void BeginWrite() => Interlocked.Increment(ref sequence);
+        internal void EndWrite() => Interlocked.Increment(ref sequence);
+
+        /// <summary>
+        /// FindNearest for readers on other threads than the capture: returns false, and an address that must
+        /// be discarded, when the snapshot was rewritten during the search
+        /// </summary>
+        public bool TryFindNearest(Vector3 point, float maxDistance, EntityKind kind, out IntPtr address)
+        {
+            int before = Volatile.Read(ref sequence);
+            address = IntPtr.Zero;
+            if ((before & 1) != 0) return false;
+
+            // Indices never pass the arrays' capacity, so a torn read is harmless; it's only thrown away
+            int index = FindNearest(point, maxDistance, kind);
+            if (index >= 0) address = Address[index];
+            Interlocked.MemoryBarrier();
+            return Volatile.Read(ref sequence) == before;
+        }
+
+        /// <summary>
+        /// FindAlongRay for readers on other threads than the capture, like TryFindNearest
+        /// </summary>
+        public bool TryFindAlongRay(Vector3 origin, Vector3 direction, float maxDistance, float slack, EntityKind kind, out IntPtr address)
+        {
+            int before = Volatile.Read(ref sequence);
+            address = IntPtr.Zero;
+            if ((before & 1) != 0) return false;
+
+            int index = FindAlongRay(origin, direction, maxDistance, slack, kind);
+            if (index >= 0) address = Address[index];
+            Interlocked.MemoryBarrier();
+            return Volatile.Read(ref sequence) == before;
+        }
+
+        /// <summary>
+        /// Entity of the given kind closest to the point, or -1
+        /// </summary>
+        public int FindNearest(Vector3 point, float maxDistance, EntityKind kind)
+        {
+            int best = -1;
+            float bestDistance = maxDistance * maxDistance;
+            for (int i = 0; i < Count; i++)
+            {
+                if (Kind[i] != kind) continue;
+
+                float dx = PositionX[i] - point.X, dy = PositionY[i] - point.Y, dz = PositionZ[i] - point.Z;
+                float distance = dx * dx + dy * dy + dz * dz;
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    best = i;
+                }
+            }
+            return best;
+        }
+
+        /// <summary>
+        /// Entity of the given kind nearest to a ray whose bounds it passes through or within slack of, or -1.
+        /// Ties go to the closer entity along the ray.
+        /// </summary>
+        public int FindAlongRay(Vector3 origin, Vector3 direction, float maxDistance, float slack, EntityKind kind)
+        {
+            int best = -1;
+            float bestScore = float.MaxValue;
+            for (int i = 0; i < Count; i++)
+            {
+                if (Kind[i] != kind) continue;
+
+                var toEntity = new Vector3(PositionX[i] - origin.X, PositionY[i] - origin.Y, PositionZ[i] - origin.Z);
+                float along = Vector3.Dot(toEntity, direction);
+                if (along <= 0 || along > maxDistance) continue;
+
+                // Miss distance past the bounding sphere of the box
+                float radius = MathF.Sqrt(ExtentX[i] * ExtentX[i] + ExtentY[i] * ExtentY[i] + ExtentZ[i] * ExtentZ[i]);
+                float miss = (toEntity - direction * along).Length() - radius;
+                if (miss > slack) continue;
+
+                float score = MathF.Max(miss, 0) * maxDistance + along;
+                if (score < bestScore)
+                {
+                    bestScore = score;
+                    best = i;
+                }
+            }
+            return best;
+        }
+    }
+
+    /// <summary>
+    /// Copy of the entities around the player, taken once per game tick from the pool-update hook so
+    /// subsystems read one contiguous snapshot instead of each chasing game pointers on their own.
+    /// Snapshots rotate through three buffers: the hook never rewrites the published snapshot or the one
+    /// published just before it, so a reader that took Latest has a whole tick to finish. Readers on other
+    /// threads that may take longer use the snapshot's Try methods, which notice a rewrite.
+    /// </summary>
+    public sealed unsafe class EntityMirror
+    {
+        private readonly EntityPoolLayout layout;
+        private Dictionary<string, IntPtr> hookTargets;
+        private bool isActive = false;
+
+        private readonly EntitySnapshot[] snapshots = new EntitySnapshot[3];
+        private EntitySnapshot published;
+        private int nextSnapshot = 0;
+        private long tick = 0;
+
+        /// <summary>
+        /// Most recently captured snapshot; empty before the first capture
+        /// </summary>
+        public EntitySnapshot Latest => Volatile.Read(ref published);
+
+        // Engine function that advances the entity pool each game tick
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        private delegate void UpdateEntityPoolDelegate(IntPtr pool, float deltaTime);
+
+        private UpdateEntityPoolDelegate originalUpdateEntityPool;
+
+        public EntityMirror(EntityPoolLayout layout)
+        {
+            this.layout = layout;
+            for (int i = 0; i < snapshots.Length; i++)
+            {
+                snapshots[i] = new EntitySnapshot(layout.Capacity);
+            }
+            published = snapshots[0];
+            nextSnapshot = 1;
+        }
+
+        /// <summary>
+        /// Address of the entity of the given kind nearest the point, or zero. A search that raced a capture is
+        /// run again on the newer snapshot.
+        /// </summary>
+        public IntPtr FindNearest(Vector3 point, float maxDistance, EntityKind kind)
+        {
+            for (int attempt = 0; attempt < 3; attempt++)
+            {
+                if (Latest.TryFindNearest(point, maxDistance, kind, out var address)) return address;
+            }
+            return IntPtr.Zero;
+        }
+
+        /// <summary>
+        /// Address of the entity of the given kind the ray points at (see EntitySnapshot.FindAlongRay), or zero
+        /// </summary>
+        public IntPtr FindAlongRay(Vector3 origin, Vector3 direction, float maxDistance, float slack, EntityKind kind)
+        {
+            for (int attempt = 0; attempt < 3; attempt++)
+            {
+                if (Latest.TryFindAlongRay(origin, direction, maxDistance, slack, kind, out var address)) return address;
+            }
+            return IntPtr.Zero;
+        }
+
+        public void SetHookTargets(Dictionary<string, IntPtr> targets)
+        {
+            this.hookTargets = targets;
+        }
+
+        public void Activate()
+        {
+            if (isActive) return;
+
+            if (hookTargets.TryGetValue("UpdateEntityPool", out var poolFunc))
+            {
+                // Hot-patch install so hooks added mid-session don't stall the game
+                HookEngine.Shared.InstallHook(poolFunc, new UpdateEntityPoolDelegate(UpdateEntityPoolHook),
+                    original => originalUpdateEntityPool = original);
+            }
+
+            isActive = true;
+        }
+
+        private void UpdateEntityPoolHook(IntPtr pool, float deltaTime)
+        {
+            var original = originalUpdateEntityPool;
+            if (original == null) return;
+
+            // Mirror after the game has moved everything for this tick
+            original(pool, deltaTime);
+            Capture(pool);
+        }
+
+        /// <summary>
+        /// Walk the pool and publish a new snapshot. Must run on the thread that owns the pool.
+        /// </summary>
+        public void Capture(IntPtr pool)
+        {
+            var snapshot = TakeNextSnapshot();
+            snapshot.BeginWrite();
+            byte* poolBase = (byte*)pool;
+            IntPtr* entries = *(IntPtr**)(poolBase + layout.EntriesOffset);
+            int slots = *(int*)(poolBase + layout.CountOffset);
+
+            snapshot.Count = 0;
+            snapshot.Truncated = false;
+            snapshot.Tick = ++tick;
+
+            if (entries == null || slots <= layout.PlayerSlot || entries[layout.PlayerSlot] == IntPtr.Zero)
+            {
+                Publish(snapshot);
+                return;
+            }
+
+            Vector3 player = *(Vector3*)((byte*)entries[layout.PlayerSlot] + layout.PositionOffset);
+            snapshot.PlayerPosition = player;
+            float radiusSquared = layout.Radius * layout.Radius;
+            int capacity = snapshot.Address.Length;
+            int count = 0;
+
+            for (int slot = 0; slot < slots; slot++)
+            {
+                byte* entity = (byte*)entries[slot];
+                if (entity == null || slot == layout.PlayerSlot) continue;
+
+                Vector3 position = *(Vector3*)(entity + layout.PositionOffset);
+                if (Vector3.DistanceSquared(position, player) > radiusSquared) continue;
+
+                if (count == capacity)
+                {
+                    snapshot.Truncated = true;
+                    break;
+                }
+
+                Vector3 extents = *(Vector3*)(entity + layout.ExtentsOffset);
+                int typeId = *(int*)(entity + layout.TypeOffset);
+
+                snapshot.Address[count] = (IntPtr)entity;
+                snapshot.PositionX[count] = position.X;
+                snapshot.PositionY[count] = position.Y;
+                snapshot.PositionZ[count] = position.Z;
+                snapshot.ExtentX[count] = extents.X;
+                snapshot.ExtentY[count] = extents.Y;
+                snapshot.ExtentZ[count] = extents.Z;
+                snapshot.TypeId[count] = typeId;
+                snapshot.Kind[count] = layout.TypeKinds.TryGetValue(typeId, out var kind) ? kind : EntityKind.Unknown;
+                count++;
+            }
+
+            snapshot.Count = count;
+            Publish(snapshot);
+        }
+
+        private EntitySnapshot TakeNextSnapshot()
+        {
+            // Never the published snapshot, and never the one published just before it
+            var snapshot = snapshots[nextSnapshot];
+            if (snapshot == published)
+            {
+                nextSnapshot = (nextSnapshot + 1) % snapshots.Length;
+                snapshot = snapshots[nextSnapshot];
+            }
+            nextSnapshot = (nextSnapshot + 1) % snapshots.Length;
+            return snapshot;
+        }
+
+        private void Publish(EntitySnapshot snapshot)
+        {
+            snapshot.EndWrite();
+            Volatile.Write(ref published, snapshot);
+        }
+    }
+}
@@ -0,0 +1,175 @@
+using System;
+using System.Collections.Concurrent;
+using System.Globalization;
+using System.IO;
+using System.Numerics;
+using System.Text;
+using System.Threading;
+using VRGameConverter.Scheduling;
+
+namespace VRGameConverter.World
+{
+    /// <summary>
+    /// How the controllers drive a vehicle
+    /// </summary>
+    public enum VehicleControlScheme
+    {
+        Triggers,       // Right trigger throttle, left trigger brake, stick steering
+        Handlebars,     // Triggers, steering from controller roll
+        FlightStick     // Sticks for pitch, roll and yaw
+    }
+
+    /// <summary>
+    /// Everything the camera and controls need about one seat of one vehicle model
+    /// </summary>
+    public struct VehicleAnchor
+    {
+        public int VehicleType;                     // VehicleType value
+        public Vector3 SeatOffset;                  // Eye point relative to the vehicle root
+        public Quaternion SeatRotation;
+        public VehicleControlScheme ControlScheme;
+    }
+
+    /// <summary>
+    /// Engine-specific inspection of a vehicle in game memory. Only used the first time a model is entered.
+    /// </summary>
+    public interface IVehicleInspector
+    {
+        uint GetModelHash(IntPtr vehicle);
+        bool TryInspect(IntPtr vehicle, int seat, out VehicleAnchor anchor);
+    }
+
+    /// <summary>
+    /// Seat anchors by vehicle model hash and seat. Looked up on every vehicle entry, inspected from game
+    /// memory only on a model's first entry, and saved to disk from the idle queue so later sessions start
+    /// with everything already known.
+    /// </summary>
+    public class VehicleAnchorCache
+    {
+        private readonly ConcurrentDictionary<ulong, VehicleAnchor> anchors = new ConcurrentDictionary<ulong, VehicleAnchor>();
+        private readonly string storePath;
+        private readonly IdleWorkScheduler scheduler;
+        private int savePending = 0;
+
+        public int Count => anchors.Count;
+
+        public VehicleAnchorCache(string gameName, string storePath = null, IdleWorkScheduler scheduler = null)
+        {
+            this.storePath = storePath ?? Path.Combine(
+                Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData), "AjsVRMOD", $"vehicle-anchors-{gameName}.txt");
+            this.scheduler = scheduler ?? IdleWorkScheduler.Shared;
+            Load();
+        }
+
+        private static ulong Key(uint modelHash, int seat) => ((ulong)modelHash << 32) | (uint)seat;
+
+        /// <summary>
+        /// Anchor for the seat, inspecting the vehicle and remembering the result on a model's first entry.
+        /// False when the model is new and the inspector can't make sense of it.
+        /// </summary>
+        public bool TryGetAnchor(IntPtr vehicle, int seat, IVehicleInspector inspector, out VehicleAnchor anchor)
+        {
+            anchor = default;
+            if (inspector == null || vehicle == IntPtr.Zero) return false;
+
+            ulong key = Key(inspector.GetModelHash(vehicle), seat);
+            if (anchors.TryGetValue(key, out anchor)) return true;
+
+            if (!inspector.TryInspect(vehicle, seat, out anchor)) return false;
+
+            anchors[key] = anchor;
+            ScheduleSave();
+            return true;
+        }
+
+        private void ScheduleSave()
+        {
+            // One save covers every anchor learned before it runs
+            if (Interlocked.Exchange(ref savePending, 1) == 1) return;
+
+            scheduler.Enqueue("vehicle anchor cache", () =>
+            {
+                Volatile.Write(ref savePending, 0);
+                Save();
+            });
+        }
+
+        private void Save()
+        {
+            var text = new StringBuilder();
+            foreach (var entry in anchors)
+            {
+                var a = entry.Value;
+                text.Append(entry.Key.ToString("X16", CultureInfo.InvariantCulture)).Append(' ')
+                    .Append(a.VehicleType.ToString(CultureInfo.InvariantCulture)).Append(' ')
+                    .Append(a.ControlScheme).Append(' ')
+                    .Append(Format(a.SeatOffset.X)).Append(' ').Append(Format(a.SeatOffset.Y)).Append(' ').Append(Format(a.SeatOffset.Z)).Append(' ')
+                    .Append(Format(a.SeatRotation.X)).Append(' ').Append(Format(a.SeatRotation.Y)).Append(' ')
+                    .Append(Format(a.SeatRotation.Z)).Append(' ').Append(Format(a.SeatRotation.W))
+                    .AppendLine();
+            }
+
+            try
+            {
+                Directory.CreateDirectory(Path.GetDirectoryName(storePath));
+
+                // Write aside and swap, so a crash mid-save never leaves a truncated cache
+                string temporary = storePath + ".tmp";
+                File.WriteAllText(temporary, text.ToString());
+                File.Move(temporary, storePath, true);
+            }
+            catch (Exception ex) when (ex is IOException || ex is UnauthorizedAccessException)
+            {
+                Console.WriteLine($"Could not save vehicle anchors: {ex.Message}");
+            }
+        }
+
+        private void Load()
+        {
+            // An unreadable cache only costs re-inspecting each model once; the next save replaces it
+            try
+            {
+                if (!File.Exists(storePath)) return;
+
+                foreach (var line in File.ReadLines(storePath))
+                {
+                    Parse(line);
+                }
+            }
+            catch (Exception ex) when (ex is IOException || ex is UnauthorizedAccessException)
+            {
+                Console.WriteLine($"Could not load vehicle anchors: {ex.Message}");
+            }
+        }
+
+        private void Parse(string line)
+        {
+            var fields = line.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+            if (fields.Length != 10 ||
+                !ulong.TryParse(fields[0], NumberStyles.HexNumber, CultureInfo.InvariantCulture, out ulong key) ||
+                !int.TryParse(fields[1], NumberStyles.Integer, CultureInfo.InvariantCulture, out int vehicleType) ||
+                !Enum.TryParse(fields[2], out VehicleControlScheme scheme))
+            {
+                return;
+            }
+
+            var values = new float[7];
+            bool valid = true;
+            for (int i = 0; i < values.Length && valid; i++)
+            {
+                valid = float.TryParse(fields[3 + i], NumberStyles.Float, CultureInfo.InvariantCulture, out values[i]);
+            }
+            if (!valid) return;
+
+            anchors[key] = new VehicleAnchor
+            {
+                VehicleType = vehicleType,
+                ControlScheme = scheme,
+                SeatOffset = new Vector3(values[0], values[1], values[2]),
+                SeatRotation = new Quaternion(values[3], values[4], values[5], values[6])
+            };
+        }
+
+        private static string Format(float value) => value.ToString("R", CultureInfo.InvariantCulture);
+    }
+}
@@ -0,0 +1,88 @@
+using System;
+using System.Collections.Generic;
+using System.Numerics;
+
+namespace VRGameConverter.World
+{
+    /// <summary>
+    /// What a game vehicle class becomes in the mod: a VehicleType value and how it's driven
+    /// </summary>
+    public struct VehicleClassInfo
+    {
+        public int VehicleType;
+        public VehicleControlScheme ControlScheme;
+    }
+
+    /// <summary>
+    /// Where the game keeps a vehicle's model and seats. Offsets are bytes; seats are an array of fixed-size entries.
+    /// </summary>
+    public class VehicleLayout
+    {
+        public int ModelInfoOffset { get; set; }         // Vehicle → pointer to the model info
+        public int ModelHashOffset { get; set; }         // Model info → uint32 model name hash
+        public int ClassOffset { get; set; }             // Model info → int32 game vehicle class
+        public int SeatCountOffset { get; set; }         // Model info → int32 number of seats
+        public int SeatsOffset { get; set; }             // Model info → pointer to the seat entries
+        public int SeatStride { get; set; } = 32;        // Bytes per seat entry
+        public int SeatPositionOffset { get; set; }      // Seat → Vector3 eye point relative to the vehicle root
+        public int SeatRotationOffset { get; set; } = 12; // Seat → Quaternion relative to the vehicle root
+
+        // Game vehicle classes the mod knows; models of any other class aren't anchored
+        public Dictionary<int, VehicleClassInfo> Classes { get; set; } = new Dictionary<int, VehicleClassInfo>();
+
+        // Nothing to inspect until the profile describes the game's classes
+        public bool IsConfigured => Classes.Count > 0;
+    }
+
+    /// <summary>
+    /// IVehicleInspector over a profile's VehicleLayout: model hash, class and seat straight from the model info
+    /// </summary>
+    public sealed unsafe class VehicleLayoutInspector : IVehicleInspector
+    {
+        private readonly VehicleLayout layout;
+
+        public VehicleLayoutInspector(VehicleLayout layout)
+        {
+            this.layout = layout;
+        }
+
+        public uint GetModelHash(IntPtr vehicle)
+        {
+            byte* model = ModelInfo(vehicle);
+            return model != null ? *(uint*)(model + layout.ModelHashOffset) : 0;
+        }
+
+        public bool TryInspect(IntPtr vehicle, int seat, out VehicleAnchor anchor)
+        {
+            anchor = default;
+            byte* model = ModelInfo(vehicle);
+            if (model == null) return false;
+
+            int vehicleClass = *(int*)(model + layout.ClassOffset);
+            if (!layout.Classes.TryGetValue(vehicleClass, out var info)) return false;
+
+            int seatCount = *(int*)(model + layout.SeatCountOffset);
+            byte* seats = *(byte**)(model + layout.SeatsOffset);
+            if (seats == null || seat < 0 || seat >= seatCount) return false;
+
+            byte* entry = seats + seat * layout.SeatStride;
+            var rotation = *(Quaternion*)(entry + layout.SeatRotationOffset);
+
+            anchor = new VehicleAnchor
+            {
+                VehicleType = info.VehicleType,
+                ControlScheme = info.ControlScheme,
+                SeatOffset = *(Vector3*)(entry + layout.SeatPositionOffset),
+
+                // Seats the game never rotates leave the quaternion zeroed
+                SeatRotation = rotation.LengthSquared() > 1e-6f ? Quaternion.Normalize(rotation) : Quaternion.Identity
+            };
+            return true;
+        }
+
+        private byte* ModelInfo(IntPtr vehicle)
+        {
+            return vehicle != IntPtr.Zero ? *(byte**)((byte*)vehicle + layout.ModelInfoOffset) : null;
+        }
+    }
+}
@@ -0,0 +1,156 @@
+using System;
+
+namespace VRGameConverter
+{
+    /// <summary>
+    /// Thresholds for firing trigger actions from pull velocity instead of waiting for the runtime's click point
+    /// </summary>
+    public class TriggerPredictionSettings
+    {
+        public bool Enabled { get; set; } = true;
+
+        // Where the runtime reports TriggerPressed, and where a held trigger counts as released again
+        public float PressThreshold { get; set; } = 0.75f;
+        public float ReleaseThreshold { get; set; } = 0.35f;
+
+        // Prediction only starts once the trigger is visibly being pulled, and fast enough
+        public float MinPullForPrediction { get; set; } = 0.2f;
+        public float VelocityThreshold { get; set; } = 4.0f;   // Full travel per second
+
+        // Fire when the press threshold is predicted within this time
+        public float MaxLeadSeconds { get; set; } = 0.06f;
+
+        // A predicted press that doesn't reach PressThreshold within this window was a false positive
+        public float ConfirmWindowSeconds { get; set; } = 0.1f;
+    }
+
+    /// <summary>
+    /// Fires a trigger action early when the pull velocity says the press threshold is about to be crossed.
+    /// Resting fingers and slow squeezes never predict (minimum pull and velocity, two consecutive fast samples);
+    /// predictions that don't turn into a real press count as false positives and raise the velocity needed,
+    /// confirmed ones let it relax back.
+    /// </summary>
+    public sealed class TriggerPredictor
+    {
+        private TriggerPredictionSettings settings;
+
+        private float lastValue = 0;
+        private double lastTime = -1;
+        private float velocity = 0;
+        private int fastSamples = 0;
+
+        private bool pressed = false;
+        private bool predicted = false;
+        private double firedAt = 0;
+
+        // Extra velocity demanded after false positives
+        private float velocityPenalty = 0;
+
+        public bool IsPressed => pressed;
+        public bool PressedThisUpdate { get; private set; }
+
+        // How much earlier predicted presses fired than the threshold crossing, and how often they were wrong
+        public int PredictedPresses { get; private set; }
+        public int FalsePositives { get; private set; }
+        public double MeanLeadMilliseconds { get; private set; }
+
+        public TriggerPredictor(TriggerPredictionSettings settings)
+        {
+            this.settings = settings;
+        }
+
+        public void Configure(TriggerPredictionSettings settings)
+        {
+            this.settings = settings;
+        }
+
+        /// <summary>
+        /// Feed the analog trigger value once per update; returns whether the action is held
+        /// </summary>
+        public bool Update(float value, double timeSeconds)
+        {
+            PressedThisUpdate = false;
+
+            if (lastTime >= 0)
+            {
+                float dt = (float)(timeSeconds - lastTime);
+                if (dt > 1e-4f)
+                {
+                    // Light smoothing: trigger sensors are noisy at the sample-to-sample level
+                    float instantaneous = (value - lastValue) / dt;
+                    velocity = velocity * 0.3f + instantaneous * 0.7f;
+                }
+            }
+            lastValue = value;
+            lastTime = timeSeconds;
+
+            if (pressed)
+            {
+                UpdateHeld(value, timeSeconds);
+            }
+            else if (value >= settings.PressThreshold)
+            {
+                Fire(timeSeconds, false);
+            }
+            else if (settings.Enabled && ShouldPredict(value))
+            {
+                Fire(timeSeconds, true);
+            }
+
+            return pressed;
+        }
+
+        private bool ShouldPredict(float value)
+        {
+            float requiredVelocity = settings.VelocityThreshold + velocityPenalty;
+            fastSamples = velocity >= requiredVelocity ? fastSamples + 1 : 0;
+
+            if (value < settings.MinPullForPrediction || fastSamples < 2) return false;
+
+            float timeToPress = (settings.PressThreshold - value) / velocity;
+            return timeToPress <= settings.MaxLeadSeconds;
+        }
+
+        private void Fire(double timeSeconds, bool isPrediction)
+        {
+            pressed = true;
+            predicted = isPrediction;
+            firedAt = timeSeconds;
+            PressedThisUpdate = true;
+
+            if (isPrediction) PredictedPresses++;
+        }
+
+        private void UpdateHeld(float value, double timeSeconds)
+        {
+            if (predicted)
+            {
+                if (value >= settings.PressThreshold)
+                {
+                    // Confirmed: record how much earlier we fired and relax any penalty
+                    double lead = (timeSeconds - firedAt) * 1000.0;
+                    int confirmed = PredictedPresses - FalsePositives;
+                    MeanLeadMilliseconds += (lead - MeanLeadMilliseconds) / Math.Max(1, confirmed);
+                    velocityPenalty = Math.Max(0, velocityPenalty - 0.25f);
+                    predicted = false;
+                }
+                else if (timeSeconds - firedAt > settings.ConfirmWindowSeconds || velocity < 0)
+                {
+                    // The pull stalled or reversed before the click point: release and be stricter next time
+                    FalsePositives++;
+                    velocityPenalty = Math.Min(settings.VelocityThreshold, velocityPenalty + 1.0f);
+                    pressed = false;
+                    predicted = false;
+                    fastSamples = 0;
+                }
+                return;
+            }
+
+            if (value < settings.ReleaseThreshold)
+            {
+                pressed = false;
+                fastSamples = 0;
+            }
+        }
+    }
+}
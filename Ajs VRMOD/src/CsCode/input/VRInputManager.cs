@@ -3,27 +3,57 @@ using System.Numerics;
 using System.Collections.Generic;
 using AJS_VRMOD.Controllers;
 using AJS_VRMOD.Models; // Assuming GameType is in this namespace
+using VRGameConverter.Output;
+using VRGameConverter.Rendering;
+using VRGameConverter.Tracking;
+using VRGameConverter.VR;
 
 namespace VRGameConverter
 {
     /// <summary>
     /// Handles integration with VR headsets for head tracking and controllers
     /// </summary>
-    public class VRInputManager // Renamed from HeadTracker to reflect broader scope
+    public class VRInputManager : IDisplayTimeSource, IRuntimeFrameLoop, IDisposable // Renamed from HeadTracker to reflect broader scope
     {
         private CameraSettings cameraSettings;
         private IVRSystem vrSystem;
+
+        // Runtime SetGraphicsBinding replaced, still running until Dispose
+        private IVRSystem retiredVrSystem;
         private GameControllerMapping currentControllerMapping;
         private GameType currentGameType;
 
+        // Every tracked device goes through the same spaces, transformed together once per pose sample
+        private const int MaxTrackers = 8;
+        private readonly TransformGraph transformGraph = new TransformGraph();
+        private readonly TrackedPoseBatch trackedPoses = new TrackedPoseBatch(TrackedPoseBatch.FirstTracker + MaxTrackers);
+
+        // Trackers and finger skeletons arrive at their own rate on the runtime's thread
+        private readonly TrackedDeviceBuffers deviceBuffers = new TrackedDeviceBuffers(MaxTrackers);
+        private readonly TrackedDeviceRole[] trackerRoles = new TrackedDeviceRole[MaxTrackers];
+
+        public TransformGraph TransformGraph => transformGraph;
+
+        // OpenXR session options; set before Configure (headless for benchmarking). The graphics binding is
+        // normally only known once the game presents, and arrives through SetGraphicsBinding.
+        public OpenXRSettings OpenXRSettings { get; set; } = new OpenXRSettings();
+
+        public int TrackerCount => trackedPoses.Count - TrackedPoseBatch.FirstTracker;
+
         public void Configure(CameraSettings settings, DetectedGame game) // Added DetectedGame
         {
             this.cameraSettings = settings;
             this.currentGameType = game.GameType;
+            transformGraph.SetCalibration(settings.PositionScale, settings.PositionOffset, settings.RotationOffset);
 
             // Initialize VR system based on available hardware
             vrSystem = DetectAndInitializeVRSystem();
 
+            if (vrSystem is ITrackedDeviceSource deviceSource)
+            {
+                deviceSource.Start(deviceBuffers);
+            }
+
             // Initialize controller mapping based on game type
             InitializeControllerMapping(game.GameType);
         }
@@ -95,10 +125,88 @@ namespace VRGameConverter
             }
         }
 
+        /// <summary>
+        /// The game's graphics device, found at its first present. Brings OpenXR up on it, replacing the runtime
+        /// Configure settled for without one; if OpenXR can't start, that runtime stays. Call from the game thread
+        /// between frames.
+        /// </summary>
+        public void SetGraphicsBinding(OpenXRGraphicsBinding binding)
+        {
+            if (binding == null || vrSystem is OpenXRSystem) return;
+
+            OpenXRSettings.GraphicsBinding = binding;
+            try
+            {
+                var openXR = new OpenXRSystem(OpenXRSettings);
+                openXR.Start(deviceBuffers);
+
+                // The previous runtime is left as it is: the latch and roomscale threads may be sampling it
+                retiredVrSystem = vrSystem;
+                vrSystem = openXR;
+                Console.WriteLine($"OpenXR session on the game's {binding.Api} device");
+            }
+            catch (VRInitializationException ex)
+            {
+                Console.WriteLine($"OpenXR unavailable on the game's device: {ex.Message}");
+            }
+        }
+
+        /// <summary>
+        /// Runtime-predicted display time of the frame being rendered, for late latching and space warp; false
+        /// while the current runtime has no frame loop of its own
+        /// </summary>
+        public bool TryGetPredictedDisplayTime(out long displayTimestamp, out long displayPeriodTicks)
+        {
+            if (vrSystem is IDisplayTimeSource displayTimes)
+            {
+                return displayTimes.TryGetPredictedDisplayTime(out displayTimestamp, out displayPeriodTicks);
+            }
+
+            displayTimestamp = 0;
+            displayPeriodTicks = 0;
+            return false;
+        }
+
+        /// <summary>
+        /// One OpenXR frame, from the game's present hook; nothing when OpenXR isn't up or runs its own loop
+        /// </summary>
+        public bool RunFrame()
+        {
+            if (!(vrSystem is OpenXRSystem openXR) || openXR.DrivesFrameLoop) return false;
+
+            openXR.PollEvents();
+            return openXR.RunFrame();
+        }
+
+        /// <summary>
+        /// Stop the runtime's frame and device threads and end its session, and the same for a runtime
+        /// SetGraphicsBinding replaced. Detach from the present hook's RuntimeFrames first.
+        /// </summary>
+        public void Dispose()
+        {
+            (vrSystem as IDisposable)?.Dispose();
+            (retiredVrSystem as IDisposable)?.Dispose();
+            retiredVrSystem = null;
+        }
+
         private IVRSystem DetectAndInitializeVRSystem()
         {
             // Try to initialize different VR systems in order of preference
 
+            // Try OpenXR, when there is a graphics binding to create the session with or no compositor is wanted
+            if (OpenXRSettings.Headless || OpenXRSettings.GraphicsBinding != null)
+            {
+                try
+                {
+                    return new OpenXRSystem(OpenXRSettings);
+                }
+                catch (VRInitializationException ex)
+                {
+                    // No OpenXR runtime, try OpenVR
+                    Console.WriteLine($"OpenXR unavailable: {ex.Message}");
+                }
+            }
+
             // Try OpenVR (SteamVR)
             try
             {
@@ -131,39 +239,185 @@ namespace VRGameConverter
             }
         }
 
+        /// <summary>
+        /// Ask the runtime for its hidden-area meshes once and cache them per headset in the render settings
+        /// </summary>
+        public void CacheHiddenAreaMeshes(RenderSettings renderSettings)
+        {
+            if (vrSystem is IHiddenAreaMeshProvider provider)
+            {
+                HiddenAreaMeshPass.ResolveMeshes(renderSettings, provider);
+            }
+        }
+
+        /// <summary>
+        /// Samples every tracked device and returns the head pose in game space. Controller and tracker
+        /// poses from the same sample are available afterwards from GetControllerState and GetTrackerPose.
+        /// </summary>
         public HeadPose GetHeadPose()
         {
-            // Get raw tracking data from VR system
-            var rawPose = vrSystem.GetHeadsetPose();
+            UpdateTrackedPoses();
+
+            return new HeadPose
+            {
+                Position = trackedPoses.GetPosition(TrackedPoseBatch.Head),
+                Rotation = trackedPoses.GetRotation(TrackedPoseBatch.Head)
+            };
+        }
+
+        /// <summary>
+        /// Headset in game space, sampled on its own without touching the other devices' poses; safe to call from
+        /// the render thread for late latching
+        /// </summary>
+        public HeadPose SampleGameSpaceHead()
+        {
+            var headset = vrSystem.GetHeadsetPose();
+
+            // Composed from the local transforms: GetWorld would update the graph's cache from this thread
+            var toGame = transformGraph.GetLocal(TransformSpace.Play).Then(transformGraph.GetLocal(TransformSpace.Game));
+            return new HeadPose
+            {
+                Position = toGame.TransformPoint(headset.Position),
+                Rotation = toGame.TransformRotation(headset.Rotation)
+            };
+        }
 
-            // Apply calibration and transformation based on game-specific settings
-            var transformedPose = TransformRawPose(rawPose);
+        /// <summary>
+        /// Headset in calibrated play space, sampled on its own; safe to poll from the roomscale thread
+        /// </summary>
+        public HeadPose SamplePlaySpaceHead()
+        {
+            var headset = vrSystem.GetHeadsetPose();
 
-            return transformedPose;
+            // Play space hangs directly off tracking space, so its local transform is already the full one
+            var toPlay = transformGraph.GetLocal(TransformSpace.Play);
+            return new HeadPose
+            {
+                Position = toPlay.TransformPoint(headset.Position),
+                Rotation = toPlay.TransformRotation(headset.Rotation)
+            };
         }
 
-        private HeadPose TransformRawPose(RawVRPose rawPose)
+        private void UpdateTrackedPoses()
         {
-            // Transform from VR space to game space
-            Vector3 position = rawPose.Position;
-            Quaternion rotation = rawPose.Rotation;
+            // Get raw tracking data from VR system
+            var headset = vrSystem.GetHeadsetPose();
+            trackedPoses.Set(TrackedPoseBatch.Head, headset.Position, headset.Rotation);
+            trackedPoses.Count = TrackedPoseBatch.FirstTracker;
+
+            if (vrSystem is ITrackedPoseProvider provider)
+            {
+                var left = provider.GetControllerPose(ControllerHand.Left);
+                var right = provider.GetControllerPose(ControllerHand.Right);
+                trackedPoses.Set(TrackedPoseBatch.LeftHand, left.Position, left.Rotation);
+                trackedPoses.Set(TrackedPoseBatch.RightHand, right.Position, right.Rotation);
+            }
+            else
+            {
+                // Runtime without separate controller poses: hands at the head, so rays still start somewhere sensible
+                trackedPoses.Set(TrackedPoseBatch.LeftHand, headset.Position, headset.Rotation);
+                trackedPoses.Set(TrackedPoseBatch.RightHand, headset.Position, headset.Rotation);
+            }
+
+            // Latest sample of each tracker that still has tracking; lost ones drop out of the batch
+            int devices = deviceBuffers.DeviceCount;
+            for (int device = 0; device < devices; device++)
+            {
+                if (!deviceBuffers.TryRead(device, out var position, out var rotation)) continue;
 
-            // Apply scaling
-            position *= cameraSettings.PositionScale;
+                int tracker = trackedPoses.Count - TrackedPoseBatch.FirstTracker;
+                trackedPoses.Set(trackedPoses.Count++, position, rotation);
+                trackerRoles[tracker] = deviceBuffers.GetRole(device);
+            }
 
-            // Apply offset
-            position += cameraSettings.PositionOffset;
+            // Apply calibration and the game root to everything in one pass
+            transformGraph.TransformBatch(trackedPoses, TransformSpace.Game);
+        }
 
-            // Apply rotation adjustment
-            rotation = cameraSettings.RotationOffset * rotation;
+        /// <summary>
+        /// Controller buttons with the hand's game-space pose from the last GetHeadPose sample
+        /// </summary>
+        public ControllerState GetControllerState(ControllerHand hand)
+        {
+            var state = vrSystem.GetControllerState(hand);
+            int slot = TrackedPoseBatch.SlotFor(hand);
+            state.Position = trackedPoses.GetPosition(slot);
+            state.Rotation = trackedPoses.GetRotation(slot);
+            return state;
+        }
+
+        public HeadPose GetTrackerPose(int tracker)
+        {
+            if (tracker < 0 || tracker >= TrackerCount) throw new ArgumentOutOfRangeException(nameof(tracker));
 
             return new HeadPose
             {
-                Position = position,
-                Rotation = rotation
+                Position = trackedPoses.GetPosition(TrackedPoseBatch.FirstTracker + tracker),
+                Rotation = trackedPoses.GetRotation(TrackedPoseBatch.FirstTracker + tracker)
             };
         }
 
+        public TrackedDeviceRole GetTrackerRole(int tracker) => trackerRoles[tracker];
+
+        /// <summary>
+        /// Game-space pose of the first tracked device with the given role, from the last GetHeadPose sample
+        /// </summary>
+        public bool TryGetTrackerPose(TrackedDeviceRole role, out HeadPose pose)
+        {
+            for (int tracker = 0; tracker < TrackerCount; tracker++)
+            {
+                if (trackerRoles[tracker] == role)
+                {
+                    pose = GetTrackerPose(tracker);
+                    return true;
+                }
+            }
+
+            pose = default;
+            return false;
+        }
+
+        /// <summary>
+        /// Finger skeleton in game space, copied into caller-owned spans of TrackedDeviceBuffers.HandJointCount
+        /// </summary>
+        public bool TryGetHandSkeleton(ControllerHand hand, Span<Vector3> positions, Span<Quaternion> rotations)
+        {
+            if (!deviceBuffers.TryReadHand(hand, positions, rotations)) return false;
+
+            var toGame = transformGraph.GetWorld(TransformSpace.Game);
+            for (int j = 0; j < TrackedDeviceBuffers.HandJointCount; j++)
+            {
+                positions[j] = toGame.TransformPoint(positions[j]);
+                rotations[j] = toGame.TransformRotation(rotations[j]);
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Both hands' mapped actions and raw analog inputs, in the form the virtual controller fallback takes
+        /// </summary>
+        public void FillActionState(ref VRActionState state)
+        {
+            state.Digital.Clear();
+            if (vrSystem == null) return;
+
+            foreach (var action in GetDigitalActionStates(ControllerHand.Left))
+            {
+                if (action.Value) state.Digital.Set(action.Key, true);
+            }
+            foreach (var action in GetDigitalActionStates(ControllerHand.Right))
+            {
+                if (action.Value) state.Digital.Set(action.Key, true);
+            }
+
+            var left = vrSystem.GetControllerState(ControllerHand.Left);
+            var right = vrSystem.GetControllerState(ControllerHand.Right);
+            state.LeftStick = left.ThumbstickPosition;
+            state.RightStick = right.ThumbstickPosition;
+            state.LeftTrigger = left.TriggerValue;
+            state.RightTrigger = right.TriggerValue;
+        }
+
         public Dictionary<VRAction, bool> GetDigitalActionStates(ControllerHand hand)
         {
             if (vrSystem != null && currentControllerMapping != null)
@@ -0,0 +1,60 @@
+using System;
+using VRGameConverter.Audio;
+
+namespace VRGameConverter.Tests.Audio
+{
+    public static class AudioMixFormatTests
+    {
+        [Test]
+        public static void ExtensibleFloatMixFormat()
+        {
+            // What shared mode reports for a typical 7.1 float endpoint
+            byte[] format = WaveFormat(0xFFFE, channels: 8, sampleRate: 48000, bits: 32, extra: 22);
+            BitConverter.GetBytes((ushort)32).CopyTo(format, 18);           // valid bits
+            BitConverter.GetBytes(0x63F).CopyTo(format, 20);                // channel mask
+            new Guid("00000003-0000-0010-8000-00aa00389b71").ToByteArray().CopyTo(format, 24);
+
+            Assert.Equal(40, AudioMixFormat.SizeOf(format));
+            var parsed = AudioMixFormat.Parse(format);
+            Assert.Equal(48000, parsed.SampleRate);
+            Assert.Equal(8, parsed.Channels);
+            Assert.True(parsed.IsFloat32, "extensible IEEE float not recognised");
+        }
+
+        [Test]
+        public static void PcmStreamIsNotSpatialized()
+        {
+            byte[] format = WaveFormat(0xFFFE, channels: 2, sampleRate: 44100, bits: 16, extra: 22);
+            new Guid("00000001-0000-0010-8000-00aa00389b71").ToByteArray().CopyTo(format, 24);
+
+            var parsed = AudioMixFormat.Parse(format);
+            Assert.Equal(44100, parsed.SampleRate);
+            Assert.True(!parsed.IsFloat32, "16-bit PCM reported as float");
+        }
+
+        [Test]
+        public static void PlainFloatWaveFormat()
+        {
+            byte[] format = WaveFormat(0x0003, channels: 2, sampleRate: 96000, bits: 32, extra: 0);
+
+            Assert.Equal(18, AudioMixFormat.SizeOf(format));
+            var parsed = AudioMixFormat.Parse(format);
+            Assert.Equal(96000, parsed.SampleRate);
+            Assert.True(parsed.IsFloat32, "WAVE_FORMAT_IEEE_FLOAT not recognised");
+        }
+
+        private static byte[] WaveFormat(ushort tag, ushort channels, uint sampleRate, ushort bits, ushort extra)
+        {
+            var format = new byte[AudioMixFormat.WaveFormatExSize + extra];
+            ushort blockAlign = (ushort)(channels * bits / 8);
+            BitConverter.GetBytes(tag).CopyTo(format, 0);
+            BitConverter.GetBytes(channels).CopyTo(format, 2);
+            BitConverter.GetBytes(sampleRate).CopyTo(format, 4);
+            BitConverter.GetBytes(sampleRate * blockAlign).CopyTo(format, 8);
+            BitConverter.GetBytes(blockAlign).CopyTo(format, 12);
+            BitConverter.GetBytes(bits).CopyTo(format, 14);
+            BitConverter.GetBytes(extra).CopyTo(format, 16);
+            return format;
+        }
+    }
+}
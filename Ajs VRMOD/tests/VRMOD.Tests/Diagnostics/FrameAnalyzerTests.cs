@@ -0,0 +1,94 @@
+using System;
+using System.Diagnostics;
+using VRGameConverter.Diagnostics;
+using VRGameConverter.Rendering;
+
+namespace VRGameConverter.Tests.Diagnostics
+{
+    public static class FrameAnalyzerTests
+    {
+        private const float RefreshRate = 90.0f;
+        private const double Refresh = 1000.0 / RefreshRate;
+
+        private static long Ticks(double milliseconds) => (long)(milliseconds * Stopwatch.Frequency / 1000.0);
+
+        /// <summary>
+        /// One window of identical frames: the game submits after submitMs, Present returns after blockedMs
+        /// </summary>
+        private static FrameSummary RunWindow(double submitMs, double blockedMs, double hookMs = 0)
+        {
+            var analyzer = new FrameAnalyzer();
+            analyzer.SetRefreshRate(RefreshRate);
+
+            long end = Ticks(1000);
+            analyzer.EndFrame(end - Ticks(1), end);
+            for (int i = 0; i < FrameAnalyzer.WindowFrames; i++)
+            {
+                long presentStart = end + Ticks(submitMs);
+                end = presentStart + Ticks(blockedMs);
+                if (hookMs > 0) analyzer.AddHookTime(Stopwatch.GetTimestamp() - Ticks(hookMs));
+                analyzer.EndFrame(presentStart, end);
+            }
+
+            Assert.True(analyzer.TryTakeSummary(out var summary), "no summary after a full window");
+            Console.WriteLine($"    {summary}");
+            return summary;
+        }
+
+        [Test]
+        public static void VsyncWaitAfterCpuMissIsNotGpu()
+        {
+            // 13 ms of game work misses the 11.1 ms interval; Present then holds until the next refresh
+            var summary = RunWindow(13.0, 2 * Refresh - 13.0);
+
+            Assert.Equal(FrameBottleneck.GameCpu, summary.Bottleneck);
+            Assert.Near(0, summary.MeanGpuMilliseconds, 0.01, "gpu");
+            Assert.Near(2 * Refresh - 13.0, summary.MeanVsyncMilliseconds, 0.01, "vsync");
+            Assert.Near(13.0, summary.MeanGameCpuMilliseconds, 0.01, "cpu");
+        }
+
+        [Test]
+        public static void BlockingPastTheRefreshBoundaryIsGpu()
+        {
+            // Submitted in 6 ms, but Present only returns a whole interval after the first boundary
+            var summary = RunWindow(6.0, 2 * Refresh - 6.0);
+
+            Assert.Equal(FrameBottleneck.Gpu, summary.Bottleneck);
+            Assert.Near(Refresh, summary.MeanGpuMilliseconds, 0.01, "gpu");
+            Assert.Near(Refresh - 6.0, summary.MeanVsyncMilliseconds, 0.01, "vsync");
+        }
+
+        [Test]
+        public static void FramesOnTimeHaveNoBottleneck()
+        {
+            var summary = RunWindow(7.0, Refresh - 7.0, hookMs: 0.5);
+
+            Assert.Equal(0, summary.MissedFrames);
+            Assert.Equal(FrameBottleneck.None, summary.Bottleneck);
+            Assert.Near(0, summary.MeanGpuMilliseconds, 0.01, "gpu");
+            Assert.Near(6.5, summary.MeanGameCpuMilliseconds, 0.05, "cpu");
+        }
+
+        [Test]
+        public static void AdaptationStepsResolutionThenStereo()
+        {
+            var settings = new RenderSettings { HeadsetRefreshRate = RefreshRate };
+            var controller = new AdaptiveQualityController();
+            var gpuBound = new FrameSummary { Frames = 120, MissedFrames = 60, Bottleneck = FrameBottleneck.Gpu, P95FrameMilliseconds = 2 * Refresh };
+
+            int steps = 0;
+            while (settings.DynamicResolutionScale > settings.MinDynamicResolutionScale)
+            {
+                Assert.True(controller.Adapt(gpuBound, settings), "resolution not lowered");
+                Assert.Equal(StereoMode.DualPass, settings.StereoMode);
+                Assert.True(++steps < 100, "resolution never reached its floor");
+            }
+
+            Assert.True(controller.Adapt(gpuBound, settings), "stereo not switched at the resolution floor");
+            Assert.Equal(StereoMode.AlternateEye, settings.StereoMode);
+
+            // The switch is given time to show up before the next judgement
+            Assert.True(!controller.Adapt(gpuBound, settings), "judged during the cooldown");
+        }
+    }
+}
@@ -0,0 +1,41 @@
+using System;
+using VRGameConverter.Events;
+
+namespace VRGameConverter.Tests.Events
+{
+    public static class EventBusTests
+    {
+        // A type of its own, so other tests' subscribers don't show up here
+        private struct Ping
+        {
+            public int Value;
+        }
+
+        [Test]
+        public static void UnsubscribedQueuesStopReceiving()
+        {
+            var first = EventBus.Subscribe<Ping>();
+            var second = EventBus.Subscribe<Ping>();
+            var third = EventBus.Subscribe<Ping>();
+
+            EventBus.Publish(new Ping { Value = 1 });
+            EventBus.Unsubscribe(second);
+            EventBus.Publish(new Ping { Value = 2 });
+
+            Assert.True(first.TryDequeue(out var ping) && ping.Value == 1, "first got 1");
+            Assert.True(first.TryDequeue(out ping) && ping.Value == 2, "first got 2");
+            Assert.True(second.TryDequeue(out ping) && ping.Value == 1, "second keeps what came before");
+            Assert.True(!second.TryDequeue(out _), "second gets nothing after unsubscribing");
+            Assert.True(third.TryDequeue(out ping) && ping.Value == 1, "third got 1");
+            Assert.True(third.TryDequeue(out ping) && ping.Value == 2, "third got 2");
+
+            // Twice, or with a queue that was never subscribed, is harmless
+            EventBus.Unsubscribe(second);
+            EventBus.Unsubscribe(new EventQueue<Ping>(4));
+            EventBus.Unsubscribe(first);
+            EventBus.Unsubscribe(third);
+            EventBus.Publish(new Ping { Value = 3 });
+            Assert.True(!first.TryDequeue(out _) && !third.TryDequeue(out _), "nobody left");
+        }
+    }
+}
@@ -0,0 +1,198 @@
+using System;
+using System.Runtime.InteropServices;
+using System.Threading;
+using VRGameConverter.Hooking;
+
+namespace VRGameConverter.Tests.Hooking
+{
+    /// <summary>
+    /// Installs and removes hooks over and over while other threads keep calling the hooked functions.
+    /// Every call has to return either the original or the hooked result; a torn prologue crashes the process.
+    /// </summary>
+    public static class HookEngineStressTests
+    {
+        private const int Cycles = 200;
+        private const int CallerThreads = 4;
+        private const long HookedBias = 1000;
+
+        [UnmanagedFunctionPointer(CallingConvention.Winapi)]
+        private delegate long ProbeFunction(long value);
+
+        // Each probe returns value + 1, with a prologue shaped to take one install path
+        private static readonly byte[][] ProbeShapes =
+        {
+            // mov rax, rcx; add rax, 1; ret — first instruction shorter than the jump: suspend-all fallback
+            new byte[] { 0x48, 0x89, 0xC8, 0x48, 0x83, 0xC0, 0x01, 0xC3 },
+            // lea rax, [rcx+disp32]; ret — one 7-byte instruction covers the jump: lone atomic write
+            new byte[] { 0x48, 0x8D, 0x81, 0x01, 0x00, 0x00, 0x00, 0xC3 },
+            // int3 padding; lea rax, [rcx+1]; ret — compiler hot-patch padding
+            new byte[] { 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0x48, 0x8D, 0x41, 0x01, 0xC3 }
+        };
+
+        private static readonly int[] EntryOffsets = { 0x10, 0x30, 0x55 };
+
+        [Test]
+        public static void ConcurrentInstallAndUninstall()
+        {
+            Assert.WindowsOnly();
+
+            var engine = new HookEngine();
+            using (var page = new ProbePage())
+            {
+                var probes = new Probe[ProbeShapes.Length];
+                for (int i = 0; i < probes.Length; i++)
+                {
+                    probes[i] = new Probe(page.Write(EntryOffsets[i], ProbeShapes[i]) + (i == 2 ? 5 : 0));
+                    probes[i].Install(engine);
+                }
+
+                var stop = new ManualResetEventSlim();
+                long calls = 0, hookedCalls = 0;
+                Exception failure = null;
+
+                var callers = new Thread[CallerThreads];
+                for (int t = 0; t < callers.Length; t++)
+                {
+                    callers[t] = new Thread(() =>
+                    {
+                        try
+                        {
+                            long local = 0, hooked = 0;
+                            for (long v = 0; !stop.IsSet; v++)
+                            {
+                                foreach (var probe in probes)
+                                {
+                                    long result = probe.Direct(v);
+                                    if (result == v + 1 + HookedBias) hooked++;
+                                    else if (result != v + 1) throw new InvalidOperationException($"Probe returned {result} for {v}");
+                                    local++;
+                                }
+                            }
+                            Interlocked.Add(ref calls, local);
+                            Interlocked.Add(ref hookedCalls, hooked);
+                        }
+                        catch (Exception ex)
+                        {
+                            failure = ex;
+                        }
+                    }) { IsBackground = true };
+                    callers[t].Start();
+                }
+
+                // Two installers so the engine's lock is contended as well
+                var second = new Thread(() => Cycle(engine, probes[2])) { IsBackground = true };
+                second.Start();
+                Cycle(engine, probes[0], probes[1]);
+                second.Join();
+
+                stop.Set();
+                foreach (var caller in callers) caller.Join();
+
+                if (failure != null) throw failure;
+                Assert.True(calls > 0 && hookedCalls > 0 && hookedCalls < calls, $"{hookedCalls} of {calls} calls went through the hook");
+
+                var statistics = engine.GetStatistics();
+                Console.WriteLine($"  {calls} calls, {hookedCalls} hooked; {statistics}");
+                Assert.Equal((long)(Cycles * probes.Length + probes.Length), statistics.InstallCount, "installs");
+                Assert.True(statistics.SuspendFallbacks >= Cycles, "short prologue never fell back to suspension");
+            }
+        }
+
+        [Test]
+        public static void UninstallDetectsOverwrittenPrologue()
+        {
+            Assert.WindowsOnly();
+
+            var engine = new HookEngine();
+            using (var page = new ProbePage())
+            {
+                IntPtr entry = page.Write(0x10, ProbeShapes[1]);
+                var probe = new Probe(entry);
+                probe.Install(engine);
+
+                // Someone else restores the prologue behind our back
+                Marshal.Copy(ProbeShapes[1], 0, entry, 5);
+                Assert.Throws<InvalidOperationException>(() => engine.UninstallHook(entry));
+            }
+        }
+
+        [Test]
+        public static void CallOverheadIsMeasured()
+        {
+            Assert.WindowsOnly();
+
+            double overhead = HookBenchmark.MeasureCallOverheadNanoseconds(new HookEngine(), 20000);
+            Console.WriteLine($"  {overhead:F1} ns per hooked call");
+            Assert.True(overhead >= 0 && overhead < 10000, $"implausible overhead {overhead} ns");
+        }
+
+        private static void Cycle(HookEngine engine, params Probe[] probes)
+        {
+            for (int i = 0; i < Cycles; i++)
+            {
+                foreach (var probe in probes)
+                {
+                    engine.UninstallHook(probe.Entry);
+                    Thread.Yield();
+                    probe.Install(engine);
+                }
+            }
+        }
+
+        private sealed class Probe
+        {
+            public readonly IntPtr Entry;
+            public readonly ProbeFunction Direct;
+            private readonly ProbeFunction hook;
+            private ProbeFunction original;
+
+            public Probe(IntPtr entry)
+            {
+                Entry = entry;
+                Direct = Marshal.GetDelegateForFunctionPointer<ProbeFunction>(entry);
+                hook = value => Volatile.Read(ref original)(value) + HookedBias;
+            }
+
+            public void Install(HookEngine engine)
+            {
+                // Trampolines from earlier installs are never freed, so a caller still holding one is safe. The
+                // callers are already running, so the original has to be in place before the patch is.
+                engine.InstallHook(Entry, hook, HookInstallMode.HotPatch, trampoline => Volatile.Write(ref original, trampoline));
+            }
+        }
+
+        private sealed class ProbePage : IDisposable
+        {
+            private readonly IntPtr page;
+
+            public ProbePage()
+            {
+                page = VirtualAlloc(IntPtr.Zero, (UIntPtr)4096, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+                if (page == IntPtr.Zero) throw new OutOfMemoryException("Unable to allocate probe page");
+            }
+
+            public IntPtr Write(int offset, byte[] code)
+            {
+                Marshal.Copy(code, 0, page + offset, code.Length);
+                return page + offset;
+            }
+
+            public void Dispose()
+            {
+                // Leaked hooks would point into freed memory; only release once every hook is gone
+                VirtualFree(page, UIntPtr.Zero, MEM_RELEASE);
+            }
+        }
+
+        private const uint MEM_COMMIT = 0x1000;
+        private const uint MEM_RESERVE = 0x2000;
+        private const uint MEM_RELEASE = 0x8000;
+        private const uint PAGE_EXECUTE_READWRITE = 0x40;
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern IntPtr VirtualAlloc(IntPtr lpAddress, UIntPtr dwSize, uint flAllocationType, uint flProtect);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool VirtualFree(IntPtr lpAddress, UIntPtr dwSize, uint dwFreeType);
+    }
+}
@@ -0,0 +1,379 @@
+using System;
+using System.Collections.Generic;
+using VRGameConverter.Hooking;
+
+namespace VRGameConverter.Tests.Hooking
+{
+    /// <summary>
+    /// One instruction written by the corpus emitter, with what the decoder should find in it
+    /// </summary>
+    public struct EmittedInstruction
+    {
+        public int Offset;
+        public int Length;
+        public string Form;
+        public bool IsRipRelative;
+        public int DisplacementOffset;
+        public BranchKind Branch;
+
+        // Absolute address the operand or branch refers to, for RIP-relative and relative-branch forms
+        public long Target;
+    }
+
+    /// <summary>
+    /// A generated function entry: the instructions the emitter wrote, then int3 padding
+    /// </summary>
+    public sealed class GeneratedPrologue
+    {
+        public byte[] Code;
+        public List<EmittedInstruction> Instructions;
+        public long Address;
+    }
+
+    /// <summary>
+    /// Small x64 emitter for the shapes compilers put at function entry: pushes with and without REX, sub/and
+    /// rsp in both immediate sizes, register saves through SIB addressing, RIP-relative loads, stores and
+    /// compares (some with an immediate after the displacement), segment loads, multi-byte nops, short and
+    /// near branches and early returns. Seeded, so a failure names a function that can be regenerated.
+    /// </summary>
+    public sealed class PrologueCorpus
+    {
+        public const int PrologueSize = 32;
+
+        private readonly Random random;
+        private readonly List<byte> code = new List<byte>();
+        private readonly List<EmittedInstruction> instructions = new List<EmittedInstruction>();
+        private long address;
+
+        private delegate void Form(PrologueCorpus corpus);
+
+        // Weighted towards the frame setup that dominates real prologues
+        private static readonly (int Weight, Form Emit)[] Forms =
+        {
+            (6, c => c.PushRegister()),
+            (4, c => c.SubRsp()),
+            (4, c => c.SaveToStack()),
+            (3, c => c.MoveRegister()),
+            (2, c => c.LeaFramePointer()),
+            (5, c => c.RipRelative()),
+            (2, c => c.ZeroOrTest()),
+            (2, c => c.MoveImmediate()),
+            (2, c => c.Nop()),
+            (1, c => c.SegmentLoad()),
+            (1, c => c.AlignStack()),
+            (3, c => c.ShortConditional()),
+            (1, c => c.NearConditional()),
+            (2, c => c.NearCall()),
+            (1, c => c.ShortJump()),
+            (1, c => c.Return())
+        };
+
+        private static readonly int TotalWeight = Sum();
+
+        public PrologueCorpus(int seed)
+        {
+            random = new Random(seed);
+        }
+
+        /// <summary>
+        /// A function at a random 16-byte aligned address in the usual image range, at least minimumLength
+        /// bytes of instructions unless it returns or jumps away first
+        /// </summary>
+        public GeneratedPrologue Next(int minimumLength)
+        {
+            code.Clear();
+            instructions.Clear();
+            address = 0x140000000L + random.Next(0x1000, 0x4000000) * 16L;
+
+            // Past the stolen bytes, so the builder has whole instructions to copy whatever it needs
+            while (code.Count < minimumLength + 8)
+            {
+                int pick = random.Next(TotalWeight);
+                foreach (var (weight, emit) in Forms)
+                {
+                    pick -= weight;
+                    if (pick >= 0) continue;
+                    emit(this);
+                    break;
+                }
+
+                var last = instructions[instructions.Count - 1];
+                if (last.Branch == BranchKind.Return || last.Branch == BranchKind.JumpRel8 || last.Branch == BranchKind.JumpRel32) break;
+            }
+
+            var bytes = new byte[PrologueSize + 16];
+            bytes.AsSpan().Fill(0xCC);
+            code.CopyTo(0, bytes, 0, Math.Min(code.Count, bytes.Length));
+            return new GeneratedPrologue { Code = bytes, Instructions = new List<EmittedInstruction>(instructions), Address = address };
+        }
+
+        private static int Sum()
+        {
+            int total = 0;
+            foreach (var form in Forms) total += form.Weight;
+            return total;
+        }
+
+        #region Forms
+
+        private void PushRegister()
+        {
+            int register = random.Next(16);
+            int start = Begin();
+            if (register >= 8) code.Add(0x41);
+            code.Add((byte)(0x50 + (register & 7)));
+            End(start, "push r64");
+        }
+
+        private void SubRsp()
+        {
+            int start = Begin();
+            if (random.Next(2) == 0)
+            {
+                Bytes(0x48, 0x83, 0xEC, (byte)(8 * random.Next(1, 16)));
+                End(start, "sub rsp, imm8");
+            }
+            else
+            {
+                Bytes(0x48, 0x81, 0xEC);
+                Int32(0x10 * random.Next(9, 0x1000));
+                End(start, "sub rsp, imm32");
+            }
+        }
+
+        private void SaveToStack()
+        {
+            // mov [rsp+disp], r64 through a SIB byte; REX.R picks r8-r15
+            int register = random.Next(16);
+            int start = Begin();
+            code.Add((byte)(0x48 | (register >= 8 ? 0x04 : 0)));
+            code.Add(0x89);
+            if (random.Next(3) > 0)
+            {
+                Bytes((byte)(0x44 | ((register & 7) << 3)), 0x24, (byte)(8 * random.Next(1, 16)));
+                End(start, "mov [rsp+disp8], r64");
+            }
+            else
+            {
+                Bytes((byte)(0x84 | ((register & 7) << 3)), 0x24);
+                Int32(8 * random.Next(16, 0x400));
+                End(start, "mov [rsp+disp32], r64");
+            }
+        }
+
+        private void MoveRegister()
+        {
+            int start = Begin();
+            Bytes(0x48, random.Next(2) == 0 ? (byte)0x89 : (byte)0x8B, (byte)(0xC0 | random.Next(64)));
+            End(start, "mov r64, r64");
+        }
+
+        private void LeaFramePointer()
+        {
+            int start = Begin();
+            Bytes(0x48, 0x8D, 0x6C, 0x24, (byte)random.Next(0x80));
+            End(start, "lea rbp, [rsp+disp8]");
+        }
+
+        private void RipRelative()
+        {
+            int displacement = random.Next(2) == 0 ? random.Next(-0x100000, 0x100000) : random.Next();
+            if (random.Next(2) == 0) displacement = -displacement;
+            int start = Begin();
+            string form;
+            int immediate = 0;
+
+            switch (random.Next(6))
+            {
+                case 0:
+                    Bytes(0x48, 0x8B, 0x05);
+                    form = "mov rax, [rip+disp32]";
+                    break;
+                case 1:
+                    Bytes(0x48, 0x8D, 0x0D);
+                    form = "lea rcx, [rip+disp32]";
+                    break;
+                case 2:
+                    Bytes(0x8B, 0x15);
+                    form = "mov edx, [rip+disp32]";
+                    break;
+                case 3:
+                    Bytes(0xF3, 0x0F, 0x10, 0x05);
+                    form = "movss xmm0, [rip+disp32]";
+                    break;
+                case 4:
+                    Bytes(0x83, 0x3D);
+                    immediate = 1;
+                    form = "cmp dword [rip+disp32], imm8";
+                    break;
+                default:
+                    Bytes(0xC7, 0x05);
+                    immediate = 4;
+                    form = "mov dword [rip+disp32], imm32";
+                    break;
+            }
+
+            int displacementOffset = code.Count - start;
+            Int32(displacement);
+            for (int i = 0; i < immediate; i++) code.Add((byte)random.Next(256));
+
+            // RIP is the end of the whole instruction, immediate included
+            long next = address + code.Count;
+            End(start, form, ripDisplacementOffset: displacementOffset, target: next + displacement);
+        }
+
+        private void ZeroOrTest()
+        {
+            int start = Begin();
+            if (random.Next(2) == 0)
+            {
+                Bytes(0x33, 0xC0);
+                End(start, "xor eax, eax");
+            }
+            else
+            {
+                Bytes(0x48, 0x85, 0xC9);
+                End(start, "test rcx, rcx");
+            }
+        }
+
+        private void MoveImmediate()
+        {
+            int start = Begin();
+            if (random.Next(2) == 0)
+            {
+                code.Add((byte)(0xB8 + random.Next(8)));
+                Int32(random.Next());
+                End(start, "mov r32, imm32");
+            }
+            else
+            {
+                Bytes(0x48, (byte)(0xB8 + random.Next(8)));
+                Int32(random.Next());
+                Int32(random.Next());
+                End(start, "mov r64, imm64");
+            }
+        }
+
+        private void Nop()
+        {
+            int start = Begin();
+            switch (random.Next(4))
+            {
+                case 0:
+                    Bytes(0x90);
+                    break;
+                case 1:
+                    Bytes(0x66, 0x90);
+                    break;
+                case 2:
+                    Bytes(0x0F, 0x1F, 0x40, 0x00);
+                    break;
+                default:
+                    Bytes(0x0F, 0x1F, 0x44, 0x00, 0x00);
+                    break;
+            }
+            End(start, "nop");
+        }
+
+        private void SegmentLoad()
+        {
+            // mov rax, gs:[0x30]: SIB with no base or index, absolute disp32
+            int start = Begin();
+            Bytes(0x65, 0x48, 0x8B, 0x04, 0x25);
+            Int32(0x30);
+            End(start, "mov rax, gs:[disp32]");
+        }
+
+        private void AlignStack()
+        {
+            int start = Begin();
+            Bytes(0x48, 0x83, 0xE4, 0xF0);
+            End(start, "and rsp, -16");
+        }
+
+        // Branch targets stay clear of the first PrologueSize bytes, which the builder must reject
+        private int BranchDisplacement(int next, bool shortForm)
+        {
+            bool backwards = random.Next(4) == 0;
+            if (shortForm)
+            {
+                return backwards ? -next - random.Next(1, 128 - next) : random.Next(PrologueSize - next + 1, 128);
+            }
+            return backwards ? -next - random.Next(1, 0x1000000) : random.Next(PrologueSize, 0x1000000);
+        }
+
+        private void ShortConditional()
+        {
+            int start = Begin();
+            int condition = random.Next(16);
+            int displacement = BranchDisplacement(code.Count + 2, true);
+            Bytes((byte)(0x70 | condition), (byte)(sbyte)displacement);
+            End(start, "jcc rel8", BranchKind.ConditionalRel8, address + code.Count + displacement);
+        }
+
+        private void NearConditional()
+        {
+            int start = Begin();
+            int displacement = BranchDisplacement(code.Count + 6, false);
+            Bytes(0x0F, (byte)(0x80 | random.Next(16)));
+            Int32(displacement);
+            End(start, "jcc rel32", BranchKind.ConditionalRel32, address + code.Count + displacement);
+        }
+
+        private void NearCall()
+        {
+            int start = Begin();
+            int displacement = BranchDisplacement(code.Count + 5, false);
+            code.Add(0xE8);
+            Int32(displacement);
+            End(start, "call rel32", BranchKind.CallRel32, address + code.Count + displacement);
+        }
+
+        private void ShortJump()
+        {
+            int start = Begin();
+            int displacement = BranchDisplacement(code.Count + 2, true);
+            Bytes(0xEB, (byte)(sbyte)displacement);
+            End(start, "jmp rel8", BranchKind.JumpRel8, address + code.Count + displacement);
+        }
+
+        private void Return()
+        {
+            int start = Begin();
+            code.Add(0xC3);
+            End(start, "ret", BranchKind.Return);
+        }
+
+        #endregion
+
+        private int Begin()
+        {
+            return code.Count;
+        }
+
+        private void Bytes(params byte[] bytes)
+        {
+            code.AddRange(bytes);
+        }
+
+        private void Int32(int value)
+        {
+            code.AddRange(BitConverter.GetBytes(value));
+        }
+
+        private void End(int start, string form, BranchKind branch = BranchKind.None, long target = 0, int ripDisplacementOffset = -1)
+        {
+            instructions.Add(new EmittedInstruction
+            {
+                Offset = start,
+                Length = code.Count - start,
+                Form = form,
+                IsRipRelative = ripDisplacementOffset >= 0,
+                DisplacementOffset = Math.Max(0, ripDisplacementOffset),
+                Branch = branch,
+                Target = target
+            });
+        }
+    }
+}
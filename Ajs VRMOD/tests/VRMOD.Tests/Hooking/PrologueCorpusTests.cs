@@ -0,0 +1,226 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using VRGameConverter.Hooking;
+
+namespace VRGameConverter.Tests.Hooking
+{
+    /// <summary>
+    /// InstructionDecoder and TrampolineBuilder over thousands of generated prologues. Every instruction has to
+    /// decode to the length and operands it was emitted with, and every trampoline has to reach the same
+    /// addresses from its own location as the stolen bytes did from theirs. Runs anywhere: nothing here touches
+    /// executable memory. Installing and calling through hooks needs the Win32 memory and thread APIs, so
+    /// their throughput stays with HookEngineStressTests; this reports the decode and build cost an install
+    /// pays on top.
+    /// </summary>
+    public static class PrologueCorpusTests
+    {
+        private const int Functions = 5000;
+        private const int Seed = 102;
+        private const int JumpRel32Size = 5;
+        private const int HotPatchJumpSize = 2;
+
+        [Test]
+        public static void CorpusDecodesAndRelocates()
+        {
+            var corpus = new PrologueCorpus(Seed);
+            var random = new Random(Seed);
+            var forms = new Dictionary<string, int>();
+            int built = 0, absolute = 0, rejected = 0;
+
+            for (int i = 0; i < Functions; i++)
+            {
+                // One in five takes the 2-byte jump into hot-patch padding
+                int minimumStolen = i % 5 == 0 ? HotPatchJumpSize : JumpRel32Size;
+                var function = corpus.Next(minimumStolen);
+                foreach (var instruction in function.Instructions)
+                {
+                    forms[instruction.Form] = forms.GetValueOrDefault(instruction.Form) + 1;
+                }
+
+                CheckDecode(function, i);
+
+                // Mostly within rel32 of the target, as AllocateCode arranges; sometimes too far, which turns every
+                // branch into its absolute form and has to refuse RIP-relative operands it can't reach
+                bool far = i % 7 == 0;
+                long trampoline = far
+                    ? function.Address + 0x200000000L
+                    : function.Address + random.Next(-0x10000000, 0x10000000) / 16 * 16L;
+
+                RelocatedPrologue relocated;
+                try
+                {
+                    relocated = TrampolineBuilder.Build(function.Code, minimumStolen, function.Address, trampoline);
+                }
+                catch (NotSupportedException ex)
+                {
+                    Assert.True(Stolen(function, minimumStolen).Any(s => s.IsRipRelative && !Reachable(s.Target, trampoline)),
+                        $"function {i} rejected with no out-of-range operand: {ex.Message}");
+                    rejected++;
+                    continue;
+                }
+
+                CheckTrampoline(function, minimumStolen, relocated, trampoline, i);
+                Assert.True(relocated.Code.Length <= TrampolineBuilder.MaxSize(function.Code, minimumStolen),
+                    $"function {i} overran its trampoline reservation");
+                built++;
+                if (far) absolute++;
+            }
+
+            Console.WriteLine($"  {Functions} prologues: {built} relocated ({absolute} through absolute jumps), {rejected} refused an unreachable operand");
+            Console.WriteLine($"  {string.Join(", ", forms.OrderByDescending(f => f.Value).Select(f => $"{f.Key} {f.Value}"))}");
+
+            // Every form the emitter knows made it into the corpus
+            Assert.Equal(25, forms.Count, "distinct instruction forms");
+            Assert.True(absolute > 0 && rejected > 0, "far trampolines were never exercised");
+        }
+
+        [Test]
+        public static void CorpusBuildThroughput()
+        {
+            var corpus = new PrologueCorpus(Seed);
+            var functions = Enumerable.Range(0, Functions).Select(_ => corpus.Next(JumpRel32Size)).ToList();
+
+            // What InstallHook spends before it touches the target: MaxSize to reserve, then Build
+            for (int pass = 0; pass < 2; pass++)
+            {
+                long started = Stopwatch.GetTimestamp();
+                int bytes = 0;
+                foreach (var function in functions)
+                {
+                    bytes += TrampolineBuilder.MaxSize(function.Code, JumpRel32Size);
+                    bytes += TrampolineBuilder.Build(function.Code, JumpRel32Size, function.Address, function.Address + 0x1000).Code.Length;
+                }
+                double seconds = (Stopwatch.GetTimestamp() - started) / (double)Stopwatch.Frequency;
+
+                // The first pass only warms the JIT
+                if (pass == 1)
+                {
+                    double microseconds = seconds * 1e6 / functions.Count;
+                    Console.WriteLine($"  {functions.Count / seconds:F0} trampolines built per second ({microseconds:F2} us each, {bytes} bytes)");
+                    Assert.True(microseconds < 100, $"building a trampoline took {microseconds:F2} us");
+                }
+            }
+        }
+
+        private static void CheckDecode(GeneratedPrologue function, int index)
+        {
+            foreach (var emitted in function.Instructions)
+            {
+                var decoded = InstructionDecoder.Decode(function.Code, emitted.Offset);
+                string where = $"function {index}, {emitted.Form} at {emitted.Offset}";
+                Assert.Equal(emitted.Length, decoded.Length, $"{where}: length");
+                Assert.Equal(emitted.IsRipRelative, decoded.IsRipRelative, $"{where}: RIP-relative");
+                if (emitted.IsRipRelative)
+                {
+                    Assert.Equal(emitted.DisplacementOffset, decoded.DisplacementOffset, $"{where}: displacement offset");
+                }
+                Assert.Equal(emitted.Branch, decoded.Branch, $"{where}: branch");
+            }
+        }
+
+        private static void CheckTrampoline(GeneratedPrologue function, int minimumStolen, RelocatedPrologue relocated, long trampoline, int index)
+        {
+            var stolen = Stolen(function, minimumStolen);
+            var last = stolen[stolen.Count - 1];
+            Assert.Equal(last.Offset + last.Length, relocated.StolenLength, $"function {index}: stolen length");
+            Assert.SequenceEqual(stolen.Select(s => s.Offset), relocated.OriginalOffsets, $"function {index}: instruction boundaries");
+
+            byte[] code = relocated.Code;
+            for (int i = 0; i < stolen.Count; i++)
+            {
+                var emitted = stolen[i];
+                int at = relocated.TrampolineOffsets[i];
+                long here = trampoline + at;
+                string where = $"function {index}, {emitted.Form} at {emitted.Offset}";
+
+                switch (emitted.Branch)
+                {
+                    case BranchKind.CallRel32:
+                        Assert.Equal(emitted.Target, code[at] == 0xE8
+                            ? here + 5 + BitConverter.ToInt32(code, at + 1)
+                            : AbsoluteTarget(code, at, 0x15, 8), $"{where}: call target");
+                        break;
+
+                    case BranchKind.JumpRel8:
+                    case BranchKind.JumpRel32:
+                        Assert.Equal(emitted.Target, code[at] == 0xE9
+                            ? here + 5 + BitConverter.ToInt32(code, at + 1)
+                            : AbsoluteTarget(code, at, 0x25, 6), $"{where}: jump target");
+                        break;
+
+                    case BranchKind.ConditionalRel8:
+                    case BranchKind.ConditionalRel32:
+                        {
+                            int condition = function.Code[emitted.Offset + (emitted.Branch == BranchKind.ConditionalRel8 ? 0 : 1)] & 0x0F;
+                            if (code[at] == 0x0F)
+                            {
+                                Assert.Equal((byte)(0x80 | condition), code[at + 1], $"{where}: condition");
+                                Assert.Equal(emitted.Target, here + 6 + BitConverter.ToInt32(code, at + 2), $"{where}: jcc target");
+                            }
+                            else
+                            {
+                                // Inverted short jcc over the absolute jump
+                                Assert.Equal((byte)(0x70 | (condition ^ 1)), code[at], $"{where}: inverted condition");
+                                Assert.Equal(emitted.Target, AbsoluteTarget(code, at + 2, 0x25, 6), $"{where}: jcc target");
+                            }
+                            break;
+                        }
+
+                    default:
+                        {
+                            var copy = code.AsSpan(at, emitted.Length).ToArray();
+                            var original = function.Code.AsSpan(emitted.Offset, emitted.Length).ToArray();
+                            if (emitted.IsRipRelative)
+                            {
+                                long target = here + emitted.Length + BitConverter.ToInt32(copy, emitted.DisplacementOffset);
+                                Assert.Equal(emitted.Target, target, $"{where}: operand address");
+
+                                // Everything but the displacement is copied as is, immediates included
+                                BitConverter.GetBytes(0).CopyTo(copy, emitted.DisplacementOffset);
+                                BitConverter.GetBytes(0).CopyTo(original, emitted.DisplacementOffset);
+                            }
+                            Assert.SequenceEqual(original, copy, $"{where}: copied bytes");
+
+                            // The copy has to decode exactly as the original did
+                            Assert.Equal(emitted.Length, InstructionDecoder.Decode(code, at).Length, $"{where}: copy decodes");
+                            break;
+                        }
+                }
+            }
+
+            // Unless the stolen bytes leave on their own, the trampoline resumes right after them
+            if (last.Branch != BranchKind.Return && last.Branch != BranchKind.JumpRel8 && last.Branch != BranchKind.JumpRel32)
+            {
+                int resume = code.Length - 14;
+                Assert.Equal(function.Address + relocated.StolenLength, AbsoluteTarget(code, resume, 0x25, 6), $"function {index}: return jump");
+            }
+        }
+
+        private static List<EmittedInstruction> Stolen(GeneratedPrologue function, int minimumStolen)
+        {
+            var stolen = new List<EmittedInstruction>();
+            foreach (var instruction in function.Instructions)
+            {
+                if (instruction.Offset >= minimumStolen) break;
+                stolen.Add(instruction);
+            }
+            return stolen;
+        }
+
+        // FF /2 or FF /4 through [rip+0], or [rip+2] over a short jump, with the destination as a qword
+        private static long AbsoluteTarget(byte[] code, int at, byte modRm, int qwordOffset)
+        {
+            Assert.Equal((byte)0xFF, code[at], "absolute branch opcode");
+            Assert.Equal(modRm, code[at + 1], "absolute branch form");
+            return BitConverter.ToInt64(code, at + qwordOffset);
+        }
+
+        private static bool Reachable(long target, long trampoline)
+        {
+            // Anywhere in the trampoline's reservation has to reach the operand
+            return Math.Abs(target - trampoline) < int.MaxValue - 256;
+        }
+    }
+}
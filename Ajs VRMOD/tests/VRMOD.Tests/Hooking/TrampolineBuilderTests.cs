@@ -0,0 +1,82 @@
+using System;
+using VRGameConverter.Hooking;
+
+namespace VRGameConverter.Tests.Hooking
+{
+    public static class TrampolineBuilderTests
+    {
+        private const long Original = 0x140001000;
+        private const long Trampoline = 0x140002000;
+
+        [Test]
+        public static void RipRelativeOperandIsRebased()
+        {
+            // mov rax, [rip+0x10]; ret
+            byte[] prologue = Pad(0x48, 0x8B, 0x05, 0x10, 0x00, 0x00, 0x00, 0xC3);
+            var relocated = TrampolineBuilder.Build(prologue, 5, Original, Trampoline);
+
+            Assert.Equal(7, relocated.StolenLength);
+            long target = Original + 7 + 0x10;
+            int displacement = BitConverter.ToInt32(relocated.Code, 3);
+            Assert.Equal(target, Trampoline + 7 + displacement, "relocated operand address");
+            AssertJumpsBackTo(relocated, 7, Original + 7);
+        }
+
+        [Test]
+        public static void ShortConditionalIsWidened()
+        {
+            // je +0x10; mov rax, rcx
+            byte[] prologue = Pad(0x74, 0x10, 0x48, 0x89, 0xC8);
+            var relocated = TrampolineBuilder.Build(prologue, 5, Original, Trampoline);
+
+            Assert.Equal((byte)0x0F, relocated.Code[0]);
+            Assert.Equal((byte)0x84, relocated.Code[1]);
+            Assert.Equal(Original + 2 + 0x10, Trampoline + 6 + BitConverter.ToInt32(relocated.Code, 2), "widened jcc target");
+
+            // A thread stopped on the mov has to resume after the widened jcc
+            Assert.Equal(6, relocated.MapOffset(2));
+            Assert.Equal(-1, relocated.MapOffset(1));
+            AssertJumpsBackTo(relocated, 9, Original + 5);
+        }
+
+        [Test]
+        public static void BranchToFunctionEntryIsRejected()
+        {
+            // jmp $ would land on the hook jump itself rather than the relocated prologue
+            byte[] prologue = Pad(0xEB, 0xFE, 0x90, 0x90, 0x90);
+            Assert.Throws<NotSupportedException>(() => TrampolineBuilder.Build(prologue, 5, Original, Trampoline));
+        }
+
+        [Test]
+        public static void BranchIntoStolenBytesIsRejected()
+        {
+            // push rbx; push rbx; jne -3 (back onto the second push)
+            byte[] prologue = Pad(0x53, 0x53, 0x75, 0xFD, 0x90);
+            Assert.Throws<NotSupportedException>(() => TrampolineBuilder.Build(prologue, 5, Original, Trampoline));
+        }
+
+        [Test]
+        public static void MaxSizeCoversBuiltTrampoline()
+        {
+            byte[] prologue = Pad(0x74, 0x10, 0xE8, 0x00, 0x01, 0x00, 0x00, 0x48, 0x8B, 0x05, 0x10, 0x00, 0x00, 0x00);
+            var relocated = TrampolineBuilder.Build(prologue, 5, Original, Trampoline);
+            Assert.True(relocated.Code.Length <= TrampolineBuilder.MaxSize(prologue, 5), "trampoline overran its reservation");
+        }
+
+        private static void AssertJumpsBackTo(RelocatedPrologue relocated, int at, long destination)
+        {
+            // jmp qword ptr [rip+0]; dq destination
+            Assert.Equal((byte)0xFF, relocated.Code[at]);
+            Assert.Equal((byte)0x25, relocated.Code[at + 1]);
+            Assert.Equal(destination, BitConverter.ToInt64(relocated.Code, at + 6), "return jump");
+        }
+
+        private static byte[] Pad(params byte[] code)
+        {
+            var prologue = new byte[32];
+            prologue.AsSpan().Fill(0xCC);
+            code.CopyTo(prologue, 0);
+            return prologue;
+        }
+    }
+}
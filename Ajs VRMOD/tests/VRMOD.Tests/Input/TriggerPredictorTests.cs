@@ -0,0 +1,109 @@
+using System;
+using System.Collections.Generic;
+
+namespace VRGameConverter.Tests.Input
+{
+    public static class TriggerPredictorTests
+    {
+        // The mapper polls input once per headset frame
+        private const double UpdateRate = 90.0;
+
+        // Trigger travel for a pull lasting pullSeconds that starts after a short rest: eased in and out,
+        // like a finger accelerating through the travel and slowing against the stop
+        private static float Pull(double t, double pullSeconds, float depth = 1.0f)
+        {
+            const double rest = 0.05;
+            double x = Math.Clamp((t - rest) / pullSeconds, 0, 1);
+            return (float)(depth * x * x * (3 - 2 * x));
+        }
+
+        /// <summary>
+        /// Time the predictor first reports the action held, or -1 if it never does within the duration
+        /// </summary>
+        private static double FirstPress(TriggerPredictor predictor, Func<double, float> trigger, double duration, double start = 0)
+        {
+            for (double t = start; t < start + duration; t += 1.0 / UpdateRate)
+            {
+                predictor.Update(trigger(t), t);
+                if (predictor.PressedThisUpdate) return t;
+            }
+            return -1;
+        }
+
+        [Test]
+        public static void FastPullsFireTensOfMillisecondsEarlier()
+        {
+            var leads = new List<double>();
+            foreach (double pullSeconds in new[] { 0.08, 0.1, 0.12, 0.15, 0.2 })
+            {
+                var threshold = new TriggerPredictor(new TriggerPredictionSettings { Enabled = false });
+                var predictor = new TriggerPredictor(new TriggerPredictionSettings());
+
+                double late = FirstPress(threshold, t => Pull(t, pullSeconds), 1.0);
+                double early = FirstPress(predictor, t => Pull(t, pullSeconds), 1.0);
+                Assert.True(late > 0 && early > 0, $"{pullSeconds * 1000:F0} ms pull never fired");
+
+                // Ride out the rest of the pull: the prediction must be confirmed, not withdrawn
+                FirstPress(predictor, t => Pull(t, pullSeconds), 0.5, early + 1.0 / UpdateRate);
+                Assert.Equal(0, predictor.FalsePositives);
+
+                double lead = (late - early) * 1000.0;
+                Console.WriteLine($"    {pullSeconds * 1000:F0} ms pull: fired {lead:F1} ms before the click point, measured lead {predictor.MeanLeadMilliseconds:F1} ms");
+                Assert.Near(lead, predictor.MeanLeadMilliseconds, 0.5, "reported lead");
+                leads.Add(lead);
+            }
+
+            double mean = 0;
+            foreach (double lead in leads) mean += lead / leads.Count;
+            Assert.True(mean >= 20.0, $"mean lead {mean:F1} ms");
+            foreach (double lead in leads) Assert.True(lead >= 1000.0 / UpdateRate - 0.5, $"a pull gained only {lead:F1} ms");
+        }
+
+        [Test]
+        public static void SlowSqueezeWaitsForTheClickPoint()
+        {
+            var threshold = new TriggerPredictor(new TriggerPredictionSettings { Enabled = false });
+            var predictor = new TriggerPredictor(new TriggerPredictionSettings());
+
+            double late = FirstPress(threshold, t => Pull(t, 0.8), 2.0);
+            double early = FirstPress(predictor, t => Pull(t, 0.8), 2.0);
+
+            Assert.Near(late, early, 1e-9, "slow squeeze");
+            Assert.Equal(0, predictor.PredictedPresses);
+        }
+
+        [Test]
+        public static void TwitchesAreWithdrawnAndRaiseTheBar()
+        {
+            var predictor = new TriggerPredictor(new TriggerPredictionSettings());
+
+            // Flicks that stop at 60% travel, short of the click point, each followed by a hold and a release
+            int flicks = 0;
+            while (flicks < 6)
+            {
+                double start = flicks * 1.0;
+                double fired = FirstPress(predictor, t => Pull(t - start, 0.15, 0.6f), 0.4, start);
+                if (fired < 0) break;
+
+                flicks++;
+                FirstPress(predictor, t => 0.6f, 0.3, start + 0.4);
+                Assert.True(!predictor.IsPressed, $"flick {flicks} still held after stalling");
+                Assert.Equal(flicks, predictor.FalsePositives);
+                FirstPress(predictor, t => 0.0f, 0.2, start + 0.7);
+            }
+
+            // Each withdrawal demands more velocity, so the same flick soon stops predicting
+            Console.WriteLine($"    flicks predicted before suppression: {flicks}");
+            Assert.True(flicks >= 1 && flicks <= 3, $"{flicks} flicks predicted");
+
+            // A committed pull is still fast enough, and confirming it starts to relax the penalty
+            double pullStart = 10.0;
+            double early = FirstPress(predictor, t => Pull(t - pullStart, 0.1), 0.5, pullStart);
+            Assert.True(early > 0, "full pull no longer fires");
+            FirstPress(predictor, t => Pull(t - pullStart, 0.1), 0.3, early + 1.0 / UpdateRate);
+            Assert.Equal(flicks + 1, predictor.PredictedPresses);
+            Assert.Equal(flicks, predictor.FalsePositives);
+            Assert.True(predictor.MeanLeadMilliseconds > 0, "confirmed pull recorded no lead");
+        }
+    }
+}
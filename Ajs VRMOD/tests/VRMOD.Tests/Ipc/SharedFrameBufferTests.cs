@@ -0,0 +1,63 @@
+using System;
+using System.IO;
+using VRGameConverter.Ipc;
+
+namespace VRGameConverter.Tests.Ipc
+{
+    /// <summary>
+    /// Frame hand-off through the /dev/shm file: the reader only ever sees whole, newest frames
+    /// </summary>
+    public static class SharedFrameBufferTests
+    {
+        private const int Width = 8;
+        private const int Height = 4;
+
+        [Test]
+        public static void ReaderTakesNewestFrame()
+        {
+            string name = $"vrmod_test_frames_{Environment.ProcessId}";
+            using (var writer = SharedFrameBuffer.Create(name, Width, Height, 44))
+            using (var reader = SharedFrameBuffer.Open(name))
+            {
+                Assert.Equal(Width, reader.Width, "width");
+                Assert.Equal(Height, reader.Height, "height");
+                Assert.Equal(44, reader.Format, "format");
+                Assert.True(!reader.TryTakeLatest(), "frame taken before any was published");
+
+                // Three frames before the reader looks: the older two are overwritten, not queued
+                for (uint frame = 1; frame <= 3; frame++)
+                {
+                    writer.WritePixels.Fill(frame);
+                    writer.Publish(frame * 100);
+                }
+
+                Assert.True(reader.TryTakeLatest(), "published frame not taken");
+                Assert.Equal(300L, reader.ReadTimestamp, "timestamp");
+                Assert.True(reader.ReadPixels.IndexOfAnyExcept(3u) < 0, "frame mixes pixels from other frames");
+                Assert.True(!reader.TryTakeLatest(), "same frame taken twice");
+
+                // The taken frame stays readable while the writer keeps going
+                writer.WritePixels.Fill(4);
+                writer.Publish(400);
+                Assert.Equal(300L, reader.ReadTimestamp, "timestamp before taking again");
+                Assert.True(reader.TryTakeLatest(), "fourth frame not taken");
+                Assert.Equal(4u, reader.ReadPixels[Width * Height - 1], "last pixel");
+            }
+        }
+
+        [Test]
+        public static void WriterRetiresOnDispose()
+        {
+            string name = $"vrmod_test_retired_{Environment.ProcessId}";
+            var writer = SharedFrameBuffer.Create(name, Width, Height, 37);
+            using (var reader = SharedFrameBuffer.Open(name))
+            {
+                Assert.True(!reader.Retired, "retired while the writer is alive");
+                writer.Dispose();
+                Assert.True(reader.Retired, "not retired after the writer went");
+                Assert.True(!File.Exists(SharedMemoryChannel.SharedMemoryPath(name)), "file left behind");
+            }
+            Assert.Throws<FileNotFoundException>(() => SharedFrameBuffer.Open(name), "opened a removed buffer");
+        }
+    }
+}
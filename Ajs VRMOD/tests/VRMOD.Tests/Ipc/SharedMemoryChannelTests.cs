@@ -0,0 +1,120 @@
+using System;
+using System.Diagnostics;
+using System.Globalization;
+using System.Threading;
+using VRGameConverter.Ipc;
+
+namespace VRGameConverter.Tests.Ipc
+{
+    /// <summary>
+    /// Game and manager ends of the channel in two real processes, so the rings are exercised across
+    /// separate address spaces and caches (/dev/shm on Linux, a named mapping on Windows)
+    /// </summary>
+    public static class SharedMemoryChannelTests
+    {
+        private const int SampleCount = 200000;
+        private const int CommandCount = 500;
+        private static readonly TimeSpan Timeout = TimeSpan.FromSeconds(20);
+
+        [Test]
+        public static void RingsCrossProcessBoundary()
+        {
+            int channelId = Environment.ProcessId;
+            using (var channel = new SharedMemoryChannel(channelId, ChannelSide.Game))
+            using (var manager = ChildProcess.Start($"{nameof(SharedMemoryChannelTests)}.{nameof(ManagerSide)}",
+                channelId.ToString(CultureInfo.InvariantCulture)))
+            {
+                var stopwatch = Stopwatch.StartNew();
+
+                // The ring is far smaller than the stream, so this also covers wrap-around and full-ring backoff
+                for (int i = 0; i < SampleCount; i++)
+                {
+                    while (!channel.PublishTelemetry(TelemetryMetric.FrameTimeMs, i, i))
+                    {
+                        Assert.True(!manager.HasExited && stopwatch.Elapsed < Timeout, $"manager stopped reading at sample {i}");
+                        Thread.Yield();
+                    }
+                }
+                channel.Log("telemetry complete");
+
+                int commands = 0;
+                while (commands < CommandCount && stopwatch.Elapsed < Timeout)
+                {
+                    if (channel.TryReadCommand(out var command))
+                    {
+                        Assert.Equal(IpcCommand.Recalibrate, command, "command");
+                        commands++;
+                    }
+                    else
+                    {
+                        Thread.Yield();
+                    }
+                }
+
+                Assert.True(manager.WaitForExit((int)Timeout.TotalMilliseconds), "manager process did not exit");
+                string output = manager.StandardOutput.ReadToEnd().Trim();
+                Console.WriteLine($"  {output}");
+                Assert.Equal(0, manager.ExitCode, $"manager side failed: {output}");
+                Assert.Equal(CommandCount, commands, "commands received");
+            }
+        }
+
+        /// <summary>
+        /// Child process: open the channel as the manager, check every sample arrives in order, then send commands back
+        /// </summary>
+        public static int ManagerSide(string[] args)
+        {
+            int channelId = int.Parse(args[0], CultureInfo.InvariantCulture);
+            using (var channel = new SharedMemoryChannel(channelId, ChannelSide.Manager))
+            {
+                var stopwatch = Stopwatch.StartNew();
+                int expected = 0;
+                while (expected < SampleCount)
+                {
+                    if (!channel.TryReadTelemetry(out var sample))
+                    {
+                        if (stopwatch.Elapsed > Timeout)
+                        {
+                            Console.WriteLine($"timed out at sample {expected}");
+                            return 3;
+                        }
+                        Thread.Yield();
+                        continue;
+                    }
+
+                    if (sample.Timestamp != expected || sample.Value != expected || sample.Metric != TelemetryMetric.FrameTimeMs)
+                    {
+                        Console.WriteLine($"sample {expected} arrived as {sample.Timestamp}/{sample.Value}/{sample.Metric}");
+                        return 1;
+                    }
+                    expected++;
+                }
+                double samplesPerSecond = SampleCount / stopwatch.Elapsed.TotalSeconds;
+
+                string log;
+                while (!channel.TryReadLog(out log))
+                {
+                    if (stopwatch.Elapsed > Timeout) return 3;
+                    Thread.Yield();
+                }
+                if (log != "telemetry complete")
+                {
+                    Console.WriteLine($"unexpected log '{log}'");
+                    return 1;
+                }
+
+                for (int i = 0; i < CommandCount; i++)
+                {
+                    while (!channel.SendCommand(IpcCommand.Recalibrate))
+                    {
+                        if (stopwatch.Elapsed > Timeout) return 3;
+                        Thread.Yield();
+                    }
+                }
+
+                Console.WriteLine($"{SampleCount} samples in order, {samplesPerSecond / 1e6:F2} M samples/s across processes");
+                return 0;
+            }
+        }
+    }
+}
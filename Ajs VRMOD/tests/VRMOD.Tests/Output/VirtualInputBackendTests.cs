@@ -0,0 +1,153 @@
+using System;
+using System.Collections.Generic;
+using System.Numerics;
+using AJS_VRMOD;
+using VRGameConverter.Output;
+
+namespace VRGameConverter.Tests.Output
+{
+    public static class VirtualInputBackendTests
+    {
+        /// <summary>
+        /// Stands in for uinput or SendInput: every Submit is one batch the OS would have seen
+        /// </summary>
+        private sealed class RecordingDevice : IVirtualInputDevice
+        {
+            public readonly List<(GamepadState State, GamepadState Previous)> Batches = new List<(GamepadState, GamepadState)>();
+            public bool Disposed;
+
+            public void Submit(in GamepadState state, in GamepadState previous)
+            {
+                Batches.Add((state, previous));
+            }
+
+            public void Dispose()
+            {
+                Disposed = true;
+            }
+        }
+
+        private const ActionGroup AllGroups = ActionGroup.Movement | ActionGroup.Camera | ActionGroup.Combat | ActionGroup.Vehicle | ActionGroup.Menu;
+
+        private static VRActionState Pressed(params VRAction[] actions)
+        {
+            var state = new VRActionState();
+            foreach (var action in actions) state.Digital.Set(action, true);
+            return state;
+        }
+
+        [Test]
+        public static void ActionSetWalksEveryBit()
+        {
+            var set = new VRActionSet();
+            var actions = new[] { VRAction.MoveForward, VRAction.Jump, VRAction.VehicleHorn, VRAction.BoatWeapons };
+            Assert.True((int)VRAction.BoatWeapons >= 64, "the last action should sit in the high word");
+
+            foreach (var action in actions) set.Set(action, true);
+            var walked = new List<VRAction>();
+            for (var action = set.NextSet(1); action != VRAction.None; action = set.NextSet((int)action + 1))
+            {
+                walked.Add(action);
+            }
+            Assert.SequenceEqual(actions, walked);
+
+            set.Set(VRAction.BoatWeapons, false);
+            Assert.True(!set.IsSet(VRAction.BoatWeapons) && set.IsSet(VRAction.VehicleHorn), "clearing one bit left the others");
+            set.Clear();
+            Assert.True(set.IsEmpty, "cleared set");
+        }
+
+        [Test]
+        public static void DefaultMapTurnsActionsIntoGamepadState()
+        {
+            var device = new RecordingDevice();
+            var backend = new VirtualInputBackend(AllGroups, device: device);
+
+            backend.Update(Pressed(VRAction.MoveForward, VRAction.MoveLeft, VRAction.Jump, VRAction.PrimaryAction, VRAction.Menu, VRAction.LookRight));
+
+            Assert.Equal(1, device.Batches.Count, "batches");
+            var state = device.Batches[0].State;
+            Assert.Equal(GamepadButtons.A | GamepadButtons.Start, state.Buttons);
+            Assert.Equal(new Vector2(-1, 1), state.LeftStick);
+            Assert.Equal(new Vector2(1, 0), state.RightStick);
+            Assert.Equal(1f, state.RightTrigger);
+            Assert.Equal(0f, state.LeftTrigger);
+        }
+
+        [Test]
+        public static void OnlyUnhookedGroupsReachTheDevice()
+        {
+            var device = new RecordingDevice();
+            var backend = new VirtualInputBackend(ActionGroup.Movement, device: device);
+
+            var actions = Pressed(VRAction.Jump, VRAction.PrimaryAction, VRAction.Inventory, VRAction.LookUp);
+            actions.RightStick = new Vector2(0, 1);
+            actions.RightTrigger = 1;
+            backend.Update(actions);
+
+            var state = device.Batches[0].State;
+            Assert.Equal(GamepadButtons.A, state.Buttons);
+            Assert.Equal(Vector2.Zero, state.RightStick);
+            Assert.Equal(0f, state.RightTrigger);
+        }
+
+        [Test]
+        public static void AnalogPassesThroughWhenStronger()
+        {
+            var device = new RecordingDevice();
+            var backend = new VirtualInputBackend(ActionGroup.Movement | ActionGroup.Combat, device: device);
+
+            // A half-pushed stick loses to the digital full deflection; a full trigger wins over nothing
+            var actions = Pressed(VRAction.MoveForward);
+            actions.LeftStick = new Vector2(0.5f, 0);
+            actions.LeftTrigger = 0.75f;
+            backend.Update(actions);
+            Assert.Equal(new Vector2(0, 1), device.Batches[0].State.LeftStick);
+            Assert.Equal(0.75f, device.Batches[0].State.LeftTrigger);
+
+            actions = new VRActionState { LeftStick = new Vector2(0.3f, -0.6f) };
+            backend.Update(actions);
+            Assert.Equal(new Vector2(0.3f, -0.6f), device.Batches[1].State.LeftStick);
+        }
+
+        [Test]
+        public static void OneBatchPerChangedFrame()
+        {
+            var device = new RecordingDevice();
+            var backend = new VirtualInputBackend(AllGroups, device: device);
+
+            // Ten frames holding jump, then ten of nothing: the device hears about the press and the release only
+            var jump = Pressed(VRAction.Jump);
+            for (int frame = 0; frame < 10; frame++) backend.Update(jump);
+            var idle = new VRActionState();
+            for (int frame = 0; frame < 10; frame++) backend.Update(idle);
+
+            Assert.Equal(2, device.Batches.Count, "batches");
+            Assert.Equal(new GamepadState(), device.Batches[0].Previous);
+            Assert.Equal(GamepadButtons.A, device.Batches[0].State.Buttons);
+            Assert.Equal(device.Batches[0].State, device.Batches[1].Previous);
+            Assert.Equal(new GamepadState(), device.Batches[1].State);
+
+            // Nothing at all before anything was pressed
+            var quiet = new RecordingDevice();
+            var untouched = new VirtualInputBackend(AllGroups, device: quiet);
+            for (int frame = 0; frame < 10; frame++) untouched.Update(idle);
+            Assert.Equal(0, quiet.Batches.Count, "batches while idle");
+        }
+
+        [Test]
+        public static void HeldLookKeepsSubmitting()
+        {
+            var device = new RecordingDevice();
+            var backend = new VirtualInputBackend(ActionGroup.Camera, device: device);
+
+            // A held right stick is a turn rate that keyboard and mouse devices have to keep sending
+            var look = new VRActionState { RightStick = new Vector2(0.5f, 0) };
+            for (int frame = 0; frame < 5; frame++) backend.Update(look);
+            Assert.Equal(5, device.Batches.Count, "batches");
+
+            backend.Dispose();
+            Assert.True(device.Disposed, "the backend disposes its device");
+        }
+    }
+}
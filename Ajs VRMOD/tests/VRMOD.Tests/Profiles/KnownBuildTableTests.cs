@@ -0,0 +1,151 @@
+using System;
+using System.Buffers.Binary;
+using System.IO;
+using System.Text;
+using VRGameConverter.ProcessManagement;
+using VRGameConverter.Profiles;
+
+namespace VRGameConverter.Tests.Profiles
+{
+    public static class KnownBuildTableTests
+    {
+        private static readonly Guid PdbGuid = new Guid("6f1c2d3e-4a5b-4c6d-8e9f-0a1b2c3d4e5f");
+
+        // The smallest PE32+ image the reader accepts: headers, one section holding the debug directory and a
+        // CodeView record naming GTA5.pdb
+        private static byte[] CreateImage(uint timestamp, uint sizeOfImage)
+        {
+            var image = new byte[0x600];
+            var data = image.AsSpan();
+
+            BinaryPrimitives.WriteUInt16LittleEndian(data, 0x5A4D);
+            BinaryPrimitives.WriteInt32LittleEndian(data.Slice(0x3C), 0x80);
+
+            BinaryPrimitives.WriteUInt32LittleEndian(data.Slice(0x80), 0x00004550);
+            var coff = data.Slice(0x84);
+            BinaryPrimitives.WriteUInt16LittleEndian(coff, 0x8664);
+            BinaryPrimitives.WriteUInt16LittleEndian(coff.Slice(2), 1);
+            BinaryPrimitives.WriteUInt32LittleEndian(coff.Slice(4), timestamp);
+            BinaryPrimitives.WriteUInt16LittleEndian(coff.Slice(16), 240);
+
+            var optional = data.Slice(0x98);
+            BinaryPrimitives.WriteUInt16LittleEndian(optional, 0x20B);
+            BinaryPrimitives.WriteUInt32LittleEndian(optional.Slice(56), sizeOfImage);
+            BinaryPrimitives.WriteUInt32LittleEndian(optional.Slice(108), 16);
+            BinaryPrimitives.WriteUInt32LittleEndian(optional.Slice(112 + 6 * 8), 0x1000);
+            BinaryPrimitives.WriteUInt32LittleEndian(optional.Slice(112 + 6 * 8 + 4), 28);
+
+            var section = data.Slice(0x98 + 240);
+            BinaryPrimitives.WriteUInt32LittleEndian(section.Slice(8), 0x1000);
+            BinaryPrimitives.WriteUInt32LittleEndian(section.Slice(12), 0x1000);
+            BinaryPrimitives.WriteUInt32LittleEndian(section.Slice(16), 0x200);
+            BinaryPrimitives.WriteUInt32LittleEndian(section.Slice(20), 0x400);
+
+            var debug = data.Slice(0x400);
+            BinaryPrimitives.WriteUInt32LittleEndian(debug.Slice(12), 2);
+            BinaryPrimitives.WriteUInt32LittleEndian(debug.Slice(16), 64);
+            BinaryPrimitives.WriteUInt32LittleEndian(debug.Slice(24), 0x500);
+
+            var record = data.Slice(0x500);
+            BinaryPrimitives.WriteUInt32LittleEndian(record, 0x53445352);
+            PdbGuid.TryWriteBytes(record.Slice(4));
+            BinaryPrimitives.WriteUInt32LittleEndian(record.Slice(20), 3);
+            Encoding.UTF8.GetBytes(@"D:\build\GTA5.pdb").CopyTo(record.Slice(24));
+            return image;
+        }
+
+        private static string CreateDirectory()
+        {
+            string directory = Path.Combine(Path.GetTempPath(), "vrmod-tests-" + Guid.NewGuid().ToString("N"));
+            Directory.CreateDirectory(directory);
+            return directory;
+        }
+
+        [Test]
+        public static void FingerprintReadsHeadersAndCodeView()
+        {
+            string directory = CreateDirectory();
+            try
+            {
+                string exe = Path.Combine(directory, "GTA5.exe");
+                File.WriteAllBytes(exe, CreateImage(0x5F3A1B2C, 0x3C8A000));
+
+                Assert.True(PeFingerprint.TryRead(exe, false, out var headers), "headers read");
+                Assert.Equal((ushort)0x8664, headers.Machine);
+                Assert.Equal(0x5F3A1B2Cu, headers.TimeDateStamp);
+                Assert.Equal(0x3C8A000u, headers.SizeOfImage);
+                Assert.True(!headers.HasCodeView, "CodeView only on request");
+
+                Assert.True(PeFingerprint.TryRead(exe, true, out var full), "CodeView read");
+                Assert.Equal(PdbGuid, full.PdbGuid);
+                Assert.Equal(3u, full.PdbAge);
+                Assert.Equal("GTA5.pdb", full.PdbName);
+
+                File.WriteAllBytes(exe, new byte[100]);
+                Assert.True(!PeFingerprint.TryRead(exe, false, out _), "not a PE file");
+            }
+            finally
+            {
+                Directory.Delete(directory, true);
+            }
+        }
+
+        [Test]
+        public static void SeedListIdentifiesBuildsBeforeAnyWalk()
+        {
+            string directory = CreateDirectory();
+            try
+            {
+                string exe = Path.Combine(directory, "GTA5.exe");
+                File.WriteAllBytes(exe, CreateImage(0x5F3A1B2C, 0x3C8A000));
+
+                string seed = Path.Combine(directory, KnownBuildTable.SeedFileName);
+                File.WriteAllLines(seed, new[]
+                {
+                    "# comment lines are skipped",
+                    $"5F3A1B2C 3C8A000 {Guid.Empty:N} 0 GTA5",
+                    $"1234ABCD 2000000 {Guid.Empty:N} 0 HogwartsLegacy"
+                });
+                string store = Path.Combine(directory, "known-builds.txt");
+
+                var table = new KnownBuildTable(store, seed);
+                Assert.Equal(2, table.Count);
+                Assert.Equal(GameType.GTA5, table.Lookup(exe, out _));
+                Assert.True(!File.Exists(store), "seeded builds are not copied to the user's store");
+            }
+            finally
+            {
+                Directory.Delete(directory, true);
+            }
+        }
+
+        [Test]
+        public static void LearnedBuildsPersistAndMatchRelinksByPdb()
+        {
+            string directory = CreateDirectory();
+            try
+            {
+                string exe = Path.Combine(directory, "GTA5.exe");
+                string store = Path.Combine(directory, "known-builds.txt");
+                string noSeed = Path.Combine(directory, "missing.txt");
+                File.WriteAllBytes(exe, CreateImage(0x5F3A1B2C, 0x3C8A000));
+
+                var first = new KnownBuildTable(store, noSeed);
+                Assert.Equal(GameType.Unknown, first.Lookup(exe, out _));
+                Assert.True(PeFingerprint.TryRead(exe, true, out var fingerprint), "fingerprint");
+                first.Learn(fingerprint, GameType.GTA5);
+
+                // A later session finds it in the store; a relink with the same PDB is matched through the GUID
+                var second = new KnownBuildTable(store, noSeed);
+                Assert.Equal(GameType.GTA5, second.Lookup(exe, out _));
+                File.WriteAllBytes(exe, CreateImage(0x60000000, 0x3C8A000));
+                Assert.Equal(GameType.GTA5, second.Lookup(exe, out _));
+                Assert.Equal(2, second.Count);
+            }
+            finally
+            {
+                Directory.Delete(directory, true);
+            }
+        }
+    }
+}
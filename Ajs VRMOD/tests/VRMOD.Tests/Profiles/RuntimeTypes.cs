@@ -0,0 +1,12 @@
+// GameType lives in the process-management sources, which pull in the Windows process APIs; this is the part
+// the profile code uses
+
+namespace VRGameConverter.ProcessManagement
+{
+    public enum GameType
+    {
+        Unknown,
+        GTA5,
+        HogwartsLegacy
+    }
+}
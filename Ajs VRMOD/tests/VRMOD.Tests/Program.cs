@@ -0,0 +1,171 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Reflection;
+
+namespace VRGameConverter.Tests
+{
+    /// <summary>
+    /// Marks a public static method as a test. Tests are named Class.Method and can be filtered on the command line.
+    /// </summary>
+    [AttributeUsage(AttributeTargets.Method)]
+    public sealed class TestAttribute : Attribute
+    {
+    }
+
+    /// <summary>
+    /// Thrown by a test that cannot run on this machine (wrong OS, missing device)
+    /// </summary>
+    public sealed class SkipException : Exception
+    {
+        public SkipException(string reason) : base(reason) { }
+    }
+
+    public static class Program
+    {
+        public static int Main(string[] args)
+        {
+            // Tests that need a second process re-launch this binary with the child's entry point
+            if (args.Length > 0 && args[0] == ChildProcess.Argument)
+            {
+                return ChildProcess.Run(args.Skip(1).ToArray());
+            }
+
+            string filter = args.Length > 0 ? args[0] : null;
+            var tests = typeof(Program).Assembly.GetTypes()
+                .SelectMany(t => t.GetMethods(BindingFlags.Public | BindingFlags.Static))
+                .Where(m => m.GetCustomAttribute<TestAttribute>() != null)
+                .Select(m => (Name: $"{m.DeclaringType.Name}.{m.Name}", Method: m))
+                .Where(t => filter == null || t.Name.Contains(filter, StringComparison.OrdinalIgnoreCase))
+                .OrderBy(t => t.Name, StringComparer.Ordinal)
+                .ToList();
+
+            int passed = 0, failed = 0, skipped = 0;
+            foreach (var (name, method) in tests)
+            {
+                var stopwatch = Stopwatch.StartNew();
+                try
+                {
+                    method.Invoke(null, null);
+                    passed++;
+                    Console.WriteLine($"PASS {name} ({stopwatch.ElapsedMilliseconds} ms)");
+                }
+                catch (TargetInvocationException ex) when (ex.InnerException is SkipException skip)
+                {
+                    skipped++;
+                    Console.WriteLine($"SKIP {name}: {skip.Message}");
+                }
+                catch (TargetInvocationException ex)
+                {
+                    failed++;
+                    Console.WriteLine($"FAIL {name}: {ex.InnerException}");
+                }
+            }
+
+            Console.WriteLine($"{passed} passed, {failed} failed, {skipped} skipped");
+            return failed == 0 && tests.Count > 0 ? 0 : 1;
+        }
+    }
+
+    /// <summary>
+    /// Runs part of a test in a second copy of this process. The entry point is any public static
+    /// int Method(string[]) in this assembly, named "Class.Method".
+    /// </summary>
+    public static class ChildProcess
+    {
+        public const string Argument = "--child";
+
+        public static Process Start(string entry, params string[] args)
+        {
+            return Start(entry, new Dictionary<string, string>(), args);
+        }
+
+        /// <summary>
+        /// As Start, with variables added to the child's environment (for native code that reads its
+        /// settings from there, such as a Vulkan layer)
+        /// </summary>
+        public static Process Start(string entry, IDictionary<string, string> environment, params string[] args)
+        {
+            string self = Environment.ProcessPath;
+            var info = new ProcessStartInfo(self) { UseShellExecute = false, RedirectStandardOutput = true };
+            foreach (var variable in environment) info.Environment[variable.Key] = variable.Value;
+
+            // Launched through the dotnet host rather than the app host: pass the test assembly explicitly
+            if (Path.GetFileNameWithoutExtension(self) == "dotnet")
+            {
+                info.ArgumentList.Add(typeof(Program).Assembly.Location);
+            }
+            info.ArgumentList.Add(Argument);
+            info.ArgumentList.Add(entry);
+            foreach (var arg in args) info.ArgumentList.Add(arg);
+            return Process.Start(info);
+        }
+
+        internal static int Run(string[] args)
+        {
+            var method = typeof(Program).Assembly.GetTypes()
+                .SelectMany(t => t.GetMethods(BindingFlags.Public | BindingFlags.Static))
+                .FirstOrDefault(m => $"{m.DeclaringType.Name}.{m.Name}" == args[0] && m.ReturnType == typeof(int));
+            if (method == null)
+            {
+                Console.Error.WriteLine($"Unknown child entry {args[0]}");
+                return 2;
+            }
+            return (int)method.Invoke(null, new object[] { args.Skip(1).ToArray() });
+        }
+    }
+
+    public static class Assert
+    {
+        public static void True(bool condition, string message)
+        {
+            if (!condition) throw new Exception(message);
+        }
+
+        public static void Equal<T>(T expected, T actual, string message = null)
+        {
+            if (!EqualityComparer<T>.Default.Equals(expected, actual))
+            {
+                throw new Exception($"{message ?? "Values differ"}: expected {expected}, got {actual}");
+            }
+        }
+
+        public static void Near(double expected, double actual, double tolerance, string message = null)
+        {
+            if (double.IsNaN(actual) || Math.Abs(expected - actual) > tolerance)
+            {
+                throw new Exception($"{message ?? "Values differ"}: expected {expected} ± {tolerance}, got {actual}");
+            }
+        }
+
+        public static TException Throws<TException>(Action action, string message = null) where TException : Exception
+        {
+            try
+            {
+                action();
+            }
+            catch (TException ex)
+            {
+                return ex;
+            }
+            throw new Exception($"{message ?? "Expected exception"}: {typeof(TException).Name} was not thrown");
+        }
+
+        public static void SequenceEqual<T>(IEnumerable<T> expected, IEnumerable<T> actual, string message = null)
+        {
+            var e = expected.ToArray();
+            var a = actual.ToArray();
+            if (!e.SequenceEqual(a))
+            {
+                throw new Exception($"{message ?? "Sequences differ"}: expected [{string.Join(", ", e)}], got [{string.Join(", ", a)}]");
+            }
+        }
+
+        public static void WindowsOnly()
+        {
+            if (!OperatingSystem.IsWindows()) throw new SkipException("needs Windows");
+        }
+    }
+}
@@ -0,0 +1,190 @@
+using System;
+using System.Diagnostics;
+using System.Numerics;
+using System.Threading;
+using VRGameConverter.Rendering;
+
+namespace VRGameConverter.Tests.Rendering
+{
+    public static class DepthPyramidTests
+    {
+        private const int Size = 256;
+        private const float WallDepth = 20.0f;
+
+        // 90 degree camera: a wall at WallDepth, and a square panel covering the middle quarter of the image
+        private static float[] SyntheticScene(DepthCamera camera, float panelDepth)
+        {
+            var device = new float[Size * Size];
+            for (int y = 0; y < Size; y++)
+            {
+                for (int x = 0; x < Size; x++)
+                {
+                    bool panel = x >= Size * 3 / 8 && x < Size * 5 / 8 && y >= Size * 3 / 8 && y < Size * 5 / 8;
+                    device[y * Size + x] = ToDevice(camera, panel ? panelDepth : WallDepth);
+                }
+            }
+            return device;
+        }
+
+        private static float ToDevice(DepthCamera camera, float linear)
+        {
+            float n = camera.NearPlane, f = camera.FarPlane;
+            return camera.ReversedZ ? (f * n / linear - n) / (f - n) : (f - f * n / linear) / (f - n);
+        }
+
+        private static DepthCamera Camera(bool reversedZ) => DepthCamera.FromFov(Size, Size, 90.0f, 0.1f, 100.0f, reversedZ);
+
+        [Test]
+        public static void DepthLinearizesInBothConventions()
+        {
+            foreach (bool reversed in new[] { true, false })
+            {
+                var camera = Camera(reversed);
+                foreach (float depth in new[] { 0.1f, 0.5f, 3.0f, 20.0f, 100.0f })
+                {
+                    Assert.Near(depth, camera.LinearizeDepth(ToDevice(camera, depth)), depth * 1e-3, $"reversed={reversed} depth {depth}");
+                }
+            }
+        }
+
+        [Test]
+        public static void RayThroughCentreHitsThePanel()
+        {
+            var camera = Camera(true);
+            var pyramid = new DepthPyramid(Size, Size);
+            pyramid.Build(SyntheticScene(camera, 5.0f), camera, Vector3.Zero, Quaternion.Identity);
+
+            var hit = pyramid.March(Vector3.Zero, -Vector3.UnitZ, 50.0f);
+            Assert.True(hit.Hit, "missed the panel");
+            Assert.Near(5.0, hit.Distance, 0.05, "panel distance");
+
+            // Aimed past the panel's edge the ray carries on to the wall
+            var past = pyramid.March(Vector3.Zero, new Vector3(0.5f, 0, -1), 50.0f);
+            Assert.True(past.Hit, "missed the wall");
+            Assert.Near(WallDepth, -past.Position.Z, 0.1, "wall depth");
+        }
+
+        [Test]
+        public static void HierarchicalMarchAgreesWithReferenceInFewerSteps()
+        {
+            var camera = Camera(true);
+            var pyramid = new DepthPyramid(Size, Size);
+            pyramid.Build(SyntheticScene(camera, 5.0f), camera, Vector3.Zero, Quaternion.Identity);
+
+            // Rays from a point off to the side, fanned across the panel and past it
+            var origin = new Vector3(-1.5f, 0.4f, -0.5f);
+            int rays = 0, referenceSteps = 0, marchSteps = 0;
+            for (int i = 0; i < 64; i++)
+            {
+                var target = new Vector3(-4 + 8 * (i / 63.0f), 0.2f, -10.0f);
+                var direction = Vector3.Normalize(target - origin);
+
+                var reference = pyramid.MarchReference(origin, direction, 40.0f);
+                var hit = pyramid.March(origin, direction, 40.0f, maxSteps: 256);
+
+                Assert.Equal(reference.Hit, hit.Hit, $"ray {i} hit");
+                if (hit.Hit) Assert.Near(reference.Distance, hit.Distance, 0.05, $"ray {i} distance");
+
+                rays++;
+                referenceSteps += reference.Steps;
+                marchSteps += hit.Steps;
+            }
+
+            Console.WriteLine($"  mean steps: {marchSteps / (double)rays:F1} hierarchical, {referenceSteps / (double)rays:F1} reference");
+            Assert.True(marchSteps * 2 < referenceSteps, "hierarchy skipped too little");
+        }
+
+        [Test]
+        public static void WorldRaysUseTheCapturePose()
+        {
+            var camera = Camera(false);
+            var pyramid = new DepthPyramid(Size, Size);
+
+            // Camera at eye height turned 90 degrees left: its -Z looks down world -X
+            var position = new Vector3(2, 1.7f, 0);
+            var rotation = Quaternion.CreateFromAxisAngle(Vector3.UnitY, MathF.PI / 2);
+            pyramid.Build(SyntheticScene(camera, 5.0f), camera, position, rotation);
+
+            var hit = pyramid.MarchFromWorld(position, -Vector3.UnitX, 50.0f);
+            Assert.True(hit.Hit, "missed the panel");
+            Assert.True(Vector3.Distance(hit.Position, position - 5.0f * Vector3.UnitX) < 0.05f, $"hit at {hit.Position}");
+        }
+
+        [Test]
+        public static void BuilderPublishesOffTheCallingThread()
+        {
+            var camera = Camera(true);
+            var near = SyntheticScene(camera, 5.0f);
+            var far = SyntheticScene(camera, 8.0f);
+
+            using var builder = new DepthPyramidBuilder(Size, Size);
+            Assert.True(builder.Latest == null, "published before any capture");
+
+            DepthPyramid previous = null;
+            for (int frame = 0; frame < 6; frame++)
+            {
+                long builds = builder.BuildCount;
+
+                long start = Stopwatch.GetTimestamp();
+                (frame % 2 == 0 ? near : far).CopyTo(builder.CaptureBuffer, 0);
+                builder.Submit(camera, Vector3.Zero, Quaternion.Identity);
+                double submitMs = (Stopwatch.GetTimestamp() - start) * 1000.0 / Stopwatch.Frequency;
+
+                var deadline = Stopwatch.StartNew();
+                while (builder.BuildCount == builds && deadline.ElapsedMilliseconds < 2000) Thread.Sleep(1);
+                Assert.True(builder.BuildCount > builds, $"frame {frame} never built");
+
+                var latest = builder.Latest;
+                Assert.True(latest != previous, "rebuilt the pyramid readers were given");
+                Assert.Equal(0, latest.Sequence & 1, "published while building");
+                Assert.Near(frame % 2 == 0 ? 5.0 : 8.0, latest.March(Vector3.Zero, -Vector3.UnitZ, 50.0f).Distance, 0.05, $"frame {frame}");
+
+                if (frame == 5) Console.WriteLine($"  submit {submitMs:F3} ms on the caller, build {builder.LastBuildMilliseconds:F2} ms on the worker");
+                previous = latest;
+            }
+        }
+
+        [Test]
+        public static void ReadsRacingARebuildAreRejected()
+        {
+            var camera = Camera(true);
+            var near = SyntheticScene(camera, 5.0f);
+            var far = SyntheticScene(camera, 8.0f);
+            var pyramid = new DepthPyramid(Size, Size);
+            pyramid.Build(near, camera, Vector3.Zero, Quaternion.Identity);
+
+            // Rebuild the one pyramid about every frame; every accepted read must match one of the two scenes
+            bool running = true;
+            var writer = new Thread(() =>
+            {
+                for (int i = 0; Volatile.Read(ref running); i++)
+                {
+                    pyramid.Build(i % 2 == 0 ? far : near, camera, Vector3.Zero, Quaternion.Identity);
+                    Thread.Sleep(1);
+                }
+            });
+            writer.Start();
+
+            int accepted = 0, rejected = 0;
+            var elapsed = Stopwatch.StartNew();
+            while (elapsed.ElapsedMilliseconds < 300)
+            {
+                if (!pyramid.TryMarchFromWorld(Vector3.Zero, -Vector3.UnitZ, 50.0f, out var hit))
+                {
+                    rejected++;
+                    continue;
+                }
+
+                accepted++;
+                Assert.True(hit.Hit && (Math.Abs(hit.Distance - 5.0f) < 0.05f || Math.Abs(hit.Distance - 8.0f) < 0.05f),
+                    $"accepted a torn read: hit={hit.Hit} distance {hit.Distance}");
+            }
+
+            Volatile.Write(ref running, false);
+            writer.Join();
+
+            Console.WriteLine($"  {accepted} accepted, {rejected} rejected");
+            Assert.True(accepted > 0 && rejected > 0, "reads never overlapped a rebuild");
+        }
+    }
+}
@@ -0,0 +1,94 @@
+using System;
+using System.Numerics;
+using VRGameConverter.Rendering;
+
+namespace VRGameConverter.Tests.Rendering
+{
+    public static class HiddenAreaMeshTests
+    {
+        private const int Width = 1440;
+        private const int Height = 1600;
+
+        [Test]
+        public static void FallbackMeshCoversExactlyOutsideTheLensPolygon()
+        {
+            const int segments = 48;
+            var mesh = HiddenAreaMesh.CreateFromLensEllipse(0, segments: segments);
+            int covered = mesh.CountCoveredPixels(Width, Height);
+
+            // Reference: pixel centres outside the inscribed polygon the mesh is built around
+            var polygon = new Vector2[segments];
+            for (int i = 0; i < segments; i++)
+            {
+                float angle = 2 * MathF.PI * i / segments;
+                polygon[i] = new Vector2(0.5f + 0.03f + 0.53f * MathF.Cos(angle), 0.5f + 0.56f * MathF.Sin(angle));
+            }
+
+            int expected = 0;
+            for (int y = 0; y < Height; y++)
+            {
+                for (int x = 0; x < Width; x++)
+                {
+                    var p = new Vector2((x + 0.5f) / Width, (y + 0.5f) / Height);
+                    if (!InsideConvex(polygon, p)) expected++;
+                }
+            }
+
+            // Pixels exactly on a shared edge may land either way
+            Assert.Near(expected, covered, expected * 0.002, "covered pixels");
+        }
+
+        [Test]
+        public static void EyesAreMirrored()
+        {
+            var left = HiddenAreaCoverage.Measure(HiddenAreaMesh.CreateFromLensEllipse(0), Width, Height);
+            var right = HiddenAreaCoverage.Measure(HiddenAreaMesh.CreateFromLensEllipse(1), Width, Height);
+
+            Console.WriteLine($"  left {left}; right {right}");
+            Assert.Near(left.HiddenPixels, right.HiddenPixels, left.HiddenPixels * 0.002, "left/right coverage");
+            Assert.True(left.HiddenFraction > 0.1f && left.HiddenFraction < 0.3f, $"implausible savings {left.HiddenFraction:P1}");
+        }
+
+        [Test]
+        public static void LensCentreIsNeverCulled()
+        {
+            var mesh = HiddenAreaMesh.CreateFromLensEllipse(0);
+
+            // A 2x2 buffer's pixel centres are at the quarter points, all well inside the lens
+            Assert.Equal(0, mesh.CountCoveredPixels(2, 2));
+            Assert.Equal(0, new HiddenAreaMesh().CountCoveredPixels(Width, Height));
+        }
+
+        private static bool InsideConvex(Vector2[] polygon, Vector2 p)
+        {
+            for (int i = 0; i < polygon.Length; i++)
+            {
+                var a = polygon[i];
+                var b = polygon[(i + 1) % polygon.Length];
+                if ((b.X - a.X) * (p.Y - a.Y) - (b.Y - a.Y) * (p.X - a.X) < 0) return false;
+            }
+            return true;
+        }
+
+        [Test]
+        public static void CoverageScalesToTheViewportWithoutRerasterizing()
+        {
+            var mesh = HiddenAreaMesh.CreateFromLensEllipse(1);
+            var full = HiddenAreaCoverage.Measure(mesh, Width, Height);
+
+            // Resolution-scale steps land on even sizes between 50% and 100%
+            foreach (float scale in new[] { 0.9f, 0.75f, 0.5f })
+            {
+                int width = (int)(Width * scale) & ~1;
+                int height = (int)(Height * scale) & ~1;
+                var scaled = full.ScaledTo(width, height);
+                var measured = HiddenAreaCoverage.Measure(mesh, width, height);
+
+                Assert.Equal(width * height, scaled.TotalPixels);
+                Assert.Near(measured.HiddenFraction, scaled.HiddenFraction, 0.002, $"hidden fraction at {width}x{height}");
+            }
+
+            Assert.Equal(full.HiddenPixels, full.ScaledTo(Width, Height).HiddenPixels);
+        }
+    }
+}
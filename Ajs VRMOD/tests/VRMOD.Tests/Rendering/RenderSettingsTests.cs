@@ -0,0 +1,77 @@
+using System;
+using System.IO;
+using VRGameConverter.Rendering;
+
+namespace VRGameConverter.Tests.Rendering
+{
+    public static class RenderSettingsTests
+    {
+        [Test]
+        public static void BenchmarkedSettingsSurviveARestart()
+        {
+            string path = Path.Combine(Path.GetTempPath(), $"render-settings-{Environment.ProcessId}.txt");
+            try
+            {
+                var store = new RenderSettingsStore("Test", path);
+                Assert.True(!store.Load(new RenderSettings()), "loaded settings that were never saved");
+
+                var chosen = new RenderSettings { ResolutionScale = 0.7f, FoveationLevel = 2, StereoMode = StereoMode.AlternateEye };
+                store.Save(chosen);
+
+                // A fresh profile picks up the tuned fields and keeps its own for everything else
+                var next = new RenderSettings { EyeWidth = 1832 };
+                Assert.True(new RenderSettingsStore("Test", path).Load(next), "nothing loaded");
+                Assert.Equal(0.7f, next.ResolutionScale);
+                Assert.Equal(2, next.FoveationLevel);
+                Assert.Equal(StereoMode.AlternateEye, next.StereoMode);
+                Assert.Equal(1832, next.EyeWidth);
+            }
+            finally
+            {
+                File.Delete(path);
+            }
+        }
+
+        [Test]
+        public static void ResolutionScaleShrinksTheViewport()
+        {
+            var settings = new RenderSettings { EyeWidth = 2016, EyeHeight = 2240, ResolutionScale = 0.8f, DynamicResolutionScale = 0.9f };
+            Assert.Equal(1450, settings.ScaledEyeWidth);
+            Assert.Equal(1612, settings.ScaledEyeHeight);
+
+            settings.ResolutionScale = 1.0f;
+            settings.DynamicResolutionScale = 1.0f;
+            Assert.Equal(2016, settings.ScaledEyeWidth);
+            Assert.Equal(2240, settings.ScaledEyeHeight);
+        }
+
+        [Test]
+        public static void FoveationLevelsShadeProgressivelyLess()
+        {
+            float previous = float.MaxValue;
+            for (int level = 0; level <= 3; level++)
+            {
+                var pattern = new FoveationPattern(0, level);
+                float cost = pattern.ShadingCost(360, 400);
+                Console.WriteLine($"  {pattern}: {cost:P0} of full-rate shading");
+
+                Assert.True(cost < previous, $"level {level} is no cheaper than the one before");
+                Assert.Equal(ShadingRate.Full, pattern.RateAt(pattern.Center.X, pattern.Center.Y), $"level {level} centre");
+                previous = cost;
+            }
+
+            Assert.Equal(1.0f, new FoveationPattern(0, 0).ShadingCost(64, 64), "level 0 must be off");
+            Assert.Equal(ShadingRate.Quarter, new FoveationPattern(0, 3).RateAt(0, 0), "level 3 corner");
+        }
+
+        [Test]
+        public static void FoveationFollowsEachEyesLens()
+        {
+            var left = new FoveationPattern(0, 2);
+            var right = new FoveationPattern(1, 2);
+
+            Assert.True(left.Center.X > 0.5f && right.Center.X < 0.5f, "lens centres not offset toward the nose");
+            Assert.Near(left.ShadingCost(360, 400), right.ShadingCost(360, 400), 0.002, "eyes not mirrored");
+        }
+    }
+}
@@ -0,0 +1,181 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Threading;
+using VRGameConverter.Rendering;
+
+namespace VRGameConverter.Tests.Rendering
+{
+    public static class SpaceWarpTests
+    {
+        private const int Width = 160;
+        private const int Height = 96;
+
+        // Smooth texture with detail at several scales, so block matching has something to lock on to
+        private static int Texture(float x, float y, float phase)
+        {
+            double v = 128 + 50 * Math.Sin(x * 0.21 + phase) * Math.Cos(y * 0.17) + 35 * Math.Sin((x + y) * 0.09 + 2 * phase) + 20 * Math.Cos(x * 0.05 - y * 0.11);
+            return Math.Clamp((int)v, 0, 255);
+        }
+
+        /// <summary>
+        /// Headset-rate frame: the background scrolls (1.5, 0.5) px per frame and a bright square moves the other way
+        /// </summary>
+        private static FrameImage RenderFrame(int frame)
+        {
+            var image = new FrameImage(Width, Height);
+            float scrollX = 1.5f * frame, scrollY = 0.5f * frame;
+            int squareX = 110 - 2 * frame, squareY = 30;
+
+            for (int y = 0; y < Height; y++)
+            {
+                for (int x = 0; x < Width; x++)
+                {
+                    int t = Texture(x - scrollX, y - scrollY, 0);
+                    bool square = x >= squareX && x < squareX + 24 && y >= squareY && y < squareY + 24;
+                    image.Pixels[y * Width + x] = square
+                        ? FrameImage.Pack(255, Texture(x - squareX, y - squareY, 1), 40)
+                        : FrameImage.Pack(t, t, 255 - t);
+                }
+            }
+            return image;
+        }
+
+        private static List<string> RecordSequence(string directory, int frames)
+        {
+            Directory.CreateDirectory(directory);
+            var paths = new List<string>();
+            for (int i = 0; i < frames; i++)
+            {
+                string path = Path.Combine(directory, $"frame{i:D3}.ppm");
+                FrameImage.WritePpm(path, RenderFrame(i));
+                paths.Add(path);
+            }
+            return paths;
+        }
+
+        [Test]
+        public static void RecordedSequenceBeatsRepeatingFrames()
+        {
+            string directory = Path.Combine(Path.GetTempPath(), $"spacewarp-{Environment.ProcessId}");
+            try
+            {
+                var paths = RecordSequence(directory, 24);
+                var report = SpaceWarp.ValidateSequence(paths, blockSize: 8, searchRadius: 16);
+
+                Assert.Equal(11, report.Frames);
+                Assert.True(report.MeanPsnr > report.MeanRepeatPsnr + 3, $"synthesis gained too little: {report}");
+                Assert.True(report.WorstPsnr > report.MeanRepeatPsnr, $"a synthesized frame was worse than repeating: {report}");
+            }
+            finally
+            {
+                Directory.Delete(directory, true);
+            }
+        }
+
+        [Test]
+        public static void GameMotionVectorsAreUsedAsGiven()
+        {
+            var warp = new SpaceWarp(Width, Height, 8, 16);
+            var vectors = new float[Width * Height * 2];
+            for (int i = 0; i < vectors.Length; i += 2)
+            {
+                vectors[i] = 3.0f;
+                vectors[i + 1] = 1.0f;
+            }
+
+            warp.SubmitMotionVectors(vectors);
+            Assert.True(warp.UsingGameMotionVectors, "motion vectors not marked as the game's");
+
+            // The game frame is 2 headset frames of motion; half of it lands on the real in-between frame
+            var gameFrame = RenderFrame(2);
+            var output = new FrameImage(Width, Height);
+            warp.Extrapolate(gameFrame, output, 0.5f);
+
+            double synthesized = SpaceWarp.Psnr(Crop(output), Crop(RenderFrame(3)));
+            double repeated = SpaceWarp.Psnr(Crop(gameFrame), Crop(RenderFrame(3)));
+            Console.WriteLine($"  background {synthesized:F1} dB vs {repeated:F1} dB repeated");
+            Assert.True(synthesized > repeated + 10, "uniform motion vectors didn't move the background");
+        }
+
+        [Test]
+        public static void SynthesisIsDeterministic()
+        {
+            FrameImage Run()
+            {
+                var warp = new SpaceWarp(Width, Height, 8, 16);
+                var luma = new float[Width * Height];
+                for (int i = 0; i <= 4; i += 2)
+                {
+                    RenderFrame(i).ToLuma(luma);
+                    warp.SubmitLuma(luma);
+                }
+
+                var output = new FrameImage(Width, Height);
+                warp.Extrapolate(RenderFrame(4), output, 0.5f);
+                return output;
+            }
+
+            Assert.SequenceEqual(Run().Pixels, Run().Pixels, "two runs differ");
+        }
+
+        [Test]
+        public static void PipelineMatchesDirectSynthesis()
+        {
+            // Reference: the same frames straight through SpaceWarp
+            var direct = new SpaceWarp(Width, Height, 8, 16);
+            var luma = new float[Width * Height];
+            var expected = new FrameImage(Width, Height);
+
+            using var pipeline = new SpaceWarpPipeline(Width, Height, 8, 16);
+            var output = new FrameImage(Width, Height);
+            long period = Stopwatch.Frequency / 45;
+            long present = Stopwatch.GetTimestamp();
+
+            Assert.True(!pipeline.TrySynthesize(present, output), "synthesized before any frame");
+
+            for (int i = 0; i <= 6; i += 2)
+            {
+                var frame = RenderFrame(i);
+                frame.ToLuma(luma);
+                direct.SubmitLuma(luma);
+
+                long estimated = pipeline.FramesEstimated;
+                Array.Copy(frame.Pixels, pipeline.ColorBuffer.Pixels, frame.Pixels.Length);
+                pipeline.Submit(false, present);
+
+                var deadline = Stopwatch.StartNew();
+                while (pipeline.FramesEstimated == estimated && deadline.ElapsedMilliseconds < 2000) Thread.Sleep(1);
+                Assert.True(pipeline.FramesEstimated > estimated, $"frame {i} never estimated");
+
+                // Half a game frame on: the in-between frame, exactly what SpaceWarp gives directly
+                bool synthesized = pipeline.TrySynthesize(present + period / 2, output);
+                Assert.Equal(i > 0, synthesized, $"frame {i} synthesized");
+                if (synthesized)
+                {
+                    direct.Extrapolate(frame, expected, 0.5f);
+                    Assert.SequenceEqual(expected.Pixels, output.Pixels, $"frame {i}");
+                }
+
+                // Still on the game frame's own display time: nothing to synthesize
+                Assert.True(!pipeline.TrySynthesize(present, output), "synthesized for a current frame");
+                present += period;
+            }
+
+            Console.WriteLine($"  flow {pipeline.LastEstimateMilliseconds:F2} ms on the worker, extrapolate {pipeline.LastSynthesisMilliseconds:F2} ms");
+        }
+
+        // Background below the square, minus a margin where content scrolls in from outside the frame
+        private static FrameImage Crop(FrameImage image)
+        {
+            const int margin = 8, top = 60;
+            var cropped = new FrameImage(Width - 2 * margin, Height - margin - top);
+            for (int y = 0; y < cropped.Height; y++)
+            {
+                Array.Copy(image.Pixels, (y + top) * Width + margin, cropped.Pixels, y * cropped.Width, cropped.Width);
+            }
+            return cropped;
+        }
+    }
+}
@@ -0,0 +1,73 @@
+using System;
+using System.Diagnostics;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using VRGameConverter.Scheduling;
+
+namespace VRGameConverter.Tests.Scheduling
+{
+    public static class HotPathWarmupTests
+    {
+        // Small struct with property and method calls: tier 0 calls every one of them, optimized code inlines
+        // them all. No loops, so on-stack replacement can't promote it early; only call counting can.
+        private struct Point
+        {
+            public float X, Y;
+
+            public Point(float x, float y) { X = x; Y = y; }
+
+            public float Length => MathF.Sqrt(X * X + Y * Y);
+            public Point Add(Point other) => new Point(X + other.X, Y + other.Y);
+            public Point Scale(float s) => new Point(X * s, Y * s);
+            public float Dot(Point other) => X * other.X + Y * other.Y;
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        private static float Kernel(float x)
+        {
+            var a = new Point(x, 1);
+            var b = a.Add(new Point(0.5f, x)).Scale(0.7f);
+            var c = b.Add(a).Scale(0.3f);
+            var d = c.Add(b.Scale(a.Dot(c) * 0.01f));
+            var e = d.Add(a).Add(b).Add(c).Scale(0.1f);
+            return e.Length + d.Dot(e) * 0.001f + a.Length * 0.01f + b.Dot(c) * 0.0001f;
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining | MethodImplOptions.AggressiveOptimization)]
+        private static float OptimizedKernel(float x)
+        {
+            var a = new Point(x, 1);
+            var b = a.Add(new Point(0.5f, x)).Scale(0.7f);
+            var c = b.Add(a).Scale(0.3f);
+            var d = c.Add(b.Scale(a.Dot(c) * 0.01f));
+            var e = d.Add(a).Add(b).Add(c).Scale(0.1f);
+            return e.Length + d.Dot(e) * 0.001f + a.Length * 0.01f + b.Dot(c) * 0.0001f;
+        }
+
+        [Test]
+        public static void RoundsWaitOutTheTieringDelay()
+        {
+            var method = typeof(HotPathWarmupTests).GetMethod(nameof(OptimizedKernel), BindingFlags.NonPublic | BindingFlags.Static);
+            RuntimeHelpers.PrepareMethod(method.MethodHandle);
+
+            // AggressiveOptimization: what PrepareMethod produced is already the final code
+            float v = 1;
+            for (int i = 0; i < 200; i++) v = OptimizedKernel(v) * 0.01f;
+            long start = Stopwatch.GetTimestamp();
+            for (int i = 0; i < 1600; i++) v = OptimizedKernel(v) * 0.01f;
+            double optimized = (Stopwatch.GetTimestamp() - start) * 1e6 / Stopwatch.Frequency / 8;
+
+            var timing = HotPathWarmup.Run("kernel", () =>
+            {
+                for (int i = 0; i < 200; i++) v = Kernel(v) * 0.01f;
+            });
+            Console.WriteLine($"    {timing}; prepared with AggressiveOptimization {optimized:F1} us");
+
+            // A single burst of calls never leaves tier 0; the rounds must get the path promoted
+            Assert.True(timing.SteadyMicroseconds < timing.Tier0Microseconds * 0.5,
+                $"steady {timing.SteadyMicroseconds:F1} us vs tier 0 {timing.Tier0Microseconds:F1} us");
+            Assert.True(optimized < timing.Tier0Microseconds * 0.5,
+                $"AggressiveOptimization {optimized:F1} us vs tier 0 {timing.Tier0Microseconds:F1} us");
+        }
+    }
+}
@@ -0,0 +1,48 @@
+using System;
+using System.Diagnostics;
+using System.Threading;
+using VRGameConverter.Scheduling;
+
+namespace VRGameConverter.Tests.Scheduling
+{
+    public static class IdleWorkSchedulerTests
+    {
+        [Test]
+        public static void WorkWaitsForMenuAndRunsOffTheFrameThread()
+        {
+            // No region: arming one would change GC behaviour for every later test in this process
+            var scheduler = new IdleWorkScheduler { NoGCRegionBytes = 0 };
+
+            scheduler.NotifyGameplayTick();
+            scheduler.OnFrame();
+            Assert.Equal(GameActivityState.Gameplay, scheduler.State);
+
+            int ranOn = 0;
+            var done = new ManualResetEventSlim();
+            scheduler.Enqueue("probe", () =>
+            {
+                ranOn = Environment.CurrentManagedThreadId;
+                done.Set();
+            });
+
+            // Keep ticking through a few frames of gameplay: nothing may run
+            for (int i = 0; i < 10; i++)
+            {
+                scheduler.NotifyGameplayTick();
+                scheduler.OnFrame();
+                Thread.Sleep(20);
+            }
+            Assert.True(!done.IsSet, "idle work ran during gameplay");
+
+            scheduler.SetMenuOpen(true);
+            long frameStart = Stopwatch.GetTimestamp();
+            scheduler.OnFrame();
+            double frameMs = (Stopwatch.GetTimestamp() - frameStart) * 1000.0 / Stopwatch.Frequency;
+
+            Assert.Equal(GameActivityState.Menu, scheduler.State);
+            Assert.True(done.Wait(TimeSpan.FromSeconds(2)), "idle work never ran in the menu");
+            Assert.True(ranOn != Environment.CurrentManagedThreadId, "idle work ran on the frame thread");
+            Assert.True(frameMs < 5, $"OnFrame took {frameMs:F2} ms");
+        }
+    }
+}
@@ -0,0 +1,71 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using VRGameConverter.Scheduling;
+
+namespace VRGameConverter.Tests.Scheduling
+{
+    /// <summary>
+    /// Placement plans on made-up topologies, so they don't depend on the machine running the tests
+    /// </summary>
+    public static class ThreadPlacementTests
+    {
+        // Physical cores with two hardware threads each, numbered the way Linux does (siblings in the top half)
+        private static CpuTopology SmtCores(int cores)
+        {
+            var processors = new List<LogicalProcessor>();
+            for (int i = 0; i < cores * 2; i++)
+            {
+                processors.Add(new LogicalProcessor { Id = i, Core = i % cores, IsSmtSibling = i >= cores });
+            }
+            return new CpuTopology(processors);
+        }
+
+        [Test]
+        public static void TrackingAndFramePacingGetCoresOfTheirOwn()
+        {
+            var topology = SmtCores(4);
+            var placement = new ThreadPlacementManager(topology);
+            placement.Configure(new ThreadPlacementSettings());
+
+            int tracking = placement.TrackingProcessor;
+            int framePacing = placement.FramePacingProcessor;
+            int Core(int id) => topology.Processors.First(p => p.Id == id).Core;
+
+            Assert.Equal(3, tracking, "tracking processor");
+            Assert.Equal(2, framePacing, "frame pacing processor");
+            Assert.SequenceEqual(new[] { tracking }, placement.ProcessorsFor(ThreadRole.Tracking), "tracking affinity");
+            Assert.SequenceEqual(new[] { framePacing }, placement.ProcessorsFor(ThreadRole.FramePacing), "frame pacing affinity");
+
+            // Neither dedicated core, nor its sibling, is handed to anything else
+            var reserved = new[] { Core(tracking), Core(framePacing) };
+            foreach (var role in new[] { ThreadRole.Input, ThreadRole.Scanning })
+            {
+                var processors = placement.ProcessorsFor(role);
+                Assert.True(processors.Length > 0, $"{role} has nowhere to run");
+                Assert.True(processors.All(id => !reserved.Contains(Core(id))), $"{role} shares a dedicated core: {string.Join(", ", processors)}");
+            }
+        }
+
+        [Test]
+        public static void SingleCoreSharesRatherThanFails()
+        {
+            var placement = new ThreadPlacementManager(SmtCores(1));
+            placement.Configure(new ThreadPlacementSettings());
+
+            Assert.Equal(placement.TrackingProcessor, placement.FramePacingProcessor, "frame pacing processor");
+            Assert.SequenceEqual(new[] { 0, 1 }, placement.ProcessorsFor(ThreadRole.Input), "input falls back to every processor");
+        }
+
+        [Test]
+        public static void ConfiguredFramePacingProcessorIsKept()
+        {
+            var placement = new ThreadPlacementManager(SmtCores(4));
+            placement.Configure(new ThreadPlacementSettings { TrackingProcessor = 1, FramePacingProcessor = 2 });
+
+            Assert.Equal(1, placement.TrackingProcessor, "tracking processor");
+            Assert.Equal(2, placement.FramePacingProcessor, "frame pacing processor");
+            Assert.SequenceEqual(new[] { 0, 3, 4, 7 }, placement.ProcessorsFor(ThreadRole.Input).OrderBy(id => id), "input processors");
+        }
+    }
+}
@@ -0,0 +1,256 @@
+using System;
+using System.Diagnostics;
+using System.Numerics;
+using VRGameConverter.Tracking;
+
+namespace VRGameConverter.Tests.Tracking
+{
+    public static class ChainIkSolverTests
+    {
+        private const float DegreesToRadians = MathF.PI / 180;
+
+        private struct Chain
+        {
+            public float[] Lengths;
+            public float MaxBendDegrees;
+            public Vector3 Root, Target, Pole;
+        }
+
+        private static Vector3 RandomVector(Random random, float scale)
+        {
+            return new Vector3(random.NextSingle() * 2 - 1, random.NextSingle() * 2 - 1, random.NextSingle() * 2 - 1) * scale;
+        }
+
+        private static Chain[] RandomChains(int count, int joints, int seed)
+        {
+            var random = new Random(seed);
+            var chains = new Chain[count];
+            for (int c = 0; c < count; c++)
+            {
+                var lengths = new float[joints - 1];
+                float reach = 0;
+                for (int b = 0; b < lengths.Length; b++)
+                {
+                    lengths[b] = 0.1f + random.NextSingle() * 0.4f;
+                    reach += lengths[b];
+                }
+
+                var root = RandomVector(random, 1);
+                chains[c] = new Chain
+                {
+                    Lengths = lengths,
+                    MaxBendDegrees = 20 + random.NextSingle() * 160,
+                    Root = root,
+
+                    // Out of reach now and then, so some chains end up straight
+                    Target = root + Vector3.Normalize(RandomVector(random, 1) + new Vector3(0, 0, 1e-3f)) * reach * (0.2f + random.NextSingle()),
+                    Pole = RandomVector(random, 1)
+                };
+            }
+            return chains;
+        }
+
+        private static ChainIkSolver Load(Chain[] chains, int joints)
+        {
+            var solver = new ChainIkSolver(chains.Length, joints);
+            for (int c = 0; c < chains.Length; c++)
+            {
+                solver.SetChain(c, chains[c].Lengths, chains[c].MaxBendDegrees);
+                solver.SetGoal(c, chains[c].Root, chains[c].Target, chains[c].Pole);
+            }
+            return solver;
+        }
+
+        private static Vector3 Normalize(Vector3 v)
+        {
+            float length = MathF.Sqrt(Vector3.Dot(v, v));
+            return length > 1e-6f ? v * (1 / length) : Vector3.Zero;
+        }
+
+        /// <summary>
+        /// Textbook FABRIK on one chain at a time, with the solver's seed pose and cone limit
+        /// </summary>
+        private static Vector3[] ScalarFabrik(in Chain chain, int iterations)
+        {
+            int count = chain.Lengths.Length + 1;
+            var joints = new Vector3[count];
+
+            var direction = Normalize(chain.Target - chain.Root);
+            var bend = Normalize(chain.Pole - direction * Vector3.Dot(chain.Pole, direction));
+            float along = 0;
+            joints[0] = chain.Root;
+            for (int j = 1; j < count; j++)
+            {
+                along += chain.Lengths[j - 1];
+                float offset = j < count - 1 ? chain.Lengths[j - 1] * 0.25f : 0;
+                joints[j] = chain.Root + direction * along + bend * offset;
+            }
+
+            float limit = Math.Clamp(chain.MaxBendDegrees, 0, 180) * DegreesToRadians;
+            float cosLimit = MathF.Cos(limit), sinLimit = MathF.Sin(limit);
+
+            for (int iteration = 0; iteration < iterations; iteration++)
+            {
+                joints[count - 1] = chain.Target;
+                for (int j = count - 2; j >= 0; j--)
+                {
+                    joints[j] = joints[j + 1] + Normalize(joints[j] - joints[j + 1]) * chain.Lengths[j];
+                }
+
+                joints[0] = chain.Root;
+                var parentDirection = Vector3.Zero;
+                for (int j = 0; j < count - 1; j++)
+                {
+                    var bone = Normalize(joints[j + 1] - joints[j]);
+                    float cos = Vector3.Dot(bone, parentDirection);
+                    if (j > 0 && cos < cosLimit)
+                    {
+                        bone = parentDirection * cosLimit + Normalize(bone - parentDirection * cos) * sinLimit;
+                    }
+                    joints[j + 1] = joints[j] + bone * chain.Lengths[j];
+                    parentDirection = bone;
+                }
+            }
+            return joints;
+        }
+
+        [Test]
+        public static void BatchMatchesScalarFabrik()
+        {
+            // Enough chains for several vector blocks and a padded last one, whatever the lane width
+            const int joints = 4;
+            const int iterations = 12;
+            var chains = RandomChains(4 * Vector<float>.Count + 3, joints, 117);
+            var solver = Load(chains, joints);
+
+            // No tolerance, so the batch can't stop a block early and both run every iteration
+            solver.Solve(iterations, 0);
+
+            float worst = 0;
+            for (int c = 0; c < chains.Length; c++)
+            {
+                var expected = ScalarFabrik(chains[c], iterations);
+                for (int j = 0; j < joints; j++)
+                {
+                    worst = MathF.Max(worst, Vector3.Distance(expected[j], solver.GetJoint(c, j)));
+                }
+            }
+            Console.WriteLine($"    {chains.Length} chains in {Vector<float>.Count}-wide lanes, worst joint difference {worst * 1000:F4} mm");
+            Assert.True(worst < 1e-4f, $"batch differs from the scalar solve by {worst} m");
+        }
+
+        [Test]
+        public static void BonesStayInsideTheirCones()
+        {
+            const int joints = 4;
+            var chains = RandomChains(3 * Vector<float>.Count, joints, 1170);
+            var solver = Load(chains, joints);
+            solver.Solve(20, 0.001f);
+
+            int clamped = 0;
+            for (int c = 0; c < chains.Length; c++)
+            {
+                for (int j = 0; j < joints - 1; j++)
+                {
+                    float length = Vector3.Distance(solver.GetJoint(c, j), solver.GetJoint(c, j + 1));
+                    Assert.Near(chains[c].Lengths[j], length, 1e-4, $"chain {c} bone {j} length");
+                }
+
+                for (int j = 1; j < joints - 1; j++)
+                {
+                    var parent = Vector3.Normalize(solver.GetJoint(c, j) - solver.GetJoint(c, j - 1));
+                    var bone = Vector3.Normalize(solver.GetJoint(c, j + 1) - solver.GetJoint(c, j));
+                    float degrees = MathF.Acos(Math.Clamp(Vector3.Dot(parent, bone), -1, 1)) / DegreesToRadians;
+                    Assert.True(degrees <= chains[c].MaxBendDegrees + 0.05f,
+                        $"chain {c} joint {j} bends {degrees:F2} deg past its {chains[c].MaxBendDegrees:F2} deg limit");
+                    if (degrees > chains[c].MaxBendDegrees - 0.05f) clamped++;
+                }
+            }
+            Assert.True(clamped > 0, "no joint was ever held at its limit");
+        }
+
+        [Test]
+        public static void TightConeKeepsTheChainStraight()
+        {
+            // A 10 degree elbow asked to fold the hand back to the shoulder: it stays nearly straight and misses
+            var solver = new ChainIkSolver(1, 3);
+            solver.SetChain(0, new[] { 0.3f, 0.3f }, 10);
+            solver.SetGoal(0, Vector3.Zero, new Vector3(0, 0.05f, 0), Vector3.UnitZ);
+            solver.Solve(20, 0.001f);
+
+            var upper = Vector3.Normalize(solver.GetJoint(0, 1) - solver.GetJoint(0, 0));
+            var lower = Vector3.Normalize(solver.GetJoint(0, 2) - solver.GetJoint(0, 1));
+            float degrees = MathF.Acos(Math.Clamp(Vector3.Dot(upper, lower), -1, 1)) / DegreesToRadians;
+            Assert.True(degrees <= 10.05f, $"elbow bent {degrees:F2} deg");
+            Assert.True(Vector3.Distance(solver.GetJoint(0, 2), Vector3.Zero) > 0.55f, "the tip folded back anyway");
+        }
+
+        [Test]
+        public static void ReachableTargetsBendTowardThePole()
+        {
+            var solver = new ChainIkSolver(2, 3);
+            solver.SetChain(0, new[] { 0.3f, 0.3f }, 150);
+            solver.SetChain(1, new[] { 0.3f, 0.3f }, 150);
+            var target = new Vector3(0, -0.4f, 0);
+            solver.SetGoal(0, Vector3.Zero, target, Vector3.UnitZ);
+            solver.SetGoal(1, Vector3.Zero, target, -Vector3.UnitZ);
+            solver.Solve(10, 0.001f);
+
+            Assert.True(Vector3.Distance(solver.GetJoint(0, 2), target) < 0.002f, "tip reached the target");
+            Assert.True(solver.GetJoint(0, 1).Z > 0.1f, "knee toward +Z pole");
+            Assert.True(solver.GetJoint(1, 1).Z < -0.1f, "knee toward -Z pole");
+
+            // Bone rotations put +Y along the bone
+            var along = Vector3.Transform(Vector3.UnitY, solver.GetBoneRotation(0, 0));
+            var expected = Vector3.Normalize(solver.GetJoint(0, 1) - solver.GetJoint(0, 0));
+            Assert.True(Vector3.Distance(along, expected) < 1e-4f, "bone rotation follows the bone");
+        }
+
+        [Test]
+        public static void BodySolveFitsTheBudget()
+        {
+            // The five chains BodySystem solves, with its default proportions, following a swaying head
+            var settings = new BodySettings();
+            var solver = new ChainIkSolver(5, 3);
+            solver.SetChain(0, new[] { settings.PelvisToChest, settings.ChestToNeck }, settings.MaxSpineBendDegrees);
+            solver.SetChain(1, new[] { settings.UpperArmLength, settings.ForearmLength }, settings.MaxElbowBendDegrees);
+            solver.SetChain(2, new[] { settings.UpperArmLength, settings.ForearmLength }, settings.MaxElbowBendDegrees);
+            solver.SetChain(3, new[] { settings.ThighLength, settings.ShinLength }, settings.MaxKneeBendDegrees);
+            solver.SetChain(4, new[] { settings.ThighLength, settings.ShinLength }, settings.MaxKneeBendDegrees);
+
+            const int frames = 2000;
+            var times = new double[frames];
+            for (int pass = 0; pass < 2; pass++)
+            {
+                for (int frame = 0; frame < frames; frame++)
+                {
+                    float t = frame / 90f;
+                    var neck = new Vector3(MathF.Sin(t) * 0.1f, 1.5f + MathF.Sin(t * 3) * 0.05f, 0);
+                    var pelvis = new Vector3(0, 0.95f, 0);
+                    var forward = -Vector3.UnitZ;
+
+                    long start = Stopwatch.GetTimestamp();
+                    solver.SetGoal(0, pelvis, neck, forward);
+                    solver.SetGoal(1, neck - new Vector3(0.18f, 0.05f, 0), new Vector3(-0.3f, 1.1f + MathF.Sin(t * 2) * 0.3f, -0.3f), -Vector3.UnitY);
+                    solver.SetGoal(2, neck + new Vector3(0.18f, 0.05f, 0), new Vector3(0.3f, 1.2f, -0.4f + MathF.Cos(t * 2) * 0.2f), -Vector3.UnitY);
+                    solver.SetGoal(3, pelvis - new Vector3(0.1f, 0, 0), new Vector3(-0.1f, 0.1f, MathF.Sin(t) * 0.2f), forward);
+                    solver.SetGoal(4, pelvis + new Vector3(0.1f, 0, 0), new Vector3(0.1f, 0.1f, -MathF.Sin(t) * 0.2f), forward);
+                    solver.Solve(settings.Iterations, settings.Tolerance);
+                    for (int chain = 0; chain < 5; chain++)
+                    {
+                        solver.GetBoneRotation(chain, 0);
+                        solver.GetBoneRotation(chain, 1);
+                    }
+                    times[frame] = (Stopwatch.GetTimestamp() - start) * 1000.0 / Stopwatch.Frequency;
+                }
+            }
+
+            // Median and 99th percentile of the second pass; the first only warms the JIT
+            Array.Sort(times);
+            double median = times[frames / 2];
+            double p99 = times[frames * 99 / 100];
+            Console.WriteLine($"    body solve {median * 1000:F1} us median, {p99 * 1000:F1} us p99, budget {settings.BudgetMilliseconds} ms");
+            Assert.True(median < settings.BudgetMilliseconds, $"median solve {median:F3} ms over the {settings.BudgetMilliseconds} ms budget");
+        }
+    }
+}
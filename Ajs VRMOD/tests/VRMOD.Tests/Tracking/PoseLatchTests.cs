@@ -0,0 +1,78 @@
+using System;
+using System.Diagnostics;
+using System.Numerics;
+using System.Threading;
+using VRGameConverter.Tracking;
+
+namespace VRGameConverter.Tests.Tracking
+{
+    public static class PoseLatchTests
+    {
+        // Head turning at a steady 1 rad/s about Y, walking forward at 1 m/s
+        private static HeadPose SteadyTurn(long start)
+        {
+            float seconds = (float)(Stopwatch.GetTimestamp() - start) / Stopwatch.Frequency;
+            return new HeadPose
+            {
+                Position = new Vector3(0, 1.7f, -seconds),
+                Rotation = Quaternion.CreateFromAxisAngle(Vector3.UnitY, seconds)
+            };
+        }
+
+        [Test]
+        public static void FramesInFlightAreAllMeasured()
+        {
+            long start = Stopwatch.GetTimestamp();
+            var latch = new PoseLatch(() => SteadyTurn(start));
+
+            // Display time lies two or three frames past each latch, so several submits are always waiting
+            const int frames = 40;
+            for (int i = 0; i < frames; i++)
+            {
+                latch.Latch();
+                Thread.Sleep(2);
+                latch.Submit(90.0);
+            }
+
+            var stats = latch.Statistics;
+            Console.WriteLine($"    {stats}");
+            Assert.True(stats.Frames >= frames / 2, $"only {stats.Frames} of {frames} frames measured");
+
+            // Constant velocity extrapolates exactly; what remains is the gap between timestamp and sample
+            Assert.True(stats.MeanRotationErrorDegrees < 0.5, $"mean rotation error {stats.MeanRotationErrorDegrees:F3} deg");
+            Assert.True(stats.MeanLatchToDisplayMilliseconds > 0, "latch to display not recorded");
+        }
+
+        [Test]
+        public static void ResubmittedFrameIsMeasuredOnce()
+        {
+            long start = Stopwatch.GetTimestamp();
+            var latch = new PoseLatch(() => SteadyTurn(start));
+
+            latch.Latch();
+            latch.Submit(90.0);
+            latch.Submit(90.0);
+            latch.Submit(90.0);
+
+            // Well past the display time
+            Thread.Sleep(40);
+            latch.Latch();
+            Assert.Equal(1L, latch.Statistics.Frames);
+        }
+
+        [Test]
+        public static void UnsubmittedLatchTracksTheFrame()
+        {
+            var latch = new PoseLatch(() => new HeadPose { Rotation = Quaternion.Identity });
+            Assert.True(!latch.HasUnsubmittedLatch, "no latch yet");
+
+            // Alternate-eye frames render one pass per present, so each present must be followed by a fresh latch
+            latch.Latch();
+            Assert.True(latch.HasUnsubmittedLatch, "latched frame not pending");
+            latch.Submit(90.0);
+            Assert.True(!latch.HasUnsubmittedLatch, "submitted frame still pending");
+            latch.Latch();
+            Assert.True(latch.HasUnsubmittedLatch, "next frame not pending");
+        }
+    }
+}
@@ -0,0 +1,102 @@
+using System;
+using System.Diagnostics;
+using System.Numerics;
+using System.Threading;
+using VRGameConverter.Tracking;
+
+namespace VRGameConverter.Tests.Tracking
+{
+    public static class RoomscaleIntegratorTests
+    {
+        private static void Near(Vector3 expected, Vector3 actual, float tolerance, string message)
+        {
+            Assert.True(Vector3.Distance(expected, actual) < tolerance, $"{message}: expected {expected}, got {actual}");
+        }
+
+        [Test]
+        public static void DeltasTelescopeToTheDistanceWalked()
+        {
+            using var roomscale = new RoomscaleIntegrator(null);
+
+            // A wandering walk taken in uneven slices; every slice together is exactly end minus start
+            var start = new Vector3(0.1234f, 1.7f, -0.4321f);
+            var position = start;
+            var total = Vector3.Zero;
+            var random = new Random(7);
+            roomscale.Sample(position);
+            for (int i = 0; i < 2000; i++)
+            {
+                position += new Vector3((float)(random.NextDouble() - 0.45) * 0.01f, 0, (float)(random.NextDouble() - 0.5) * 0.01f);
+                roomscale.Sample(position);
+                if (random.Next(7) == 0) total += roomscale.TakeDelta();
+            }
+            total += roomscale.TakeDelta();
+
+            Near(new Vector3(position.X - start.X, 0, position.Z - start.Z), total, 1e-4f, "walked");
+        }
+
+        [Test]
+        public static void LongStepsAreDropped()
+        {
+            using var roomscale = new RoomscaleIntegrator(null);
+
+            roomscale.Sample(new Vector3(0, 1.7f, 0));
+            roomscale.Sample(new Vector3(0.1f, 1.7f, 0));
+            roomscale.Sample(new Vector3(2.1f, 1.7f, 0));
+            roomscale.Sample(new Vector3(2.1f, 1.7f, -0.1f));
+
+            Assert.Equal(1L, roomscale.DiscardedSteps);
+            Near(new Vector3(0.1f, 0, -0.1f), roomscale.TakeDelta(), 1e-4f, "without the jump");
+        }
+
+        [Test]
+        public static void DeltaTurnsIntoTheGameHeading()
+        {
+            using var roomscale = new RoomscaleIntegrator(null);
+
+            // One metre forward in the room, with the game facing a quarter turn left (forward is -X there);
+            // pitch and roll in the heading must not tip the step out of the floor or shorten it
+            roomscale.Sample(new Vector3(0, 1.7f, 0));
+            roomscale.Sample(new Vector3(0, 1.7f, -0.2f));
+            var heading = Quaternion.CreateFromYawPitchRoll(MathF.PI / 2, 0.4f, -0.2f);
+            Near(new Vector3(-0.2f, 0, 0), roomscale.TakeDelta(heading), 1e-4f, "forward");
+
+            roomscale.Sample(new Vector3(0.2f, 1.7f, -0.2f));
+            Near(new Vector3(0, 0, -0.2f), roomscale.TakeDelta(heading), 1e-4f, "right");
+        }
+
+        [Test]
+        public static void YawOfAHeadingLookingStraightUpOrDown()
+        {
+            var turn = Quaternion.CreateFromAxisAngle(Vector3.UnitY, 0.7f);
+            foreach (float pitch in new[] { MathF.PI / 2, -MathF.PI / 2, 0.3f })
+            {
+                var yaw = RoomscaleIntegrator.Yaw(turn * Quaternion.CreateFromAxisAngle(Vector3.UnitX, pitch));
+                Near(Vector3.Transform(-Vector3.UnitZ, turn), Vector3.Transform(-Vector3.UnitZ, yaw), 1e-3f, $"pitch {pitch}");
+            }
+        }
+
+        [Test]
+        public static void SamplesAtTheRequestedRate()
+        {
+            const int RateHz = 500;
+            var walked = 0;
+            using var roomscale = new RoomscaleIntegrator(() =>
+            {
+                walked++;
+                return new HeadPose { Position = new Vector3(walked * 0.001f, 1.7f, 0), Rotation = Quaternion.Identity };
+            }, RateHz);
+
+            Thread.Sleep(50);
+            long before = roomscale.Samples;
+            var clock = Stopwatch.StartNew();
+            Thread.Sleep(500);
+            long samples = roomscale.Samples - before;
+            double expected = clock.Elapsed.TotalSeconds * RateHz;
+
+            // Never faster than asked; slower only by what a busy machine costs
+            Assert.True(samples <= expected * 1.05 + 2, $"{samples} samples, expected about {expected:F0}");
+            Assert.True(samples >= expected * 0.5, $"{samples} samples, expected about {expected:F0}");
+        }
+    }
+}
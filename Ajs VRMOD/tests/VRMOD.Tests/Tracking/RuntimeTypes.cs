@@ -0,0 +1,43 @@
+using System;
+using System.Numerics;
+
+// These come from the VR runtime bindings, which are not part of the tracking sources linked here; this is
+// the shape the tracking code uses
+
+public struct HeadPose
+{
+    public Vector3 Position;
+    public Quaternion Rotation;
+}
+
+public struct RawVRPose
+{
+    public Vector3 Position;
+    public Quaternion Rotation;
+}
+
+public enum ControllerHand
+{
+    Left,
+    Right
+}
+
+public struct ControllerState
+{
+    public Vector3 Position;
+    public Quaternion Rotation;
+    public float TriggerValue;
+    public Vector2 ThumbstickPosition;
+}
+
+public interface IVRSystem
+{
+    RawVRPose GetHeadsetPose();
+    RawVRPose GetControllerPose(ControllerHand hand);
+    ControllerState GetControllerState(ControllerHand hand);
+}
+
+public class VRInitializationException : Exception
+{
+    public VRInitializationException(string message) : base(message) { }
+}
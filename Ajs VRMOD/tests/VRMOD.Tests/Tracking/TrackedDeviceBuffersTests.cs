@@ -0,0 +1,123 @@
+using System;
+using System.Diagnostics;
+using System.Numerics;
+using System.Threading;
+using VRGameConverter.Tracking;
+
+namespace VRGameConverter.Tests.Tracking
+{
+    public static class TrackedDeviceBuffersTests
+    {
+        [Test]
+        public static void ConcurrentRegistrationGivesEachTrackerItsOwnSlot()
+        {
+            const int capacity = 8;
+            const int registrants = 12;
+            var buffers = new TrackedDeviceBuffers(capacity);
+            var slots = new int[registrants];
+            var roles = new TrackedDeviceRole[registrants];
+            using var go = new ManualResetEventSlim();
+
+            var threads = new Thread[registrants];
+            for (int i = 0; i < registrants; i++)
+            {
+                int registrant = i;
+                roles[i] = (TrackedDeviceRole)(1 + i % 8);
+                threads[i] = new Thread(() =>
+                {
+                    go.Wait();
+                    slots[registrant] = buffers.Register(roles[registrant]);
+                });
+                threads[i].Start();
+            }
+            go.Set();
+            foreach (var thread in threads) thread.Join();
+
+            Assert.Equal(capacity, buffers.DeviceCount);
+            var taken = new bool[capacity];
+            int rejected = 0;
+            for (int i = 0; i < registrants; i++)
+            {
+                if (slots[i] < 0)
+                {
+                    rejected++;
+                    continue;
+                }
+                Assert.True(!taken[slots[i]], $"slot {slots[i]} handed out twice");
+                taken[slots[i]] = true;
+                Assert.Equal(roles[i], buffers.GetRole(slots[i]));
+            }
+            Assert.Equal(registrants - capacity, rejected);
+        }
+
+        [Test]
+        public static void ReadsNeverSeeAHalfWrittenSample()
+        {
+            var buffers = new TrackedDeviceBuffers(2);
+            int device = buffers.Register(TrackedDeviceRole.Waist);
+            var positions = new Vector3[TrackedDeviceBuffers.HandJointCount];
+            var rotations = new Quaternion[TrackedDeviceBuffers.HandJointCount];
+
+            // Every component of a sample carries the same value, so a mix of two samples shows
+            bool stop = false;
+            var writer = new Thread(() =>
+            {
+                for (int k = 1; !Volatile.Read(ref stop); k++)
+                {
+                    buffers.Write(device, new Vector3(k, k, k), new Quaternion(k, k, k, k), Stopwatch.GetTimestamp());
+                    for (int j = 0; j < positions.Length; j++)
+                    {
+                        positions[j] = new Vector3(k, k, k);
+                        rotations[j] = new Quaternion(k, k, k, k);
+                    }
+                    buffers.WriteHand(ControllerHand.Right, positions, rotations, Stopwatch.GetTimestamp());
+                }
+            });
+            writer.Start();
+
+            var readPositions = new Vector3[TrackedDeviceBuffers.HandJointCount];
+            var readRotations = new Quaternion[TrackedDeviceBuffers.HandJointCount];
+            int reads = 0;
+            var until = Stopwatch.StartNew();
+            while (until.ElapsedMilliseconds < 300)
+            {
+                if (buffers.TryRead(device, out var position, out var rotation))
+                {
+                    float k = position.X;
+                    Assert.True(position.Y == k && position.Z == k && rotation.X == k && rotation.W == k, $"torn tracker sample at {k}");
+                    reads++;
+                }
+
+                if (buffers.TryReadHand(ControllerHand.Right, readPositions, readRotations))
+                {
+                    float k = readPositions[0].X;
+                    for (int j = 0; j < readPositions.Length; j++)
+                    {
+                        Assert.True(readPositions[j].Z == k && readRotations[j].W == k, $"torn hand sample at joint {j}");
+                    }
+                }
+            }
+
+            Volatile.Write(ref stop, true);
+            writer.Join();
+            Console.WriteLine($"    {reads} consistent tracker reads");
+            Assert.True(reads > 0, "no reads completed");
+        }
+
+        [Test]
+        public static void UnreportedAndStaleDevicesReadAsUntracked()
+        {
+            var buffers = new TrackedDeviceBuffers(2);
+            int device = buffers.Register(TrackedDeviceRole.LeftFoot);
+            Assert.True(!buffers.TryRead(device, out _, out _), "never-written device read as tracked");
+
+            buffers.Write(device, Vector3.One, Quaternion.Identity, Stopwatch.GetTimestamp());
+            Assert.True(buffers.TryRead(device, out var position, out _), "fresh sample read as untracked");
+            Assert.Equal(Vector3.One, position);
+
+            buffers.Write(device, Vector3.One, Quaternion.Identity, Stopwatch.GetTimestamp() - Stopwatch.Frequency);
+            Assert.True(!buffers.TryRead(device, out _, out _), "second-old sample read as tracked");
+            Assert.True(!buffers.TryReadHand(ControllerHand.Left, new Vector3[26], new Quaternion[26]), "untracked hand");
+        }
+    }
+}
@@ -0,0 +1,92 @@
+using System;
+using System.Numerics;
+using VRGameConverter.Tracking;
+
+namespace VRGameConverter.Tests.Tracking
+{
+    public static class TransformGraphTests
+    {
+        private static readonly Quaternion Yaw90 = Quaternion.CreateFromAxisAngle(Vector3.UnitY, MathF.PI / 2);
+
+        // Calibration doubles distances, turns a quarter and shifts along X; the game root sits 5 m down Z,
+        // turned around
+        private static TransformGraph CreateGraph()
+        {
+            var graph = new TransformGraph();
+            graph.SetCalibration(2.0f, new Vector3(1, 0, 0), Yaw90);
+            graph.SetGameRoot(new Vector3(0, 0, 5), Quaternion.CreateFromAxisAngle(Vector3.UnitY, MathF.PI));
+            return graph;
+        }
+
+        private static void Near(Vector3 expected, Vector3 actual, string message)
+        {
+            Assert.True(Vector3.Distance(expected, actual) < 1e-4f, $"{message}: expected {expected}, got {actual}");
+        }
+
+        [Test]
+        public static void GameSpaceAppliesCalibrationBeforeTheGameRoot()
+        {
+            var graph = CreateGraph();
+            var play = graph.GetLocal(TransformSpace.Play);
+            var game = graph.GetLocal(TransformSpace.Game);
+
+            // One step at a time: tracking into play space, then play space into the game
+            var point = new Vector3(0.3f, 1.6f, -0.2f);
+            var expected = game.TransformPoint(play.TransformPoint(point));
+            Near(expected, graph.GetWorld(TransformSpace.Game).TransformPoint(point), "head position");
+
+            // Worked by hand: scale (0.6, 3.2, -0.4), quarter turn (-0.4, 3.2, -0.6), offset (0.6, 3.2, -0.6),
+            // half turn (-0.6, 3.2, 0.6), root (-0.6, 3.2, 5.6)
+            Near(new Vector3(-0.6f, 3.2f, 5.6f), expected, "reference");
+
+            var rotation = graph.GetWorld(TransformSpace.Game).TransformRotation(Quaternion.Identity);
+            Near(Vector3.Transform(Vector3.UnitZ, game.Rotation * play.Rotation), Vector3.Transform(Vector3.UnitZ, rotation), "facing");
+        }
+
+        [Test]
+        public static void BatchMatchesPerPoseTransform()
+        {
+            var graph = CreateGraph();
+            var world = graph.GetWorld(TransformSpace.Game);
+
+            // Enough poses for full SIMD blocks and a remainder
+            var batch = new TrackedPoseBatch(19) { Count = 19 };
+            var positions = new Vector3[batch.Count];
+            var rotations = new Quaternion[batch.Count];
+            for (int i = 0; i < batch.Count; i++)
+            {
+                positions[i] = new Vector3(i * 0.1f, 1.0f + i * 0.05f, -i * 0.2f);
+                rotations[i] = Quaternion.CreateFromYawPitchRoll(i * 0.3f, i * 0.1f, -i * 0.05f);
+                batch.Set(i, positions[i], rotations[i]);
+            }
+
+            graph.TransformBatch(batch, TransformSpace.Game);
+
+            for (int i = 0; i < batch.Count; i++)
+            {
+                Near(world.TransformPoint(positions[i]), batch.GetPosition(i), $"pose {i} position");
+                var expected = world.TransformRotation(rotations[i]);
+                Assert.True(MathF.Abs(Quaternion.Dot(expected, batch.GetRotation(i))) > 0.99999f, $"pose {i} rotation");
+            }
+        }
+
+        [Test]
+        public static void ChangingAParentRecomposesItsChildren()
+        {
+            var graph = CreateGraph();
+            var before = graph.GetWorld(TransformSpace.Game);
+            int version = graph.Version;
+
+            // Unchanged values are not a change
+            graph.SetCalibration(2.0f, new Vector3(1, 0, 0), Yaw90);
+            graph.GetWorld(TransformSpace.Game);
+            Assert.Equal(version, graph.Version);
+
+            graph.SetCalibration(1.0f, Vector3.Zero, Quaternion.Identity);
+            var after = graph.GetWorld(TransformSpace.Game);
+            Assert.True(graph.Version > version, "version not bumped");
+            Assert.True(!before.Equals(after), "game space kept the old calibration");
+            Near(graph.GetLocal(TransformSpace.Game).TransformPoint(Vector3.UnitX), after.TransformPoint(Vector3.UnitX), "identity calibration");
+        }
+    }
+}
@@ -0,0 +1,64 @@
+using System;
+using System.Diagnostics;
+using System.IO;
+using System.Threading;
+using VRGameConverter.VR;
+
+namespace VRGameConverter.Tests.VR
+{
+    public static class OpenXRHeadlessBenchmark
+    {
+        private const int Frames = 600;
+
+        // Frames are run from this thread the way the present hook runs them (DriveFrameLoop off)
+        [Test]
+        public static void OpenXRHeadlessFrameLoop()
+        {
+            string runtime = Environment.GetEnvironmentVariable("XR_RUNTIME_JSON");
+            if (string.IsNullOrEmpty(runtime) || !File.Exists(runtime))
+            {
+                throw new SkipException("needs XR_RUNTIME_JSON pointing at a runtime with XR_MND_headless (openxr-headless-benchmark.sh)");
+            }
+
+            OpenXRSystem openXR;
+            try
+            {
+                openXR = new OpenXRSystem(new OpenXRSettings { Headless = true, DriveFrameLoop = false });
+            }
+            catch (VRInitializationException ex)
+            {
+                throw new SkipException($"OpenXR unavailable: {ex.Message}");
+            }
+
+            using (openXR)
+            {
+                // The session only starts once the runtime reports it ready
+                var clock = Stopwatch.StartNew();
+                while (!openXR.RunFrame())
+                {
+                    Assert.True(clock.ElapsedMilliseconds < 5000, "session never became ready");
+                    openXR.PollEvents();
+                    Thread.Sleep(10);
+                }
+
+                clock.Restart();
+                for (int i = 0; i < Frames; i++)
+                {
+                    openXR.PollEvents();
+                    Assert.True(openXR.RunFrame(), $"frame {i} failed");
+                }
+                double perFrame = clock.Elapsed.TotalMilliseconds / Frames;
+
+                var statistics = openXR.Statistics;
+                Console.WriteLine($"    {statistics}");
+                Console.WriteLine($"    {perFrame:F2} ms per frame driven from the caller");
+
+                Assert.True(openXR.TryGetPredictedDisplayTime(out long display, out long period), "display time published");
+                Assert.True(period > 0 && display > 0, "display time and period");
+
+                // The wait paces the caller to the display: frames take about a display period each
+                Assert.Near(statistics.DisplayPeriodMilliseconds, perFrame, statistics.DisplayPeriodMilliseconds * 0.25, "pacing");
+            }
+        }
+    }
+}
@@ -0,0 +1,84 @@
+using System;
+using System.Diagnostics;
+using VRGameConverter.Diagnostics;
+using VRGameConverter.Ipc;
+using VRGameConverter.Rendering;
+using VRGameConverter.Vulkan;
+
+namespace VRGameConverter.Tests.Vulkan
+{
+    /// <summary>
+    /// The mod's end of the Vulkan layer, fed by a channel written the way the layer writes it
+    /// </summary>
+    public static class PresentLayerBridgeTests
+    {
+        [Test]
+        public static void LayerTimingsReachFrameAnalyzer()
+        {
+            string name = $"vrmod_test_layer_{Environment.ProcessId}";
+            using (var layer = new SharedMemoryChannel(name, ChannelSide.Game))
+            using (var bridge = PresentLayerBridge.TryConnect(name))
+            {
+                Assert.True(bridge != null, "bridge did not connect");
+                Assert.True(!bridge.Live, "live before anything was sent");
+
+                // 90 Hz presents in the layer's own clock, each after 0.25 ms of layer work and blocking 2 ms
+                var analyzer = new FrameAnalyzer();
+                analyzer.SetRefreshRate(90);
+                long frameTicks = TimeSpan.TicksPerSecond / 90;
+                long start = 5 * TimeSpan.TicksPerSecond;
+                for (int i = 0; i <= 120; i++)
+                {
+                    long presentEnd = start + i * frameTicks;
+                    layer.PublishTelemetry(TelemetryMetric.LayerHookMs, 0.25f, presentEnd);
+                    layer.PublishTelemetry(TelemetryMetric.LayerPresentMs, 2.0f, presentEnd);
+                    if (i % 20 == 0)
+                    {
+                        Assert.True(bridge.Drain(analyzer), "not live while receiving");
+                    }
+                }
+                layer.Log("swapchain 256x256");
+                bridge.Drain(analyzer);
+
+                Assert.Equal(121L, bridge.PresentsReceived, "presents received");
+                Assert.True(analyzer.TryTakeSummary(out var summary), "no window closed");
+                Assert.Near(1000.0 / 90, summary.MeanFrameMilliseconds, 0.01, "mean frame");
+                Assert.Near(0.25, summary.MeanHookMilliseconds, 0.05, "mean hook time");
+                Assert.Equal(0, summary.MissedFrames, "missed frames");
+            }
+        }
+
+        [Test]
+        public static void MissingLayerDoesNotConnect()
+        {
+            Assert.True(PresentLayerBridge.TryConnect($"vrmod_test_absent_{Environment.ProcessId}") == null, "connected to nothing");
+        }
+
+        [Test]
+        public static void ReadbackSwizzlesAndSamplesCapturedFrames()
+        {
+            string name = $"vrmod_test_capture_{Environment.ProcessId}";
+            using (var frames = SharedFrameBuffer.Create(name, 4, 2, 44))
+            using (var readback = new PresentLayerReadback(name))
+            {
+                var image = new FrameImage(2, 1);
+                Assert.True(!readback.TryReadColor(IntPtr.Zero, image), "read before anything was published");
+
+                // BGRA in memory: left half blue-ish, right half red-ish
+                var pixels = frames.WritePixels;
+                for (int y = 0; y < 2; y++)
+                {
+                    for (int x = 0; x < 4; x++)
+                    {
+                        pixels[y * 4 + x] = x < 2 ? 0xFFC08040u : 0xFF102030u;
+                    }
+                }
+                frames.Publish(Stopwatch.GetTimestamp());
+
+                Assert.True(readback.TryReadColor(IntPtr.Zero, image), "published frame not read");
+                Assert.Equal(FrameImage.Pack(0xC0, 0x80, 0x40), image.Pixels[0], "left pixel");
+                Assert.Equal(FrameImage.Pack(0x10, 0x20, 0x30), image.Pixels[1], "right pixel");
+            }
+        }
+    }
+}
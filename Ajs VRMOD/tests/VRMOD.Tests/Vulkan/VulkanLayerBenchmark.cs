@@ -0,0 +1,651 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading;
+using VRGameConverter.Ipc;
+using VRGameConverter.Rendering;
+using VRGameConverter.Vulkan;
+
+namespace VRGameConverter.Tests.Vulkan
+{
+    /// <summary>
+    /// Per-present cost of the Vulkan layer on lavapipe with a headless swapchain. The same present loop runs in
+    /// three child processes, since the loader reads its layers once per process: without the layer, with it,
+    /// and with it capturing frames. The layer's own time comes back over its channel to the mod, and the
+    /// capture run checks the frame that reaches the mod is the one presented.
+    /// </summary>
+    public static unsafe class VulkanLayerBenchmark
+    {
+        private const int Presents = 2000;
+        private const int Width = 256;
+        private const int Height = 256;
+        private const string LayerName = "VK_LAYER_AJS_vrmod";
+        private static readonly TimeSpan Timeout = TimeSpan.FromSeconds(60);
+
+        // Cleared into every presented image: (255, 128, 64) in 8-bit UNORM
+        private static readonly float[] ClearColor = { 1.0f, 0.5f, 0.25f, 1.0f };
+
+        [Test]
+        public static void VulkanLayerPresentOverhead()
+        {
+            string layerPath = Environment.GetEnvironmentVariable("VK_LAYER_PATH");
+            string icd = Environment.GetEnvironmentVariable("VK_ICD_FILENAMES");
+            if (string.IsNullOrEmpty(layerPath) || !File.Exists(Path.Combine(layerPath, "libVkLayer_ajs_vrmod.so")) ||
+                string.IsNullOrEmpty(icd) || !File.Exists(icd))
+            {
+                throw new SkipException("needs the published layer in VK_LAYER_PATH and lavapipe in VK_ICD_FILENAMES (vulkan-layer-benchmark.sh)");
+            }
+            if (!NativeLibrary.TryLoad("libvulkan.so.1", out _))
+            {
+                throw new SkipException("needs the Vulkan loader (libvulkan.so.1)");
+            }
+
+            var baseline = RunLoop("none");
+            var layer = RunLoop("layer");
+            var capture = RunLoop("capture");
+
+            Console.WriteLine($"    vkQueuePresentKHR: {baseline["presentUs"]:F1} us without the layer, " +
+                $"{layer["presentUs"]:F1} us with it, {capture["presentUs"]:F1} us capturing");
+            Console.WriteLine($"    layer's own time before the driver: {layer["layerUs"]:F2} us, {capture["layerUs"]:F2} us capturing " +
+                $"({capture["frames"]:F0} frames reached the mod)");
+
+            // Every present's timing reached the mod, and the layer's bookkeeping is small next to a present
+            Assert.Equal((double)Presents, layer["layerPresents"], "timings received");
+            Assert.True(layer["layerUs"] < 50, $"layer spends {layer["layerUs"]:F2} us per present");
+            Assert.True(capture["frames"] > 0, "no captured frame reached the mod");
+        }
+
+        private static Dictionary<string, double> RunLoop(string mode)
+        {
+            var environment = new Dictionary<string, string>
+            {
+                ["AJSVRMOD_SESSION"] = $"benchmark{Environment.ProcessId}{mode}",
+                ["AJSVRMOD_VK_CAPTURE"] = mode == "capture" ? "1" : "0"
+            };
+
+            using (var child = ChildProcess.Start($"{nameof(VulkanLayerBenchmark)}.{nameof(PresentLoop)}", environment, mode))
+            {
+                Assert.True(child.WaitForExit((int)Timeout.TotalMilliseconds), $"{mode} run did not finish");
+                string output = child.StandardOutput.ReadToEnd().Trim();
+                Assert.Equal(0, child.ExitCode, $"{mode} run failed: {output}");
+
+                // Last line is key=value pairs; anything before it is the layer's own logging
+                return output.Split('\n').Last().Split(' ')
+                    .Select(pair => pair.Split('='))
+                    .ToDictionary(pair => pair[0], pair => double.Parse(pair[1], CultureInfo.InvariantCulture));
+            }
+        }
+
+        /// <summary>
+        /// Child process: present cleared images on a headless swapchain, timing each present, and read back
+        /// what the layer sends the mod
+        /// </summary>
+        public static int PresentLoop(string[] args)
+        {
+            string mode = args[0];
+            using (var vulkan = new HeadlessVulkan(mode != "none"))
+            {
+                var bridge = mode != "none" ? new SharedMemoryChannel(VulkanPresentLayer.ChannelName, ChannelSide.Manager) : null;
+                int layerPresents = 0;
+                double layerMilliseconds = 0;
+
+                long presentTicks = 0;
+                for (int i = 0; i < Presents; i++)
+                {
+                    presentTicks += vulkan.Present();
+
+                    // Drained as the mod does, every frame, so the ring never fills
+                    while (bridge != null && bridge.TryReadTelemetry(out var sample))
+                    {
+                        if (sample.Metric == TelemetryMetric.LayerHookMs) layerMilliseconds += sample.Value;
+                        if (sample.Metric == TelemetryMetric.LayerPresentMs) layerPresents++;
+                    }
+                }
+
+                int frames = 0;
+                if (mode == "capture")
+                {
+                    frames = ReadCapturedFrame();
+                    if (frames < 0) return 1;
+                }
+
+                double presentUs = presentTicks * 1e6 / Stopwatch.Frequency / Presents;
+                double layerUs = layerPresents > 0 ? layerMilliseconds * 1000.0 / layerPresents : 0;
+                Console.WriteLine(string.Format(CultureInfo.InvariantCulture,
+                    "presentUs={0:F3} layerUs={1:F3} layerPresents={2} frames={3}", presentUs, layerUs, layerPresents, frames));
+                bridge?.Dispose();
+                return 0;
+            }
+        }
+
+        // The capture worker publishes after the copy lands, so the last frames may still be on their way
+        private static int ReadCapturedFrame()
+        {
+            using (var readback = new PresentLayerReadback(VulkanPresentLayer.FrameBufferName))
+            {
+                var frame = new FrameImage(Width / 4, Height / 4);
+                var stopwatch = Stopwatch.StartNew();
+                while (!readback.TryReadColor(IntPtr.Zero, frame))
+                {
+                    if (stopwatch.Elapsed > TimeSpan.FromSeconds(5))
+                    {
+                        Console.WriteLine("no frame arrived");
+                        return -1;
+                    }
+                    Thread.Sleep(50);
+                }
+
+                uint pixel = frame.Pixels[frame.Pixels.Length / 2];
+                int r = (int)(pixel & 0xFF), g = (int)((pixel >> 8) & 0xFF), b = (int)((pixel >> 16) & 0xFF);
+                if (Math.Abs(r - 255) > 1 || Math.Abs(g - 128) > 1 || Math.Abs(b - 64) > 1)
+                {
+                    Console.WriteLine($"captured ({r}, {g}, {b}) instead of the clear colour");
+                    return -1;
+                }
+                return 1;
+            }
+        }
+
+        /// <summary>
+        /// Just enough Vulkan for a present loop: a headless surface and swapchain, and one command buffer per
+        /// image that clears it and hands it to the presentation engine
+        /// </summary>
+        private sealed class HeadlessVulkan : IDisposable
+        {
+            private const int FramesInFlight = 2;
+            private const int VK_FORMAT_B8G8R8A8_UNORM = 44;
+            private const int VK_IMAGE_LAYOUT_UNDEFINED = 0;
+            private const int VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL = 7;
+            private const int VK_IMAGE_LAYOUT_PRESENT_SRC_KHR = 1000001002;
+            private const uint VK_IMAGE_USAGE_TRANSFER_DST_BIT = 0x2;
+            private const uint VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT = 0x10;
+            private const uint VK_QUEUE_GRAPHICS_BIT = 0x1;
+            private const uint VK_PIPELINE_STAGE_TRANSFER_BIT = 0x1000;
+            private const uint VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT = 0x2000;
+            private const uint VK_ACCESS_TRANSFER_WRITE_BIT = 0x1000;
+            private const int VK_PRESENT_MODE_FIFO_KHR = 2;
+
+            private readonly delegate* unmanaged<IntPtr, byte*, IntPtr> getInstanceProcAddr;
+            private readonly IntPtr instance;
+            private readonly IntPtr device;
+            private readonly IntPtr queue;
+            private readonly ulong surface;
+            private readonly ulong swapchain;
+            private readonly ulong commandPool;
+            private readonly IntPtr[] commandBuffers;
+            private readonly ulong[] acquired = new ulong[FramesInFlight];
+            private readonly ulong[] rendered = new ulong[FramesInFlight];
+            private readonly ulong[] inFlight = new ulong[FramesInFlight];
+            private int frame = 0;
+
+            private readonly delegate* unmanaged<IntPtr, ulong, ulong, ulong, ulong, uint*, int> acquireNextImage;
+            private readonly delegate* unmanaged<IntPtr, uint, ulong*, uint, ulong, int> waitForFences;
+            private readonly delegate* unmanaged<IntPtr, uint, ulong*, int> resetFences;
+            private readonly delegate* unmanaged<IntPtr, uint, VkSubmitInfo*, ulong, int> queueSubmit;
+            private readonly delegate* unmanaged<IntPtr, VkPresentInfoKHR*, int> queuePresent;
+
+            public HeadlessVulkan(bool withLayer)
+            {
+                var loader = NativeLibrary.Load("libvulkan.so.1");
+                getInstanceProcAddr = (delegate* unmanaged<IntPtr, byte*, IntPtr>)NativeLibrary.GetExport(loader, "vkGetInstanceProcAddr");
+
+                using (var names = new NativeStrings())
+                {
+                    var application = new VkApplicationInfo { SType = 0, ApiVersion = 1u << 22 };
+                    byte** extensions = names.Array("VK_KHR_surface", "VK_EXT_headless_surface");
+                    byte** layers = names.Array(LayerName);
+                    var instanceInfo = new VkInstanceCreateInfo
+                    {
+                        SType = 1,
+                        PApplicationInfo = &application,
+                        EnabledLayerCount = withLayer ? 1u : 0u,
+                        PpEnabledLayerNames = layers,
+                        EnabledExtensionCount = 2,
+                        PpEnabledExtensionNames = extensions
+                    };
+                    IntPtr createdInstance;
+                    Check(((delegate* unmanaged<VkInstanceCreateInfo*, void*, IntPtr*, int>)Instance("vkCreateInstance"))(&instanceInfo, null, &createdInstance), "vkCreateInstance");
+                    instance = createdInstance;
+
+                    uint count = 1;
+                    IntPtr physicalDevice;
+                    ((delegate* unmanaged<IntPtr, uint*, IntPtr*, int>)Instance("vkEnumeratePhysicalDevices"))(instance, &count, &physicalDevice);
+                    if (count == 0) throw new InvalidOperationException("no Vulkan device");
+
+                    var headlessInfo = new VkCreateInfo { SType = 1000256000 };
+                    ulong createdSurface;
+                    Check(((delegate* unmanaged<IntPtr, VkCreateInfo*, void*, ulong*, int>)Instance("vkCreateHeadlessSurfaceEXT"))(instance, &headlessInfo, null, &createdSurface), "vkCreateHeadlessSurfaceEXT");
+                    surface = createdSurface;
+
+                    uint family = GraphicsFamily(physicalDevice);
+                    float priority = 1.0f;
+                    var queueInfo = new VkDeviceQueueCreateInfo { SType = 2, QueueFamilyIndex = family, QueueCount = 1, PQueuePriorities = &priority };
+                    byte** deviceExtensions = names.Array("VK_KHR_swapchain");
+                    var deviceInfo = new VkDeviceCreateInfo
+                    {
+                        SType = 3,
+                        QueueCreateInfoCount = 1,
+                        PQueueCreateInfos = &queueInfo,
+                        EnabledExtensionCount = 1,
+                        PpEnabledExtensionNames = deviceExtensions
+                    };
+                    IntPtr createdDevice;
+                    Check(((delegate* unmanaged<IntPtr, VkDeviceCreateInfo*, void*, IntPtr*, int>)Instance("vkCreateDevice"))(physicalDevice, &deviceInfo, null, &createdDevice), "vkCreateDevice");
+                    device = createdDevice;
+
+                    IntPtr createdQueue;
+                    ((delegate* unmanaged<IntPtr, uint, uint, IntPtr*, void>)Device("vkGetDeviceQueue"))(device, family, 0, &createdQueue);
+                    queue = createdQueue;
+
+                    uint* capabilities = stackalloc uint[13];
+                    ((delegate* unmanaged<IntPtr, ulong, uint*, int>)Instance("vkGetPhysicalDeviceSurfaceCapabilitiesKHR"))(physicalDevice, surface, capabilities);
+                    uint compositeAlpha = capabilities[11] & (uint)-(int)capabilities[11];
+
+                    var swapchainInfo = new VkSwapchainCreateInfoKHR
+                    {
+                        SType = 1000001000,
+                        Surface = surface,
+                        MinImageCount = Math.Max(3, capabilities[0]),
+                        ImageFormat = VK_FORMAT_B8G8R8A8_UNORM,
+                        ImageWidth = Width,
+                        ImageHeight = Height,
+                        ImageArrayLayers = 1,
+                        ImageUsage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+                        PreTransform = (int)capabilities[10],
+                        CompositeAlpha = (int)compositeAlpha,
+                        PresentMode = VK_PRESENT_MODE_FIFO_KHR,
+                        Clipped = 1
+                    };
+                    ulong createdSwapchain;
+                    Check(((delegate* unmanaged<IntPtr, VkSwapchainCreateInfoKHR*, void*, ulong*, int>)Device("vkCreateSwapchainKHR"))(device, &swapchainInfo, null, &createdSwapchain), "vkCreateSwapchainKHR");
+                    swapchain = createdSwapchain;
+                }
+
+                uint imageCount = 0;
+                var getImages = (delegate* unmanaged<IntPtr, ulong, uint*, ulong*, int>)Device("vkGetSwapchainImagesKHR");
+                getImages(device, swapchain, &imageCount, null);
+                var images = new ulong[imageCount];
+                fixed (ulong* imagePointer = images)
+                {
+                    getImages(device, swapchain, &imageCount, imagePointer);
+                }
+
+                commandBuffers = RecordClears(images, out commandPool);
+
+                var createSemaphore = (delegate* unmanaged<IntPtr, VkCreateInfo*, void*, ulong*, int>)Device("vkCreateSemaphore");
+                var createFence = (delegate* unmanaged<IntPtr, VkCreateInfo*, void*, ulong*, int>)Device("vkCreateFence");
+                var semaphoreInfo = new VkCreateInfo { SType = 9 };
+                var fenceInfo = new VkCreateInfo { SType = 8, Flags = 1 };
+                for (int i = 0; i < FramesInFlight; i++)
+                {
+                    ulong handle;
+                    Check(createSemaphore(device, &semaphoreInfo, null, &handle), "vkCreateSemaphore");
+                    acquired[i] = handle;
+                    Check(createSemaphore(device, &semaphoreInfo, null, &handle), "vkCreateSemaphore");
+                    rendered[i] = handle;
+                    Check(createFence(device, &fenceInfo, null, &handle), "vkCreateFence");
+                    inFlight[i] = handle;
+                }
+
+                acquireNextImage = (delegate* unmanaged<IntPtr, ulong, ulong, ulong, ulong, uint*, int>)Device("vkAcquireNextImageKHR");
+                waitForFences = (delegate* unmanaged<IntPtr, uint, ulong*, uint, ulong, int>)Device("vkWaitForFences");
+                resetFences = (delegate* unmanaged<IntPtr, uint, ulong*, int>)Device("vkResetFences");
+                queueSubmit = (delegate* unmanaged<IntPtr, uint, VkSubmitInfo*, ulong, int>)Device("vkQueueSubmit");
+                queuePresent = (delegate* unmanaged<IntPtr, VkPresentInfoKHR*, int>)Device("vkQueuePresentKHR");
+            }
+
+            /// <summary>
+            /// One frame; returns the Stopwatch ticks spent in vkQueuePresentKHR
+            /// </summary>
+            public long Present()
+            {
+                ulong fence = inFlight[frame];
+                ulong acquire = acquired[frame];
+                ulong render = rendered[frame];
+                Check(waitForFences(device, 1, &fence, 1, ulong.MaxValue), "vkWaitForFences");
+                Check(resetFences(device, 1, &fence), "vkResetFences");
+
+                uint index;
+                Check(acquireNextImage(device, swapchain, ulong.MaxValue, acquire, 0, &index), "vkAcquireNextImageKHR");
+
+                IntPtr commandBuffer = commandBuffers[index];
+                uint stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+                var submit = new VkSubmitInfo
+                {
+                    SType = 4,
+                    WaitSemaphoreCount = 1,
+                    PWaitSemaphores = &acquire,
+                    PWaitDstStageMask = &stage,
+                    CommandBufferCount = 1,
+                    PCommandBuffers = &commandBuffer,
+                    SignalSemaphoreCount = 1,
+                    PSignalSemaphores = &render
+                };
+                Check(queueSubmit(queue, 1, &submit, fence), "vkQueueSubmit");
+
+                ulong presented = swapchain;
+                var presentInfo = new VkPresentInfoKHR
+                {
+                    SType = 1000001001,
+                    WaitSemaphoreCount = 1,
+                    PWaitSemaphores = &render,
+                    SwapchainCount = 1,
+                    PSwapchains = &presented,
+                    PImageIndices = &index
+                };
+
+                long start = Stopwatch.GetTimestamp();
+                Check(queuePresent(queue, &presentInfo), "vkQueuePresentKHR");
+                long ticks = Stopwatch.GetTimestamp() - start;
+
+                frame = (frame + 1) % FramesInFlight;
+                return ticks;
+            }
+
+            private IntPtr[] RecordClears(ulong[] images, out ulong pool)
+            {
+                var poolInfo = new VkCreateInfo { SType = 39 };
+                ulong createdPool;
+                Check(((delegate* unmanaged<IntPtr, VkCreateInfo*, void*, ulong*, int>)Device("vkCreateCommandPool"))(device, &poolInfo, null, &createdPool), "vkCreateCommandPool");
+                pool = createdPool;
+
+                var buffers = new IntPtr[images.Length];
+                var allocateInfo = new VkCommandBufferAllocateInfo { SType = 40, CommandPool = pool, CommandBufferCount = (uint)images.Length };
+                fixed (IntPtr* bufferPointer = buffers)
+                {
+                    Check(((delegate* unmanaged<IntPtr, VkCommandBufferAllocateInfo*, IntPtr*, int>)Device("vkAllocateCommandBuffers"))(device, &allocateInfo, bufferPointer), "vkAllocateCommandBuffers");
+                }
+
+                var begin = (delegate* unmanaged<IntPtr, VkCommandBufferBeginInfo*, int>)Device("vkBeginCommandBuffer");
+                var end = (delegate* unmanaged<IntPtr, int>)Device("vkEndCommandBuffer");
+                var barrier = (delegate* unmanaged<IntPtr, uint, uint, uint, uint, void*, uint, void*, uint, VkImageMemoryBarrier*, void>)Device("vkCmdPipelineBarrier");
+                var clear = (delegate* unmanaged<IntPtr, ulong, int, float*, uint, VkImageSubresourceRange*, void>)Device("vkCmdClearColorImage");
+
+                var range = new VkImageSubresourceRange { AspectMask = 1, LevelCount = 1, LayerCount = 1 };
+                float* color = stackalloc float[4];
+                for (int c = 0; c < 4; c++) color[c] = ClearColor[c];
+
+                for (int i = 0; i < images.Length; i++)
+                {
+                    var beginInfo = new VkCommandBufferBeginInfo { SType = 42 };
+                    Check(begin(buffers[i], &beginInfo), "vkBeginCommandBuffer");
+
+                    var toClear = new VkImageMemoryBarrier
+                    {
+                        SType = 45,
+                        DstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                        OldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                        NewLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        SrcQueueFamilyIndex = ~0u,
+                        DstQueueFamilyIndex = ~0u,
+                        Image = images[i],
+                        SubresourceRange = range
+                    };
+                    barrier(buffers[i], VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, null, 0, null, 1, &toClear);
+                    clear(buffers[i], images[i], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, color, 1, &range);
+
+                    var toPresent = toClear;
+                    toPresent.SrcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                    toPresent.DstAccessMask = 0;
+                    toPresent.OldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+                    toPresent.NewLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+                    barrier(buffers[i], VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, null, 0, null, 1, &toPresent);
+
+                    Check(end(buffers[i]), "vkEndCommandBuffer");
+                }
+                return buffers;
+            }
+
+            private uint GraphicsFamily(IntPtr physicalDevice)
+            {
+                var query = (delegate* unmanaged<IntPtr, uint*, uint*, void>)Instance("vkGetPhysicalDeviceQueueFamilyProperties");
+                uint count = 0;
+                query(physicalDevice, &count, null);
+
+                // VkQueueFamilyProperties is six 32-bit words, the flags first
+                uint* properties = stackalloc uint[(int)count * 6];
+                query(physicalDevice, &count, properties);
+                for (uint i = 0; i < count; i++)
+                {
+                    if ((properties[i * 6] & VK_QUEUE_GRAPHICS_BIT) != 0) return i;
+                }
+                throw new InvalidOperationException("no graphics queue");
+            }
+
+            private IntPtr Instance(string name)
+            {
+                return Lookup(getInstanceProcAddr, instance, name);
+            }
+
+            private IntPtr Device(string name)
+            {
+                var getDeviceProcAddr = (delegate* unmanaged<IntPtr, byte*, IntPtr>)Instance("vkGetDeviceProcAddr");
+                return Lookup(getDeviceProcAddr, device, name);
+            }
+
+            private static IntPtr Lookup(delegate* unmanaged<IntPtr, byte*, IntPtr> getProcAddr, IntPtr handle, string name)
+            {
+                byte* buffer = stackalloc byte[64];
+                int length = Encoding.ASCII.GetBytes(name, new Span<byte>(buffer, 63));
+                buffer[length] = 0;
+                IntPtr function = getProcAddr(handle, buffer);
+                if (function == IntPtr.Zero) throw new InvalidOperationException($"{name} not found");
+                return function;
+            }
+
+            private static void Check(int result, string function)
+            {
+                // VK_SUBOPTIMAL_KHR still presents
+                if (result != 0 && result != 1000001003) throw new InvalidOperationException($"{function} returned {result}");
+            }
+
+            public void Dispose()
+            {
+                ((delegate* unmanaged<IntPtr, int>)Device("vkDeviceWaitIdle"))(device);
+
+                var destroySemaphore = (delegate* unmanaged<IntPtr, ulong, void*, void>)Device("vkDestroySemaphore");
+                var destroyFence = (delegate* unmanaged<IntPtr, ulong, void*, void>)Device("vkDestroyFence");
+                for (int i = 0; i < FramesInFlight; i++)
+                {
+                    destroySemaphore(device, acquired[i], null);
+                    destroySemaphore(device, rendered[i], null);
+                    destroyFence(device, inFlight[i], null);
+                }
+                ((delegate* unmanaged<IntPtr, ulong, void*, void>)Device("vkDestroyCommandPool"))(device, commandPool, null);
+                ((delegate* unmanaged<IntPtr, ulong, void*, void>)Device("vkDestroySwapchainKHR"))(device, swapchain, null);
+                ((delegate* unmanaged<IntPtr, void*, void>)Device("vkDestroyDevice"))(device, null);
+                ((delegate* unmanaged<IntPtr, ulong, void*, void>)Instance("vkDestroySurfaceKHR"))(instance, surface, null);
+                ((delegate* unmanaged<IntPtr, void*, void>)Instance("vkDestroyInstance"))(instance, null);
+            }
+        }
+
+        /// <summary>
+        /// NUL-terminated name arrays that live until disposed
+        /// </summary>
+        private sealed class NativeStrings : IDisposable
+        {
+            private readonly List<IntPtr> allocations = new List<IntPtr>();
+
+            public byte** Array(params string[] strings)
+            {
+                var array = (byte**)Marshal.AllocHGlobal(IntPtr.Size * strings.Length);
+                allocations.Add((IntPtr)array);
+                for (int i = 0; i < strings.Length; i++)
+                {
+                    IntPtr text = Marshal.StringToHGlobalAnsi(strings[i]);
+                    allocations.Add(text);
+                    array[i] = (byte*)text;
+                }
+                return array;
+            }
+
+            public void Dispose()
+            {
+                foreach (var allocation in allocations) Marshal.FreeHGlobal(allocation);
+            }
+        }
+
+        #region Vulkan structures
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkCreateInfo
+        {
+            public int SType;
+            public void* PNext;
+            public uint Flags;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkApplicationInfo
+        {
+            public int SType;
+            public void* PNext;
+            public byte* PApplicationName;
+            public uint ApplicationVersion;
+            public byte* PEngineName;
+            public uint EngineVersion;
+            public uint ApiVersion;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkInstanceCreateInfo
+        {
+            public int SType;
+            public void* PNext;
+            public uint Flags;
+            public VkApplicationInfo* PApplicationInfo;
+            public uint EnabledLayerCount;
+            public byte** PpEnabledLayerNames;
+            public uint EnabledExtensionCount;
+            public byte** PpEnabledExtensionNames;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkDeviceQueueCreateInfo
+        {
+            public int SType;
+            public void* PNext;
+            public uint Flags;
+            public uint QueueFamilyIndex;
+            public uint QueueCount;
+            public float* PQueuePriorities;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkDeviceCreateInfo
+        {
+            public int SType;
+            public void* PNext;
+            public uint Flags;
+            public uint QueueCreateInfoCount;
+            public VkDeviceQueueCreateInfo* PQueueCreateInfos;
+            public uint EnabledLayerCount;
+            public byte** PpEnabledLayerNames;
+            public uint EnabledExtensionCount;
+            public byte** PpEnabledExtensionNames;
+            public void* PEnabledFeatures;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkSwapchainCreateInfoKHR
+        {
+            public int SType;
+            public void* PNext;
+            public uint Flags;
+            public ulong Surface;
+            public uint MinImageCount;
+            public int ImageFormat;
+            public int ImageColorSpace;
+            public uint ImageWidth;
+            public uint ImageHeight;
+            public uint ImageArrayLayers;
+            public uint ImageUsage;
+            public int ImageSharingMode;
+            public uint QueueFamilyIndexCount;
+            public uint* PQueueFamilyIndices;
+            public int PreTransform;
+            public int CompositeAlpha;
+            public int PresentMode;
+            public uint Clipped;
+            public ulong OldSwapchain;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkCommandBufferAllocateInfo
+        {
+            public int SType;
+            public void* PNext;
+            public ulong CommandPool;
+            public int Level;
+            public uint CommandBufferCount;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkCommandBufferBeginInfo
+        {
+            public int SType;
+            public void* PNext;
+            public uint Flags;
+            public void* PInheritanceInfo;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkImageSubresourceRange
+        {
+            public uint AspectMask;
+            public uint BaseMipLevel;
+            public uint LevelCount;
+            public uint BaseArrayLayer;
+            public uint LayerCount;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkImageMemoryBarrier
+        {
+            public int SType;
+            public void* PNext;
+            public uint SrcAccessMask;
+            public uint DstAccessMask;
+            public int OldLayout;
+            public int NewLayout;
+            public uint SrcQueueFamilyIndex;
+            public uint DstQueueFamilyIndex;
+            public ulong Image;
+            public VkImageSubresourceRange SubresourceRange;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkSubmitInfo
+        {
+            public int SType;
+            public void* PNext;
+            public uint WaitSemaphoreCount;
+            public ulong* PWaitSemaphores;
+            public uint* PWaitDstStageMask;
+            public uint CommandBufferCount;
+            public IntPtr* PCommandBuffers;
+            public uint SignalSemaphoreCount;
+            public ulong* PSignalSemaphores;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct VkPresentInfoKHR
+        {
+            public int SType;
+            public void* PNext;
+            public uint WaitSemaphoreCount;
+            public ulong* PWaitSemaphores;
+            public uint SwapchainCount;
+            public ulong* PSwapchains;
+            public uint* PImageIndices;
+            public int* PResults;
+        }
+
+        #endregion
+    }
+}
@@ -0,0 +1,259 @@
+using System;
+using System.Collections.Generic;
+using System.Numerics;
+using System.Runtime.InteropServices;
+using System.Threading;
+using VRGameConverter.World;
+
+namespace VRGameConverter.Tests.World
+{
+    public static class EntityMirrorTests
+    {
+        /// <summary>
+        /// An entity pool laid out in unmanaged memory the way EntityPoolLayout describes a game's:
+        /// pool → entry array and slot count, entity → position, extents and type id
+        /// </summary>
+        private sealed unsafe class FakePool : IDisposable
+        {
+            private const int EntitySize = 32;
+
+            public readonly IntPtr Pool;
+            private readonly IntPtr entries;
+            private readonly IntPtr entities;
+
+            public static EntityPoolLayout Layout(int capacity = 512, float radius = 60) => new EntityPoolLayout
+            {
+                EntriesOffset = 0,
+                CountOffset = 8,
+                PositionOffset = 0,
+                ExtentsOffset = 12,
+                TypeOffset = 24,
+                PlayerSlot = 0,
+                Radius = radius,
+                Capacity = capacity,
+                TypeKinds = new Dictionary<int, EntityKind> { [1] = EntityKind.Vehicle, [2] = EntityKind.Character }
+            };
+
+            public FakePool(int slots)
+            {
+                Pool = Marshal.AllocHGlobal(16);
+                entries = Marshal.AllocHGlobal(slots * IntPtr.Size);
+                entities = Marshal.AllocHGlobal(slots * EntitySize);
+                new Span<byte>((void*)entities, slots * EntitySize).Clear();
+
+                *(IntPtr*)Pool = entries;
+                *(int*)((byte*)Pool + 8) = slots;
+                for (int slot = 0; slot < slots; slot++) Remove(slot);
+            }
+
+            public IntPtr Entity(int slot) => entities + slot * EntitySize;
+
+            public void Set(int slot, Vector3 position, int typeId, Vector3 extents = default)
+            {
+                byte* entity = (byte*)Entity(slot);
+                *(Vector3*)entity = position;
+                *(Vector3*)(entity + 12) = extents;
+                *(int*)(entity + 24) = typeId;
+                ((IntPtr*)entries)[slot] = (IntPtr)entity;
+            }
+
+            public void Remove(int slot)
+            {
+                ((IntPtr*)entries)[slot] = IntPtr.Zero;
+            }
+
+            public void ClearEntries()
+            {
+                *(IntPtr*)Pool = IntPtr.Zero;
+            }
+
+            public void Dispose()
+            {
+                Marshal.FreeHGlobal(entities);
+                Marshal.FreeHGlobal(entries);
+                Marshal.FreeHGlobal(Pool);
+            }
+        }
+
+        [Test]
+        public static void CaptureMirrorsEntitiesInRange()
+        {
+            using var pool = new FakePool(8);
+            pool.Set(0, new Vector3(10, 0, 10), 2);
+            pool.Set(1, new Vector3(12, 0, 10), 1, new Vector3(1, 0.8f, 2.2f));
+            pool.Set(2, new Vector3(10, 5, 10), 2);
+            pool.Set(4, new Vector3(10, 0, 80), 1);
+            pool.Set(5, new Vector3(9, 0, 9), 7);
+
+            var mirror = new EntityMirror(FakePool.Layout(radius: 20));
+            Assert.Equal(0, mirror.Latest.Count, "before the first capture");
+
+            mirror.Capture(pool.Pool);
+            var snapshot = mirror.Latest;
+
+            // The player and the empty and far slots are left out; pool order is kept
+            Assert.Equal(3, snapshot.Count, "entities in range");
+            Assert.Equal(1L, snapshot.Tick);
+            Assert.Equal(new Vector3(10, 0, 10), snapshot.PlayerPosition);
+            Assert.True(!snapshot.Truncated, "truncated without filling up");
+            Assert.SequenceEqual(new[] { pool.Entity(1), pool.Entity(2), pool.Entity(5) }, snapshot.Address.AsSpan(0, 3).ToArray());
+
+            Assert.Equal(new Vector3(12, 0, 10), snapshot.GetPosition(0));
+            Assert.Equal(2.2f, snapshot.ExtentZ[0]);
+            Assert.Equal(EntityKind.Vehicle, snapshot.Kind[0]);
+            Assert.Equal(EntityKind.Character, snapshot.Kind[1]);
+            Assert.Equal(7, snapshot.TypeId[2]);
+            Assert.Equal(EntityKind.Unknown, snapshot.Kind[2]);
+
+            Assert.Equal(pool.Entity(1), mirror.FindNearest(new Vector3(11, 0, 10), 5, EntityKind.Vehicle));
+            Assert.Equal(pool.Entity(2), mirror.FindAlongRay(new Vector3(10, 5, 0), Vector3.UnitZ, 20, 0.5f, EntityKind.Character));
+            Assert.Equal(IntPtr.Zero, mirror.FindNearest(new Vector3(11, 0, 10), 5, EntityKind.Pickup));
+        }
+
+        [Test]
+        public static void RadiusBoundIsInclusive()
+        {
+            using var pool = new FakePool(4);
+            pool.Set(0, Vector3.Zero, 2);
+            pool.Set(1, new Vector3(0, 0, 20), 1);
+            pool.Set(2, new Vector3(0, 0, 20.01f), 1);
+
+            var mirror = new EntityMirror(FakePool.Layout(radius: 20));
+            mirror.Capture(pool.Pool);
+            Assert.Equal(1, mirror.Latest.Count, "entities in range");
+            Assert.Equal(pool.Entity(1), mirror.Latest.Address[0]);
+        }
+
+        [Test]
+        public static void CapacityCutsOffTheRest()
+        {
+            using var pool = new FakePool(12);
+            pool.Set(0, Vector3.Zero, 2);
+            for (int slot = 1; slot < 12; slot++) pool.Set(slot, new Vector3(slot, 0, 0), 1);
+
+            var mirror = new EntityMirror(FakePool.Layout(capacity: 4));
+            mirror.Capture(pool.Pool);
+            var snapshot = mirror.Latest;
+            Assert.Equal(4, snapshot.Count, "entities kept");
+            Assert.True(snapshot.Truncated, "truncation not reported");
+            Assert.Equal(pool.Entity(4), snapshot.Address[3]);
+
+            // Exactly full isn't truncated
+            for (int slot = 5; slot < 12; slot++) pool.Remove(slot);
+            mirror.Capture(pool.Pool);
+            Assert.Equal(4, mirror.Latest.Count, "entities kept");
+            Assert.True(!mirror.Latest.Truncated, "a full snapshot reported as truncated");
+        }
+
+        [Test]
+        public static void MissingPlayerPublishesAnEmptySnapshot()
+        {
+            using var pool = new FakePool(4);
+            pool.Set(1, Vector3.Zero, 1);
+
+            var mirror = new EntityMirror(FakePool.Layout());
+            mirror.Capture(pool.Pool);
+            Assert.Equal(0, mirror.Latest.Count, "without a player");
+            Assert.Equal(1L, mirror.Latest.Tick);
+
+            pool.Set(0, Vector3.Zero, 2);
+            mirror.Capture(pool.Pool);
+            Assert.Equal(1, mirror.Latest.Count, "with a player");
+
+            pool.ClearEntries();
+            mirror.Capture(pool.Pool);
+            Assert.Equal(0, mirror.Latest.Count, "without an entry array");
+            Assert.Equal(3L, mirror.Latest.Tick);
+        }
+
+        [Test]
+        public static void TakenSnapshotSurvivesTheNextTick()
+        {
+            using var pool = new FakePool(3);
+            pool.Set(0, Vector3.Zero, 2);
+            pool.Set(1, new Vector3(1, 0, 0), 1);
+
+            var mirror = new EntityMirror(FakePool.Layout());
+            mirror.Capture(pool.Pool);
+            var taken = mirror.Latest;
+            int sequence = taken.Sequence;
+            Assert.Equal(0, sequence & 1, "published while being written");
+
+            // Neither of the next two captures touches it...
+            for (int tick = 0; tick < 2; tick++)
+            {
+                pool.Set(1, new Vector3(2 + tick, 0, 0), 1);
+                mirror.Capture(pool.Pool);
+                Assert.True(mirror.Latest != taken, "the published snapshot was rewritten");
+                Assert.Equal(new Vector3(1, 0, 0), taken.GetPosition(0));
+                Assert.Equal(1L, taken.Tick);
+                Assert.Equal(sequence, taken.Sequence);
+                Assert.True(taken.TryFindNearest(Vector3.Zero, 5, EntityKind.Vehicle, out var address), "an untouched snapshot reported a rewrite");
+                Assert.Equal(pool.Entity(1), address);
+            }
+
+            // ...and once the third reuses it, the sequence says so
+            mirror.Capture(pool.Pool);
+            Assert.True(mirror.Latest == taken, "three snapshots should rotate");
+            Assert.True(taken.Sequence != sequence, "a rewrite left the sequence alone");
+            Assert.Equal(4L, taken.Tick);
+        }
+
+        [Test]
+        public static unsafe void ReadersNeverSeeATornSnapshot()
+        {
+            // Every capture moves all entities to the same new X; a snapshot a reader accepts must agree on it
+            const int slots = 64;
+            using var pool = new FakePool(slots);
+            pool.Set(0, Vector3.Zero, 2);
+            for (int slot = 1; slot < slots; slot++) pool.Set(slot, new Vector3(0, slot * 0.1f, 0), 1);
+
+            var mirror = new EntityMirror(FakePool.Layout());
+            mirror.Capture(pool.Pool);
+
+            long accepted = 0, rejected = 0;
+            bool running = true;
+            var writer = new Thread(() =>
+            {
+                for (int tick = 1; Volatile.Read(ref running); tick++)
+                {
+                    float x = tick % 50;
+                    for (int slot = 1; slot < slots; slot++) *(float*)pool.Entity(slot) = x;
+                    mirror.Capture(pool.Pool);
+                }
+            }) { IsBackground = true };
+            writer.Start();
+
+            var deadline = DateTime.UtcNow.AddMilliseconds(300);
+            while (DateTime.UtcNow < deadline)
+            {
+                var snapshot = mirror.Latest;
+                int before = snapshot.Sequence;
+                if ((before & 1) != 0)
+                {
+                    rejected++;
+                    continue;
+                }
+
+                int count = snapshot.Count;
+                float first = snapshot.PositionX[0];
+                bool agree = count == slots - 1;
+                for (int i = 1; i < count; i++) agree &= snapshot.PositionX[i] == first;
+                Interlocked.MemoryBarrier();
+
+                if (snapshot.Sequence != before)
+                {
+                    rejected++;
+                    continue;
+                }
+                Assert.True(agree, $"accepted a torn snapshot at tick {snapshot.Tick}");
+                accepted++;
+            }
+
+            Volatile.Write(ref running, false);
+            writer.Join();
+            Console.WriteLine($"    {accepted} snapshots read whole, {rejected} caught mid-rewrite");
+            Assert.True(accepted > 0, "no snapshot was ever read");
+        }
+    }
+}
@@ -0,0 +1,233 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Numerics;
+using System.Runtime.InteropServices;
+using System.Threading;
+using VRGameConverter.Scheduling;
+using VRGameConverter.World;
+
+namespace VRGameConverter.Tests.World
+{
+    public static class VehicleAnchorCacheTests
+    {
+        /// <summary>
+        /// Models by vehicle address, counting what the cache asks for
+        /// </summary>
+        private sealed class CountingInspector : IVehicleInspector
+        {
+            public readonly Dictionary<IntPtr, (uint Hash, VehicleAnchor Anchor)> Models = new Dictionary<IntPtr, (uint, VehicleAnchor)>();
+            public int Inspections;
+
+            public uint GetModelHash(IntPtr vehicle) => Models.TryGetValue(vehicle, out var model) ? model.Hash : 0;
+
+            public bool TryInspect(IntPtr vehicle, int seat, out VehicleAnchor anchor)
+            {
+                Inspections++;
+                anchor = default;
+                if (!Models.TryGetValue(vehicle, out var model)) return false;
+
+                anchor = model.Anchor;
+                anchor.SeatOffset.X += seat;
+                return true;
+            }
+        }
+
+        private static readonly VehicleAnchor Car = new VehicleAnchor
+        {
+            VehicleType = 1,
+            ControlScheme = VehicleControlScheme.Triggers,
+            SeatOffset = new Vector3(-0.37f, 0.52f, 0.1f),
+            SeatRotation = Quaternion.CreateFromYawPitchRoll(0.1f, -0.05f, 0)
+        };
+
+        private static readonly VehicleAnchor Bike = new VehicleAnchor
+        {
+            VehicleType = 2,
+            ControlScheme = VehicleControlScheme.Handlebars,
+            SeatOffset = new Vector3(0, 0.83f, -0.21f),
+            SeatRotation = Quaternion.Identity
+        };
+
+        private static string TemporaryStore() => Path.Combine(Path.GetTempPath(), $"vehicle-anchors-{Guid.NewGuid():N}.txt");
+
+        // The cache saves from the idle queue; a menu frame lets it run
+        private static void RunIdleSave(IdleWorkScheduler scheduler, string storePath)
+        {
+            scheduler.SetMenuOpen(true);
+            scheduler.OnFrame();
+
+            var stopwatch = Stopwatch.StartNew();
+            while (!File.Exists(storePath) && stopwatch.ElapsedMilliseconds < 2000) Thread.Sleep(5);
+            Assert.True(File.Exists(storePath), "the idle save never ran");
+        }
+
+        [Test]
+        public static void ModelIsInspectedOnceThenCached()
+        {
+            var inspector = new CountingInspector();
+            inspector.Models[(IntPtr)0x1000] = (0xA1B2C3D4, Car);
+            inspector.Models[(IntPtr)0x2000] = (0xA1B2C3D4, Car);
+            var scheduler = new IdleWorkScheduler { NoGCRegionBytes = 0 };
+            var cache = new VehicleAnchorCache("test", TemporaryStore(), scheduler);
+
+            Assert.True(cache.TryGetAnchor((IntPtr)0x1000, 0, inspector, out var first), "first entry");
+            Assert.Equal(1, inspector.Inspections, "inspections after the first entry");
+
+            // The same model again, here or in another vehicle of that model, is a cache hit
+            Assert.True(cache.TryGetAnchor((IntPtr)0x1000, 0, inspector, out var again), "second entry");
+            Assert.True(cache.TryGetAnchor((IntPtr)0x2000, 0, inspector, out var other), "same model elsewhere");
+            Assert.Equal(1, inspector.Inspections, "inspections after repeat entries");
+            Assert.Equal(first.SeatOffset, again.SeatOffset);
+            Assert.Equal(first.SeatOffset, other.SeatOffset);
+
+            // Each seat is its own anchor
+            Assert.True(cache.TryGetAnchor((IntPtr)0x1000, 1, inspector, out var passenger), "passenger seat");
+            Assert.Equal(2, inspector.Inspections, "inspections after another seat");
+            Assert.Equal(Car.SeatOffset.X + 1, passenger.SeatOffset.X);
+            Assert.Equal(2, cache.Count, "cached anchors");
+
+            // A model the inspector can't read isn't remembered, so it's tried again next time
+            Assert.True(!cache.TryGetAnchor((IntPtr)0x3000, 0, inspector, out _), "unknown model");
+            Assert.True(!cache.TryGetAnchor((IntPtr)0x3000, 0, inspector, out _), "unknown model again");
+            Assert.Equal(4, inspector.Inspections, "inspections after failures");
+            Assert.Equal(2, cache.Count, "cached anchors");
+
+            // One save covers every anchor learned so far
+            Assert.Equal(1, scheduler.PendingCount, "queued saves");
+        }
+
+        [Test]
+        public static void SavedAnchorsLoadInTheNextSession()
+        {
+            string store = TemporaryStore();
+            try
+            {
+                var inspector = new CountingInspector();
+                inspector.Models[(IntPtr)0x1000] = (0xA1B2C3D4, Car);
+                inspector.Models[(IntPtr)0x2000] = (0x0BADF00D, Bike);
+                var scheduler = new IdleWorkScheduler { NoGCRegionBytes = 0 };
+                var cache = new VehicleAnchorCache("test", store, scheduler);
+                cache.TryGetAnchor((IntPtr)0x1000, 0, inspector, out _);
+                cache.TryGetAnchor((IntPtr)0x1000, 2, inspector, out _);
+                cache.TryGetAnchor((IntPtr)0x2000, 0, inspector, out _);
+                RunIdleSave(scheduler, store);
+
+                // A new session knows every anchor without inspecting anything
+                var loaded = new VehicleAnchorCache("test", store, new IdleWorkScheduler { NoGCRegionBytes = 0 });
+                Assert.Equal(3, loaded.Count, "loaded anchors");
+
+                var known = new CountingInspector();
+                known.Models[(IntPtr)0x5000] = (0xA1B2C3D4, default);
+                known.Models[(IntPtr)0x6000] = (0x0BADF00D, default);
+                Assert.True(loaded.TryGetAnchor((IntPtr)0x5000, 2, known, out var car), "car from disk");
+                Assert.True(loaded.TryGetAnchor((IntPtr)0x6000, 0, known, out var bike), "bike from disk");
+                Assert.Equal(0, known.Inspections, "inspections in the new session");
+
+                // Floats survive the text round trip exactly
+                Assert.Equal(Car.VehicleType, car.VehicleType);
+                Assert.Equal(Car.ControlScheme, car.ControlScheme);
+                Assert.Equal(Car.SeatOffset + new Vector3(2, 0, 0), car.SeatOffset);
+                Assert.Equal(Car.SeatRotation, car.SeatRotation);
+                Assert.Equal(Bike.ControlScheme, bike.ControlScheme);
+                Assert.Equal(Bike.SeatOffset, bike.SeatOffset);
+            }
+            finally
+            {
+                File.Delete(store);
+            }
+        }
+
+        [Test]
+        public static void DamagedOrLockedStoreStartsEmpty()
+        {
+            string store = TemporaryStore();
+            try
+            {
+                // Bad lines are skipped, good ones kept
+                File.WriteAllLines(store, new[]
+                {
+                    "not an anchor",
+                    "00000000A1B2C3D4 1 Triggers 0 0 0 0 0 0",
+                    "00000000A1B2C3D4 1 Rudder 0 0 0 0 0 0 1",
+                    "00000000A1B2C3D4 1 Triggers 0 zero 0 0 0 0 1",
+                    "00000000A1B2C3D4 1 Triggers 0.5 1 0 0 0 0 1"
+                });
+                Assert.Equal(1, new VehicleAnchorCache("test", store).Count, "anchors from a damaged store");
+
+                // Held open exclusively, as by another instance mid-save: no anchors, and no exception
+                using (new FileStream(store, FileMode.Open, FileAccess.ReadWrite, FileShare.None))
+                {
+                    Assert.Equal(0, new VehicleAnchorCache("test", store).Count, "anchors from a locked store");
+                }
+            }
+            finally
+            {
+                File.Delete(store);
+            }
+        }
+
+        [Test]
+        public static unsafe void LayoutInspectorReadsModelAndSeat()
+        {
+            var layout = new VehicleLayout
+            {
+                ModelInfoOffset = 0x20,
+                ModelHashOffset = 0x18,
+                ClassOffset = 0x1C,
+                SeatCountOffset = 0x30,
+                SeatsOffset = 0x38,
+                SeatStride = 32,
+                SeatPositionOffset = 0,
+                SeatRotationOffset = 12,
+                Classes = new Dictionary<int, VehicleClassInfo>
+                {
+                    [8] = new VehicleClassInfo { VehicleType = 2, ControlScheme = VehicleControlScheme.Handlebars }
+                }
+            };
+
+            IntPtr vehicle = Marshal.AllocHGlobal(0x40);
+            IntPtr model = Marshal.AllocHGlobal(0x40);
+            IntPtr seats = Marshal.AllocHGlobal(2 * 32);
+            try
+            {
+                new Span<byte>((void*)vehicle, 0x40).Clear();
+                new Span<byte>((void*)model, 0x40).Clear();
+                new Span<byte>((void*)seats, 2 * 32).Clear();
+
+                *(IntPtr*)((byte*)vehicle + 0x20) = model;
+                *(uint*)((byte*)model + 0x18) = 0x0BADF00D;
+                *(int*)((byte*)model + 0x1C) = 8;
+                *(int*)((byte*)model + 0x30) = 2;
+                *(IntPtr*)((byte*)model + 0x38) = seats;
+                *(Vector3*)((byte*)seats + 32) = new Vector3(0, 0.9f, -0.6f);
+                *(Quaternion*)((byte*)seats + 32 + 12) = new Quaternion(0, 0, 0, 2);
+
+                var inspector = new VehicleLayoutInspector(layout);
+                Assert.Equal(0x0BADF00Du, inspector.GetModelHash(vehicle));
+
+                Assert.True(inspector.TryInspect(vehicle, 1, out var anchor), "pillion seat");
+                Assert.Equal(2, anchor.VehicleType);
+                Assert.Equal(VehicleControlScheme.Handlebars, anchor.ControlScheme);
+                Assert.Equal(new Vector3(0, 0.9f, -0.6f), anchor.SeatOffset);
+                Assert.Equal(Quaternion.Identity, anchor.SeatRotation);
+
+                // A zeroed rotation is no rotation
+                Assert.True(inspector.TryInspect(vehicle, 0, out anchor), "rider seat");
+                Assert.Equal(Quaternion.Identity, anchor.SeatRotation);
+
+                Assert.True(!inspector.TryInspect(vehicle, 2, out _), "seat past the model's count");
+                *(int*)((byte*)model + 0x1C) = 3;
+                Assert.True(!inspector.TryInspect(vehicle, 0, out _), "class the profile doesn't know");
+                Assert.True(!inspector.TryInspect(IntPtr.Zero, 0, out _), "no vehicle");
+            }
+            finally
+            {
+                Marshal.FreeHGlobal(seats);
+                Marshal.FreeHGlobal(model);
+                Marshal.FreeHGlobal(vehicle);
+            }
+        }
+    }
+}
@@ -0,0 +1,12 @@
+#!/bin/sh
+# Times the OpenXR frame loop without a headset: Monado's simulated HMD behind a headless (XR_MND_headless)
+# session, frames driven the way the present hook drives them. Needs Monado and the OpenXR loader installed;
+# MONADO_JSON overrides where Monado's runtime manifest is.
+set -e
+cd "$(dirname "$0")"
+
+export XR_RUNTIME_JSON="${MONADO_JSON:-/usr/share/openxr/1/openxr_monado.json}"
+export SIMULATED_ENABLE=1
+export AJSVRMOD_OPENXR_HEADLESS=1
+
+exec dotnet run -c Release -- OpenXRHeadless
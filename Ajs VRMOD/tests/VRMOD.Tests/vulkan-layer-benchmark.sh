@@ -0,0 +1,13 @@
+#!/bin/sh
+# Times the Vulkan layer's present on lavapipe with a headless swapchain: publishes the layer with NativeAOT,
+# then presents without it, with it, and with it capturing frames. Needs the Vulkan loader and Mesa's
+# lavapipe installed; LVP_ICD overrides where lavapipe's ICD manifest is.
+set -e
+cd "$(dirname "$0")"
+
+dotnet publish ../../src/VkLayer -c Release -r linux-x64 -o bin/vklayer
+
+export VK_LAYER_PATH="$(pwd)/bin/vklayer"
+export VK_ICD_FILENAMES="${LVP_ICD:-/usr/share/vulkan/icd.d/lvp_icd.x86_64.json}"
+
+exec dotnet run -c Release -- VulkanLayer
@@ -1,13 +1,30 @@
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Numerics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Threading;
+using VRGameConverter.Audio;
+using VRGameConverter.Diagnostics;
+using VRGameConverter.Events;
+using VRGameConverter.Hooking;
+using VRGameConverter.Ipc;
+using VRGameConverter.Output;
+using VRGameConverter.Rendering;
+using VRGameConverter.Scheduling;
+using VRGameConverter.Tracking;
+using VRGameConverter.VR;
+using VRGameConverter.Vulkan;
+using VRGameConverter.World;
 
 namespace VRGameConverter.OpenWorld
 {
     /// <summary>
     /// Specialized mapping system for complex open-world games
     /// </summary>
-    public class OpenWorldVRMapper
+    public class OpenWorldVRMapper : IDisposable
     {
         private GameProfile gameProfile;
         private CameraManager cameraManager;
@@ -16,11 +33,54 @@ namespace VRGameConverter.OpenWorld
         private VehicleHandler vehicleHandler;
         private CombatSystem combatSystem;
         private UIManager uiManager;
+        private AudioSystem audioSystem;
+        private RenderSystem renderSystem;
+        private BodySystem bodySystem;
+        
+        // Nearby entities, copied once per game tick for every subsystem to read
+        private EntityMirror entityMirror;
+        
+        // Link to GameProcessManager in the launcher process
+        private SharedMemoryChannel managerChannel;
+        
+        // Settings sweep in progress, if any; replaces live head tracking while it runs
+        private PerformanceBenchmark benchmark;
+        
+        // Where the benchmark's choice is kept between sessions
+        private RenderSettingsStore renderSettingsStore;
+        
+        // Adapts stereo mode and resolution to what the frame analyzer says is limiting us
+        private AdaptiveQualityController adaptiveQuality = new AdaptiveQualityController();
+        
+        // Virtual controller for the parts of the game we couldn't hook; null when every hook was found
+        private VirtualInputBackend virtualInput;
+        
+        // Reused each frame so filling it from the controllers doesn't allocate
+        private VRActionState actionState;
+        
+        // Head and controller tracking, once AttachVRInput is called; OpenXR comes up on the game's device
+        // after its first present
+        private VRInputManager vrInput;
+        private bool graphicsBindingResolved = false;
+        
+        // The Vulkan layer's end under Proton, looked for once a second until it turns up
+        private PresentLayerBridge presentLayer;
+        private PresentLayerBridge retiredPresentLayer;
+        private long presentLayerConnected;
+        private long nextPresentLayerAttempt = 0;
         
         public OpenWorldVRMapper(GameProfile profile)
         {
             this.gameProfile = profile;
             
+            // Settings an earlier benchmark chose for this game replace the profile's defaults
+            renderSettingsStore = new RenderSettingsStore(profile.GameName);
+            if (renderSettingsStore.Load(profile.RenderSettings))
+            {
+                Console.WriteLine($"Using benchmarked render settings: scale {profile.RenderSettings.ResolutionScale:F2}, " +
+                    $"foveation {profile.RenderSettings.FoveationLevel}, {profile.RenderSettings.StereoMode}");
+            }
+            
             // Initialize subsystems based on game type
             cameraManager = new CameraManager(profile.GameType);
             movementSystem = new MovementSystem(profile.GameType);
@@ -28,9 +88,55 @@ namespace VRGameConverter.OpenWorld
             vehicleHandler = new VehicleHandler(profile.GameType);
             combatSystem = new CombatSystem(profile.GameType);
             uiManager = new UIManager(profile.GameType);
+            audioSystem = new AudioSystem(profile.GameType);
+            renderSystem = new RenderSystem(profile.GameType);
+            bodySystem = new BodySystem(profile.GameType);
+            
+            // Controller pointing marches against the depth the render hooks capture
+            interactionSystem.SetDepthSource(renderSystem);
+            
+            entityMirror = new EntityMirror(profile.EntityPoolLayout);
+            interactionSystem.SetEntitySource(entityMirror);
+            vehicleHandler.SetEntitySource(entityMirror);
+            combatSystem.SetEntitySource(entityMirror);
+            
+            // Seat anchors for models the cache hasn't seen, read through the profile's vehicle layout
+            if (profile.VehicleLayout.IsConfigured)
+            {
+                vehicleHandler.VehicleInspector = new VehicleLayoutInspector(profile.VehicleLayout);
+            }
+            
+            // We run inside the game, so the channel is keyed by our own process id
+            managerChannel = new SharedMemoryChannel(Environment.ProcessId, ChannelSide.Game);
+        }
+        
+        public void Dispose()
+        {
+            // Subsystems that subscribed to the event bus or run threads of their own
+            cameraManager.Dispose();
+            movementSystem.Dispose();
+            virtualInput?.Dispose();
+            managerChannel.Dispose();
+            renderSystem.Dispose();
+            
+            // The present hook outlives us, so it lets go of the runtime and the layer before they're shut down
+            renderSystem.RuntimeFrames = null;
+            vrInput?.Dispose();
+            
+            renderSystem.PresentLayer = null;
+            presentLayer?.Dispose();
+            retiredPresentLayer?.Dispose();
         }
         
         public void Initialize()
+        {
+            ConfigureSubsystems();
+            
+            // Memory scanning to find critical game functions
+            ScanGameMemoryForHooks();
+        }
+        
+        private void ConfigureSubsystems()
         {
             // Configure each system
             cameraManager.Configure(gameProfile.CameraSettings);
@@ -38,14 +144,23 @@ namespace VRGameConverter.OpenWorld
             interactionSystem.Configure(gameProfile.InteractionSettings);
             vehicleHandler.Configure(gameProfile.VehicleSettings);
             combatSystem.Configure(gameProfile.CombatSettings);
+            movementSystem.ConfigureTriggerPrediction(gameProfile.TriggerPrediction);
+            combatSystem.ConfigureTriggerPrediction(gameProfile.TriggerPrediction);
             uiManager.Configure(gameProfile.UISettings);
+            audioSystem.Configure(gameProfile.AudioSettings);
+            renderSystem.RequestConfigure(gameProfile.RenderSettings);
+            bodySystem.Configure(gameProfile.BodySettings);
             
-            // Memory scanning to find critical game functions
-            ScanGameMemoryForHooks();
+            // Before any of our threads start, so each one lands on the cores meant for it
+            ThreadPlacementManager.Shared.Configure(gameProfile.ThreadPlacement);
         }
         
         private void ScanGameMemoryForHooks()
         {
+            // Scanning is throughput work; keep it off the cores the game and tracking need. Held to the end of
+            // the method: what follows only picks fallbacks from the scan results.
+            using var scanPlacement = ThreadPlacementManager.Shared.Enter(ThreadRole.Scanning);
+            
             // Scan game memory to find key functions and data structures
             var scanner = new MemoryScanner(gameProfile.ExecutablePath);
             
@@ -72,10 +187,61 @@ namespace VRGameConverter.OpenWorld
             // Scan for UI rendering functions
             var uiFunctions = scanner.FindFunctions(gameProfile.UISignatures);
             uiManager.SetHookTargets(uiFunctions);
+            
+            // Scan for the audio render client the game submits its mix through
+            var audioFunctions = scanner.FindFunctions(gameProfile.AudioSignatures);
+            audioSystem.SetHookTargets(audioFunctions);
+            
+            // Scan for frame submission (present and per-eye scene pass)
+            var renderFunctions = scanner.FindFunctions(gameProfile.RenderSignatures);
+            renderSystem.SetHookTargets(renderFunctions);
+            
+            // Scan for the skeleton update the first-person body is animated in
+            var bodyFunctions = scanner.FindFunctions(gameProfile.BodySignatures);
+            bodySystem.SetHookTargets(bodyFunctions);
+            
+            // Scan for the entity pool tick the world mirror copies from
+            var worldFunctions = scanner.FindFunctions(gameProfile.WorldSignatures);
+            entityMirror.SetHookTargets(worldFunctions);
+            
+            // Whatever we couldn't hook is driven through a virtual controller instead
+            var fallbackGroups = ActionGroup.None;
+            if (IsMissingHooks(movementFunctions)) fallbackGroups |= ActionGroup.Movement;
+            if (IsMissingHooks(cameraFunctions)) fallbackGroups |= ActionGroup.Camera;
+            if (IsMissingHooks(combatFunctions)) fallbackGroups |= ActionGroup.Combat;
+            if (IsMissingHooks(uiFunctions)) fallbackGroups |= ActionGroup.Menu;
+            if (gameProfile.VehicleSignatures.Count > 0 && IsMissingHooks(vehicleFunctions)) fallbackGroups |= ActionGroup.Vehicle;
+            
+            if (fallbackGroups != ActionGroup.None)
+            {
+                try
+                {
+                    virtualInput = new VirtualInputBackend(fallbackGroups);
+                    Console.WriteLine($"Virtual controller fallback for: {fallbackGroups}");
+                }
+                catch (InvalidOperationException ex)
+                {
+                    Console.WriteLine($"Virtual controller fallback unavailable: {ex.Message}");
+                }
+            }
+        }
+        
+        private static bool IsMissingHooks(Dictionary<string, IntPtr> functions)
+        {
+            if (functions.Count == 0) return true;
+            
+            foreach (var function in functions.Values)
+            {
+                if (function == IntPtr.Zero) return true;
+            }
+            return false;
         }
         
         public void Start()
         {
+            // Compile and exercise hot paths while the game is still loading, before any hook can fire
+            WarmUp();
+            
             // Activate all subsystems
             cameraManager.Activate();
             movementSystem.Activate();
@@ -83,24 +249,336 @@ namespace VRGameConverter.OpenWorld
             vehicleHandler.Activate();
             combatSystem.Activate();
             uiManager.Activate();
+            audioSystem.Activate();
+            renderSystem.Activate();
+            bodySystem.Activate();
+            entityMirror.Activate();
+            
+            // Install cost of every hook set up during activation
+            HookBenchmark.Report(HookEngine.Shared);
+        }
+        
+        /// <summary>
+        /// JIT every subsystem and kernel up front and run the update paths with synthetic input,
+        /// so the first frames in game cost the same as steady state
+        /// </summary>
+        private void WarmUp()
+        {
+            var stopwatch = Stopwatch.StartNew();
+            
+            var hotTypes = new[]
+            {
+                typeof(OpenWorldVRMapper), typeof(CameraManager), typeof(MovementSystem), typeof(InteractionSystem),
+                typeof(VehicleHandler), typeof(CombatSystem), typeof(UIManager), typeof(AudioSystem), typeof(RenderSystem), typeof(BodySystem),
+                typeof(HookEngine), typeof(SharedMemoryChannel), typeof(SpscRingBuffer), typeof(IdleWorkScheduler),
+                typeof(HrtfSpatializer), typeof(PartitionedConvolver), typeof(Fft), typeof(DepthPyramid), typeof(SpaceWarp), typeof(SpaceWarpPipeline),
+                typeof(PoseLatch), typeof(FrameAnalyzer), typeof(VirtualInputBackend), typeof(GamepadActionMap), typeof(ChainIkSolver),
+                typeof(EntityMirror), typeof(EntitySnapshot)
+            };
+            
+            int prepared = 0;
+            foreach (var type in hotTypes)
+            {
+                prepared += HotPathWarmup.PrepareType(type);
+            }
+            
+            // Standing at eye height, controllers idle: exercises every branch that runs without input
+            var head = new HeadPose { Position = new Vector3(0, 1.7f, 0), Rotation = Quaternion.Identity };
+            var idle = new ControllerState();
+            var updateTiming = HotPathWarmup.Run("subsystem update", () =>
+            {
+                cameraManager.Update(head);
+                movementSystem.Update(head, idle, idle);
+                interactionSystem.Update(head, idle, idle);
+                vehicleHandler.Update(head, idle, idle);
+                combatSystem.Update(head, idle, idle);
+                bodySystem.Update(head, idle, idle);
+                uiManager.Update(head);
+                cameraManager.ToCameraSpace(head);
+            });
+            
+            var noActions = new VRActionState();
+            var actionTiming = HotPathWarmup.Run("action mapping", () => virtualInput?.Update(noActions));
+            var audioTiming = audioSystem.WarmUp();
+            var renderTiming = renderSystem.WarmUp();
+            var bodyTiming = bodySystem.WarmUp();
+            
+            Console.WriteLine($"Warm-up: {prepared} methods compiled in {stopwatch.ElapsedMilliseconds} ms");
+            Console.WriteLine($"Warm-up: {updateTiming}; {actionTiming}; {audioTiming}; {renderTiming}; {bodyTiming}");
         }
         
         public void Update(HeadPose headPose, ControllerState leftController, ControllerState rightController)
         {
+            // Apply anything the manager app asked for since last frame
+            ProcessManagerCommands(headPose);
+            
+            // The game has presented: its swap chain leads to the device OpenXR has to share. Done here, between
+            // frames on the game thread, because it swaps the runtime under VRInputManager.
+            if (vrInput != null && !graphicsBindingResolved && renderSystem.SwapChain != IntPtr.Zero)
+            {
+                graphicsBindingResolved = true;
+                vrInput.SetGraphicsBinding(OpenXRGraphicsBinding.FromSwapChain(renderSystem.SwapChain));
+            }
+            
+            ConnectPresentLayer();
+            
+            if (benchmark != null)
+            {
+                headPose = UpdateBenchmark(headPose);
+            }
+            
+            // The controllers' mapped actions reach the virtual device as one batch per frame
+            if (vrInput != null && virtualInput != null)
+            {
+                vrInput.FillActionState(ref actionState);
+                UpdateActions(actionState);
+            }
+            
             // Update all subsystems with the latest VR input
             cameraManager.Update(headPose);
             movementSystem.Update(headPose, leftController, rightController);
             interactionSystem.Update(headPose, leftController, rightController);
             vehicleHandler.Update(headPose, leftController, rightController);
             combatSystem.Update(headPose, leftController, rightController);
+            bodySystem.FirstPerson = cameraManager.IsFirstPerson;
+            if (vrInput != null)
+            {
+                PollBodyTracker(TrackedDeviceRole.Waist);
+                PollBodyTracker(TrackedDeviceRole.LeftFoot);
+                PollBodyTracker(TrackedDeviceRole.RightFoot);
+            }
+            bodySystem.Update(headPose, leftController, rightController);
             uiManager.Update(headPose);
+            audioSystem.Update(headPose);
+            renderSystem.Update(headPose);
+            
+            if (FrameAnalyzer.Shared.TryTakeSummary(out var frameSummary))
+            {
+                PublishFrameSummary(frameSummary);
+                
+                // The benchmark owns the settings while it runs
+                if (benchmark == null && adaptiveQuality.Adapt(frameSummary, gameProfile.RenderSettings))
+                {
+                    renderSystem.RequestConfigure(gameProfile.RenderSettings);
+                }
+            }
+            
+            if (renderSystem.PoseLatch != null)
+            {
+                managerChannel.PublishTelemetry(TelemetryMetric.LatchErrorDegrees,
+                    (float)renderSystem.PoseLatch.LastRotationErrorDegrees, Stopwatch.GetTimestamp());
+            }
+            
+            // Maintenance only runs in loading screens and menus
+            IdleWorkScheduler.Shared.OnFrame();
+        }
+        
+        private void ProcessManagerCommands(HeadPose headPose)
+        {
+            while (managerChannel.TryReadCommand(out var command))
+            {
+                switch (command)
+                {
+                    case IpcCommand.TogglePerspective:
+                        cameraManager.TogglePerspective();
+                        break;
+                    case IpcCommand.Recalibrate:
+                        cameraManager.Recenter(headPose);
+                        break;
+                    case IpcCommand.ReloadBindings:
+                        ConfigureSubsystems();
+                        break;
+                    case IpcCommand.RunBenchmark:
+                        StartBenchmark();
+                        break;
+                }
+                
+                managerChannel.Log($"Handled command {command}");
+            }
+        }
+        
+        /// <summary>
+        /// Mapped controller actions for this frame. Only reaches the game through the virtual controller
+        /// for action groups whose hooks weren't found. Update already feeds it from the attached VRInputManager.
+        /// </summary>
+        public void UpdateActions(in VRActionState actions)
+        {
+            virtualInput?.Update(actions);
+        }
+        
+        /// <summary>
+        /// Waist and feet trackers for the first-person body; pass tracked = false when one loses tracking
+        /// </summary>
+        public void UpdateBodyTracker(TrackedDeviceRole role, HeadPose pose, bool tracked)
+        {
+            bodySystem.SetTracker(role, pose, tracked);
+        }
+        
+        // A tracker that loses tracking drops out of VRInputManager's batch, and the body goes back to estimating it
+        private void PollBodyTracker(TrackedDeviceRole role)
+        {
+            bool tracked = vrInput.TryGetTrackerPose(role, out var pose);
+            bodySystem.SetTracker(role, pose, tracked);
+        }
+        
+        /// <summary>
+        /// Under Proton on Vulkan, the layer's timings replace the DXGI hook's, and its captured frames become the
+        /// space warp colour source when the backend has no readback of its own. A channel that goes quiet (or
+        /// never speaks: one left from an earlier run) is dropped and looked for again.
+        /// </summary>
+        private void ConnectPresentLayer()
+        {
+            long now = Stopwatch.GetTimestamp();
+            if (now < nextPresentLayerAttempt) return;
+            nextPresentLayerAttempt = now + Stopwatch.Frequency;
+            
+            // Dropped a second ago, so no present can still be draining it
+            retiredPresentLayer?.Dispose();
+            retiredPresentLayer = null;
+            
+            if (presentLayer != null)
+            {
+                bool quiet = presentLayer.PresentsReceived > 0
+                    ? !presentLayer.Live
+                    : now - presentLayerConnected > 5 * Stopwatch.Frequency;
+                if (!quiet) return;
+                
+                renderSystem.PresentLayer = null;
+                retiredPresentLayer = presentLayer;
+                presentLayer = null;
+                return;
+            }
+            
+            presentLayer = PresentLayerBridge.TryConnect();
+            if (presentLayer == null) return;
+            
+            presentLayerConnected = now;
+            renderSystem.PresentLayer = presentLayer;
+            if (renderSystem.MotionReadback == null)
+            {
+                renderSystem.MotionReadback = new PresentLayerReadback();
+                Console.WriteLine("Vulkan layer found: using its present timings and captured frames");
+            }
+        }
+        
+        private void PublishFrameSummary(FrameSummary summary)
+        {
+            long timestamp = Stopwatch.GetTimestamp();
+            managerChannel.PublishTelemetry(TelemetryMetric.FrameTimeMs, (float)summary.MeanFrameMilliseconds, timestamp);
+            managerChannel.PublishTelemetry(TelemetryMetric.P95FrameTimeMs, (float)summary.P95FrameMilliseconds, timestamp);
+            managerChannel.PublishTelemetry(TelemetryMetric.GameCpuMs, (float)summary.MeanGameCpuMilliseconds, timestamp);
+            managerChannel.PublishTelemetry(TelemetryMetric.HookTimeMs, (float)summary.MeanHookMilliseconds, timestamp);
+            managerChannel.PublishTelemetry(TelemetryMetric.GpuWaitMs, (float)summary.MeanGpuMilliseconds, timestamp);
+            managerChannel.PublishTelemetry(TelemetryMetric.CompositorMs, (float)summary.MeanCompositorMilliseconds, timestamp);
+            managerChannel.PublishTelemetry(TelemetryMetric.MissedFrames, summary.MissedFrames, timestamp);
+            managerChannel.PublishTelemetry(TelemetryMetric.Bottleneck, (float)summary.Bottleneck, timestamp);
+            managerChannel.PublishTelemetry(TelemetryMetric.TriggerLeadMs, (float)combatSystem.TriggerLeadMilliseconds, timestamp);
+            managerChannel.PublishTelemetry(TelemetryMetric.TriggerFalsePositives, combatSystem.TriggerFalsePositives, timestamp);
+        }
+        
+        /// <summary>
+        /// Feed physical walking into the character's movement. The sampler is polled on a separate
+        /// thread at tracking rate and must return the head in play space.
+        /// </summary>
+        public void EnableRoomscale(Func<HeadPose> sampler, int sampleRateHz = 500)
+        {
+            movementSystem.Roomscale?.Dispose();
+            movementSystem.RoomscaleHeading = cameraManager.PlaySpaceHeading;
+            movementSystem.Roomscale = new RoomscaleIntegrator(sampler, sampleRateHz);
+        }
+        
+        /// <summary>
+        /// Connect the VR runtime to the render path: late latching against its predicted display times, its frame
+        /// loop driven from the present hook, and space warp when a sink is given (the backend sets
+        /// RenderSystem.MotionReadback first). OpenXR itself starts once the game has presented, on the game's
+        /// device; until then the runtime Configure found without one is used.
+        /// </summary>
+        public void AttachVRInput(VRInputManager vrInput, ICameraConstantsWriter cameraConstantsWriter, ISynthesizedFrameSink spaceWarpSink = null)
+        {
+            this.vrInput = vrInput;
+            renderSystem.RuntimeFrames = vrInput;
+            EnableLateLatching(vrInput.SampleGameSpaceHead, cameraConstantsWriter, vrInput);
+            
+            if (spaceWarpSink != null && renderSystem.MotionReadback != null)
+            {
+                EnableSpaceWarp(renderSystem.MotionReadback, spaceWarpSink, vrInput);
+            }
+        }
+        
+        /// <summary>
+        /// Re-sample the head pose at the scene-submit hook instead of using the one passed to Update.
+        /// The sampler must be safe to call from the game's render thread. Runtimes with their own frame
+        /// loop (OpenXR) pass it as displayTimes so prediction targets the runtime's display time.
+        /// </summary>
+        public void EnableLateLatching(Func<HeadPose> sampler, ICameraConstantsWriter cameraConstantsWriter, IDisplayTimeSource displayTimes = null)
+        {
+            var latch = new PoseLatch(sampler) { DisplayTimes = displayTimes };
+            renderSystem.PoseLatch = latch;
+            renderSystem.AddPreScenePass(new LateLatchPass(latch, cameraConstantsWriter, cameraManager.ToCameraSpace));
+        }
+        
+        /// <summary>
+        /// Fill in the headset frames the game misses with frames extrapolated along its motion. The backend
+        /// provides the readbacks (RenderSystem.MotionReadback) and the sink; runtimes with their own frame
+        /// loop pass displayTimes so frames are synthesized for the runtime's display times.
+        /// </summary>
+        public void EnableSpaceWarp(IMotionReadback motionReadback, ISynthesizedFrameSink sink, IDisplayTimeSource displayTimes = null)
+        {
+            renderSystem.MotionReadback = motionReadback;
+            renderSystem.EnableSpaceWarp(sink, displayTimes);
+        }
+        
+        /// <summary>
+        /// Replay a pose path while sweeping render settings, then keep the best combination in the profile
+        /// and save it for later sessions. Started by the manager app (GameProcessManager.RunBenchmark).
+        /// </summary>
+        public void StartBenchmark()
+        {
+            if (benchmark != null) return;
+            
+            var settings = gameProfile.RenderSettings;
+            var path = string.IsNullOrEmpty(settings.BenchmarkPosePath)
+                ? PosePath.CreateLookAround()
+                : PosePath.Load(settings.BenchmarkPosePath);
+            
+            benchmark = new PerformanceBenchmark(path, settings.HeadsetRefreshRate);
+            renderSystem.Benchmark = benchmark;
+            managerChannel.Log($"Benchmark started: {benchmark.Candidates.Count} settings combinations");
+        }
+        
+        private HeadPose UpdateBenchmark(HeadPose livePose)
+        {
+            var settings = gameProfile.RenderSettings;
+            if (benchmark.Advance(settings))
+            {
+                renderSystem.RequestConfigure(settings);
+            }
+            
+            if (benchmark.IsComplete)
+            {
+                // The winning combination is already written into the profile's render settings
+                foreach (var candidate in benchmark.Candidates)
+                {
+                    Console.WriteLine($"Benchmark: {candidate}");
+                }
+                managerChannel.Log($"Benchmark chose {benchmark.Best}");
+                
+                // Saved right away: a small one-off write, and the game may be closed before the next menu
+                renderSettingsStore.Save(settings);
+                
+                renderSystem.Benchmark = null;
+                benchmark = null;
+                return livePose;
+            }
+            
+            return benchmark.CurrentPose();
         }
     }
     
     /// <summary>
     /// Manages camera conversion from third-person to first-person VR
     /// </summary>
-    public class CameraManager
+    public class CameraManager : IDisposable
     {
         private GameType gameType;
         private CameraSettings settings;
@@ -109,8 +587,22 @@ namespace VRGameConverter.OpenWorld
         
         // Special settings for different perspective modes
         private bool isFirstPerson = false;
+        public bool IsFirstPerson => isFirstPerson;
         private Vector3 thirdPersonOffset = new Vector3(0, 1.7f, -0.5f);
         
+        // Yaw correction captured when the user recenters
+        private Quaternion recenterRotation = Quaternion.Identity;
+        
+        // Which way the camera rig faces in the game world; game thread only
+        private Quaternion rigHeading = Quaternion.Identity;
+        
+        // Vehicle transitions published by VehicleHandler's hooks
+        private EventQueue<VehicleEnteredEvent> vehicleEntered = EventBus.Subscribe<VehicleEnteredEvent>();
+        private EventQueue<VehicleExitedEvent> vehicleExited = EventBus.Subscribe<VehicleExitedEvent>();
+        private Vector3 vehicleSeatOffset = Vector3.Zero;
+        private Quaternion vehicleSeatRotation = Quaternion.Identity;
+        private volatile bool toggleRequested = false;
+        
         public CameraManager(GameType gameType)
         {
             this.gameType = gameType;
@@ -171,20 +663,37 @@ namespace VRGameConverter.OpenWorld
         
         private void InstallHook(IntPtr targetFunction, Delegate hookFunction)
         {
-            // Implementation would use a library like EasyHook to install function hooks
-            Console.WriteLine($"Installing hook at {targetFunction} with function {hookFunction.Method.Name}");
+            // Hot-patch install so hooks added mid-session don't stall the game
+            HookEngine.Shared.InstallHook(targetFunction, hookFunction);
         }
         
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
         private void UpdateCameraHook(IntPtr gameCamera, float deltaTime)
         {
             // This would be called instead of the game's camera update function
             // We would modify the camera parameters for VR
             
+            long start = Stopwatch.GetTimestamp();
+            
+            // The camera only ticks during gameplay, which tells the scheduler we're not loading
+            IdleWorkScheduler.Shared.NotifyGameplayTick();
+            
+            if (toggleRequested)
+            {
+                toggleRequested = false;
+                isFirstPerson = !isFirstPerson;
+                EventBus.Publish(new CameraModeChangedEvent { Timestamp = Stopwatch.GetTimestamp(), FirstPerson = isFirstPerson, GameMode = -1 });
+            }
+            
+            // Orientation set here is provisional: when late latching is enabled, LateLatchPass overwrites the
+            // camera constants with a fresher pose right before the scene pass
+            
             // Example implementation (pseudocode):
             if (isFirstPerson)
             {
                 // In first-person mode, directly use the HMD orientation
                 // gameCamera->orientation = headPose.Rotation;
+                rigHeading = Quaternion.Identity;
             }
             else
             {
@@ -194,7 +703,10 @@ namespace VRGameConverter.OpenWorld
                 
                 // Orient based on a combination of character direction and HMD rotation
                 // gameCamera->orientation = characterOrientation * headPose.Rotation;
+                // rigHeading = RoomscaleIntegrator.Yaw(characterOrientation);
             }
+            
+            FrameAnalyzer.Shared.AddHookTime(start);
         }
         
         private void SetCameraModeHook(IntPtr gameCamera, int mode)
@@ -203,6 +715,7 @@ namespace VRGameConverter.OpenWorld
             // mode: 0 = third-person, 1 = first-person, etc. (game-specific)
             
             isFirstPerson = (mode == 1);
+            EventBus.Publish(new CameraModeChangedEvent { Timestamp = Stopwatch.GetTimestamp(), FirstPerson = isFirstPerson, GameMode = mode });
             
             // Call original function or apply our own camera mode
             // originalSetCameraMode(gameCamera, mode);
@@ -213,20 +726,84 @@ namespace VRGameConverter.OpenWorld
             // Update camera based on head tracking
             // This is called from our main update loop
             
+            // Vehicle hooks fire on the game thread; pick up what happened since last frame
+            while (vehicleEntered.TryDequeue(out var entered))
+            {
+                AdjustCameraForVehicle(entered);
+            }
+            while (vehicleExited.TryDequeue(out _))
+            {
+                ResetCameraPosition();
+            }
+            
             // Implementation will depend on the specific game and how we're hooking into it
         }
         
+        private void AdjustCameraForVehicle(in VehicleEnteredEvent entered)
+        {
+            // Seat the camera at the cached eye point for this model and seat; without one the game's
+            // own vehicle camera stays in charge
+            if (entered.HasAnchor)
+            {
+                vehicleSeatOffset = entered.SeatOffset;
+                vehicleSeatRotation = entered.SeatRotation;
+                // gameCamera->attachment = entered.Vehicle; gameCamera->offset = vehicleSeatOffset;
+            }
+        }
+        
+        private void ResetCameraPosition()
+        {
+            // Back to following the character
+            // gameCamera->attachment = character head;
+        }
+        
         public void TogglePerspective()
         {
-            // Toggle between first and third person
-            isFirstPerson = !isFirstPerson;
+            // Toggle between first and third person on the next camera tick, so mode changes are only
+            // ever published from the game thread
+            toggleRequested = true;
+        }
+        
+        public void Recenter(HeadPose headPose)
+        {
+            // Make the current head yaw the new forward direction
+            Vector3 forward = Vector3.Transform(-Vector3.UnitZ, headPose.Rotation);
+            float yaw = MathF.Atan2(-forward.X, -forward.Z);
+            recenterRotation = Quaternion.CreateFromAxisAngle(Vector3.UnitY, -yaw);
+        }
+        
+        /// <summary>
+        /// Tracking-space head pose to the pose the game camera should take, with recentering applied
+        /// </summary>
+        public HeadPose ToCameraSpace(HeadPose headPose)
+        {
+            return new HeadPose
+            {
+                Position = Vector3.Transform(headPose.Position, recenterRotation),
+                Rotation = recenterRotation * headPose.Rotation
+            };
+        }
+        
+        /// <summary>
+        /// Rotation from play space to the game world's heading: recentering, then the way the rig faces.
+        /// Game thread only.
+        /// </summary>
+        public Quaternion PlaySpaceHeading()
+        {
+            return rigHeading * recenterRotation;
+        }
+        
+        public void Dispose()
+        {
+            EventBus.Unsubscribe(vehicleEntered);
+            EventBus.Unsubscribe(vehicleExited);
         }
     }
     
     /// <summary>
     /// Handles character movement conversion for VR
     /// </summary>
-    public class MovementSystem
+    public class MovementSystem : IDisposable
     {
         private GameType gameType;
         private MovementSettings settings;
@@ -244,6 +821,22 @@ namespace VRGameConverter.OpenWorld
         private bool isSwinging = false;
         private bool isGliding = false;
         
+        // Jump fires from trigger pull velocity rather than the runtime's click point
+        private TriggerPredictor jumpTrigger = new TriggerPredictor(new TriggerPredictionSettings());
+        
+        // Physical walking accumulated at tracking rate; null unless roomscale is enabled
+        public RoomscaleIntegrator Roomscale { get; set; }
+        
+        // Play space to game heading, read on the game thread each movement tick; identity when unset
+        public Func<Quaternion> RoomscaleHeading { get; set; }
+        
+        // Camera and vehicle state changes published by the other subsystems' hooks
+        private EventQueue<CameraModeChangedEvent> cameraModeChanged = EventBus.Subscribe<CameraModeChangedEvent>();
+        private EventQueue<VehicleEnteredEvent> vehicleEntered = EventBus.Subscribe<VehicleEnteredEvent>();
+        private EventQueue<VehicleExitedEvent> vehicleExited = EventBus.Subscribe<VehicleExitedEvent>();
+        private bool isFirstPerson = false;
+        private bool isInVehicle = false;
+        
         public MovementSystem(GameType gameType)
         {
             this.gameType = gameType;
@@ -254,6 +847,11 @@ namespace VRGameConverter.OpenWorld
             this.settings = settings;
         }
         
+        public void ConfigureTriggerPrediction(TriggerPredictionSettings settings)
+        {
+            jumpTrigger.Configure(settings);
+        }
+        
         public void SetHookTargets(Dictionary<string, IntPtr> targets)
         {
             this.hookTargets = targets;
@@ -290,10 +888,11 @@ namespace VRGameConverter.OpenWorld
         
         private void InstallHook(IntPtr targetFunction, Delegate hookFunction)
         {
-            // Implementation would use a library like EasyHook
-            Console.WriteLine($"Installing hook at {targetFunction} with function {hookFunction.Method.Name}");
+            // Hot-patch install so hooks added mid-session don't stall the game
+            HookEngine.Shared.InstallHook(targetFunction, hookFunction);
         }
         
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
         private void UpdateMovementHook(IntPtr character, Vector3 direction, float speed)
         {
             // Called instead of the game's character movement function
@@ -302,11 +901,21 @@ namespace VRGameConverter.OpenWorld
             // character->moveDirection = movementDirection;
             // character->moveSpeed = isSprinting ? settings.SprintSpeed : settings.WalkSpeed;
             
+            // Walking in the room since the previous tick, taken exactly once; moves the character directly
+            // rather than through its speed, so it isn't scaled by the game's tick length
+            if (Roomscale != null)
+            {
+                Quaternion heading = RoomscaleHeading != null ? RoomscaleHeading() : Quaternion.Identity;
+                Vector3 walked = Roomscale.TakeDelta(heading);
+                // character->position += walked;
+            }
+            
             // Apply jumping/crouching if active
             // if (isJumping) character->Jump();
             // if (isCrouching) character->Crouch();
         }
         
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
         private void WebSwingHook(IntPtr character, Vector3 direction, float speed)
         {
             // Special handler for Spider-Man web swinging
@@ -318,6 +927,7 @@ namespace VRGameConverter.OpenWorld
             }
         }
         
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
         private void BroomFlightHook(IntPtr character, Vector3 direction, float speed)
         {
             // Special handler for Hogwarts Legacy broom flight
@@ -326,6 +936,27 @@ namespace VRGameConverter.OpenWorld
         
         public void Update(HeadPose headPose, ControllerState leftController, ControllerState rightController)
         {
+            while (cameraModeChanged.TryDequeue(out var modeChange))
+            {
+                isFirstPerson = modeChange.FirstPerson;
+            }
+            while (vehicleEntered.TryDequeue(out _))
+            {
+                isInVehicle = true;
+            }
+            while (vehicleExited.TryDequeue(out _))
+            {
+                isInVehicle = false;
+            }
+            
+            // In a vehicle the sticks and triggers belong to VehicleHandler
+            if (isInVehicle)
+            {
+                movementDirection = Vector3.Zero;
+                isSprinting = isJumping = isCrouching = false;
+                return;
+            }
+            
             // Map VR controller input to character movement
             
             // Get movement direction from left thumbstick
@@ -339,7 +970,11 @@ namespace VRGameConverter.OpenWorld
             if (movementDirection != Vector3.Zero)
             {
                 movementDirection = Vector3.Normalize(movementDirection);
-                
+            }
+            
+            // In third person the game already moves relative to its orbiting camera
+            if (movementDirection != Vector3.Zero && isFirstPerson)
+            {
                 // Rotate movement direction based on head rotation (but only yaw component)
                 Quaternion headYaw = ExtractYawRotation(headPose.Rotation);
                 movementDirection = Vector3.Transform(movementDirection, headYaw);
@@ -347,7 +982,8 @@ namespace VRGameConverter.OpenWorld
             
             // Map other controller inputs to movement actions
             isSprinting = leftController.ThumbstickPressed;
-            isJumping = rightController.TriggerPressed;
+            isJumping = jumpTrigger.Update(rightController.TriggerValue, Stopwatch.GetTimestamp() / (double)Stopwatch.Frequency)
+                || rightController.TriggerPressed;
             isCrouching = rightController.GripPressed;
             
             // Special movement for specific games
@@ -357,6 +993,15 @@ namespace VRGameConverter.OpenWorld
             }
         }
         
+        public void Dispose()
+        {
+            EventBus.Unsubscribe(cameraModeChanged);
+            EventBus.Unsubscribe(vehicleEntered);
+            EventBus.Unsubscribe(vehicleExited);
+            Roomscale?.Dispose();
+            Roomscale = null;
+        }
+        
         private Quaternion ExtractYawRotation(Quaternion rotation)
         {
             // Extract just the yaw component (rotation around Y axis) from a quaternion
@@ -396,6 +1041,19 @@ namespace VRGameConverter.OpenWorld
         private Dictionary<string, IntPtr> hookTargets;
         private bool isActive = false;
         
+        // Pointing is resolved against the captured depth buffer rather than engine collision
+        private RenderSystem depthSource;
+        private const float MaxPointingDistance = 100.0f;
+        
+        // Surfaces the controllers pointed at this frame
+        public DepthHit LeftPointTarget { get; private set; }
+        public DepthHit RightPointTarget { get; private set; }
+        
+        // Objects the controllers pointed at this frame, from the world mirror; zero when none
+        private EntityMirror entitySource;
+        public IntPtr LeftPointedEntity { get; private set; }
+        public IntPtr RightPointedEntity { get; private set; }
+        
         public InteractionSystem(GameType gameType)
         {
             this.gameType = gameType;
@@ -411,6 +1069,16 @@ namespace VRGameConverter.OpenWorld
             this.hookTargets = targets;
         }
         
+        public void SetDepthSource(RenderSystem renderSystem)
+        {
+            this.depthSource = renderSystem;
+        }
+        
+        public void SetEntitySource(EntityMirror mirror)
+        {
+            this.entitySource = mirror;
+        }
+        
         public void Activate()
         {
             if (isActive) return;
@@ -426,7 +1094,8 @@ namespace VRGameConverter.OpenWorld
         
         private void InstallHook(IntPtr targetFunction, Delegate hookFunction)
         {
-            // Implementation using hooking library
+            // Hot-patch install so hooks added mid-session don't stall the game
+            HookEngine.Shared.InstallHook(targetFunction, hookFunction);
         }
         
         private void InteractionHook(IntPtr character, IntPtr targetObject)
@@ -444,8 +1113,14 @@ namespace VRGameConverter.OpenWorld
             // Handle interaction inputs from controllers
             
             // Ray casting from controllers for pointing-based interaction
-            var leftRay = CalculateRayFromController(headPose, "left");
-            var rightRay = CalculateRayFromController(headPose, "right");
+            var leftRay = CalculateRayFromController(leftController);
+            var rightRay = CalculateRayFromController(rightController);
+            
+            LeftPointTarget = FindPointedSurface(leftRay);
+            RightPointTarget = FindPointedSurface(rightRay);
+            
+            LeftPointedEntity = entitySource != null ? FindPointedEntity(leftRay) : IntPtr.Zero;
+            RightPointedEntity = entitySource != null ? FindPointedEntity(rightRay) : IntPtr.Zero;
             
             // Check for interactions
             bool leftInteracting = leftController.TriggerPressed;
@@ -464,13 +1139,37 @@ namespace VRGameConverter.OpenWorld
             }
         }
         
-        private Ray CalculateRayFromController(HeadPose headPose, string controller)
+        private Ray CalculateRayFromController(ControllerState controller)
+        {
+            // Ray from the controller along its forward axis; VRInputManager gives hands the same game space as the head
+            return new Ray
+            {
+                Origin = controller.Position,
+                Direction = Vector3.Transform(-Vector3.UnitZ, controller.Rotation)
+            };
+        }
+        
+        private IntPtr FindPointedEntity(Ray ray)
+        {
+            // Pickups win over props; both need to be within arm's reach of the ray
+            const float reach = 5.0f, slack = 0.15f;
+            var entity = entitySource.FindAlongRay(ray.Origin, ray.Direction, reach, slack, EntityKind.Pickup);
+            if (entity == IntPtr.Zero) entity = entitySource.FindAlongRay(ray.Origin, ray.Direction, reach, slack, EntityKind.Prop);
+            return entity;
+        }
+        
+        private DepthHit FindPointedSurface(Ray ray)
         {
-            // Calculate a ray originating from the controller position in the direction it's pointing
-            // Implementation depends on how we're tracking controllers
+            // A pyramid can be rebuilt under a slow query; take the newer one and try again
+            for (int attempt = 0; attempt < 3; attempt++)
+            {
+                var depth = depthSource?.LatestDepth;
+                if (depth == null) break;
+                
+                if (depth.TryMarchFromWorld(ray.Origin, ray.Direction, MaxPointingDistance, out DepthHit hit)) return hit;
+            }
             
-            // Placeholder
-            return new Ray();
+            return new DepthHit();
         }
     }
     
@@ -488,9 +1187,25 @@ namespace VRGameConverter.OpenWorld
         private bool isInVehicle = false;
         private VehicleType currentVehicleType = VehicleType.None;
         
+        // Seat anchors and control schemes by vehicle model, so entering a vehicle never waits on inspection
+        private VehicleAnchorCache anchorCache;
+        private VehicleControlScheme controlScheme = VehicleControlScheme.Triggers;
+        public IVehicleInspector VehicleInspector { get; set; }
+        
+        // Closest vehicle while on foot, from the world mirror; zero when none is in reach
+        private EntityMirror entitySource;
+        private const float VehicleReach = 4.0f;
+        public IntPtr NearestVehicle { get; private set; }
+        
         public VehicleHandler(GameType gameType)
         {
             this.gameType = gameType;
+            anchorCache = new VehicleAnchorCache(gameType.ToString());
+        }
+        
+        public void SetEntitySource(EntityMirror mirror)
+        {
+            this.entitySource = mirror;
         }
         
         public void Configure(VehicleSettings settings)
@@ -531,9 +1246,11 @@ namespace VRGameConverter.OpenWorld
         
         private void InstallHook(IntPtr targetFunction, Delegate hookFunction)
         {
-            // Implementation using hooking library
+            // Hot-patch install so hooks added mid-session don't stall the game
+            HookEngine.Shared.InstallHook(targetFunction, hookFunction);
         }
         
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
         private void DriveVehicleHook(IntPtr vehicle, float throttle, float brake, float steering)
         {
             // Replace the game's vehicle control function
@@ -550,11 +1267,31 @@ namespace VRGameConverter.OpenWorld
             
             isInVehicle = true;
             
-            // Determine vehicle type
-            // currentVehicleType = DetermineVehicleType(vehicle);
+            // Determine vehicle type: a cache hit for any model entered before, inspected once otherwise
+            bool hasAnchor = anchorCache.TryGetAnchor(vehicle, seat, VehicleInspector, out var anchor);
+            if (hasAnchor)
+            {
+                currentVehicleType = (VehicleType)anchor.VehicleType;
+                controlScheme = anchor.ControlScheme;
+            }
+            else
+            {
+                currentVehicleType = VehicleType.Car;
+                controlScheme = VehicleControlScheme.Triggers;
+            }
             
-            // Apply appropriate VR camera positioning
-            // AdjustCameraForVehicle(currentVehicleType);
+            // CameraManager and MovementSystem pick this up on their next update
+            EventBus.Publish(new VehicleEnteredEvent
+            {
+                Timestamp = Stopwatch.GetTimestamp(),
+                Character = character,
+                Vehicle = vehicle,
+                Seat = seat,
+                VehicleType = (int)currentVehicleType,
+                HasAnchor = hasAnchor,
+                SeatOffset = anchor.SeatOffset,
+                SeatRotation = anchor.SeatRotation
+            });
         }
         
         private void ExitVehicleHook(IntPtr character, IntPtr vehicle)
@@ -565,20 +1302,24 @@ namespace VRGameConverter.OpenWorld
             currentVehicleType = VehicleType.None;
             
             // Reset VR camera positioning
-            // ResetCameraPosition();
+            EventBus.Publish(new VehicleExitedEvent { Timestamp = Stopwatch.GetTimestamp(), Character = character, Vehicle = vehicle });
         }
         
         public void Update(HeadPose headPose, ControllerState leftController, ControllerState rightController)
         {
-            if (!isInVehicle) return;
+            if (!isInVehicle)
+            {
+                NearestVehicle = entitySource?.FindNearest(headPose.Position, VehicleReach, EntityKind.Vehicle) ?? IntPtr.Zero;
+                return;
+            }
             
             // Map controller inputs to vehicle controls
             float throttle = 0, brake = 0, steering = 0;
             
-            // Different control schemes based on vehicle type
-            switch (currentVehicleType)
+            // Different control schemes based on vehicle type, from the anchor cache
+            switch (controlScheme)
             {
-                case VehicleType.Car:
+                case VehicleControlScheme.Triggers:
                     // Use triggers for throttle/brake
                     throttle = rightController.TriggerValue;
                     brake = leftController.TriggerValue;
@@ -586,7 +1327,7 @@ namespace VRGameConverter.OpenWorld
                     steering = leftController.ThumbstickPosition.X;
                     break;
                     
-                case VehicleType.Motorcycle:
+                case VehicleControlScheme.Handlebars:
                     // Similar to car but with different ergonomics
                     throttle = rightController.TriggerValue;
                     brake = leftController.TriggerValue;
@@ -594,7 +1335,7 @@ namespace VRGameConverter.OpenWorld
                     // steering = CalculateSteeringFromControllerRotation();
                     break;
                     
-                case VehicleType.Aircraft:
+                case VehicleControlScheme.FlightStick:
                     // More complex control scheme for aircraft
                     // Use joysticks for pitch/roll/yaw
                     break;
@@ -615,16 +1356,53 @@ namespace VRGameConverter.OpenWorld
         private Dictionary<string, IntPtr> hookTargets;
         private bool isActive = false;
         
-        public CombatSystem(GameType gameType)
+        // Ranged attacks fire from trigger pull velocity rather than the runtime's click point
+        private TriggerPredictor leftTrigger = new TriggerPredictor(new TriggerPredictionSettings());
+        private TriggerPredictor rightTrigger = new TriggerPredictor(new TriggerPredictionSettings());
+        
+        /// <summary>
+        /// How far ahead of the press threshold predicted shots fired, i.e. the latency removed
+        /// </summary>
+        public double TriggerLeadMilliseconds
         {
-            this.gameType = gameType;
+            get
+            {
+                int left = leftTrigger.PredictedPresses - leftTrigger.FalsePositives;
+                int right = rightTrigger.PredictedPresses - rightTrigger.FalsePositives;
+                if (left + right == 0) return 0;
+                return (leftTrigger.MeanLeadMilliseconds * left + rightTrigger.MeanLeadMilliseconds * right) / (left + right);
+            }
         }
         
-        public void Configure(CombatSettings settings)
+        public int TriggerFalsePositives => leftTrigger.FalsePositives + rightTrigger.FalsePositives;
+        
+        // Character the right controller is aimed at, from the world mirror; zero when none
+        private EntityMirror entitySource;
+        private const float MaxAimDistance = 80.0f;
+        private const float AimSlack = 0.5f;
+        public IntPtr AimTarget { get; private set; }
+        
+        public CombatSystem(GameType gameType)
+        {
+            this.gameType = gameType;
+        }
+        
+        public void SetEntitySource(EntityMirror mirror)
+        {
+            this.entitySource = mirror;
+        }
+        
+        public void Configure(CombatSettings settings)
         {
             this.settings = settings;
         }
         
+        public void ConfigureTriggerPrediction(TriggerPredictionSettings settings)
+        {
+            leftTrigger.Configure(settings);
+            rightTrigger.Configure(settings);
+        }
+        
         public void SetHookTargets(Dictionary<string, IntPtr> targets)
         {
             this.hookTargets = targets;
@@ -659,7 +1437,8 @@ namespace VRGameConverter.OpenWorld
         
         private void InstallHook(IntPtr targetFunction, Delegate hookFunction)
         {
-            // Implementation using hooking library
+            // Hot-patch install so hooks added mid-session don't stall the game
+            HookEngine.Shared.InstallHook(targetFunction, hookFunction);
         }
         
         private void MeleeAttackHook(IntPtr character, int attackType)
@@ -708,7 +1487,9 @@ namespace VRGameConverter.OpenWorld
             
             // Check for attack triggers
             bool meleeAttackTriggered = leftController.GripPressed || rightController.GripPressed;
-            bool rangedAttackTriggered = leftController.TriggerPressed || rightController.TriggerPressed;
+            double now = Stopwatch.GetTimestamp() / (double)Stopwatch.Frequency;
+            bool rangedAttackTriggered = leftTrigger.Update(leftController.TriggerValue, now) | rightTrigger.Update(rightController.TriggerValue, now)
+                || leftController.TriggerPressed || rightController.TriggerPressed;
             
             if (meleeAttackTriggered)
             {
@@ -717,6 +1498,12 @@ namespace VRGameConverter.OpenWorld
                 // TriggerMeleeAttack(attackType);
             }
             
+            if (entitySource != null)
+            {
+                Vector3 aimDirection = Vector3.Transform(-Vector3.UnitZ, rightController.Rotation);
+                AimTarget = entitySource.FindAlongRay(rightController.Position, aimDirection, MaxAimDistance, AimSlack, EntityKind.Character);
+            }
+            
             if (rangedAttackTriggered)
             {
                 // Get aiming direction from controller
@@ -736,6 +1523,223 @@ namespace VRGameConverter.OpenWorld
         }
     }
     
+    /// <summary>
+    /// Puts the first-person body where the player is: spine from the head, arms to the controllers,
+    /// legs to feet trackers. All chains are solved together once per frame, right after the game animates
+    /// its skeleton, and the results are written over the game's bones.
+    /// </summary>
+    public class BodySystem
+    {
+        private GameType gameType;
+        private BodySettings settings;
+        private Dictionary<string, IntPtr> hookTargets;
+        private bool isActive = false;
+        
+        // Every chain is root, middle joint, tip
+        private const int SpineChain = 0;
+        private const int LeftArmChain = 1;
+        private const int RightArmChain = 2;
+        private const int LeftLegChain = 3;
+        private const int RightLegChain = 4;
+        private ChainIkSolver solver = new ChainIkSolver(5, 3);
+        
+        // Latest poses from the update loop; the skeleton hook solves against whatever is newest
+        private HeadPose headPose;
+        private Vector3 leftHandPosition;
+        private Vector3 rightHandPosition;
+        private Quaternion leftHandRotation = Quaternion.Identity;
+        private Quaternion rightHandRotation = Quaternion.Identity;
+        
+        // Optional trackers; without a waist tracker the pelvis hangs below the head
+        private HeadPose waistPose;
+        private HeadPose leftFootPose;
+        private HeadPose rightFootPose;
+        private bool hasWaist = false;
+        private bool hasLeftFoot = false;
+        private bool hasRightFoot = false;
+        
+        private BoneOverride[] overrides = new BoneOverride[Enum.GetValues(typeof(BodyBone)).Length];
+        private int overrideCount = 0;
+        private bool budgetWarned = false;
+        
+        // Provided by the engine backend
+        public ISkeletonWriter SkeletonWriter { get; set; }
+        
+        // Only the first-person body is ours to move
+        public bool FirstPerson { get; set; }
+        public double LastSolveMilliseconds { get; private set; }
+        
+        // Engine function that finishes animating a character skeleton for the frame
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        private delegate void UpdateSkeletonDelegate(IntPtr skeleton, IntPtr boneTransforms, int boneCount);
+        
+        private UpdateSkeletonDelegate originalUpdateSkeleton;
+        
+        public BodySystem(GameType gameType)
+        {
+            this.gameType = gameType;
+        }
+        
+        public void Configure(BodySettings settings)
+        {
+            this.settings = settings;
+            
+            solver.SetChain(SpineChain, new[] { settings.PelvisToChest, settings.ChestToNeck }, settings.MaxSpineBendDegrees);
+            solver.SetChain(LeftArmChain, new[] { settings.UpperArmLength, settings.ForearmLength }, settings.MaxElbowBendDegrees);
+            solver.SetChain(RightArmChain, new[] { settings.UpperArmLength, settings.ForearmLength }, settings.MaxElbowBendDegrees);
+            solver.SetChain(LeftLegChain, new[] { settings.ThighLength, settings.ShinLength }, settings.MaxKneeBendDegrees);
+            solver.SetChain(RightLegChain, new[] { settings.ThighLength, settings.ShinLength }, settings.MaxKneeBendDegrees);
+            budgetWarned = false;
+        }
+        
+        public void SetHookTargets(Dictionary<string, IntPtr> targets)
+        {
+            this.hookTargets = targets;
+        }
+        
+        public void Activate()
+        {
+            if (isActive) return;
+            
+            if (hookTargets.TryGetValue("UpdateSkeleton", out var skeletonFunc))
+            {
+                InstallHook(skeletonFunc, new UpdateSkeletonDelegate(UpdateSkeletonHook), original => originalUpdateSkeleton = original);
+            }
+            
+            isActive = true;
+        }
+        
+        private static void InstallHook<T>(IntPtr targetFunction, T hookFunction, Action<T> setOriginal) where T : Delegate
+        {
+            // Hot-patch install so hooks added mid-session don't stall the game
+            HookEngine.Shared.InstallHook(targetFunction, hookFunction, setOriginal);
+        }
+        
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        private void UpdateSkeletonHook(IntPtr skeleton, IntPtr boneTransforms, int boneCount)
+        {
+            var original = originalUpdateSkeleton;
+            if (original == null) return;
+            
+            // Let the game animate first, then override the bones we drive
+            original(skeleton, boneTransforms, boneCount);
+            
+            if (!FirstPerson || !settings.Enabled || SkeletonWriter == null) return;
+            
+            long start = Stopwatch.GetTimestamp();
+            Solve();
+            SkeletonWriter.WriteBones(skeleton, boneTransforms, boneCount, new ReadOnlySpan<BoneOverride>(overrides, 0, overrideCount));
+            FrameAnalyzer.Shared.AddHookTime(start);
+        }
+        
+        private void Solve()
+        {
+            long start = Stopwatch.GetTimestamp();
+            
+            // The body faces where the head looks, flattened onto the floor
+            Vector3 forward = Vector3.Transform(-Vector3.UnitZ, headPose.Rotation);
+            forward.Y = 0;
+            forward = forward.LengthSquared() > 1e-6f ? Vector3.Normalize(forward) : -Vector3.UnitZ;
+            Vector3 right = Vector3.Cross(forward, Vector3.UnitY);
+            Quaternion bodyRotation = Quaternion.CreateFromAxisAngle(Vector3.UnitY, MathF.Atan2(-forward.X, -forward.Z));
+            
+            // Neck base sits below and behind the eyes
+            Vector3 neck = headPose.Position + Vector3.Transform(new Vector3(0, -settings.NeckToEyes, 0.08f), headPose.Rotation);
+            Vector3 pelvis = hasWaist
+                ? waistPose.Position
+                : neck - Vector3.UnitY * (settings.PelvisToChest + settings.ChestToNeck);
+            solver.SetGoal(SpineChain, pelvis, neck, forward);
+            
+            // Elbows bend down, back and out
+            Vector3 shoulderOffset = right * (settings.ShoulderWidth * 0.5f) - Vector3.UnitY * 0.05f;
+            solver.SetGoal(LeftArmChain, neck - shoulderOffset, leftHandPosition, -Vector3.UnitY - forward * 0.5f - right * 0.3f);
+            solver.SetGoal(RightArmChain, neck + shoulderOffset, rightHandPosition, -Vector3.UnitY - forward * 0.5f + right * 0.3f);
+            
+            // Without feet trackers, legs stand straight under the hips
+            bool solveLegs = (hasLeftFoot && hasRightFoot) || settings.SolveLegsWithoutTrackers;
+            Vector3 hipOffset = right * (settings.HipWidth * 0.5f);
+            Vector3 standing = Vector3.UnitY * ((settings.ThighLength + settings.ShinLength) * 0.98f);
+            solver.SetGoal(LeftLegChain, pelvis - hipOffset, hasLeftFoot ? leftFootPose.Position : pelvis - hipOffset - standing, forward);
+            solver.SetGoal(RightLegChain, pelvis + hipOffset, hasRightFoot ? rightFootPose.Position : pelvis + hipOffset - standing, forward);
+            
+            solver.Solve(settings.Iterations, settings.Tolerance);
+            
+            overrideCount = 0;
+            AddOverride(BodyBone.Pelvis, pelvis, hasWaist ? waistPose.Rotation : bodyRotation);
+            AddBone(BodyBone.Spine, SpineChain, 0);
+            AddBone(BodyBone.Chest, SpineChain, 1);
+            AddBone(BodyBone.LeftUpperArm, LeftArmChain, 0);
+            AddBone(BodyBone.LeftForearm, LeftArmChain, 1);
+            AddOverride(BodyBone.LeftHand, solver.GetJoint(LeftArmChain, 2), leftHandRotation);
+            AddBone(BodyBone.RightUpperArm, RightArmChain, 0);
+            AddBone(BodyBone.RightForearm, RightArmChain, 1);
+            AddOverride(BodyBone.RightHand, solver.GetJoint(RightArmChain, 2), rightHandRotation);
+            
+            if (solveLegs)
+            {
+                AddBone(BodyBone.LeftThigh, LeftLegChain, 0);
+                AddBone(BodyBone.LeftShin, LeftLegChain, 1);
+                AddOverride(BodyBone.LeftFoot, solver.GetJoint(LeftLegChain, 2), hasLeftFoot ? leftFootPose.Rotation : bodyRotation);
+                AddBone(BodyBone.RightThigh, RightLegChain, 0);
+                AddBone(BodyBone.RightShin, RightLegChain, 1);
+                AddOverride(BodyBone.RightFoot, solver.GetJoint(RightLegChain, 2), hasRightFoot ? rightFootPose.Rotation : bodyRotation);
+            }
+            
+            LastSolveMilliseconds = (Stopwatch.GetTimestamp() - start) * 1000.0 / Stopwatch.Frequency;
+            if (LastSolveMilliseconds > settings.BudgetMilliseconds && !budgetWarned)
+            {
+                Console.WriteLine($"Body IK took {LastSolveMilliseconds:F3} ms, over the {settings.BudgetMilliseconds} ms budget");
+                budgetWarned = true;
+            }
+        }
+        
+        private void AddBone(BodyBone bone, int chain, int index)
+        {
+            AddOverride(bone, solver.GetJoint(chain, index), solver.GetBoneRotation(chain, index));
+        }
+        
+        private void AddOverride(BodyBone bone, Vector3 position, Quaternion rotation)
+        {
+            // Bones the profile doesn't map are left to the game's animation
+            if (!settings.BoneIndices.TryGetValue(bone, out int boneIndex)) return;
+            
+            overrides[overrideCount++] = new BoneOverride { BoneIndex = boneIndex, Position = position, Rotation = rotation };
+        }
+        
+        public WarmupTiming WarmUp()
+        {
+            return HotPathWarmup.Run("body IK", Solve);
+        }
+        
+        public void SetTracker(TrackedDeviceRole role, HeadPose pose, bool tracked)
+        {
+            switch (role)
+            {
+                case TrackedDeviceRole.Waist:
+                    waistPose = pose;
+                    hasWaist = tracked;
+                    break;
+                case TrackedDeviceRole.LeftFoot:
+                    leftFootPose = pose;
+                    hasLeftFoot = tracked;
+                    break;
+                case TrackedDeviceRole.RightFoot:
+                    rightFootPose = pose;
+                    hasRightFoot = tracked;
+                    break;
+            }
+        }
+        
+        public void Update(HeadPose headPose, ControllerState leftController, ControllerState rightController)
+        {
+            this.headPose = headPose;
+            leftHandPosition = leftController.Position;
+            leftHandRotation = leftController.Rotation;
+            rightHandPosition = rightController.Position;
+            rightHandRotation = rightController.Rotation;
+        }
+    }
+    
     /// <summary>
     /// Manages the UI adaptation for VR
     /// </summary>
@@ -776,14 +1780,26 @@ namespace VRGameConverter.OpenWorld
                 InstallHook(showMenuFunc, ShowMenuHook);
             }
             
+            if (hookTargets.TryGetValue("HideMenu", out var hideMenuFunc))
+            {
+                InstallHook(hideMenuFunc, HideMenuHook);
+            }
+            
+            if (hookTargets.TryGetValue("SetLoadingScreen", out var loadingFunc))
+            {
+                InstallHook(loadingFunc, SetLoadingScreenHook);
+            }
+            
             isActive = true;
         }
         
         private void InstallHook(IntPtr targetFunction, Delegate hookFunction)
         {
-            // Implementation using hooking library
+            // Hot-patch install so hooks added mid-session don't stall the game
+            HookEngine.Shared.InstallHook(targetFunction, hookFunction);
         }
         
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
         private void RenderUIHook(IntPtr uiContext)
         {
             // Replace the game's UI rendering function
@@ -801,6 +1817,19 @@ namespace VRGameConverter.OpenWorld
             
             // Create a 3D VR-friendly version of the menu
             // ShowVRMenu(uiContext, menuType);
+            
+            // Menus are a safe window for background maintenance
+            IdleWorkScheduler.Shared.SetMenuOpen(true);
+        }
+        
+        private void HideMenuHook(IntPtr uiContext, int menuType)
+        {
+            IdleWorkScheduler.Shared.SetMenuOpen(false);
+        }
+        
+        private void SetLoadingScreenHook(IntPtr uiContext, bool visible)
+        {
+            IdleWorkScheduler.Shared.SetLoadingScreen(visible);
         }
         
         public void Update(HeadPose headPose)
@@ -812,6 +1841,702 @@ namespace VRGameConverter.OpenWorld
         }
     }
     
+    /// <summary>
+    /// Re-spatializes the game's audio output with the current head pose
+    /// </summary>
+    public class AudioSystem
+    {
+        private GameType gameType;
+        private AudioSettings settings;
+        private Dictionary<string, IntPtr> hookTargets;
+        private bool isActive = false;
+        
+        // One spatializer and in-flight buffer per IAudioRenderClient: games often run several streams
+        // (music, effects, voice) at different formats, each released from its own thread
+        private readonly ConcurrentDictionary<IntPtr, RenderClientState> renderClients = new ConcurrentDictionary<IntPtr, RenderClientState>();
+        
+        // Copy-on-write list for Update, so the per-frame head pose fan-out doesn't allocate
+        private volatile RenderClientState[] renderClientList = new RenderClientState[0];
+        private readonly object registrationLock = new object();
+        
+        // HRIR sets are only built once per sample rate
+        private readonly Dictionary<int, HrtfSet> hrtfSets = new Dictionary<int, HrtfSet>();
+        
+        private sealed class RenderClientState
+        {
+            public AudioMixFormat Format;
+            public HrtfSpatializer Spatializer;   // null when the stream's format can't be spatialized
+            public IntPtr PendingBuffer;          // Handed out by GetBuffer, processed when the game releases it
+        }
+        
+        private const uint AUDCLNT_BUFFERFLAGS_SILENT = 0x2;
+        private const int AUDCLNT_E_NOT_INITIALIZED = unchecked((int)0x88890001);
+        private const int GetMixFormatVtableSlot = 8;
+        private static readonly Guid IID_IAudioRenderClient = new Guid("F294ACFC-3146-4483-A7BF-ADDCA7C260E2");
+        
+        // IAudioRenderClient::GetBuffer / ReleaseBuffer
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        private delegate int GetBufferDelegate(IntPtr renderClient, uint framesRequested, out IntPtr data);
+        
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        private delegate int ReleaseBufferDelegate(IntPtr renderClient, uint framesWritten, uint flags);
+        
+        // IAudioClient::GetService, where the game obtains each render client, and IAudioClient::GetMixFormat
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        private delegate int GetServiceDelegate(IntPtr audioClient, ref Guid riid, out IntPtr service);
+        
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        private delegate int GetMixFormatDelegate(IntPtr audioClient, out IntPtr format);
+        
+        private GetBufferDelegate originalGetBuffer;
+        private ReleaseBufferDelegate originalReleaseBuffer;
+        private GetServiceDelegate originalGetService;
+        
+        public AudioSystem(GameType gameType)
+        {
+            this.gameType = gameType;
+        }
+        
+        public void Configure(AudioSettings settings)
+        {
+            this.settings = settings;
+            
+            if (settings.SpatializationEnabled)
+            {
+                GetHrtfSet(settings.SampleRate);
+            }
+        }
+        
+        public void SetHookTargets(Dictionary<string, IntPtr> targets)
+        {
+            this.hookTargets = targets;
+        }
+        
+        public void Activate()
+        {
+            if (isActive) return;
+            
+            // Both halves are needed: GetBuffer tells us where the samples are, ReleaseBuffer when they're final
+            if (hookTargets.TryGetValue("GetAudioBuffer", out var getBufferFunc) &&
+                hookTargets.TryGetValue("ReleaseAudioBuffer", out var releaseBufferFunc))
+            {
+                // The originals are handed over before each patch goes in; the game's audio thread can call
+                // through a hook the moment it is written
+                InstallHook(getBufferFunc, new GetBufferDelegate(GetBufferHook), original => originalGetBuffer = original);
+                InstallHook(releaseBufferFunc, new ReleaseBufferDelegate(ReleaseBufferHook), original => originalReleaseBuffer = original);
+            }
+            
+            // Optional: without it every stream is assumed to use the profile's format
+            if (hookTargets.TryGetValue("GetAudioClientService", out var getServiceFunc))
+            {
+                InstallHook(getServiceFunc, new GetServiceDelegate(GetServiceHook), original => originalGetService = original);
+            }
+            
+            isActive = true;
+        }
+        
+        private static void InstallHook<T>(IntPtr targetFunction, T hookFunction, Action<T> setOriginal) where T : Delegate
+        {
+            // Hot-patch install so hooks added mid-session don't stall the game
+            HookEngine.Shared.InstallHook(targetFunction, hookFunction, setOriginal);
+        }
+        
+        /// <summary>
+        /// Push silence through a spatializer before the audio hooks go live, so the audio thread's first
+        /// buffers don't pay for JIT
+        /// </summary>
+        public WarmupTiming WarmUp()
+        {
+            if (!settings.SpatializationEnabled) return new WarmupTiming { Name = "audio (spatialization off)" };
+            
+            var spatializer = new HrtfSpatializer(GetHrtfSet(settings.SampleRate), settings.SpeakerAngleDegrees, settings.BlockSize);
+            var silence = new float[spatializer.BlockSize * settings.Channels];
+            return HotPathWarmup.Run("audio block", () => spatializer.ProcessInterleaved(silence, settings.Channels));
+        }
+        
+        private int GetServiceHook(IntPtr audioClient, ref Guid riid, out IntPtr service)
+        {
+            var original = originalGetService;
+            if (original == null)
+            {
+                service = IntPtr.Zero;
+                return AUDCLNT_E_NOT_INITIALIZED;
+            }
+            
+            int result = original(audioClient, ref riid, out service);
+            
+            // Runs where the game sets its stream up, so building the spatializer here keeps it off the audio thread
+            if (result >= 0 && service != IntPtr.Zero && riid == IID_IAudioRenderClient)
+            {
+                RegisterRenderClient(service, ReadMixFormat(audioClient));
+            }
+            return result;
+        }
+        
+        private unsafe AudioMixFormat ReadMixFormat(IntPtr audioClient)
+        {
+            IntPtr vtable = Marshal.ReadIntPtr(audioClient);
+            var getMixFormat = Marshal.GetDelegateForFunctionPointer<GetMixFormatDelegate>(
+                Marshal.ReadIntPtr(vtable, GetMixFormatVtableSlot * IntPtr.Size));
+            
+            if (getMixFormat(audioClient, out var format) < 0 || format == IntPtr.Zero)
+            {
+                Console.WriteLine("IAudioClient::GetMixFormat failed, assuming the profile's audio format");
+                return AudioMixFormat.FromSettings(settings);
+            }
+            
+            try
+            {
+                var header = new ReadOnlySpan<byte>((void*)format, AudioMixFormat.WaveFormatExSize);
+                return AudioMixFormat.Parse(new ReadOnlySpan<byte>((void*)format, AudioMixFormat.SizeOf(header)));
+            }
+            finally
+            {
+                Marshal.FreeCoTaskMem(format);
+            }
+        }
+        
+        private RenderClientState RegisterRenderClient(IntPtr renderClient, AudioMixFormat format)
+        {
+            var state = new RenderClientState { Format = format };
+            if (settings.SpatializationEnabled && format.IsFloat32 && format.Channels >= 2)
+            {
+                state.Spatializer = new HrtfSpatializer(GetHrtfSet(format.SampleRate), settings.SpeakerAngleDegrees, settings.BlockSize);
+            }
+            
+            lock (registrationLock)
+            {
+                // A released client's address can be reused by the next stream, which replaces its state
+                renderClients[renderClient] = state;
+                var list = new List<RenderClientState>(renderClients.Values);
+                renderClientList = list.ToArray();
+            }
+            
+            Console.WriteLine($"Audio stream {renderClient}: {format}{(state.Spatializer == null ? ", passed through" : "")}");
+            return state;
+        }
+        
+        private HrtfSet GetHrtfSet(int sampleRate)
+        {
+            lock (hrtfSets)
+            {
+                if (!hrtfSets.TryGetValue(sampleRate, out var set))
+                {
+                    set = HrtfSet.CreateSphericalHeadModel(sampleRate);
+                    hrtfSets[sampleRate] = set;
+                }
+                return set;
+            }
+        }
+        
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        private int GetBufferHook(IntPtr renderClient, uint framesRequested, out IntPtr data)
+        {
+            var original = originalGetBuffer;
+            if (original == null)
+            {
+                data = IntPtr.Zero;
+                return AUDCLNT_E_NOT_INITIALIZED;
+            }
+            
+            int result = original(renderClient, framesRequested, out data);
+            
+            // Streams created before our hooks went in are only met here; they pay for setup once
+            if (!renderClients.TryGetValue(renderClient, out var state))
+            {
+                state = RegisterRenderClient(renderClient, AudioMixFormat.FromSettings(settings));
+            }
+            state.PendingBuffer = result >= 0 ? data : IntPtr.Zero;
+            return result;
+        }
+        
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        private unsafe int ReleaseBufferHook(IntPtr renderClient, uint framesWritten, uint flags)
+        {
+            var original = originalReleaseBuffer;
+            if (original == null) return AUDCLNT_E_NOT_INITIALIZED;
+            
+            // Runs on the stream's audio thread; the spatializer is allocation-free
+            if (renderClients.TryGetValue(renderClient, out var state))
+            {
+                if (state.Spatializer != null && state.PendingBuffer != IntPtr.Zero && (flags & AUDCLNT_BUFFERFLAGS_SILENT) == 0)
+                {
+                    var samples = new Span<float>((void*)state.PendingBuffer, (int)framesWritten * state.Format.Channels);
+                    state.Spatializer.ProcessInterleaved(samples, state.Format.Channels);
+                }
+                state.PendingBuffer = IntPtr.Zero;
+            }
+            
+            return original(renderClient, framesWritten, flags);
+        }
+        
+        public void Update(HeadPose headPose)
+        {
+            // Picked up by each audio thread at its next block boundary
+            foreach (var state in renderClientList)
+            {
+                state.Spatializer?.SetHeadRotation(headPose.Rotation);
+            }
+        }
+    }
+    
+    /// <summary>
+    /// Hooks the game's frame submission so VR passes can be injected around the scene pass
+    /// </summary>
+    public class RenderSystem : IDisposable
+    {
+        private GameType gameType;
+        private RenderSettings settings;
+        private Dictionary<string, IntPtr> hookTargets;
+        private bool isActive = false;
+        
+        // Passes that run before the game's scene pass for each eye. Only the render thread changes the list once
+        // the present hook is in; passes added elsewhere wait in pendingPasses for the next present.
+        private List<IRenderPass> preScenePasses = new List<IRenderPass>();
+        private readonly ConcurrentQueue<IRenderPass> pendingPasses = new ConcurrentQueue<IRenderPass>();
+        private LateLatchPass lateLatchPass;
+        private ResolutionScalePass resolutionScalePass;
+        private HiddenAreaMeshPass hiddenAreaMeshPass;
+        private FoveationPass foveationPass;
+        
+        // Settings changed off the render thread, applied at the start of the next present
+        private RenderSettings pendingSettings;
+        
+        // Provided by the backend for the game's graphics API
+        public IStencilMaskWriter StencilMaskWriter { get; set; }
+        public IDepthReadback DepthReadback { get; set; }
+        public IViewportWriter ViewportWriter { get; set; }
+        public IShadingRateWriter ShadingRateWriter { get; set; }
+        
+        // Part of each eye buffer the game renders into; the compositor backend samples this rectangle
+        public int EyeViewportWidth => resolutionScalePass?.Width ?? settings.EyeWidth;
+        public int EyeViewportHeight => resolutionScalePass?.Height ?? settings.EyeHeight;
+        
+        // Eye the last scene pass rendered; in alternate-eye mode the compositor only updates that one
+        public int LastRenderedEye { get; private set; }
+        private long presentCount = 0;
+        
+        // Depth read back at present; the pyramid is built off the render thread
+        private DepthPyramidBuilder depthBuilder;
+        private HeadPose lastHeadPose;
+        
+        public DepthPyramid LatestDepth => depthBuilder?.Latest;
+        
+        // Frame synthesis: captured every present so the flow history stays current, estimated on the
+        // pipeline's worker, and extrapolated at headset rate by the compositor once EnableSpaceWarp is called
+        public IMotionReadback MotionReadback { get; set; }
+        public SpaceWarpPipeline SpaceWarp { get; private set; }
+        public bool SpaceWarpActive => SpaceWarp?.Active ?? false;
+        private SpaceWarpCompositor spaceWarpCompositor;
+        private ISynthesizedFrameSink synthesizedFrameSink;
+        private IDisplayTimeSource spaceWarpDisplayTimes;
+        
+        // Game frame pacing measured between presents
+        private long lastPresentTimestamp = 0;
+        public double LastFrameMilliseconds { get; private set; }
+        
+        // Set while the benchmark mode is sweeping settings
+        public PerformanceBenchmark Benchmark { get; set; }
+        
+        // Late-latched head pose; the compositor backend submits LastSubmittedPose with the frame
+        public PoseLatch PoseLatch { get; set; }
+        public LatchedPose LastSubmittedPose { get; private set; }
+        
+        // Runtime frame loop run after each present (OpenXR without a thread of its own), and the swap chain
+        // the game presents, which is how its graphics device is found
+        public IRuntimeFrameLoop RuntimeFrames { get; set; }
+        public IntPtr SwapChain { get; private set; }
+        
+        // Under DXVK, Present only queues the frame for DXVK's own thread; the Vulkan layer sees the real one
+        public PresentLayerBridge PresentLayer { get; set; }
+        
+        // IDXGISwapChain::Present
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        private delegate int PresentDelegate(IntPtr swapChain, uint syncInterval, uint flags);
+        
+        // Engine function that starts the scene pass for one eye/view
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        private delegate void BeginScenePassDelegate(IntPtr renderContext, int eye);
+        
+        // Engine function returning how many views the scene renderer loops over per frame
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        private delegate int GetViewCountDelegate(IntPtr renderer);
+        
+        private const int DXGI_ERROR_NOT_CURRENTLY_AVAILABLE = unchecked((int)0x887A0022);
+        
+        private PresentDelegate originalPresent;
+        private BeginScenePassDelegate originalBeginScenePass;
+        
+        public RenderSystem(GameType gameType)
+        {
+            this.gameType = gameType;
+        }
+        
+        /// <summary>
+        /// Apply settings from the render thread. Before the present hook is installed; afterwards, go through
+        /// RequestConfigure.
+        /// </summary>
+        public void Configure(RenderSettings settings)
+        {
+            this.settings = settings;
+            FrameAnalyzer.Shared.SetRefreshRate(settings.HeadsetRefreshRate);
+            
+            preScenePasses.Remove(resolutionScalePass);
+            preScenePasses.Remove(hiddenAreaMeshPass);
+            preScenePasses.Remove(foveationPass);
+            
+            // Right after the latch, viewport first, so the mask and shading rates are drawn into the part the
+            // game renders to
+            var previousHiddenArea = hiddenAreaMeshPass;
+            resolutionScalePass = new ResolutionScalePass(ViewportWriter, settings);
+            hiddenAreaMeshPass = null;
+            foveationPass = null;
+            int insertAt = lateLatchPass != null ? 1 : 0;
+            preScenePasses.Insert(insertAt++, resolutionScalePass);
+            
+            if (settings.HiddenAreaMeshEnabled)
+            {
+                // Meshes are cached per headset in the settings, filled by VRInputManager from the runtime.
+                // Rasterizing them is only redone for a new eye-buffer size; a resolution step just rescales.
+                var meshes = HiddenAreaMeshPass.ResolveMeshes(settings, null);
+                if (previousHiddenArea == null || !previousHiddenArea.Matches(meshes, StencilMaskWriter, settings.EyeWidth, settings.EyeHeight))
+                {
+                    previousHiddenArea = new HiddenAreaMeshPass(meshes, StencilMaskWriter, settings.EyeWidth, settings.EyeHeight);
+                }
+                hiddenAreaMeshPass = previousHiddenArea;
+                hiddenAreaMeshPass.SetViewport(resolutionScalePass.Width, resolutionScalePass.Height);
+                preScenePasses.Insert(insertAt++, hiddenAreaMeshPass);
+            }
+            
+            if (settings.FoveationLevel > 0)
+            {
+                foveationPass = new FoveationPass(settings.FoveationLevel, ShadingRateWriter);
+                preScenePasses.Insert(insertAt++, foveationPass);
+            }
+            
+            bool depthSizeChanged = depthBuilder == null ||
+                depthBuilder.Width != settings.DepthCaptureWidth || depthBuilder.Height != settings.DepthCaptureHeight;
+            if (depthBuilder != null && (!settings.DepthCaptureEnabled || depthSizeChanged))
+            {
+                depthBuilder.Dispose();
+                depthBuilder = null;
+            }
+            
+            if (settings.DepthCaptureEnabled && depthBuilder == null)
+            {
+                depthBuilder = new DepthPyramidBuilder(settings.DepthCaptureWidth, settings.DepthCaptureHeight);
+            }
+            
+            // Keep the pipeline (and its flow history) unless its shape changed
+            var warp = SpaceWarp;
+            bool warpChanged = warp == null || warp.Width != settings.SpaceWarpWidth || warp.Height != settings.SpaceWarpHeight ||
+                warp.BlockSize != settings.SpaceWarpBlockSize || warp.SearchRadius != settings.SpaceWarpSearchRadius;
+            if (warp != null && (!settings.SpaceWarpEnabled || warpChanged))
+            {
+                StopSpaceWarp();
+            }
+            
+            if (settings.SpaceWarpEnabled && SpaceWarp == null)
+            {
+                SpaceWarp = new SpaceWarpPipeline(settings.SpaceWarpWidth, settings.SpaceWarpHeight,
+                    settings.SpaceWarpBlockSize, settings.SpaceWarpSearchRadius);
+                StartSpaceWarpCompositor();
+            }
+        }
+        
+        /// <summary>
+        /// Apply settings changed on another thread. The render thread picks up a copy at its next present,
+        /// between frames, so nothing it is iterating or filling changes under it.
+        /// </summary>
+        public void RequestConfigure(RenderSettings settings)
+        {
+            var snapshot = settings.Clone();
+            if (originalPresent == null)
+            {
+                Configure(snapshot);
+                return;
+            }
+            
+            Volatile.Write(ref pendingSettings, snapshot);
+        }
+        
+        /// <summary>
+        /// Send synthesized frames to the compositor backend while the game runs below the headset rate
+        /// </summary>
+        public void EnableSpaceWarp(ISynthesizedFrameSink sink, IDisplayTimeSource displayTimes)
+        {
+            synthesizedFrameSink = sink;
+            spaceWarpDisplayTimes = displayTimes;
+            spaceWarpCompositor?.Dispose();
+            spaceWarpCompositor = null;
+            StartSpaceWarpCompositor();
+        }
+        
+        private void StartSpaceWarpCompositor()
+        {
+            if (SpaceWarp == null || synthesizedFrameSink == null) return;
+            
+            spaceWarpCompositor = new SpaceWarpCompositor(SpaceWarp, synthesizedFrameSink, spaceWarpDisplayTimes, settings.HeadsetRefreshRate);
+        }
+        
+        private void StopSpaceWarp()
+        {
+            spaceWarpCompositor?.Dispose();
+            spaceWarpCompositor = null;
+            
+            SpaceWarp.Dispose();
+            SpaceWarp = null;
+        }
+        
+        /// <summary>
+        /// Stop the depth pyramid builder, the space warp worker and the compositor thread. The present hook stays
+        /// in; it finds nothing left to capture into.
+        /// </summary>
+        public void Dispose()
+        {
+            pendingSettings = null;
+            
+            var builder = depthBuilder;
+            depthBuilder = null;
+            builder?.Dispose();
+            
+            if (SpaceWarp != null)
+            {
+                StopSpaceWarp();
+            }
+        }
+        
+        public void SetHookTargets(Dictionary<string, IntPtr> targets)
+        {
+            this.hookTargets = targets;
+        }
+        
+        /// <summary>
+        /// Add a pass from any thread. Like RequestConfigure, it joins the list at the render thread's next present
+        /// once the present hook is in.
+        /// </summary>
+        public void AddPreScenePass(IRenderPass pass)
+        {
+            if (originalPresent == null)
+            {
+                AddPass(pass);
+                return;
+            }
+            
+            pendingPasses.Enqueue(pass);
+        }
+        
+        private void AddPass(IRenderPass pass)
+        {
+            // The late latch stays in the first slot, whatever Configure inserts later, so every other pass and
+            // the game's draws see the latched pose; a new one replaces the old
+            if (pass is LateLatchPass latch)
+            {
+                if (lateLatchPass != null) preScenePasses.Remove(lateLatchPass);
+                lateLatchPass = latch;
+                preScenePasses.Insert(0, latch);
+                return;
+            }
+            
+            preScenePasses.Add(pass);
+        }
+        
+        public void Activate()
+        {
+            if (isActive) return;
+            
+            // The originals are handed over before each patch goes in; the render thread can call through a hook
+            // the moment it is written
+            if (hookTargets.TryGetValue("Present", out var presentFunc))
+            {
+                InstallHook(presentFunc, new PresentDelegate(PresentHook), original => originalPresent = original);
+            }
+            
+            if (hookTargets.TryGetValue("BeginScenePass", out var scenePassFunc))
+            {
+                InstallHook(scenePassFunc, new BeginScenePassDelegate(BeginScenePassHook), original => originalBeginScenePass = original);
+            }
+            
+            // Replaced outright; the game's own count is never needed
+            if (hookTargets.TryGetValue("GetViewCount", out var viewCountFunc))
+            {
+                InstallHook(viewCountFunc, new GetViewCountDelegate(GetViewCountHook));
+            }
+            else
+            {
+                Console.WriteLine("RenderSystem: no view count hook, stereo mode stays as the game renders it");
+            }
+            
+            isActive = true;
+        }
+        
+        private void InstallHook(IntPtr targetFunction, Delegate hookFunction)
+        {
+            // Hot-patch install so hooks added mid-session don't stall the game
+            HookEngine.Shared.InstallHook(targetFunction, hookFunction);
+        }
+        
+        private static void InstallHook<T>(IntPtr targetFunction, T hookFunction, Action<T> setOriginal) where T : Delegate
+        {
+            HookEngine.Shared.InstallHook(targetFunction, hookFunction, setOriginal);
+        }
+        
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        private int PresentHook(IntPtr swapChain, uint syncInterval, uint flags)
+        {
+            var original = originalPresent;
+            if (original == null) return DXGI_ERROR_NOT_CURRENTLY_AVAILABLE;
+            
+            while (pendingPasses.TryDequeue(out var pass))
+            {
+                AddPass(pass);
+            }
+            
+            var pending = Interlocked.Exchange(ref pendingSettings, null);
+            if (pending != null)
+            {
+                Configure(pending);
+            }
+            
+            long now = Stopwatch.GetTimestamp();
+            if (lastPresentTimestamp != 0)
+            {
+                LastFrameMilliseconds = (now - lastPresentTimestamp) * 1000.0 / Stopwatch.Frequency;
+            }
+            lastPresentTimestamp = now;
+            SwapChain = swapChain;
+            Benchmark?.RecordFrame(LastFrameMilliseconds);
+            
+            if (PoseLatch != null)
+            {
+                LastSubmittedPose = PoseLatch.Submit(settings.HeadsetRefreshRate);
+            }
+            
+            CaptureDepth(swapChain);
+            CaptureMotion(swapChain);
+            presentCount++;
+            FrameAnalyzer.Shared.AddHookTime(now);
+            
+            // Time inside the real Present is the GPU or vsync; the analyzer tells them apart. While the Vulkan
+            // layer is sending its own timings, they are the ones that count.
+            long presentStart = Stopwatch.GetTimestamp();
+            int result = original(swapChain, syncInterval, flags);
+            var presentLayer = PresentLayer;
+            if (presentLayer == null || !presentLayer.Drain(FrameAnalyzer.Shared))
+            {
+                FrameAnalyzer.Shared.EndFrame(presentStart, Stopwatch.GetTimestamp());
+            }
+            
+            // The runtime's frame wait holds the game until the headset wants the next frame; the analyzer
+            // counts it as compositor time in that frame
+            RuntimeFrames?.RunFrame();
+            return result;
+        }
+        
+        private void CaptureMotion(IntPtr swapChain)
+        {
+            var warp = SpaceWarp;
+            if (warp == null || MotionReadback == null) return;
+            
+            // Only worth synthesizing once the game can't keep up with the headset (with some slack for jitter),
+            // but every frame is captured so the flow never has to start over from a stale one
+            double refreshMilliseconds = 1000.0 / settings.HeadsetRefreshRate;
+            warp.Active = LastFrameMilliseconds > refreshMilliseconds * 1.5;
+            
+            if (!MotionReadback.TryReadColor(swapChain, warp.ColorBuffer)) return;
+            
+            // Prefer the game's own TAA motion vectors; optical flow on the colour is the fallback
+            bool hasMotionVectors = MotionReadback.TryReadMotionVectors(swapChain, warp.MotionVectorBuffer, warp.Width, warp.Height);
+            warp.Submit(hasMotionVectors, lastPresentTimestamp);
+        }
+        
+        private void CaptureDepth(IntPtr swapChain)
+        {
+            var builder = depthBuilder;
+            if (DepthReadback == null || builder == null) return;
+            
+            int width = builder.Width;
+            int height = builder.Height;
+            if (!DepthReadback.TryReadDepth(swapChain, builder.CaptureBuffer, width, height)) return;
+            
+            var camera = DepthCamera.FromFov(width, height, settings.GameVerticalFovDegrees,
+                settings.DepthNearPlane, settings.DepthFarPlane, settings.DepthReversedZ);
+            
+            // The game camera follows the head, so the last pose handed to the mapper is the capture pose
+            builder.Submit(camera, lastHeadPose.Position, lastHeadPose.Rotation);
+        }
+        
+        public void Update(HeadPose headPose)
+        {
+            lastHeadPose = headPose;
+        }
+        
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        private int GetViewCountHook(IntPtr renderer)
+        {
+            // Dual pass renders both eyes every frame; alternate-eye renders one
+            return settings.StereoMode == StereoMode.AlternateEye ? 1 : 2;
+        }
+        
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        private void BeginScenePassHook(IntPtr renderContext, int eye)
+        {
+            var original = originalBeginScenePass;
+            if (original == null) return;
+            
+            long start = Stopwatch.GetTimestamp();
+            
+            // Alternate-eye frames have a single view, and which eye it is flips with every present
+            if (settings.StereoMode == StereoMode.AlternateEye)
+            {
+                eye = (int)(presentCount & 1);
+            }
+            LastRenderedEye = eye;
+            
+            // Our passes go first so their depth/stencil writes are in place for the game's draws
+            for (int i = 0; i < preScenePasses.Count; i++)
+            {
+                preScenePasses[i].Execute(renderContext, eye);
+            }
+            
+            FrameAnalyzer.Shared.AddHookTime(start);
+            
+            original(renderContext, eye);
+        }
+        
+        /// <summary>
+        /// Run the CPU kernels on small scratch instances; only the compiled code carries over
+        /// </summary>
+        public WarmupTiming WarmUp()
+        {
+            const int size = 64;
+            var depth = new float[size * size];
+            var luma = new float[size * size];
+            for (int i = 0; i < depth.Length; i++)
+            {
+                depth[i] = 0.5f + 0.25f * ((i % size) / (float)size);
+                luma[i] = (i * 37) % 255;
+            }
+            
+            var pyramid = new DepthPyramid(size, size);
+            var camera = DepthCamera.FromFov(size, size, 90.0f, 0.1f, 100.0f, true);
+            var warp = new SpaceWarp(size, size, 8, 4);
+            var frame = new FrameImage(size, size);
+            var warped = new FrameImage(size, size);
+            
+            return HotPathWarmup.Run("render kernels", () =>
+            {
+                pyramid.Build(depth, camera, Vector3.Zero, Quaternion.Identity);
+                pyramid.March(Vector3.Zero, -Vector3.UnitZ, 50.0f);
+                warp.SubmitLuma(luma);
+                warp.Extrapolate(frame, warped, 0.5f);
+            });
+        }
+        
+        // Pixels the game skipped shading thanks to the hidden-area mesh
+        public long PixelsSaved => hiddenAreaMeshPass?.PixelsSavedTotal ?? 0;
+    }
+    
     // Support classes
     
     public class MemoryScanner
@@ -853,6 +2578,12 @@ namespace VRGameConverter.OpenWorld
         public VehicleSettings VehicleSettings { get; set; } = new VehicleSettings();
         public CombatSettings CombatSettings { get; set; } = new CombatSettings();
         public UISettings UISettings { get; set; } = new UISettings();
+        public AudioSettings AudioSettings { get; set; } = new AudioSettings();
+        public TriggerPredictionSettings TriggerPrediction { get; set; } = new TriggerPredictionSettings();
+        public BodySettings BodySettings { get; set; } = new BodySettings();
+        public EntityPoolLayout EntityPoolLayout { get; set; } = new EntityPoolLayout();
+        public VehicleLayout VehicleLayout { get; set; } = new VehicleLayout();
+        public ThreadPlacementSettings ThreadPlacement { get; set; } = new ThreadPlacementSettings();
         
         // Memory signatures for hooking
         public Dictionary<string, byte[]> CameraSignatures { get; set; } = new Dictionary<string, byte[]>();
@@ -861,6 +2592,10 @@ namespace VRGameConverter.OpenWorld
         public Dictionary<string, byte[]> VehicleSignatures { get; set; } = new Dictionary<string, byte[]>();
         public Dictionary<string, byte[]> CombatSignatures { get; set; } = new Dictionary<string, byte[]>();
         public Dictionary<string, byte[]> UISignatures { get; set; } = new Dictionary<string, byte[]>();
+        public Dictionary<string, byte[]> AudioSignatures { get; set; } = new Dictionary<string, byte[]>();
+        public Dictionary<string, byte[]> RenderSignatures { get; set; } = new Dictionary<string, byte[]>();
+        public Dictionary<string, byte[]> BodySignatures { get; set; } = new Dictionary<string, byte[]>();
+        public Dictionary<string, byte[]> WorldSignatures { get; set; } = new Dictionary<string, byte[]>();
         
         // Factory methods for popular games
         public static GameProfile CreateForGTA5()